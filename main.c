@@ -56,6 +56,10 @@
 #include "shared-module/atexit/__init__.h"
 #endif
 
+#if CIRCUITPY_AUDIOCORE
+#include "shared-module/audiocore/delay_pool.h"
+#endif
+
 #if CIRCUITPY_BLEIO
 #include "shared-bindings/_bleio/__init__.h"
 #include "supervisor/shared/bluetooth/bluetooth.h"
@@ -399,6 +403,12 @@ static void cleanup_after_vm(mp_obj_t exception) {
     filesystem_flush();
     stop_mp();
 
+    // The finalisers run by stop_mp() give the audio effects' delay lines back
+    // to the pool. Release them so that they don't hold the port heap.
+    #if CIRCUITPY_AUDIOCORE
+    audiocore_delay_pool_reset();
+    #endif
+
     // Let the workflows know we've reset in case they want to restart.
     supervisor_workflow_reset();
 }
@@ -1183,6 +1193,10 @@ size_t gc_get_max_new_split(void) {
     return port_heap_get_largest_free_size();
 }
 
+bool gc_ram_is_fast(void *ptr) {
+    return port_heap_ptr_is_fast(ptr);
+}
+
 void NORETURN nlr_jump_fail(void *val) {
     reset_into_safe_mode(SAFE_MODE_NLR_JUMP_FAIL);
     while (true) {
@@ -11,6 +11,7 @@
 #include "py/mpprint.h"
 #include "py/runtime.h"
 #include "shared-bindings/audiobusio/PDMIn.h"
+#include "shared-bindings/util.h"
 
 
 #include "driver/i2s_pdm.h"
@@ -73,6 +74,11 @@ void common_hal_audiobusio_pdmin_construct(audiobusio_pdmin_obj_t *self,
 
     self->sample_rate = sample_rate;
     self->bit_depth = bit_depth;
+    #if CIRCUITPY_AUDIOBUSIO_PDMIN_CAPTURE
+    self->channel_count = mono ? 1 : 2;
+    self->capture_ring = NULL;
+    self->capture_task = NULL;
+    #endif
 }
 
 bool common_hal_audiobusio_pdmin_deinited(audiobusio_pdmin_obj_t *self) {
@@ -84,6 +90,12 @@ void common_hal_audiobusio_pdmin_deinit(audiobusio_pdmin_obj_t *self) {
         return;
     }
 
+    #if CIRCUITPY_AUDIOBUSIO_PDMIN_CAPTURE
+    if (self->capture_ring != NULL) {
+        audiobusio_pdmin_capture_proto.stop(MP_OBJ_FROM_PTR(self));
+    }
+    #endif
+
     esp_err_t err = i2s_channel_disable(self->rx_chan);
     CHECK_ESP_RESULT(err);
     err = i2s_del_channel(self->rx_chan);
@@ -110,6 +122,11 @@ uint32_t common_hal_audiobusio_pdmin_record_to_buffer(audiobusio_pdmin_obj_t *se
     uint16_t *buffer,
     uint32_t length) {
 //      mp_printf(MP_PYTHON_PRINTER, "Copying bytes to buffer\n");
+    #if CIRCUITPY_AUDIOBUSIO_PDMIN_CAPTURE
+    if (self->capture_ring != NULL) {
+        mp_raise_RuntimeError(MP_ERROR_TEXT("Already running"));
+    }
+    #endif
 
     size_t result = 0;
     size_t elementSize = common_hal_audiobusio_pdmin_get_bit_depth(self) / 8;
@@ -126,4 +143,89 @@ uint32_t common_hal_audiobusio_pdmin_get_sample_rate(audiobusio_pdmin_obj_t *sel
     return self->sample_rate;
 }
 
+#if CIRCUITPY_AUDIOBUSIO_PDMIN_CAPTURE
+// There is no interrupt for a filled block, so a task reads the channel into the
+// ring instead. It runs above the VM so that the ring keeps filling while Python
+// code is busy, and spends most of its time blocked in i2s_channel_read.
+static void audiobusio_pdmin_capture_task(void *arg) {
+    audiobusio_pdmin_obj_t *self = arg;
+    audiocore_capture_ring_t *ring = self->capture_ring;
+    size_t filled = 0;
+    while (!self->capture_stopping) {
+        uint8_t *block = audiocore_capture_ring_block(ring, ring->write_count);
+        size_t result = 0;
+        esp_err_t err = i2s_channel_read(self->rx_chan, block + filled, ring->block_length - filled,
+            &result, pdMS_TO_TICKS(100));
+        if (err != ESP_OK && err != ESP_ERR_TIMEOUT) {
+            vTaskDelay(1);
+            continue;
+        }
+        filled += result;
+        if (filled == ring->block_length) {
+            audiocore_capture_ring_commit(ring);
+            filled = 0;
+        }
+    }
+    xTaskNotifyGive(self->capture_waiter);
+    vTaskDelete(NULL);
+}
+
+static void audiobusio_pdmin_capture_get_format(mp_obj_t self_in, audiosample_base_t *format) {
+    audiobusio_pdmin_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    format->sample_rate = self->sample_rate;
+    format->channel_count = self->channel_count;
+    format->bits_per_sample = 16;
+    format->samples_signed = true;
+}
+
+static void audiobusio_pdmin_capture_start(mp_obj_t self_in, audiocore_capture_ring_t *ring) {
+    audiobusio_pdmin_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    if (common_hal_audiobusio_pdmin_deinited(self)) {
+        raise_deinited_error();
+    }
+    if (self->capture_ring != NULL) {
+        mp_raise_RuntimeError(MP_ERROR_TEXT("Already running"));
+    }
+    if (self->bit_depth != 16) {
+        mp_raise_ValueError_varg(MP_ERROR_TEXT("%q must be %d"), MP_QSTR_bit_depth, 16);
+    }
+    self->capture_ring = ring;
+    self->capture_stopping = false;
+    BaseType_t result = xTaskCreatePinnedToCore(
+        audiobusio_pdmin_capture_task,
+        "pdmin_capture",
+        2 * configMINIMAL_STACK_SIZE,
+        self,
+        uxTaskPriorityGet(NULL) + 1,
+        &self->capture_task,
+        xPortGetCoreID());
+    if (result != pdPASS) {
+        self->capture_ring = NULL;
+        self->capture_task = NULL;
+        mp_raise_RuntimeError(MP_ERROR_TEXT("Failed to start async audio"));
+    }
+}
+
+static void audiobusio_pdmin_capture_stop(mp_obj_t self_in) {
+    audiobusio_pdmin_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    if (self->capture_task == NULL) {
+        return;
+    }
+    // Let the task finish its current read rather than deleting it while it
+    // holds the channel.
+    self->capture_waiter = xTaskGetCurrentTaskHandle();
+    self->capture_stopping = true;
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    self->capture_task = NULL;
+    self->capture_ring = NULL;
+}
+
+const audiocore_capture_source_p_t audiobusio_pdmin_capture_proto = {
+    MP_PROTO_IMPLEMENT(MP_QSTR_protocol_audiocapture)
+    .get_format = audiobusio_pdmin_capture_get_format,
+    .start = audiobusio_pdmin_capture_start,
+    .stop = audiobusio_pdmin_capture_stop,
+};
+#endif
+
 #endif
@@ -11,15 +11,33 @@
 #include "common-hal/audiobusio/__init__.h"
 #include "common-hal/microcontroller/Pin.h"
 
+#if CIRCUITPY_AUDIOBUSIO_PDMIN_CAPTURE
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "shared-module/audiocore/Capture.h"
+#endif
+
 #if CIRCUITPY_AUDIOBUSIO_PDMIN
 
 typedef struct {
+    mp_obj_base_t base;
     i2s_t i2s;
     i2s_chan_handle_t rx_chan;
     const mcu_pin_obj_t *clock_pin;
     const mcu_pin_obj_t *data_pin;
     uint32_t sample_rate;
     uint8_t bit_depth;
+    #if CIRCUITPY_AUDIOBUSIO_PDMIN_CAPTURE
+    uint8_t channel_count;
+    audiocore_capture_ring_t *capture_ring; // non-NULL while capturing for audiocore.Capture
+    TaskHandle_t capture_task; // reads from rx_chan into capture_ring
+    TaskHandle_t capture_waiter; // notified when capture_task has stopped
+    volatile bool capture_stopping;
+    #endif
 } audiobusio_pdmin_obj_t;
 
+#if CIRCUITPY_AUDIOBUSIO_PDMIN_CAPTURE
+extern const audiocore_capture_source_p_t audiobusio_pdmin_capture_proto;
+#endif
+
 #endif
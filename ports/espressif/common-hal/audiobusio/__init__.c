@@ -46,6 +46,7 @@ static void i2s_fill_buffer(i2s_t *self) {
                 audiosample_get_buffer(self->sample, false, 0,
                     &self->sample_data, &sample_buffer_length);
             self->sample_end = self->sample_data + sample_buffer_length;
+            self->sample_silent = audiosample_get_silent(self->sample);
             if (get_buffer_result == GET_BUFFER_DONE) {
                 if (self->loop) {
                     audiosample_reset_buffer(self->sample, false, 0);
@@ -62,35 +63,12 @@ static void i2s_fill_buffer(i2s_t *self) {
         size_t sample_bytecount = self->sample_end - self->sample_data;
         // The framecount is the minimum of space left in the output buffer or left in the incoming sample.
         size_t framecount = MIN(output_buffer_size / bytes_per_output_frame, sample_bytecount / bytes_per_input_frame);
-        if (self->samples_signed && self->channel_count == 2) {
-            if (self->bytes_per_sample == 2) {
-                memcpy(output_buffer, self->sample_data, framecount * bytes_per_output_frame);
-            } else {
-                audiosample_convert_s8s_s16s(output_buffer, ((int8_t *)self->sample_data), framecount);
-            }
+        if (self->sample_silent) {
+            // Output is always signed, so silence is zero whatever the input format
+            memset(output_buffer, 0, framecount * bytes_per_output_frame);
         } else {
-            if (self->samples_signed) {
-                assert(self->channel_count == 1);
-                if (self->bytes_per_sample == 1) {
-                    audiosample_convert_s8m_s16s(output_buffer, (int8_t *)(void *)self->sample_data, framecount);
-                } else {
-                    audiosample_convert_s16m_s16s(output_buffer, (int16_t *)(void *)self->sample_data, framecount);
-                }
-            } else {
-                if (self->channel_count == 1) {
-                    if (self->bytes_per_sample == 1) {
-                        audiosample_convert_u8m_s16s(output_buffer, (uint8_t *)(void *)self->sample_data, framecount);
-                    } else {
-                        audiosample_convert_u16m_s16s(output_buffer, (uint16_t *)(void *)self->sample_data, framecount);
-                    }
-                } else {
-                    if (self->bytes_per_sample == 1) {
-                        audiosample_convert_u8s_s16s(output_buffer, (uint8_t *)(void *)self->sample_data, framecount);
-                    } else {
-                        audiosample_convert_u16s_s16s(output_buffer, (uint16_t *)(void *)self->sample_data, framecount);
-                    }
-                }
-            }
+            audiosample_convert(output_buffer, AUDIOSAMPLE_S16S, self->sample_data,
+                AUDIOSAMPLE_FORMAT(self->bytes_per_sample, self->samples_signed, self->channel_count), framecount);
         }
         self->sample_data += framecount * bytes_per_input_frame;
         output_buffer += framecount * CIRCUITPY_OUTPUT_SLOTS;
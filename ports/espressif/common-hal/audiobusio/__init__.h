@@ -24,6 +24,7 @@ typedef struct {
     int8_t channel_count;
     uint16_t buffer_length;
     uint8_t *sample_data, *sample_end;
+    bool sample_silent; // sample_data is silence
     void *next_buffer;
     size_t next_buffer_size;
     i2s_chan_handle_t handle;
@@ -23,286 +23,33 @@ static dac_continuous_handle_t _active_handle;
 
 #define INCREMENT_BUF_IDX(idx) ((idx + 1) % (NUM_DMA_BUFFERS + 1))
 
-static bool audioout_convert_noop(
+// Convert a buffer from the sample to the DAC's unsigned 8 bit format, into
+// out_buffer when that is big enough. Returns whether a new out_buffer had to
+// be allocated.
+static bool audioout_convert(audioio_audioout_obj_t *self,
     void *in_buffer,
     size_t in_buffer_size,
     uint8_t **out_buffer,
     uint32_t *out_buffer_size) {
 
-    *out_buffer = in_buffer;
-    *out_buffer_size = in_buffer_size;
-    return false;
-}
-
-static bool audioout_convert_u8s_u8m(
-    void *in_buffer,
-    size_t in_buffer_size,
-    uint8_t **out_buffer,
-    uint32_t *out_buffer_size) {
-
-    bool buffer_changed = false;
-    if (in_buffer_size / 2 > *out_buffer_size) {
-        *out_buffer = m_malloc(in_buffer_size / 2);
-        buffer_changed = true;
-    }
-    audiosample_convert_u8s_u8m(*out_buffer, (uint8_t *)in_buffer, in_buffer_size / 2);
-    *out_buffer_size = in_buffer_size / 2;
-    return buffer_changed;
-}
-
-static bool audioout_convert_u8m_u8s(
-    void *in_buffer,
-    size_t in_buffer_size,
-    uint8_t **out_buffer,
-    uint32_t *out_buffer_size) {
-
-    bool buffer_changed = false;
-    if (in_buffer_size * 2 > *out_buffer_size) {
-        *out_buffer = m_malloc(in_buffer_size * 2);
-        buffer_changed = true;
-    }
-    audiosample_convert_u8m_u8s(*out_buffer, (uint8_t *)in_buffer, in_buffer_size);
-    *out_buffer_size = in_buffer_size * 2;
-    return buffer_changed;
-}
-
-static bool audioout_convert_s8m_u8m(
-    void *in_buffer,
-    size_t in_buffer_size,
-    uint8_t **out_buffer,
-    uint32_t *out_buffer_size) {
-
-    bool buffer_changed = false;
-    if (in_buffer_size > *out_buffer_size) {
-        *out_buffer = m_malloc(in_buffer_size);
-        buffer_changed = true;
-    }
-    audiosample_convert_s8m_u8m(*out_buffer, (int8_t *)in_buffer, in_buffer_size);
-    *out_buffer_size = in_buffer_size;
-    return buffer_changed;
-}
-
-static bool audioout_convert_s8s_u8m(
-    void *in_buffer,
-    size_t in_buffer_size,
-    uint8_t **out_buffer,
-    uint32_t *out_buffer_size) {
-
-    bool buffer_changed = false;
-    if (in_buffer_size / 2 > *out_buffer_size) {
-        *out_buffer = m_malloc(in_buffer_size / 2);
-        buffer_changed = true;
-    }
-    audiosample_convert_s8s_u8m(*out_buffer, (int8_t *)in_buffer, in_buffer_size / 2);
-    *out_buffer_size = in_buffer_size / 2;
-    return buffer_changed;
-}
-
-static bool audioout_convert_s8m_u8s(
-    void *in_buffer,
-    size_t in_buffer_size,
-    uint8_t **out_buffer,
-    uint32_t *out_buffer_size) {
-
-    bool buffer_changed = false;
-    if (in_buffer_size * 2 > *out_buffer_size) {
-        *out_buffer = m_malloc(in_buffer_size * 2);
-        buffer_changed = true;
-    }
-    audiosample_convert_s8m_u8s(*out_buffer, (int8_t *)in_buffer, in_buffer_size);
-    *out_buffer_size = in_buffer_size * 2;
-    return buffer_changed;
-}
-
-static bool audioout_convert_s8s_u8s(
-    void *in_buffer,
-    size_t in_buffer_size,
-    uint8_t **out_buffer,
-    uint32_t *out_buffer_size) {
-
-    bool buffer_changed = false;
-    if (in_buffer_size > *out_buffer_size) {
-        *out_buffer = m_malloc(in_buffer_size);
-        buffer_changed = true;
-    }
-    audiosample_convert_s8s_u8s(*out_buffer, (int8_t *)in_buffer, in_buffer_size);
-    *out_buffer_size = in_buffer_size;
-    return buffer_changed;
-}
-
-static bool audioout_convert_u16m_u8m(
-    void *in_buffer,
-    size_t in_buffer_size,
-    uint8_t **out_buffer,
-    uint32_t *out_buffer_size) {
-
-    bool buffer_changed = false;
-    if (in_buffer_size / 2 > *out_buffer_size) {
-        *out_buffer = m_malloc(in_buffer_size / 2);
-        buffer_changed = true;
-    }
-    audiosample_convert_u16m_u8m(*out_buffer, (uint16_t *)in_buffer, in_buffer_size / 2);
-    *out_buffer_size = in_buffer_size / 2;
-    return buffer_changed;
-}
-
-static bool audioout_convert_u16m_u8s(
-    void *in_buffer,
-    size_t in_buffer_size,
-    uint8_t **out_buffer,
-    uint32_t *out_buffer_size) {
-
-    bool buffer_changed = false;
-    if (in_buffer_size > *out_buffer_size) {
-        *out_buffer = m_malloc(in_buffer_size);
-        buffer_changed = true;
-    }
-    audiosample_convert_u16m_u8s(*out_buffer, (uint16_t *)in_buffer, in_buffer_size / 2);
-    *out_buffer_size = in_buffer_size;
-    return buffer_changed;
-}
-
-static bool audioout_convert_u16s_u8m(
-    void *in_buffer,
-    size_t in_buffer_size,
-    uint8_t **out_buffer,
-    uint32_t *out_buffer_size) {
-
-    bool buffer_changed = false;
-    if (in_buffer_size / 4 > *out_buffer_size) {
-        *out_buffer = m_malloc(in_buffer_size / 4);
-        buffer_changed = true;
-    }
-    audiosample_convert_u16s_u8m(*out_buffer, (uint16_t *)in_buffer, in_buffer_size / 4);
-    *out_buffer_size = in_buffer_size / 4;
-    return buffer_changed;
-}
-
-static bool audioout_convert_u16s_u8s(
-    void *in_buffer,
-    size_t in_buffer_size,
-    uint8_t **out_buffer,
-    uint32_t *out_buffer_size) {
-
-    bool buffer_changed = false;
-    if (in_buffer_size / 2 > *out_buffer_size) {
-        *out_buffer = m_malloc(in_buffer_size / 2);
-        buffer_changed = true;
-    }
-    audiosample_convert_u16s_u8s(*out_buffer, (uint16_t *)in_buffer, in_buffer_size / 4);
-    *out_buffer_size = in_buffer_size / 2;
-    return buffer_changed;
-}
-
-static bool audioout_convert_s16m_u8m(
-    void *in_buffer,
-    size_t in_buffer_size,
-    uint8_t **out_buffer,
-    uint32_t *out_buffer_size) {
-
-    bool buffer_changed = false;
-    if (in_buffer_size / 2 > *out_buffer_size) {
-        *out_buffer = m_malloc(in_buffer_size / 2);
-        buffer_changed = true;
-    }
-    audiosample_convert_s16m_u8m(*out_buffer, (int16_t *)in_buffer, in_buffer_size / 2);
-    *out_buffer_size = in_buffer_size / 2;
-    return buffer_changed;
-}
-
-static bool audioout_convert_s16m_u8s(
-    void *in_buffer,
-    size_t in_buffer_size,
-    uint8_t **out_buffer,
-    uint32_t *out_buffer_size) {
-
-    bool buffer_changed = false;
-    if (in_buffer_size > *out_buffer_size) {
-        *out_buffer = m_malloc(in_buffer_size);
-        buffer_changed = true;
-    }
-    audiosample_convert_s16m_u8s(*out_buffer, (int16_t *)in_buffer, in_buffer_size / 2);
-    *out_buffer_size = in_buffer_size;
-    return buffer_changed;
-}
-
-static bool audioout_convert_s16s_u8m(
-    void *in_buffer,
-    size_t in_buffer_size,
-    uint8_t **out_buffer,
-    uint32_t *out_buffer_size) {
-
-    bool buffer_changed = false;
-    if (in_buffer_size / 4 > *out_buffer_size) {
-        *out_buffer = m_malloc(in_buffer_size / 4);
-        buffer_changed = true;
+    if (self->in_format == self->out_format) {
+        *out_buffer = in_buffer;
+        *out_buffer_size = in_buffer_size;
+        return false;
     }
-    audiosample_convert_s16s_u8m(*out_buffer, (int16_t *)in_buffer, in_buffer_size / 4);
-    *out_buffer_size = in_buffer_size / 4;
-    return buffer_changed;
-}
-
-static bool audioout_convert_s16s_u8s(
-    void *in_buffer,
-    size_t in_buffer_size,
-    uint8_t **out_buffer,
-    uint32_t *out_buffer_size) {
 
+    size_t nframes = in_buffer_size / audiosample_format_frame_bytes(self->in_format);
+    size_t size = nframes * audiosample_format_frame_bytes(self->out_format);
     bool buffer_changed = false;
-    if (in_buffer_size / 2 > *out_buffer_size) {
-        *out_buffer = m_malloc(in_buffer_size / 2);
+    if (size > *out_buffer_size) {
+        *out_buffer = m_malloc(size);
         buffer_changed = true;
     }
-    audiosample_convert_s16s_u8s(*out_buffer, (int16_t *)in_buffer, in_buffer_size / 4);
-    *out_buffer_size = in_buffer_size / 2;
+    audiosample_convert(*out_buffer, self->out_format, in_buffer, self->in_format, nframes);
+    *out_buffer_size = size;
     return buffer_changed;
 }
 
-#define CONV_MATCH(bps, sign, ichans, ochans) ((bps & 0xf) | ((sign & 0x1) << 4) | ((ichans & 0x3) << 5) | ((ochans & 0x3) << 7))
-
-static audioout_sample_convert_func_t audioout_get_samples_convert_func(
-    size_t in_bits_per_sample,
-    int in_channels,
-    bool in_signed,
-    int out_channels) {
-
-    switch CONV_MATCH(in_bits_per_sample, in_signed, in_channels, out_channels) {
-        case CONV_MATCH(8, false, 1, 1):
-        case CONV_MATCH(8, false, 2, 2):
-            return audioout_convert_noop;
-        case CONV_MATCH(8, false, 2, 1):
-            return audioout_convert_u8s_u8m;
-        case CONV_MATCH(8, false, 1, 2):
-            return audioout_convert_u8m_u8s;
-        case CONV_MATCH(8, true, 1, 1):
-            return audioout_convert_s8m_u8m;
-        case CONV_MATCH(8, true, 2, 1):
-            return audioout_convert_s8s_u8m;
-        case CONV_MATCH(8, true, 1, 2):
-            return audioout_convert_s8m_u8s;
-        case CONV_MATCH(8, true, 2, 2):
-            return audioout_convert_s8s_u8s;
-        case CONV_MATCH(16, false, 1, 1):
-            return audioout_convert_u16m_u8m;
-        case CONV_MATCH(16, false, 1, 2):
-            return audioout_convert_u16m_u8s;
-        case CONV_MATCH(16, false, 2, 1):
-            return audioout_convert_u16s_u8m;
-        case CONV_MATCH(16, false, 2, 2):
-            return audioout_convert_u16s_u8s;
-        case CONV_MATCH(16, true, 1, 1):
-            return audioout_convert_s16m_u8m;
-        case CONV_MATCH(16, true, 1, 2):
-            return audioout_convert_s16m_u8s;
-        case CONV_MATCH(16, true, 2, 1):
-            return audioout_convert_s16s_u8m;
-        case CONV_MATCH(16, true, 2, 2):
-            return audioout_convert_s16s_u8s;
-        default:
-            mp_raise_RuntimeError(MP_ERROR_TEXT("audio format not supported"));
-    }
-}
-
 static void audioio_audioout_start(audioio_audioout_obj_t *self) {
     esp_err_t ret;
 
@@ -372,7 +119,7 @@ static bool audioout_fill_buffer(audioio_audioout_obj_t *self) {
         }
 
         bool buffer_changed;
-        buffer_changed = self->samples_convert(
+        buffer_changed = audioout_convert(self,
             raw_sample_buf,
             raw_sample_buf_size,
             &sample_buf,
@@ -603,11 +350,11 @@ void common_hal_audioio_audioout_play(audioio_audioout_obj_t *self,
         &_single_buffer, &samples_signed,
         &_max_buffer_length, &_spacing);
 
-    self->samples_convert = audioout_get_samples_convert_func(
-        samples_size,
-        channel_count,
-        samples_signed,
-        self->num_channels);
+    if ((samples_size != 8 && samples_size != 16) || channel_count > 2) {
+        mp_raise_RuntimeError(MP_ERROR_TEXT("audio format not supported"));
+    }
+    self->in_format = AUDIOSAMPLE_FORMAT(samples_size / 8, samples_signed, channel_count);
+    self->out_format = AUDIOSAMPLE_FORMAT(1, false, self->num_channels);
 
     audioio_audioout_start(self);
 }
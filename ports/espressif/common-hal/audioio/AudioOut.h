@@ -16,8 +16,6 @@
 
 #define DEFAULT_SAMPLE_RATE 32000
 
-typedef bool (*audioout_sample_convert_func_t)(void *in_buffer, size_t in_buffer_size, uint8_t **out_buffer, uint32_t *out_buffer_size);
-
 typedef struct {
     uint8_t *ptr;
     size_t size;
@@ -43,5 +41,6 @@ typedef struct {
     background_callback_t callback;
     uint8_t *scratch_buffer;
     size_t scratch_buffer_size;
-    audioout_sample_convert_func_t samples_convert;
+    audiosample_format_t in_format;
+    audiosample_format_t out_format;
 } audioio_audioout_obj_t;
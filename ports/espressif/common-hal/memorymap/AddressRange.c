@@ -11,6 +11,8 @@
 #include "py/runtime.h"
 #include "soc/soc.h"
 
+#include "esp_partition.h"
+
 size_t allow_ranges[][2] = {
     // ULP accessible RAM
     {SOC_RTC_DATA_LOW, SOC_RTC_DATA_HIGH},
@@ -20,7 +22,93 @@ size_t allow_ranges[][2] = {
     {0x60008000, 0x60009000}
 };
 
+// Flash mappings handed out to AddressRanges. They are released on reset because
+// AddressRange objects have no finaliser. The MMU has few pages to spare, so
+// the number of mappings is kept small and an existing one is reused when it
+// already covers the requested range.
+#define MAX_FLASH_MAPPINGS (4)
+
+typedef struct {
+    size_t flash_start;
+    size_t flash_end;
+    const uint8_t *ptr;
+    esp_partition_mmap_handle_t handle;
+    bool in_use;
+} flash_mapping_t;
+
+static flash_mapping_t flash_mappings[MAX_FLASH_MAPPINGS];
+
+void memorymap_reset(void) {
+    for (size_t i = 0; i < MAX_FLASH_MAPPINGS; i++) {
+        if (flash_mappings[i].in_use) {
+            esp_partition_munmap(flash_mappings[i].handle);
+            flash_mappings[i].in_use = false;
+        }
+    }
+}
+
+// Map a range of flash, given as offsets from the start of flash, read-only
+// into the data bus. Only ranges inside a single data partition are allowed.
+// Returns NULL if the range isn't inside one.
+static const uint8_t *map_flash(size_t start, size_t length) {
+    size_t end = start + length;
+    for (size_t i = 0; i < MAX_FLASH_MAPPINGS; i++) {
+        flash_mapping_t *m = &flash_mappings[i];
+        if (m->in_use && m->flash_start <= start && end <= m->flash_end) {
+            return m->ptr + (start - m->flash_start);
+        }
+    }
+
+    const esp_partition_t *partition = NULL;
+    esp_partition_iterator_t it = esp_partition_find(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, NULL);
+    for (; it != NULL; it = esp_partition_next(it)) {
+        const esp_partition_t *p = esp_partition_get(it);
+        if (p->address <= start && end <= p->address + p->size) {
+            partition = p;
+            break;
+        }
+    }
+    esp_partition_iterator_release(it);
+    if (partition == NULL) {
+        return NULL;
+    }
+
+    flash_mapping_t *m = NULL;
+    for (size_t i = 0; i < MAX_FLASH_MAPPINGS; i++) {
+        if (!flash_mappings[i].in_use) {
+            m = &flash_mappings[i];
+            break;
+        }
+    }
+    if (m == NULL) {
+        mp_raise_RuntimeError(MP_ERROR_TEXT("Too many flash mappings"));
+    }
+
+    const void *ptr;
+    if (esp_partition_mmap(partition, start - partition->address, length,
+        ESP_PARTITION_MMAP_DATA, &ptr, &m->handle) != ESP_OK) {
+        mp_raise_RuntimeError(MP_ERROR_TEXT("Unable to map flash"));
+    }
+    m->flash_start = start;
+    m->flash_end = end;
+    m->ptr = ptr;
+    m->in_use = true;
+    return ptr;
+}
+
 void common_hal_memorymap_addressrange_construct(memorymap_addressrange_obj_t *self, uint8_t *start_address, size_t length) {
+    // Addresses below the data bus are offsets into flash.
+    if ((size_t)start_address < SOC_DROM_LOW) {
+        const uint8_t *mapped = map_flash((size_t)start_address, length);
+        if (mapped == NULL) {
+            mp_raise_ValueError(MP_ERROR_TEXT("Address range not allowed"));
+        }
+        self->start_address = (uint8_t *)mapped;
+        self->len = length;
+        self->flash = true;
+        return;
+    }
+
     bool allowed = false;
     for (size_t i = 0; i < MP_ARRAY_SIZE(allow_ranges); i++) {
         uint8_t *allowed_start = (uint8_t *)allow_ranges[i][0];
@@ -38,14 +126,26 @@ void common_hal_memorymap_addressrange_construct(memorymap_addressrange_obj_t *s
 
     self->start_address = start_address;
     self->len = length;
+    self->flash = false;
 }
 
 size_t common_hal_memorymap_addressrange_get_length(const memorymap_addressrange_obj_t *self) {
     return self->len;
 }
 
+bool common_hal_memorymap_addressrange_is_memory(const memorymap_addressrange_obj_t *self, bool writable) {
+    if (self->flash) {
+        return !writable;
+    }
+    // Everything allowed other than the RTC peripheral registers is RTC RAM
+    return (size_t)self->start_address < 0x60008000 || (size_t)self->start_address >= 0x60009000;
+}
+
 void common_hal_memorymap_addressrange_set_bytes(const memorymap_addressrange_obj_t *self,
     size_t start_index, uint8_t *values, size_t len) {
+    if (self->flash) {
+        mp_raise_ValueError(MP_ERROR_TEXT("Read-only"));
+    }
     uint8_t *address = self->start_address + start_index;
     #pragma GCC diagnostic push
     #pragma GCC diagnostic ignored "-Wcast-align"
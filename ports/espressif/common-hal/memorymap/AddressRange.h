@@ -12,4 +12,8 @@ typedef struct {
     mp_obj_base_t base;
     uint8_t *start_address;
     size_t len;
+    // True when the range is flash mapped read-only by esp_partition_mmap().
+    bool flash;
 } memorymap_addressrange_obj_t;
+
+void memorymap_reset(void);
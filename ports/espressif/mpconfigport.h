@@ -60,6 +60,25 @@ extern portMUX_TYPE background_task_mutex;
 #define CALLBACK_CRITICAL_BEGIN (taskENTER_CRITICAL(&background_task_mutex))
 #define CALLBACK_CRITICAL_END (taskEXIT_CRITICAL(&background_task_mutex))
 
+// On the ESP32-S3, a board may define MICROPY_GC_PARALLEL_MARK to (1) in
+// mpconfigboard.h to have the core that CircuitPython isn't running on help
+// mark during collections. It is off by default until it has been measured on
+// hardware. MICROPY_GC_MARK_HISTOGRAM can be turned on the same way to measure
+// it.
+#if defined(CONFIG_IDF_TARGET_ESP32S3) && !(defined(CONFIG_FREERTOS_UNICORE) && CONFIG_FREERTOS_UNICORE)
+#ifndef MICROPY_GC_PARALLEL_MARK
+#define MICROPY_GC_PARALLEL_MARK (0)
+#endif
+#elif defined(MICROPY_GC_PARALLEL_MARK) && MICROPY_GC_PARALLEL_MARK
+#error "MICROPY_GC_PARALLEL_MARK needs a second core"
+#endif
+
+// Filter synthio notes through the shared bank buffer. The ESP32-S3's PIE
+// vector unit isn't used, so the bank filters the notes one at a time.
+#ifndef SYNTHIO_FILTER_BANK
+#define SYNTHIO_FILTER_BANK (1)
+#endif
+
 // 20 dBm is the default and the highest max tx power.
 // Allow a different value to be specified for boards that have trouble with using the maximum power.
 #ifndef CIRCUITPY_WIFI_DEFAULT_TX_POWER
@@ -51,6 +51,8 @@ CIRCUITPY_ALARM_TOUCH ?= 0
 CIRCUITPY_ANALOGBUFIO ?= 1
 CIRCUITPY_AUDIOBUSIO ?= 1
 CIRCUITPY_AUDIOBUSIO_PDMIN ?= 0
+# audiocore.Capture from audiobusio.PDMIn
+CIRCUITPY_AUDIOBUSIO_PDMIN_CAPTURE ?= $(CIRCUITPY_AUDIOBUSIO_PDMIN)
 CIRCUITPY_AUDIOIO ?= 0
 CIRCUITPY_BLEIO_HCI = 0
 CIRCUITPY_CANIO ?= 1
@@ -13,11 +13,14 @@
 #include "supervisor/filesystem.h"
 #include "supervisor/shared/reload.h"
 #include "supervisor/shared/serial.h"
+#include "py/gc.h"
 #include "py/mpprint.h"
 #include "py/runtime.h"
 
 #include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
 #include "freertos/task.h"
+#include "esp_memory_utils.h"
 
 #include "bindings/espidf/__init__.h"
 #include "bindings/espnow/__init__.h"
@@ -27,6 +30,7 @@
 #include "common-hal/busio/SPI.h"
 #include "common-hal/busio/UART.h"
 #include "common-hal/dualbank/__init__.h"
+#include "common-hal/memorymap/AddressRange.h"
 #include "common-hal/ps2io/Ps2.h"
 #include "common-hal/watchdog/WatchDogTimer.h"
 #include "common-hal/socketpool/Socket.h"
@@ -332,11 +336,62 @@ void *port_realloc(void *ptr, size_t size, bool dma_capable) {
     return heap_caps_realloc(ptr, size, caps);
 }
 
+bool port_heap_ptr_is_fast(const void *ptr) {
+    return esp_ptr_internal(ptr);
+}
+
 size_t port_heap_get_largest_free_size(void) {
     size_t free_size = heap_caps_get_largest_free_block(MALLOC_CAP_8BIT);
     return free_size;
 }
 
+#if MICROPY_GC_PARALLEL_MARK
+// A task on the other core helps mark during collections. It is started on
+// first use and then waits for the next collection.
+//
+// The mark stacks are in MP_STATE_MEM, not on this task's stack. The task
+// only needs room for the calls from gc_mark_helper down to gc_mark_push,
+// which don't recurse, so their depth doesn't grow with the heap or with
+// MICROPY_ALLOC_GC_STACK_SIZE. Twice the minimum leaves room for those frames
+// and for the interrupt frames saved on top of them, as for socket_select.
+// The stack is static, so the task can't fail to start for lack of heap.
+#define GC_MARK_TASK_STACK_SIZE (2 * configMINIMAL_STACK_SIZE)
+static StackType_t gc_mark_task_stack[GC_MARK_TASK_STACK_SIZE];
+static StaticTask_t gc_mark_task_buffer;
+static TaskHandle_t gc_mark_task_handle;
+static StaticSemaphore_t gc_mark_done_buffer;
+static SemaphoreHandle_t gc_mark_done;
+
+static void gc_mark_task(void *arg) {
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        gc_mark_helper(1);
+        xSemaphoreGive(gc_mark_done);
+    }
+}
+
+size_t gc_mark_helpers_start(size_t n_helpers) {
+    if (n_helpers == 0) {
+        return 0;
+    }
+    if (gc_mark_task_handle == NULL) {
+        gc_mark_done = xSemaphoreCreateBinaryStatic(&gc_mark_done_buffer);
+        gc_mark_task_handle = xTaskCreateStaticPinnedToCore(gc_mark_task, "gc_mark",
+            GC_MARK_TASK_STACK_SIZE, NULL, uxTaskPriorityGet(NULL),
+            gc_mark_task_stack, &gc_mark_task_buffer, xPortGetCoreID() ^ 1);
+        if (gc_mark_task_handle == NULL) {
+            return 0;
+        }
+    }
+    xTaskNotifyGive(gc_mark_task_handle);
+    return 1;
+}
+
+void gc_mark_helpers_wait(void) {
+    xSemaphoreTake(gc_mark_done, portMAX_DELAY);
+}
+#endif
+
 void reset_port(void) {
     // TODO deinit for esp32-camera
     #if CIRCUITPY_ESPCAMERA
@@ -370,6 +425,10 @@ void reset_port(void) {
     espnow_reset();
     #endif
 
+    #if CIRCUITPY_MEMORYMAP
+    memorymap_reset();
+    #endif
+
     #if CIRCUITPY_ESPULP
     espulp_reset();
     #endif
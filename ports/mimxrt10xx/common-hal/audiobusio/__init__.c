@@ -214,43 +214,8 @@ static void i2s_fill_buffer(i2s_t *self) {
             size_t bytes_per_input_frame = self->channel_count * self->bytes_per_sample;
             size_t framecount = MIN((size_t)(end - ptr), input_bytecount / bytes_per_input_frame);
 
-#define SAMPLE_TYPE(is_signed, channel_count, bytes_per_sample) ((is_signed) | ((channel_count) << 1) | ((bytes_per_sample) << 3))
-
-            switch (SAMPLE_TYPE(self->samples_signed, self->channel_count, self->bytes_per_sample)) {
-
-                case SAMPLE_TYPE(true, 2, 2):
-                    memcpy(ptr, self->sample_data, 4 * framecount);
-                    break;
-
-                case SAMPLE_TYPE(false, 2, 2):
-                    audiosample_convert_u16s_s16s((int16_t *)ptr, (uint16_t *)(void *)self->sample_data, framecount);
-                    break;
-
-                case SAMPLE_TYPE(true, 1, 2):
-                    audiosample_convert_s16m_s16s((int16_t *)ptr, (int16_t *)(void *)self->sample_data, framecount);
-                    break;
-
-                case SAMPLE_TYPE(false, 1, 2):
-                    audiosample_convert_u16m_s16s((int16_t *)ptr, (uint16_t *)(void *)self->sample_data, framecount);
-                    break;
-
-                case SAMPLE_TYPE(true, 2, 1):
-                    audiosample_convert_s8s_s16s((int16_t *)ptr, (int8_t *)(void *)self->sample_data, framecount);
-                    memcpy(ptr, self->sample_data, 4 * framecount);
-                    break;
-
-                case SAMPLE_TYPE(false, 2, 1):
-                    audiosample_convert_u8s_s16s((int16_t *)ptr, (uint8_t *)(void *)self->sample_data, framecount);
-                    break;
-
-                case SAMPLE_TYPE(true, 1, 1):
-                    audiosample_convert_s8m_s16s((int16_t *)ptr, (int8_t *)(void *)self->sample_data, framecount);
-                    break;
-
-                case SAMPLE_TYPE(false, 1, 1):
-                    audiosample_convert_u8m_s16s((int16_t *)ptr, (uint8_t *)(void *)self->sample_data, framecount);
-                    break;
-            }
+            audiosample_convert(ptr, AUDIOSAMPLE_S16S, self->sample_data,
+                AUDIOSAMPLE_FORMAT(self->bytes_per_sample, self->samples_signed, self->channel_count), framecount);
             self->sample_data += bytes_per_input_frame * framecount; // in bytes
             ptr += framecount; // in frames
         }
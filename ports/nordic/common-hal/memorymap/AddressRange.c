@@ -74,6 +74,12 @@ size_t common_hal_memorymap_addressrange_get_length(const memorymap_addressrange
     return self->len;
 }
 
+bool common_hal_memorymap_addressrange_is_memory(const memorymap_addressrange_obj_t *self, bool writable) {
+    // Flash and FICR/UICR can only be read in place; peripherals not at all
+    size_t start = (size_t)self->start_address;
+    return start < 0x40000000 && (!writable || start >= 0x20000000);
+}
+
 
 void common_hal_memorymap_addressrange_set_bytes(const memorymap_addressrange_obj_t *self,
     size_t start_index, uint8_t *values, size_t len) {
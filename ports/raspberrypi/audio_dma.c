@@ -10,6 +10,7 @@
 #include "shared-bindings/audiocore/WaveFile.h"
 #include "shared-bindings/microcontroller/__init__.h"
 #include "bindings/rp2pio/StateMachine.h"
+#include "common-hal/analogbufio/BufferedIn.h"
 #include "supervisor/background_callback.h"
 
 #include "py/mpstate.h"
@@ -547,6 +548,12 @@ void __not_in_flash_func(isr_dma_0)(void) {
             rp2pio_statemachine_obj_t *pio = MP_STATE_PORT(background_pio_write)[i];
             rp2pio_statemachine_dma_complete_write(pio, i);
         }
+        #if CIRCUITPY_ANALOGBUFIO_CAPTURE
+        if (MP_STATE_PORT(background_capture)[i] != NULL) {
+            analogbufio_bufferedin_obj_t *adc = MP_STATE_PORT(background_capture)[i];
+            analogbufio_bufferedin_dma_complete(adc, i);
+        }
+        #endif
     }
 }
 
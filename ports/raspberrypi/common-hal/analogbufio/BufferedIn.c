@@ -8,11 +8,15 @@
 #include <stdio.h>
 #include "common-hal/analogbufio/BufferedIn.h"
 #include "shared-bindings/analogbufio/BufferedIn.h"
+#include "shared-bindings/microcontroller/__init__.h"
 #include "shared-bindings/microcontroller/Pin.h"
+#include "shared-bindings/util.h"
 #include "shared/runtime/interrupt_char.h"
+#include "py/mpstate.h"
 #include "py/runtime.h"
 #include "hardware/adc.h"
 #include "hardware/dma.h"
+#include "hardware/irq.h"
 #include "pico/stdlib.h"
 
 #define ADC_CLOCK_INPUT 48000000
@@ -62,6 +66,10 @@ void common_hal_analogbufio_bufferedin_construct(analogbufio_bufferedin_obj_t *s
     // So subtract 1. See PR #9396.
     float clk_div = (float)ADC_CLOCK_INPUT / (float)sample_rate - 1;
     adc_set_clkdiv(clk_div);
+    #if CIRCUITPY_ANALOGBUFIO_CAPTURE
+    self->sample_rate = sample_rate;
+    self->capture_ring = NULL;
+    #endif
 
     self->dma_chan[0] = dma_claim_unused_channel(true);
     self->dma_chan[1] = dma_claim_unused_channel(true);
@@ -99,6 +107,10 @@ void common_hal_analogbufio_bufferedin_construct(analogbufio_bufferedin_obj_t *s
     adc_run(false);
 }
 
+#if CIRCUITPY_ANALOGBUFIO_CAPTURE
+static void analogbufio_bufferedin_capture_stop(mp_obj_t self_in);
+#endif
+
 bool common_hal_analogbufio_bufferedin_deinited(analogbufio_bufferedin_obj_t *self) {
     return self->pin == NULL;
 }
@@ -108,6 +120,10 @@ void common_hal_analogbufio_bufferedin_deinit(analogbufio_bufferedin_obj_t *self
         return;
     }
 
+    #if CIRCUITPY_ANALOGBUFIO_CAPTURE
+    analogbufio_bufferedin_capture_stop(self);
+    #endif
+
     // stop DMA
     dma_channel_abort(self->dma_chan[0]);
     dma_channel_abort(self->dma_chan[1]);
@@ -132,6 +148,12 @@ uint32_t common_hal_analogbufio_bufferedin_readinto(analogbufio_bufferedin_obj_t
     // samples at the first sample with the error bit set.
     // Number of transfers is always the number of samples which is the array
     // byte length divided by the bytes_per_sample.
+    #if CIRCUITPY_ANALOGBUFIO_CAPTURE
+    if (self->capture_ring != NULL) {
+        mp_raise_RuntimeError(MP_ERROR_TEXT("Already running"));
+    }
+    #endif
+
     uint dma_size = DMA_SIZE_8;
     bool show_error_bit = false;
     if (bytes_per_sample == 2) {
@@ -223,3 +245,117 @@ uint32_t common_hal_analogbufio_bufferedin_readinto(analogbufio_bufferedin_obj_t
 
     }
 }
+
+#if CIRCUITPY_ANALOGBUFIO_CAPTURE
+// Capturing for audiocore.Capture. The two DMA channels take turns filling the
+// blocks of the ring, each chaining to the other when it is done, so the ADC
+// is never left without somewhere to put its samples. When a channel finishes,
+// its interrupt commits the block and points the channel at the block after the
+// one the other channel is now filling.
+
+static void analogbufio_bufferedin_capture_get_format(mp_obj_t self_in, audiosample_base_t *format) {
+    analogbufio_bufferedin_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    format->sample_rate = self->sample_rate;
+    format->channel_count = 1;
+    format->bits_per_sample = 16;
+    format->samples_signed = false;
+}
+
+static void analogbufio_bufferedin_capture_start(mp_obj_t self_in, audiocore_capture_ring_t *ring) {
+    analogbufio_bufferedin_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    if (common_hal_analogbufio_bufferedin_deinited(self)) {
+        raise_deinited_error();
+    }
+    if (self->capture_ring != NULL || dma_channel_is_busy(self->dma_chan[0])) {
+        mp_raise_RuntimeError(MP_ERROR_TEXT("Already running"));
+    }
+
+    // Plain 12 bit values; they are scaled to 16 bits by finish_block
+    adc_fifo_setup(true, true, 1, false, false);
+    adc_fifo_drain();
+
+    uint32_t sample_count = ring->block_length / sizeof(uint16_t);
+    for (size_t i = 0; i < 2; i++) {
+        // Don't touch cfg, which readinto() relies on
+        dma_channel_config c = dma_channel_get_default_config(self->dma_chan[i]);
+        channel_config_set_transfer_data_size(&c, DMA_SIZE_16);
+        channel_config_set_read_increment(&c, false);
+        channel_config_set_write_increment(&c, true);
+        channel_config_set_dreq(&c, DREQ_ADC);
+        channel_config_set_chain_to(&c, self->dma_chan[1 - i]);
+        dma_channel_configure(self->dma_chan[i], &c,
+            audiocore_capture_ring_block(ring, ring->write_count + i), // dst
+            &adc_hw->fifo,  // src
+            sample_count,   // transfer count
+            false           // don't start yet
+            );
+    }
+
+    uint32_t channel_mask = (1u << self->dma_chan[0]) | (1u << self->dma_chan[1]);
+    common_hal_mcu_disable_interrupts();
+    self->capture_ring = ring;
+    // Acknowledge any previous pending interrupt
+    dma_hw->ints0 = channel_mask;
+    MP_STATE_PORT(background_capture)[self->dma_chan[0]] = self;
+    MP_STATE_PORT(background_capture)[self->dma_chan[1]] = self;
+    dma_hw->inte0 |= channel_mask;
+    irq_set_mask_enabled(1 << DMA_IRQ_0, true);
+    dma_channel_start(self->dma_chan[0]);
+    common_hal_mcu_enable_interrupts();
+
+    adc_run(true);
+}
+
+static void analogbufio_bufferedin_capture_stop(mp_obj_t self_in) {
+    analogbufio_bufferedin_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    if (self->capture_ring == NULL) {
+        return;
+    }
+    uint32_t channel_mask = (1u << self->dma_chan[0]) | (1u << self->dma_chan[1]);
+    dma_hw->inte0 &= ~channel_mask;
+    if (!dma_hw->inte0) {
+        irq_set_mask_enabled(1 << DMA_IRQ_0, false);
+    }
+    MP_STATE_PORT(background_capture)[self->dma_chan[0]] = NULL;
+    MP_STATE_PORT(background_capture)[self->dma_chan[1]] = NULL;
+
+    adc_run(false);
+    // The first channel may have been chained to while the second was aborted
+    dma_channel_abort(self->dma_chan[0]);
+    dma_channel_abort(self->dma_chan[1]);
+    dma_channel_abort(self->dma_chan[0]);
+    adc_fifo_drain();
+    self->capture_ring = NULL;
+}
+
+static void analogbufio_bufferedin_capture_finish_block(mp_obj_t self_in, uint8_t *block, uint32_t length) {
+    uint16_t *samples = (uint16_t *)block;
+    for (uint32_t i = 0; i < length / sizeof(uint16_t); i++) {
+        uint16_t value = samples[i] & 0xfff;
+        samples[i] = (value << 4) | (value >> 8);
+    }
+}
+
+// Called from isr_dma_0 when one of our channels has filled its block
+void __not_in_flash_func(analogbufio_bufferedin_dma_complete)(analogbufio_bufferedin_obj_t *self, uint channel) {
+    audiocore_capture_ring_t *ring = self->capture_ring;
+    if (ring == NULL) {
+        return;
+    }
+    audiocore_capture_ring_commit(ring);
+    // The other channel is now filling block write_count, so this one is next
+    // after it. It starts when the other one chains to it.
+    dma_channel_set_write_addr(channel, audiocore_capture_ring_block(ring, ring->write_count + 1), false);
+    dma_channel_set_trans_count(channel, ring->block_length / sizeof(uint16_t), false);
+}
+
+const audiocore_capture_source_p_t analogbufio_bufferedin_capture_proto = {
+    MP_PROTO_IMPLEMENT(MP_QSTR_protocol_audiocapture)
+    .get_format = analogbufio_bufferedin_capture_get_format,
+    .start = analogbufio_bufferedin_capture_start,
+    .stop = analogbufio_bufferedin_capture_stop,
+    .finish_block = analogbufio_bufferedin_capture_finish_block,
+};
+
+MP_REGISTER_ROOT_POINTER(mp_obj_t background_capture[enum_NUM_DMA_CHANNELS]);
+#endif
@@ -12,6 +12,10 @@
 
 #include "py/obj.h"
 
+#if CIRCUITPY_ANALOGBUFIO_CAPTURE
+#include "shared-module/audiocore/Capture.h"
+#endif
+
 //  This is the analogbufio object
 typedef struct {
     mp_obj_base_t base;
@@ -19,4 +23,13 @@ typedef struct {
     uint8_t chan;
     uint dma_chan[2];
     dma_channel_config cfg[2];
+    #if CIRCUITPY_ANALOGBUFIO_CAPTURE
+    uint32_t sample_rate;
+    audiocore_capture_ring_t *capture_ring; // non-NULL while capturing for audiocore.Capture
+    #endif
 } analogbufio_bufferedin_obj_t;
+
+#if CIRCUITPY_ANALOGBUFIO_CAPTURE
+extern const audiocore_capture_source_p_t analogbufio_bufferedin_capture_proto;
+void analogbufio_bufferedin_dma_complete(analogbufio_bufferedin_obj_t *self, uint channel);
+#endif
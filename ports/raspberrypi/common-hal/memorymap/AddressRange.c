@@ -81,6 +81,18 @@ size_t common_hal_memorymap_addressrange_get_length(const memorymap_addressrange
     return self->len;
 }
 
+bool common_hal_memorymap_addressrange_is_memory(const memorymap_addressrange_obj_t *self, bool writable) {
+    switch (self->type) {
+        case SRAM:
+            return true;
+        case XIP:
+        case ROM:
+            return !writable;
+        default:
+            return false;
+    }
+}
+
 void common_hal_memorymap_addressrange_set_bytes(const memorymap_addressrange_obj_t *self,
     size_t start_index, uint8_t *values, size_t len) {
     uint8_t *dest_addr = self->start_address + start_index;
@@ -42,6 +42,8 @@ CIRCUITPY_ANALOGBUFIO = 1
 CIRCUITPY_AUDIOIO = 0
 CIRCUITPY_AUDIOBUSIO ?= 1
 CIRCUITPY_AUDIOCORE ?= 1
+# audiocore.Capture from analogbufio.BufferedIn
+CIRCUITPY_ANALOGBUFIO_CAPTURE ?= $(CIRCUITPY_AUDIOCORE)
 CIRCUITPY_AUDIOPWMIO ?= 1
 
 CIRCUITPY_AUDIOMIXER ?= 1
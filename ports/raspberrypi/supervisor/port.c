@@ -281,6 +281,11 @@ void port_free(void *ptr) {
     }
 }
 
+bool port_heap_ptr_is_fast(const void *ptr) {
+    // PSRAM is mapped below SRAM
+    return ((size_t)ptr) >= SRAM_BASE;
+}
+
 void *port_realloc(void *ptr, size_t size, bool dma_capable) {
     if (_psram_size > 0 && ((ptr != NULL && ((size_t)ptr) < SRAM_BASE) || (ptr == NULL && !dma_capable))) {
         void *block = tlsf_realloc(_psram_heap, ptr, size);
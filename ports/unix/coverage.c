@@ -17,6 +17,11 @@
 #include "py/stream.h"
 #include "py/binary.h"
 #include "py/bc.h"
+// CIRCUITPY-CHANGE
+#if CIRCUITPY_SYNTHIO
+#include "shared-bindings/synthio/Biquad.h"
+#include "shared-module/synthio/Biquad.h"
+#endif
 
 // expected output of this file is found in extra_coverage.py.exp
 
@@ -182,6 +187,32 @@ static void pairheap_test(size_t nops, int *ops) {
     mp_printf(&mp_plat_print, "\n");
 }
 
+#if MICROPY_GC_COMPACT
+// Make lists with movable items, each followed by garbage of the same size.
+// This is done in its own function so that no pointers to the items are left
+// in registers or on the part of the stack that the GC scans.
+static MP_NOINLINE void gc_compact_test_make(mp_obj_list_t **lists, size_t n_lists, size_t n_items) {
+    for (size_t i = 0; i < n_lists; i++) {
+        lists[i] = MP_OBJ_TO_PTR(mp_obj_new_list(n_items, NULL));
+        for (size_t j = 0; j < n_items; j++) {
+            lists[i]->items[j] = MP_OBJ_NEW_SMALL_INT(i * n_items + j);
+        }
+        m_malloc(n_items * sizeof(mp_obj_t));
+    }
+}
+
+static MP_NOINLINE bool gc_compact_test_check(mp_obj_list_t **lists, size_t n_lists, size_t n_items) {
+    for (size_t i = 0; i < n_lists; i++) {
+        for (size_t j = 0; j < n_items; j++) {
+            if (lists[i]->items[j] != MP_OBJ_NEW_SMALL_INT(i * n_items + j)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+#endif
+
 // function to run extra tests for things that can't be checked by scripts
 static mp_obj_t extra_coverage(void) {
     // mp_printf (used by ports that don't have a native printf)
@@ -261,6 +292,68 @@ static mp_obj_t extra_coverage(void) {
         mp_state_ctx.mem = mp_state_mem_orig;
     }
 
+    #if MICROPY_GC_PLACEMENT
+    // GC placement
+    {
+        mp_printf(&mp_plat_print, "# GC placement\n");
+        void *ptrs[3] = {
+            gc_alloc(16, 0),
+            gc_alloc(16, GC_ALLOC_FLAG_BULK),
+            gc_alloc(MICROPY_GC_PLACEMENT_BULK_BYTES, 0),
+        };
+        for (size_t i = 0; i < MP_ARRAY_SIZE(ptrs); i++) {
+            for (mp_state_mem_area_t *area = &MP_STATE_MEM(area); area != NULL; area = area->next) {
+                if ((byte *)ptrs[i] >= area->gc_pool_start && (byte *)ptrs[i] < area->gc_pool_end) {
+                    mp_printf(&mp_plat_print, "%d\n", area->gc_fast);
+                }
+            }
+            gc_free(ptrs[i]);
+        }
+        gc_info_t info;
+        gc_info(&info);
+        mp_printf(&mp_plat_print, "%d\n", info.fast_total > 0 && info.fast_total < info.total);
+    }
+    #endif
+
+    #if MICROPY_GC_COMPACT
+    // GC compaction
+    {
+        mp_printf(&mp_plat_print, "# GC compaction\n");
+        mp_state_mem_t mp_state_mem_orig = mp_state_ctx.mem;
+        size_t heap_size = 16 * 1024;
+        char *heap = calloc(heap_size, 1);
+        gc_init(heap, heap + heap_size);
+
+        size_t n_items = MICROPY_GC_COMPACT_MIN_BYTES / sizeof(mp_obj_t);
+        mp_obj_list_t *lists[4];
+        gc_compact_test_make(lists, MP_ARRAY_SIZE(lists), n_items);
+        gc_collect();
+
+        // the addresses of the items, inverted so as not to point to them
+        uintptr_t was[MP_ARRAY_SIZE(lists)];
+        for (size_t i = 0; i < MP_ARRAY_SIZE(lists); i++) {
+            was[i] = ~(uintptr_t)lists[i]->items;
+        }
+        // a pointer into some of them keeps them in place
+        mp_obj_t *volatile held = lists[1]->items + 1;
+        // as does handing them out
+        gc_movable_lend(lists[2]->items + 3);
+
+        // more than the largest free run, which only compaction can make
+        gc_info_t info;
+        gc_info(&info);
+        void *p = m_malloc_maybe((info.max_free + 1) * MICROPY_BYTES_PER_GC_BLOCK);
+        mp_printf(&mp_plat_print, "%d\n", p != NULL);
+        mp_printf(&mp_plat_print, "%d\n", gc_compact_test_check(lists, MP_ARRAY_SIZE(lists), n_items));
+        mp_printf(&mp_plat_print, "%d %d\n", ~(uintptr_t)lists[1]->items == was[1], *held == MP_OBJ_NEW_SMALL_INT(n_items + 1));
+        mp_printf(&mp_plat_print, "%d\n", ~(uintptr_t)lists[2]->items == was[2]);
+        mp_printf(&mp_plat_print, "%d\n", ~(uintptr_t)lists[3]->items != was[3]);
+
+        free(heap);
+        mp_state_ctx.mem = mp_state_mem_orig;
+    }
+    #endif
+
     // tracked allocation
     {
         #define NUM_PTRS (8)
@@ -729,6 +822,64 @@ static mp_obj_t extra_coverage(void) {
         mp_printf(&mp_plat_print, "%d %d\n", mp_obj_is_int(MP_OBJ_NEW_SMALL_INT(1)), mp_obj_is_int(mp_obj_new_int_from_ll(1)));
     }
 
+    // CIRCUITPY-CHANGE: the synthio filter bank must match filtering one note at a time
+    #if CIRCUITPY_SYNTHIO && SYNTHIO_FILTER_BANK
+    {
+        mp_printf(&mp_plat_print, "# synthio filter bank\n");
+
+        static const synthio_filter_mode modes[SYNTHIO_FILTER_BANK_LANES] = {
+            SYNTHIO_LOW_PASS, SYNTHIO_HIGH_PASS, SYNTHIO_BAND_PASS, SYNTHIO_PEAKING_EQ
+        };
+        synthio_render_context_t ctx = { .rate_scale = MICROPY_FLOAT_CONST(0.008), .W_scale = MICROPY_FLOAT_CONST(6.283185307179586) / 8000, .tick = 1 };
+        mp_obj_t filters[SYNTHIO_FILTER_BANK_LANES];
+        biquad_filter_state bank_state[SYNTHIO_FILTER_BANK_LANES], voice_state[SYNTHIO_FILTER_BANK_LANES];
+        biquad_filter_state *bank_states[SYNTHIO_FILTER_BANK_LANES];
+        for (size_t k = 0; k < SYNTHIO_FILTER_BANK_LANES; k++) {
+            synthio_biquad_t *f = MP_OBJ_TO_PTR(common_hal_synthio_biquad_new(modes[k]));
+            common_hal_synthio_biquad_set_frequency(f, mp_obj_new_float(300 + 400 * k));
+            common_hal_synthio_biquad_set_Q(f, mp_obj_new_float(MICROPY_FLOAT_CONST(0.7071067811865475)));
+            common_hal_synthio_biquad_set_A(f, mp_obj_new_float(MICROPY_FLOAT_CONST(2.0)));
+            filters[k] = MP_OBJ_FROM_PTR(f);
+            common_hal_synthio_biquad_tick(filters[k], &ctx);
+            synthio_biquad_filter_reset(&bank_state[k]);
+            synthio_biquad_filter_reset(&voice_state[k]);
+            bank_states[k] = &bank_state[k];
+        }
+
+        // two blocks of noise, first through all the lanes then through three,
+        // so that the filter state is carried between blocks
+        enum { N = 64 };
+        uint32_t seed = 1;
+        for (size_t n_lanes = SYNTHIO_FILTER_BANK_LANES; n_lanes >= SYNTHIO_FILTER_BANK_LANES - 1; n_lanes--) {
+            int32_t bank[N * SYNTHIO_FILTER_BANK_LANES];
+            int32_t voice[SYNTHIO_FILTER_BANK_LANES][N];
+            for (size_t i = 0; i < N; i++) {
+                for (size_t k = 0; k < SYNTHIO_FILTER_BANK_LANES; k++) {
+                    seed = seed * 1103515245 + 12345;
+                    int32_t sample = (int16_t)(seed >> 16) >> 2;
+                    bank[i * SYNTHIO_FILTER_BANK_LANES + k] = sample;
+                    voice[k][i] = sample;
+                }
+            }
+            synthio_biquad_filter_bank_samples(filters, bank_states, n_lanes, bank, N);
+            int32_t max_diff = 0;
+            for (size_t k = 0; k < n_lanes; k++) {
+                synthio_biquad_filter_samples(filters[k], &voice_state[k], voice[k], N, false);
+                for (size_t i = 0; i < N; i++) {
+                    int32_t diff = bank[i * SYNTHIO_FILTER_BANK_LANES + k] - voice[k][i];
+                    if (diff < 0) {
+                        diff = -diff;
+                    }
+                    if (diff > max_diff) {
+                        max_diff = diff;
+                    }
+                }
+            }
+            mp_printf(&mp_plat_print, "%d lanes, max difference %d\n", (int)n_lanes, (int)max_diff);
+        }
+    }
+    #endif
+
     mp_printf(&mp_plat_print, "# end coverage.c\n");
 
     mp_obj_streamtest_t *s = mp_obj_malloc(mp_obj_streamtest_t, &mp_type_stest_fileio);
@@ -45,4 +45,89 @@ void gc_collect(void) {
     gc_collect_end();
 }
 
+// CIRCUITPY-CHANGE
+#if MICROPY_GC_PARALLEL_MARK
+
+#if !MICROPY_PY_THREAD
+#error "MICROPY_GC_PARALLEL_MARK needs MICROPY_PY_THREAD"
+#endif
+
+#include <pthread.h>
+#include <signal.h>
+
+long mp_unix_gc_mark_threads = MICROPY_GC_MARK_THREADS;
+
+// The helpers are started on first use, and then wait between collections
+static pthread_mutex_t mark_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t mark_cond = PTHREAD_COND_INITIALIZER;
+static pthread_t mark_threads[MICROPY_GC_MARK_THREADS - 1];
+static size_t mark_n_threads;
+// Bumped for each collection, which wants the first mark_n_wanted helpers
+static unsigned int mark_generation;
+static size_t mark_n_wanted;
+// The helpers still marking in this collection
+static size_t mark_n_running;
+
+static void *mark_thread_entry(void *arg) {
+    size_t index = (uintptr_t)arg;
+    unsigned int generation = 0;
+    pthread_mutex_lock(&mark_mutex);
+    for (;;) {
+        while (generation == mark_generation) {
+            pthread_cond_wait(&mark_cond, &mark_mutex);
+        }
+        generation = mark_generation;
+        if (index > mark_n_wanted) {
+            continue;
+        }
+        pthread_mutex_unlock(&mark_mutex);
+        gc_mark_helper(index);
+        pthread_mutex_lock(&mark_mutex);
+        if (--mark_n_running == 0) {
+            pthread_cond_broadcast(&mark_cond);
+        }
+    }
+    return NULL;
+}
+
+size_t gc_mark_helpers_start(size_t n_helpers) {
+    n_helpers = MIN(n_helpers, (size_t)mp_unix_gc_mark_threads - 1);
+    pthread_mutex_lock(&mark_mutex);
+    if (mark_n_threads < n_helpers && mark_n_threads < MP_ARRAY_SIZE(mark_threads)) {
+        // Signals such as SIGINT are left to the VM's own threads
+        sigset_t all;
+        sigset_t old;
+        sigfillset(&all);
+        sigdelset(&all, SIGSEGV);
+        sigdelset(&all, SIGBUS);
+        sigdelset(&all, SIGFPE);
+        sigdelset(&all, SIGILL);
+        pthread_sigmask(SIG_SETMASK, &all, &old);
+        while (mark_n_threads < n_helpers && mark_n_threads < MP_ARRAY_SIZE(mark_threads)) {
+            if (pthread_create(&mark_threads[mark_n_threads], NULL, mark_thread_entry,
+                (void *)(uintptr_t)(mark_n_threads + 1)) != 0) {
+                break;
+            }
+            mark_n_threads++;
+        }
+        pthread_sigmask(SIG_SETMASK, &old, NULL);
+    }
+    mark_n_wanted = MIN(n_helpers, mark_n_threads);
+    mark_n_running = mark_n_wanted;
+    mark_generation++;
+    pthread_cond_broadcast(&mark_cond);
+    pthread_mutex_unlock(&mark_mutex);
+    return mark_n_wanted;
+}
+
+void gc_mark_helpers_wait(void) {
+    pthread_mutex_lock(&mark_mutex);
+    while (mark_n_running > 0) {
+        pthread_cond_wait(&mark_cond, &mark_mutex);
+    }
+    pthread_mutex_unlock(&mark_mutex);
+}
+
+#endif // MICROPY_GC_PARALLEL_MARK
+
 #endif // MICROPY_ENABLE_GC
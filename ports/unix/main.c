@@ -98,6 +98,22 @@ long heap_size = 1024 * 1024 * (sizeof(mp_uint_t) / 4);
 #define MICROPY_GC_SPLIT_HEAP_N_HEAPS (1)
 #endif
 
+#if MICROPY_GC_PLACEMENT
+// CIRCUITPY-CHANGE: the first half of the heaps stand in for fast internal
+// RAM, and the rest for PSRAM
+static char *fast_heaps[(MICROPY_GC_SPLIT_HEAP_N_HEAPS + 1) / 2];
+static long fast_heap_size;
+
+bool gc_ram_is_fast(void *ptr) {
+    for (size_t i = 0; i < MP_ARRAY_SIZE(fast_heaps); i++) {
+        if ((char *)ptr >= fast_heaps[i] && (char *)ptr < fast_heaps[i] + fast_heap_size) {
+            return true;
+        }
+    }
+    return false;
+}
+#endif
+
 #if !MICROPY_PY_SYS_PATH
 #error "The unix port requires MICROPY_PY_SYS_PATH=1"
 #endif
@@ -375,6 +391,13 @@ static void print_help(char **argv) {
         , heap_size);
     impl_opts_cnt++;
     #endif
+    // CIRCUITPY-CHANGE
+    #if MICROPY_GC_PARALLEL_MARK
+    printf(
+        "  gcmarkthreads=<n> -- set the number of threads that mark in a collection (default %ld)\n"
+        , mp_unix_gc_mark_threads);
+    impl_opts_cnt++;
+    #endif
     #if defined(__APPLE__)
     printf("  realtime -- set thread priority to realtime\n");
     impl_opts_cnt++;
@@ -450,6 +473,15 @@ static void pre_process_options(int argc, char **argv) {
                         goto invalid_arg;
                     }
                 #endif
+                // CIRCUITPY-CHANGE
+                #if MICROPY_GC_PARALLEL_MARK
+                } else if (strncmp(argv[a + 1], "gcmarkthreads=", sizeof("gcmarkthreads=") - 1) == 0) {
+                    char *end;
+                    mp_unix_gc_mark_threads = strtol(argv[a + 1] + sizeof("gcmarkthreads=") - 1, &end, 0);
+                    if (*end != 0 || mp_unix_gc_mark_threads < 1 || mp_unix_gc_mark_threads > MICROPY_GC_MARK_THREADS) {
+                        goto invalid_arg;
+                    }
+                #endif
                 #if defined(__APPLE__)
                 } else if (strcmp(argv[a + 1], "realtime") == 0) {
                     #if MICROPY_PY_THREAD
@@ -542,8 +574,16 @@ MP_NOINLINE int main_(int argc, char **argv) {
     assert(MICROPY_GC_SPLIT_HEAP_N_HEAPS > 0);
     char *heaps[MICROPY_GC_SPLIT_HEAP_N_HEAPS];
     long multi_heap_size = heap_size / MICROPY_GC_SPLIT_HEAP_N_HEAPS;
+    #if MICROPY_GC_PLACEMENT
+    fast_heap_size = multi_heap_size;
+    #endif
     for (size_t i = 0; i < MICROPY_GC_SPLIT_HEAP_N_HEAPS; i++) {
         heaps[i] = malloc(multi_heap_size);
+        #if MICROPY_GC_PLACEMENT
+        if (i < MP_ARRAY_SIZE(fast_heaps)) {
+            fast_heaps[i] = heaps[i];
+        }
+        #endif
         if (i == 0) {
             gc_init(heaps[i], heaps[i] + multi_heap_size);
         } else {
@@ -237,6 +237,22 @@ static inline unsigned long mp_random_seed_init(void) {
 #include <sched.h>
 #define MICROPY_UNIX_MACHINE_IDLE sched_yield();
 
+// CIRCUITPY-CHANGE: let the collecting thread run while a marking thread
+// waits, and let -X gcmarkthreads set how many threads mark
+#define MICROPY_GC_MARK_IDLE_HOOK() sched_yield()
+extern long mp_unix_gc_mark_threads;
+
+// CIRCUITPY-CHANGE: with threads and no GIL, let each thread allocate small
+// objects without taking the GC mutex
+#if MICROPY_PY_THREAD && !MICROPY_PY_THREAD_GIL
+#ifndef MICROPY_GC_ALLOC_CACHE
+#define MICROPY_GC_ALLOC_CACHE (1)
+#endif
+#define MICROPY_GC_ALLOC_CACHE_WAIT_HOOK() sched_yield()
+// CIRCUITPY-CHANGE: compact the heap only while there is one thread
+#define MICROPY_GC_COMPACT_OTHER_THREADS() mp_thread_unix_others_exist()
+#endif
+
 #ifndef MICROPY_PY_BLUETOOTH_ENABLE_CENTRAL_MODE
 #define MICROPY_PY_BLUETOOTH_ENABLE_CENTRAL_MODE (1)
 #endif
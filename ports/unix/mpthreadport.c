@@ -85,6 +85,22 @@ void mp_thread_unix_end_atomic_section(void) {
     pthread_mutex_unlock(&thread_mutex);
 }
 
+// CIRCUITPY-CHANGE
+// Whether there are threads other than the calling one. Only the calling one
+// can start another while there aren't.
+bool mp_thread_unix_others_exist(void) {
+    mp_thread_unix_begin_atomic_section();
+    bool others = false;
+    for (mp_thread_t *th = thread; th != NULL; th = th->next) {
+        if (th->id != pthread_self()) {
+            others = true;
+            break;
+        }
+    }
+    mp_thread_unix_end_atomic_section();
+    return others;
+}
+
 // this signal handler is used to scan the regs and stack of a thread
 static void mp_thread_gc(int signo, siginfo_t *info, void *context) {
     (void)info; // unused
@@ -38,6 +38,9 @@ void mp_thread_gc_others(void);
 void mp_thread_unix_begin_atomic_section(void);
 void mp_thread_unix_end_atomic_section(void);
 
+// CIRCUITPY-CHANGE
+bool mp_thread_unix_others_exist(void);
+
 // for `-X realtime` command line option
 #if defined(__APPLE__)
 extern bool mp_thread_is_realtime_enabled;
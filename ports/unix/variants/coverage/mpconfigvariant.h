@@ -37,9 +37,22 @@
 #define MICROPY_GC_SPLIT_HEAP          (1)
 #define MICROPY_GC_SPLIT_HEAP_N_HEAPS  (4)
 
+// CIRCUITPY-CHANGE: Enable testing of incremental sweeping and marking, the
+// nursery, placement by RAM speed, compaction, heap walking and parallel
+// marking.
+#define MICROPY_GC_INCREMENTAL_SWEEP   (1)
+#define MICROPY_GC_INCREMENTAL_MARK    (1)
+#define MICROPY_GC_NURSERY             (1)
+#define MICROPY_GC_PLACEMENT           (1)
+#define MICROPY_GC_COMPACT             (1)
+#define MICROPY_GC_HEAP_WALK           (1)
+#define MICROPY_GC_PARALLEL_MARK       (1)
+#define MICROPY_GC_MARK_HISTOGRAM      (1)
+
 // Enable additional features.
 #define MICROPY_DEBUG_PARSE_RULE_NAME  (1)
 #define MICROPY_TRACKED_ALLOC          (1)
+#define MICROPY_TRACK_CODE_STATE       (1)
 #define MICROPY_WARNINGS_CATEGORY      (1)
 
 // CIRCUITPY-CHANGE: Disable things never used in circuitpython
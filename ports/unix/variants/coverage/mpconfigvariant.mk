@@ -30,7 +30,10 @@ SRC_BITMAP := \
 	shared-bindings/__future__/__init__.c \
 	shared-bindings/aesio/aes.c \
 	shared-bindings/aesio/__init__.c \
+	shared-bindings/audioanalysis/__init__.c \
+	shared-bindings/audioanalysis/Analyzer.c \
 	shared-bindings/audiocore/__init__.c \
+	shared-bindings/audiocore/Capture.c \
 	shared-bindings/audiocore/RawSample.c \
 	shared-bindings/audiocore/WaveFile.c \
 	shared-bindings/audiodelays/Echo.c \
@@ -58,6 +61,10 @@ SRC_BITMAP := \
 	shared-bindings/jpegio/__init__.c \
 	shared-bindings/jpegio/JpegDecoder.c \
 	shared-bindings/locale/__init__.c \
+	shared-bindings/memorymonitor/__init__.c \
+	shared-bindings/memorymonitor/AllocationAlarm.c \
+	shared-bindings/memorymonitor/AllocationProfiler.c \
+	shared-bindings/memorymonitor/AllocationSize.c \
 	shared-bindings/rainbowio/__init__.c \
 	shared-bindings/struct/__init__.c \
 	shared-bindings/synthio/__init__.c \
@@ -68,6 +75,7 @@ SRC_BITMAP := \
 	shared-bindings/synthio/Biquad.c \
 	shared-bindings/synthio/Synthesizer.c \
 	shared-bindings/traceback/__init__.c \
+	shared-bindings/uheap/__init__.c \
 	shared-bindings/util.c \
 	shared-bindings/vectorio/Circle.c \
 	shared-bindings/vectorio/__init__.c \
@@ -77,9 +85,13 @@ SRC_BITMAP := \
 	shared-bindings/zlib/__init__.c \
 	shared-module/aesio/aes.c \
 	shared-module/aesio/__init__.c \
+	shared-module/audioanalysis/__init__.c \
+	shared-module/audioanalysis/Analyzer.c \
 	shared-module/audiocore/__init__.c \
+	shared-module/audiocore/Capture.c \
 	shared-module/audiocore/RawSample.c \
 	shared-module/audiocore/WaveFile.c \
+	shared-module/audiocore/delay_pool.c \
 	shared-module/audiodelays/Echo.c \
 	shared-module/audiodelays/Chorus.c \
 	shared-module/audiodelays/PitchShift.c \
@@ -103,6 +115,10 @@ SRC_BITMAP := \
 	shared-module/floppyio/__init__.c \
 	shared-module/jpegio/__init__.c \
 	shared-module/jpegio/JpegDecoder.c \
+	shared-module/memorymonitor/__init__.c \
+	shared-module/memorymonitor/AllocationAlarm.c \
+	shared-module/memorymonitor/AllocationProfiler.c \
+	shared-module/memorymonitor/AllocationSize.c \
 	shared-module/os/getenv.c \
 	shared-module/rainbowio/__init__.c \
 	shared-module/struct/__init__.c \
@@ -120,6 +136,7 @@ SRC_BITMAP := \
 	shared-module/vectorio/Rectangle.c \
 	shared-module/vectorio/VectorShape.c \
 	shared-module/traceback/__init__.c \
+	shared-module/uheap/__init__.c \
 	shared-module/zlib/__init__.c \
 
 SRC_C += $(SRC_BITMAP)
@@ -146,6 +163,7 @@ $(BUILD)/lib/mp3/src/buffers.o: CFLAGS += -include "shared-module/audiomp3/__ini
 
 CFLAGS += \
 	-DCIRCUITPY_AESIO=1 \
+	-DCIRCUITPY_AUDIOANALYSIS=1 \
 	-DCIRCUITPY_AUDIOCORE=1 \
 	-DCIRCUITPY_AUDIOEFFECTS=1 \
 	-DCIRCUITPY_AUDIODELAYS=1 \
@@ -153,6 +171,7 @@ CFLAGS += \
 	-DCIRCUITPY_AUDIOMIXER=1 \
 	-DCIRCUITPY_AUDIOMP3=1 \
 	-DCIRCUITPY_AUDIOCORE_DEBUG=1 \
+	-DCIRCUITPY_AUDIOCORE_CAPTURE=1 \
 	-DCIRCUITPY_BITMAPTOOLS=1 \
 	-DCIRCUITPY_CODEOP=1 \
 	-DCIRCUITPY_DISPLAYIO_UNIX=1 \
@@ -161,12 +180,14 @@ CFLAGS += \
 	-DCIRCUITPY_GIFIO=1 \
 	-DCIRCUITPY_JPEGIO=1 \
 	-DCIRCUITPY_LOCALE=1 \
+	-DCIRCUITPY_MEMORYMONITOR=1 \
 	-DCIRCUITPY_OS_GETENV=1 \
 	-DCIRCUITPY_RAINBOWIO=1 \
 	-DCIRCUITPY_STRUCT=1 \
 	-DCIRCUITPY_SYNTHIO=1 \
 	-DCIRCUITPY_SYNTHIO_MAX_CHANNELS=14 \
 	-DCIRCUITPY_TRACEBACK=1 \
+	-DCIRCUITPY_UHEAP=1 \
 	-DCIRCUITPY_VECTORIO=1 \
 	-DCIRCUITPY_ZLIB=1
 
@@ -128,6 +128,9 @@ endif
 ifeq ($(CIRCUITPY_AUDIOPWMIO),1)
 SRC_PATTERNS += audiopwmio/%
 endif
+ifeq ($(CIRCUITPY_AUDIOANALYSIS),1)
+SRC_PATTERNS += audioanalysis/%
+endif
 ifeq ($(CIRCUITPY_AUDIOCORE),1)
 SRC_PATTERNS += audiocore/%
 endif
@@ -664,8 +667,12 @@ SRC_SHARED_MODULE_ALL = \
 	aesio/__init__.c \
 	aesio/aes.c \
 	atexit/__init__.c \
+	audioanalysis/Analyzer.c \
+	audioanalysis/__init__.c \
+	audiocore/Capture.c \
 	audiocore/RawSample.c \
 	audiocore/WaveFile.c \
+	audiocore/delay_pool.c \
 	audiocore/__init__.c \
 	audiodelays/Echo.c \
 	audiodelays/Chorus.c \
@@ -745,6 +752,7 @@ SRC_SHARED_MODULE_ALL = \
 	max3421e/Max3421E.c \
 	memorymonitor/__init__.c \
 	memorymonitor/AllocationAlarm.c \
+	memorymonitor/AllocationProfiler.c \
 	memorymonitor/AllocationSize.c \
 	network/__init__.c \
 	msgpack/__init__.c \
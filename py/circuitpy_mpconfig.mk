@@ -138,10 +138,21 @@ CIRCUITPY_AUDIOCORE_DEBUG ?= 0
 endif
 CFLAGS += -DCIRCUITPY_AUDIOCORE_DEBUG=$(CIRCUITPY_AUDIOCORE_DEBUG)
 
+# audiocore.Capture, for ports with a capture source. The port sets which of
+# its inputs can be captured from.
+CIRCUITPY_ANALOGBUFIO_CAPTURE ?= 0
+CFLAGS += -DCIRCUITPY_ANALOGBUFIO_CAPTURE=$(CIRCUITPY_ANALOGBUFIO_CAPTURE)
+CIRCUITPY_AUDIOBUSIO_PDMIN_CAPTURE ?= 0
+CFLAGS += -DCIRCUITPY_AUDIOBUSIO_PDMIN_CAPTURE=$(CIRCUITPY_AUDIOBUSIO_PDMIN_CAPTURE)
+CIRCUITPY_AUDIOCORE_CAPTURE ?= $(call enable-if-any,$(CIRCUITPY_ANALOGBUFIO_CAPTURE) $(CIRCUITPY_AUDIOBUSIO_PDMIN_CAPTURE))
+CFLAGS += -DCIRCUITPY_AUDIOCORE_CAPTURE=$(CIRCUITPY_AUDIOCORE_CAPTURE)
+
 CIRCUITPY_AUDIOMP3 ?= $(call enable-if-all,$(CIRCUITPY_FULL_BUILD) $(CIRCUITPY_AUDIOCORE))
 CFLAGS += -DCIRCUITPY_AUDIOMP3=$(CIRCUITPY_AUDIOMP3)
 
 CIRCUITPY_AUDIOEFFECTS ?= 0
+CIRCUITPY_AUDIOANALYSIS ?= $(CIRCUITPY_AUDIOEFFECTS)
+CFLAGS += -DCIRCUITPY_AUDIOANALYSIS=$(CIRCUITPY_AUDIOANALYSIS)
 CIRCUITPY_AUDIODELAYS ?= $(CIRCUITPY_AUDIOEFFECTS)
 CFLAGS += -DCIRCUITPY_AUDIODELAYS=$(CIRCUITPY_AUDIODELAYS)
 CIRCUITPY_AUDIOFILTERS ?= $(CIRCUITPY_AUDIOEFFECTS)
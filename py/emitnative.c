@@ -1675,6 +1675,17 @@ static void emit_native_store_deref(emit_t *emit, qstr qst, mp_uint_t local_num)
     int reg_src = REG_TEMP1;
     emit_pre_pop_reg_flexible(emit, &vtype, &reg_src, reg_base, reg_base);
     ASM_STORE_REG_REG_OFFSET(emit->as, reg_src, reg_base, 1);
+    // CIRCUITPY-CHANGE: the cell may be old
+    #if MICROPY_GC_WRITE_BARRIER
+    need_reg_all(emit);
+    ASM_MOV_REG_REG(emit->as, REG_ARG_1, reg_base);
+    #if N_X86
+    // past the end of mp_f_n_args
+    asm_x86_call_ind(emit->as, MP_F_GC_WRITE_BARRIER, 1, ASM_X86_REG_EAX);
+    #else
+    ASM_CALL_IND(emit->as, MP_F_GC_WRITE_BARRIER);
+    #endif
+    #endif
     emit_post(emit);
 }
 
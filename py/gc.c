@@ -36,6 +36,11 @@
 #include <valgrind/memcheck.h>
 #endif
 
+// CIRCUITPY-CHANGE
+#if MICROPY_GC_MARK_HISTOGRAM
+#include "py/mphal.h"
+#endif
+
 // CIRCUITPY-CHANGE
 #include "supervisor/shared/safe_mode.h"
 
@@ -64,6 +69,24 @@
 // detect untraced object still in use
 #define CLEAR_ON_SWEEP (0)
 
+// CIRCUITPY-CHANGE
+// make this 1 to print the pointers to new objects that a minor collection is
+// about to free, or to unmarked objects from marked ones once incremental
+// marking has finished, which are stores that missed gc_write_barrier
+#define CHECK_WRITE_BARRIER (0)
+
+#if MICROPY_GC_NURSERY && !MICROPY_GC_WRITE_BARRIER
+#error "MICROPY_GC_NURSERY requires MICROPY_GC_WRITE_BARRIER"
+#endif
+
+#if MICROPY_GC_INCREMENTAL_MARK && !(MICROPY_GC_INCREMENTAL_SWEEP && MICROPY_GC_WRITE_BARRIER)
+#error "MICROPY_GC_INCREMENTAL_MARK requires MICROPY_GC_INCREMENTAL_SWEEP and MICROPY_GC_WRITE_BARRIER"
+#endif
+
+#if MICROPY_GC_COMPACT && MICROPY_PY_THREAD && !MICROPY_PY_THREAD_GIL && !defined(MICROPY_GC_COMPACT_OTHER_THREADS)
+#error "MICROPY_GC_COMPACT with threads and no GIL requires MICROPY_GC_COMPACT_OTHER_THREADS"
+#endif
+
 #define WORDS_PER_BLOCK ((MICROPY_BYTES_PER_GC_BLOCK) / MP_BYTES_PER_OBJ_WORD)
 #define BYTES_PER_BLOCK (MICROPY_BYTES_PER_GC_BLOCK)
 
@@ -103,6 +126,19 @@
 #define ATB_HEAD_TO_MARK(area, block) do { area->gc_alloc_table_start[(block) / BLOCKS_PER_ATB] |= (AT_MARK << BLOCK_SHIFT(block)); } while (0)
 #define ATB_MARK_TO_HEAD(area, block) do { area->gc_alloc_table_start[(block) / BLOCKS_PER_ATB] &= (~(AT_TAIL << BLOCK_SHIFT(block))); } while (0)
 
+// CIRCUITPY-CHANGE: the head of a live object stays marked until a pending
+// incremental sweep reaches it
+#if MICROPY_GC_INCREMENTAL_SWEEP
+#define ATB_KIND_IS_LIVE_HEAD(kind) ((kind) == AT_HEAD || (kind) == AT_MARK)
+#else
+#define ATB_KIND_IS_LIVE_HEAD(kind) ((kind) == AT_HEAD)
+#endif
+
+#if MICROPY_GC_NURSERY
+#define GC_BLOCK_IN_NURSERY(a, block) ((a) == &MP_STATE_MEM(area) \
+    && (block) >= MP_STATE_MEM(gc_nursery_start) && (block) < MP_STATE_MEM(gc_nursery_end))
+#endif
+
 #define BLOCK_FROM_PTR(area, ptr) (((byte *)(ptr) - area->gc_pool_start) / BYTES_PER_BLOCK)
 #define PTR_FROM_BLOCK(area, block) (((block) * BYTES_PER_BLOCK + (uintptr_t)area->gc_pool_start))
 
@@ -112,6 +148,35 @@
 // being interpreted as AT_TAIL.
 #define ALLOC_TABLE_GAP_BYTE (1)
 
+// CIRCUITPY-CHANGE
+// The sweep reads the ATB a machine word at a time, so that runs of blocks
+// that are all free or all in use are swept without looking at each one.
+// The words are read with memcpy, and only where they are aligned.
+typedef unsigned long atb_word_t;
+#define ATB_PER_WORD (sizeof(atb_word_t))
+#define BLOCKS_PER_ATB_WORD (BLOCKS_PER_ATB * ATB_PER_WORD)
+#define ATB_WORD_ALIGNED(atb) (((uintptr_t)(atb) & (ATB_PER_WORD - 1)) == 0)
+// The low bit of each entry, 0x5555...
+#define ATB_WORD_LOW_BITS ((atb_word_t)-1 / 3)
+// The low bit of each entry that is in use, that is AT_HEAD, and that is AT_MARK
+#define ATB_WORD_USED(w) (((w) | ((w) >> 1)) & ATB_WORD_LOW_BITS)
+#define ATB_WORD_HEADS(w) ((w) & ~((w) >> 1) & ATB_WORD_LOW_BITS)
+#define ATB_WORD_MARKS(w) ((w) & ((w) >> 1) & ATB_WORD_LOW_BITS)
+
+static inline atb_word_t atb_word_get(const byte *atb) {
+    atb_word_t w;
+    memcpy(&w, atb, sizeof(w));
+    return w;
+}
+
+static inline void atb_word_set(byte *atb, atb_word_t w) {
+    memcpy(atb, &w, sizeof(w));
+}
+
+// CIRCUITPY-CHANGE
+// The size class of an allocation of n blocks, an index into gc_first_free_atb_index
+#define SIZE_CLASS(n_blocks) (MIN((n_blocks), MICROPY_GC_ALLOC_SIZE_CLASSES) - 1)
+
 #if MICROPY_ENABLE_FINALISER
 // FTB = finaliser table byte
 // if set, then the corresponding block may have a finaliser
@@ -123,6 +188,32 @@
 #define FTB_CLEAR(area, block) do { area->gc_finaliser_table_start[(block) / BLOCKS_PER_FTB] &= (~(1 << ((block) & 7))); } while (0)
 #endif
 
+// CIRCUITPY-CHANGE
+#if MICROPY_GC_WRITE_BARRIER
+// RTB = remembered table byte
+// if set, then a pointer may have been stored in the corresponding block since
+// the last collection, or since incremental marking started
+
+#define BLOCKS_PER_RTB (8)
+
+#define RTB_GET(area, block) ((area->gc_remembered_table_start[(block) / BLOCKS_PER_RTB] >> ((block) & 7)) & 1)
+#endif
+
+// CIRCUITPY-CHANGE
+#if MICROPY_GC_INCREMENTAL_MARK
+// MP_STATE_MEM(gc_mark_phase)
+enum {
+    // no incremental marking under way
+    GC_MARK_AT_ONCE,
+    // the collection that marks the roots, leaving the rest to slices
+    GC_MARK_STARTING,
+    // between collections, while slices mark the rest
+    GC_MARK_SLICES,
+    // the collection that marks what the slices haven't
+    GC_MARK_FINISHING,
+};
+#endif
+
 #if MICROPY_PY_THREAD && !MICROPY_PY_THREAD_GIL
 #define GC_ENTER() mp_thread_mutex_lock(&MP_STATE_MEM(gc_mutex), 1)
 #define GC_EXIT() mp_thread_mutex_unlock(&MP_STATE_MEM(gc_mutex))
@@ -143,6 +234,44 @@ void __attribute__ ((noinline)) gc_log_change(uint32_t start_block, uint32_t len
 #pragma GCC pop_options
 #endif
 
+// CIRCUITPY-CHANGE
+// Free blocks starting at block have just been freed. A run of at least c + 1
+// free blocks that includes them, where there wasn't one before, can only start
+// up to c blocks earlier, so move the hint for each size class c back to there.
+static void gc_free_hints_lower(mp_state_mem_area_t *area, size_t block) {
+    for (size_t c = 0; c < MICROPY_GC_ALLOC_SIZE_CLASSES; c++) {
+        size_t atb_index = (block > c ? block - c : 0) / BLOCKS_PER_ATB;
+        if (atb_index < area->gc_first_free_atb_index[c]) {
+            area->gc_first_free_atb_index[c] = atb_index;
+        }
+    }
+    #if MICROPY_GC_ALLOC_CACHE
+    size_t atb_index = (block > MICROPY_GC_ALLOC_CACHE_RUN_BLOCKS - 1 ? block - (MICROPY_GC_ALLOC_CACHE_RUN_BLOCKS - 1) : 0) / BLOCKS_PER_ATB;
+    if (atb_index < area->gc_first_free_run_atb_index) {
+        area->gc_first_free_run_atb_index = atb_index;
+    }
+    #endif
+}
+
+// There is no run of n_blocks free blocks before the given ATB index, so there
+// is none of any larger size either. Nothing is known about the sizes in the
+// last class that are larger than n_blocks.
+static void gc_free_hints_raise(mp_state_mem_area_t *area, size_t n_blocks, size_t atb_index) {
+    #if MICROPY_GC_ALLOC_CACHE
+    if (n_blocks <= MICROPY_GC_ALLOC_CACHE_RUN_BLOCKS && atb_index > area->gc_first_free_run_atb_index) {
+        area->gc_first_free_run_atb_index = atb_index;
+    }
+    #endif
+    if (n_blocks > MICROPY_GC_ALLOC_SIZE_CLASSES) {
+        return;
+    }
+    for (size_t c = n_blocks - 1; c < MICROPY_GC_ALLOC_SIZE_CLASSES; c++) {
+        if (atb_index > area->gc_first_free_atb_index[c]) {
+            area->gc_first_free_atb_index[c] = atb_index;
+        }
+    }
+}
+
 // TODO waste less memory; currently requires that all entries in alloc_table have a corresponding block in pool
 static void gc_setup_area(mp_state_mem_area_t *area, void *start, void *end) {
     // calculate parameters for GC (T=total, A=alloc table, F=finaliser table, P=pool; all in bytes):
@@ -150,13 +279,20 @@ static void gc_setup_area(mp_state_mem_area_t *area, void *start, void *end) {
     //     F = A * BLOCKS_PER_ATB / BLOCKS_PER_FTB
     //     P = A * BLOCKS_PER_ATB * BYTES_PER_BLOCK
     // => T = A * (1 + BLOCKS_PER_ATB / BLOCKS_PER_FTB + BLOCKS_PER_ATB * BYTES_PER_BLOCK)
+    // CIRCUITPY-CHANGE: and the remembered table R = A * BLOCKS_PER_ATB / BLOCKS_PER_RTB
+    // follows F, if there is one
     size_t total_byte_len = (byte *)end - (byte *)start;
-    #if MICROPY_ENABLE_FINALISER
+    #if MICROPY_ENABLE_FINALISER || MICROPY_GC_WRITE_BARRIER
     area->gc_alloc_table_byte_len = (total_byte_len - ALLOC_TABLE_GAP_BYTE)
         * MP_BITS_PER_BYTE
         / (
             MP_BITS_PER_BYTE
+            #if MICROPY_ENABLE_FINALISER
             + MP_BITS_PER_BYTE * BLOCKS_PER_ATB / BLOCKS_PER_FTB
+            #endif
+            #if MICROPY_GC_WRITE_BARRIER
+            + MP_BITS_PER_BYTE * BLOCKS_PER_ATB / BLOCKS_PER_RTB
+            #endif
             + MP_BITS_PER_BYTE * BLOCKS_PER_ATB * BYTES_PER_BLOCK
             );
     #else
@@ -169,6 +305,15 @@ static void gc_setup_area(mp_state_mem_area_t *area, void *start, void *end) {
     size_t gc_finaliser_table_byte_len = (area->gc_alloc_table_byte_len * BLOCKS_PER_ATB + BLOCKS_PER_FTB - 1) / BLOCKS_PER_FTB;
     area->gc_finaliser_table_start = area->gc_alloc_table_start + area->gc_alloc_table_byte_len + ALLOC_TABLE_GAP_BYTE;
     #endif
+    // CIRCUITPY-CHANGE
+    #if MICROPY_GC_WRITE_BARRIER
+    size_t gc_remembered_table_byte_len = (area->gc_alloc_table_byte_len * BLOCKS_PER_ATB + BLOCKS_PER_RTB - 1) / BLOCKS_PER_RTB;
+    #if MICROPY_ENABLE_FINALISER
+    area->gc_remembered_table_start = area->gc_finaliser_table_start + gc_finaliser_table_byte_len;
+    #else
+    area->gc_remembered_table_start = area->gc_alloc_table_start + area->gc_alloc_table_byte_len + ALLOC_TABLE_GAP_BYTE;
+    #endif
+    #endif
 
     size_t gc_pool_block_len = area->gc_alloc_table_byte_len * BLOCKS_PER_ATB;
     area->gc_pool_start = (byte *)end - gc_pool_block_len * BYTES_PER_BLOCK;
@@ -177,6 +322,11 @@ static void gc_setup_area(mp_state_mem_area_t *area, void *start, void *end) {
     #if MICROPY_ENABLE_FINALISER
     assert(area->gc_pool_start >= area->gc_finaliser_table_start + gc_finaliser_table_byte_len);
     #endif
+    // CIRCUITPY-CHANGE
+    #if MICROPY_GC_WRITE_BARRIER
+    assert(area->gc_pool_start >= area->gc_remembered_table_start + gc_remembered_table_byte_len);
+    memset(area->gc_remembered_table_start, 0, gc_remembered_table_byte_len);
+    #endif
 
     #if MICROPY_ENABLE_FINALISER
     // clear ATB's and FTB's
@@ -186,8 +336,20 @@ static void gc_setup_area(mp_state_mem_area_t *area, void *start, void *end) {
     memset(area->gc_alloc_table_start, 0, area->gc_alloc_table_byte_len + ALLOC_TABLE_GAP_BYTE);
     #endif
 
-    area->gc_last_free_atb_index = 0;
+    for (size_t c = 0; c < MICROPY_GC_ALLOC_SIZE_CLASSES; c++) {
+        area->gc_first_free_atb_index[c] = 0;
+    }
+    // CIRCUITPY-CHANGE
+    #if MICROPY_GC_ALLOC_CACHE
+    area->gc_first_free_run_atb_index = 0;
+    #endif
     area->gc_last_used_block = 0;
+    #if MICROPY_GC_INCREMENTAL_SWEEP
+    area->gc_sweep_block = SIZE_MAX;
+    #endif
+    #if MICROPY_GC_PLACEMENT
+    area->gc_fast = gc_ram_is_fast(start);
+    #endif
 
     #if MICROPY_GC_SPLIT_HEAP
     area->next = NULL;
@@ -209,6 +371,158 @@ static void gc_setup_area(mp_state_mem_area_t *area, void *start, void *end) {
         gc_pool_block_len * BYTES_PER_BLOCK, gc_pool_block_len);
 }
 
+#if MICROPY_GC_WRITE_BARRIER
+// CIRCUITPY-CHANGE
+// Set the remembered bits of blocks start_block up to end_block. Threads
+// without the GIL do this without the GC mutex.
+static void gc_remember_blocks(mp_state_mem_area_t *area, size_t start_block, size_t end_block) {
+    for (size_t block = start_block; block < end_block; block++) {
+        byte *rtb = &area->gc_remembered_table_start[block / BLOCKS_PER_RTB];
+        byte bit = 1 << (block & 7);
+        if (*rtb & bit) {
+            continue;
+        }
+        #if MICROPY_PY_THREAD && !MICROPY_PY_THREAD_GIL
+        __atomic_fetch_or(rtb, bit, __ATOMIC_RELAXED);
+        #else
+        *rtb |= bit;
+        #endif
+    }
+}
+
+// Remember all of the object whose head is block, if it is one, returning
+// the block after it, or block if it isn't
+static size_t gc_remember_head(mp_state_mem_area_t *area, size_t block) {
+    size_t kind = ATB_GET_KIND(area, block);
+    if (kind != AT_HEAD && kind != AT_MARK) {
+        return block;
+    }
+    size_t n_blocks = area->gc_alloc_table_byte_len * BLOCKS_PER_ATB;
+    size_t end_block = block + 1;
+    while (end_block < n_blocks && ATB_GET_KIND(area, end_block) == AT_TAIL) {
+        end_block++;
+    }
+    gc_remember_blocks(area, block, end_block);
+    return end_block;
+}
+
+// The area that ptr is anywhere in, or NULL if it isn't in the heap
+static mp_state_mem_area_t *gc_remember_area(const void *ptr) {
+    for (mp_state_mem_area_t *area = &MP_STATE_MEM(area); area != NULL; area = NEXT_AREA(area)) {
+        if (ptr >= (void *)area->gc_pool_start && ptr < (void *)area->gc_pool_end) {
+            return area;
+        }
+    }
+    return NULL;
+}
+
+void gc_remember(const void *ptr) {
+    mp_state_mem_area_t *area = gc_remember_area(ptr);
+    if (area != NULL) {
+        size_t block = BLOCK_FROM_PTR(area, ptr);
+        gc_remember_blocks(area, block, block + 1);
+    }
+}
+
+void gc_remember_obj(const void *ptr) {
+    mp_state_mem_area_t *area = gc_remember_area(ptr);
+    if (area != NULL) {
+        size_t block = BLOCK_FROM_PTR(area, ptr);
+        while (block > 0 && ATB_GET_KIND(area, block) == AT_TAIL) {
+            block--;
+        }
+        gc_remember_head(area, block);
+    }
+}
+
+// Forget everything remembered, once a full collection has left no objects new
+static void gc_remember_clear(void) {
+    for (mp_state_mem_area_t *area = &MP_STATE_MEM(area); area != NULL; area = NEXT_AREA(area)) {
+        memset(area->gc_remembered_table_start, 0,
+            (area->gc_alloc_table_byte_len * BLOCKS_PER_ATB + BLOCKS_PER_RTB - 1) / BLOCKS_PER_RTB);
+    }
+}
+#endif
+
+#if MICROPY_GC_NURSERY
+// CIRCUITPY-CHANGE
+// Make the nursery the longest run of free blocks in the first area, trimmed
+// to whole words of the ATB so that it is swept a word at a time. Starting and
+// ending on free blocks means that no object crosses either end. If the run is
+// too short for minor collections to pay off, there is no nursery until the
+// next full collection.
+static void gc_nursery_place(void) {
+    mp_state_mem_area_t *area = &MP_STATE_MEM(area);
+    size_t n_blocks = area->gc_alloc_table_byte_len * BLOCKS_PER_ATB;
+    // The allocator outside the nursery hasn't looked at the free blocks in
+    // it, so may have passed them by
+    gc_free_hints_lower(area, MP_STATE_MEM(gc_nursery_start));
+
+    size_t best_start = 0;
+    size_t best_end = 0;
+    size_t run_start = 0;
+    for (size_t block = 0; block < n_blocks; block++) {
+        if (block % BLOCKS_PER_ATB == 0 && area->gc_alloc_table_start[block / BLOCKS_PER_ATB] == 0) {
+            block += BLOCKS_PER_ATB - 1;
+            continue;
+        }
+        if (ATB_GET_KIND(area, block) != AT_FREE) {
+            if (block - run_start > best_end - best_start) {
+                best_start = run_start;
+                best_end = block;
+            }
+            run_start = block + 1;
+        }
+    }
+    if (n_blocks - run_start > best_end - best_start) {
+        best_start = run_start;
+        best_end = n_blocks;
+    }
+
+    best_start = (best_start + BLOCKS_PER_ATB_WORD - 1) & ~(BLOCKS_PER_ATB_WORD - 1);
+    if (best_end < n_blocks) {
+        best_end &= ~(BLOCKS_PER_ATB_WORD - 1);
+    }
+    if (best_end < best_start + n_blocks / 8) {
+        best_start = best_end = 0;
+    }
+    MP_STATE_MEM(gc_nursery_start) = best_start;
+    MP_STATE_MEM(gc_nursery_end) = best_end;
+    MP_STATE_MEM(gc_nursery_next) = best_start;
+}
+
+static inline bool gc_nursery_exists(void) {
+    return MP_STATE_MEM(gc_nursery_start) < MP_STATE_MEM(gc_nursery_end);
+}
+
+// The objects in the nursery are about to be old without a collection, so
+// that nothing found them being filled in, so remember them all
+static void gc_nursery_remember_all(void) {
+    mp_state_mem_area_t *area = &MP_STATE_MEM(area);
+    for (size_t block = MP_STATE_MEM(gc_nursery_start); block < MP_STATE_MEM(gc_nursery_end); block++) {
+        if (ATB_GET_KIND(area, block) != AT_FREE) {
+            gc_remember_blocks(area, block, block + 1);
+        }
+    }
+}
+
+// An object before the nursery has grown in place up to end_block, over free
+// blocks at the start of it, so the nursery now starts after the object
+static void gc_nursery_grown_into(mp_state_mem_area_t *area, size_t block, size_t end_block) {
+    if (area != &MP_STATE_MEM(area) || block >= MP_STATE_MEM(gc_nursery_start)
+        || end_block <= MP_STATE_MEM(gc_nursery_start)) {
+        return;
+    }
+    if (end_block >= MP_STATE_MEM(gc_nursery_end)) {
+        gc_nursery_remember_all();
+        MP_STATE_MEM(gc_nursery_start) = MP_STATE_MEM(gc_nursery_end) = 0;
+        return;
+    }
+    MP_STATE_MEM(gc_nursery_start) = end_block;
+    MP_STATE_MEM(gc_nursery_next) = MAX(MP_STATE_MEM(gc_nursery_next), end_block);
+}
+#endif
+
 void gc_init(void *start, void *end) {
     // align end pointer on block boundary
     end = (void *)((uintptr_t)end & (~(BYTES_PER_BLOCK - 1)));
@@ -216,6 +530,12 @@ void gc_init(void *start, void *end) {
 
     gc_setup_area(&MP_STATE_MEM(area), start, end);
 
+    // CIRCUITPY-CHANGE: until the first collection, the nursery is the whole area
+    #if MICROPY_GC_NURSERY
+    gc_nursery_place();
+    MP_STATE_MEM(gc_minor) = false;
+    #endif
+
     // set last free ATB index to start of heap
     #if MICROPY_GC_SPLIT_HEAP
     MP_STATE_MEM(gc_last_free_area) = &MP_STATE_MEM(area);
@@ -227,6 +547,34 @@ void gc_init(void *start, void *end) {
     // allow auto collection
     MP_STATE_MEM(gc_auto_collect_enabled) = 1;
 
+    // CIRCUITPY-CHANGE
+    #if MICROPY_GC_INCREMENTAL_SWEEP
+    MP_STATE_MEM(gc_sweep_area) = NULL;
+    MP_STATE_MEM(gc_sweep_lazily) = false;
+    #endif
+    #if MICROPY_GC_INCREMENTAL_MARK
+    MP_STATE_MEM(gc_mark_phase) = GC_MARK_AT_ONCE;
+    MP_STATE_MEM(gc_mark_sp) = 0;
+    MP_STATE_MEM(gc_mark_walk_area) = NULL;
+    #endif
+    #if MICROPY_GC_COMPACT
+    MP_STATE_MEM(gc_movable) = NULL;
+    MP_STATE_MEM(gc_movable_len) = 0;
+    MP_STATE_MEM(gc_compact_len) = 0;
+    #endif
+    #if MICROPY_GC_PARALLEL_MARK
+    MP_STATE_MEM(gc_mark_parallel) = false;
+    #endif
+    #if MICROPY_GC_MARK_HISTOGRAM
+    memset(MP_STATE_MEM(gc_mark_histogram), 0, sizeof(MP_STATE_MEM(gc_mark_histogram)));
+    #endif
+    #if MICROPY_GC_ALLOC_CACHE
+    MP_STATE_MEM(gc_alloc_caches) = NULL;
+    MP_STATE_MEM(gc_alloc_cache_blocked) = 0;
+    MP_STATE_MEM(gc_alloc_cache_no_run) = false;
+    memset(&MP_STATE_THREAD(gc_alloc_cache), 0, sizeof(MP_STATE_THREAD(gc_alloc_cache)));
+    #endif
+
     #if MICROPY_GC_ALLOC_THRESHOLD
     // by default, maxuint for gc threshold, effectively turning gc-by-threshold off
     MP_STATE_MEM(gc_alloc_threshold) = (size_t)-1;
@@ -358,6 +706,11 @@ void gc_deinit(void) {
     // any additional heap areas (but not the first.)
     gc_sweep_all();
     memset(&MP_STATE_MEM(area), 0, sizeof(MP_STATE_MEM(area)));
+    // CIRCUITPY-CHANGE: nothing may come from the old heap
+    #if MICROPY_GC_ALLOC_CACHE
+    MP_STATE_MEM(gc_alloc_caches) = NULL;
+    memset(&MP_STATE_THREAD(gc_alloc_cache), 0, sizeof(MP_STATE_THREAD(gc_alloc_cache)));
+    #endif
 }
 
 void gc_lock(void) {
@@ -420,6 +773,306 @@ static inline mp_state_mem_area_t *gc_get_ptr_area(const void *ptr) {
 #endif
 #endif
 
+// CIRCUITPY-CHANGE
+#if MICROPY_GC_COMPACT
+
+static mp_state_mem_area_t *gc_compact_area(const void *ptr) {
+    for (mp_state_mem_area_t *area = &MP_STATE_MEM(area); area != NULL; area = NEXT_AREA(area)) {
+        if ((const byte *)ptr >= area->gc_pool_start && (const byte *)ptr < area->gc_pool_end) {
+            return area;
+        }
+    }
+    return NULL;
+}
+
+static size_t gc_compact_n_blocks(mp_state_mem_area_t *area, size_t block) {
+    size_t n_blocks = 1;
+    while (block + n_blocks < area->gc_alloc_table_byte_len * BLOCKS_PER_ATB
+           && ATB_GET_KIND(area, block + n_blocks) == AT_TAIL) {
+        n_blocks++;
+    }
+    return n_blocks;
+}
+
+// The table of owners is on the heap, and the GC looks in it as in any other
+// object, so the pointers in it are kept inverted: it mustn't keep the owners
+// alive, or the buffers in place.
+#define MOVABLE_HIDE(ptr) (~(uintptr_t)(ptr))
+#define MOVABLE_SHOW(type, value) ((type) ~(value))
+
+// Whether the owner is still an object of the same type, with the handle in it
+static bool gc_movable_owner_ok(const mp_gc_movable_t *m) {
+    mp_obj_base_t *owner = MOVABLE_SHOW(mp_obj_base_t *, m->owner);
+    void **handle = MOVABLE_SHOW(void **, m->handle);
+    mp_state_mem_area_t *area = gc_compact_area(owner);
+    if (area == NULL || ((uintptr_t)owner & (BYTES_PER_BLOCK - 1)) != 0) {
+        return false;
+    }
+    size_t block = BLOCK_FROM_PTR(area, owner);
+    if (!ATB_KIND_IS_LIVE_HEAD(ATB_GET_KIND(area, block))
+        || owner->type != MOVABLE_SHOW(const mp_obj_type_t *, m->type)) {
+        return false;
+    }
+    size_t n_blocks = gc_compact_n_blocks(area, block);
+    return (byte *)handle >= (byte *)owner
+           && (byte *)(handle + 1) <= (byte *)owner + n_blocks * BYTES_PER_BLOCK;
+}
+
+// The entry for handle, or else one that is unused or whose owner has gone.
+// NULL if the table is full.
+static mp_gc_movable_t *gc_movable_find(void **handle) {
+    mp_gc_movable_t *movable = MP_STATE_MEM(gc_movable);
+    size_t len = MP_STATE_MEM(gc_movable_len);
+    mp_gc_movable_t *entry = NULL;
+    for (size_t i = 0; i < len; i++) {
+        if (movable[i].handle == MOVABLE_HIDE(handle)) {
+            return &movable[i];
+        }
+        if (entry == NULL && movable[i].owner == 0) {
+            entry = &movable[i];
+        }
+    }
+    for (size_t i = 0; entry == NULL && i < len; i++) {
+        if (!gc_movable_owner_ok(&movable[i])) {
+            entry = &movable[i];
+        }
+    }
+    return entry;
+}
+
+void gc_movable_add(void *owner, void **handle, size_t n_bytes) {
+    if (gc_compact_area(owner) == NULL) {
+        // Only objects on the heap can be checked on later
+        return;
+    }
+    GC_ENTER();
+    mp_gc_movable_t *entry;
+    while ((entry = gc_movable_find(handle)) == NULL) {
+        // The table is full, so make it twice the size. The new one is
+        // allocated without the GC mutex, so another thread may have grown it
+        // meanwhile. If there isn't the memory, the buffer just stays where it
+        // is.
+        size_t len = MP_STATE_MEM(gc_movable_len);
+        size_t new_len = len == 0 ? MICROPY_GC_COMPACT_MOVABLE_INIT : len * 2;
+        GC_EXIT();
+        mp_gc_movable_t *grown = gc_alloc(new_len * sizeof(mp_gc_movable_t), 0);
+        if (grown == NULL) {
+            return;
+        }
+        GC_ENTER();
+        len = MP_STATE_MEM(gc_movable_len);
+        if (len < new_len) {
+            memcpy(grown, MP_STATE_MEM(gc_movable), len * sizeof(mp_gc_movable_t));
+            memset(grown + len, 0, (new_len - len) * sizeof(mp_gc_movable_t));
+            mp_gc_movable_t *old = MP_STATE_MEM(gc_movable);
+            MP_STATE_MEM(gc_movable) = grown;
+            MP_STATE_MEM(gc_movable_len) = new_len;
+            grown = old;
+        }
+        GC_EXIT();
+        gc_free(grown);
+        GC_ENTER();
+    }
+    if (entry->handle != MOVABLE_HIDE(handle)) {
+        entry->lent = 0;
+    }
+    entry->owner = MOVABLE_HIDE(owner);
+    entry->type = MOVABLE_HIDE(((mp_obj_base_t *)owner)->type);
+    entry->handle = MOVABLE_HIDE(handle);
+    entry->n_bytes = n_bytes;
+    GC_EXIT();
+}
+
+void gc_movable_lend(const void *buf) {
+    if (MP_STATE_MEM(gc_movable_len) == 0 || gc_compact_area(buf) == NULL) {
+        return;
+    }
+    GC_ENTER();
+    mp_gc_movable_t *movable = MP_STATE_MEM(gc_movable);
+    for (size_t i = 0; i < MP_STATE_MEM(gc_movable_len); i++) {
+        mp_gc_movable_t *m = &movable[i];
+        if (m->owner == 0) {
+            continue;
+        }
+        // The handle is in the heap even if its owner has gone, so it can be
+        // read. At worst, a buffer that wasn't lent stays where it is.
+        const byte *start = *MOVABLE_SHOW(byte **, m->handle);
+        if ((const byte *)buf >= start && (const byte *)buf < start + m->n_bytes) {
+            m->lent = MOVABLE_HIDE(start);
+        }
+    }
+    GC_EXIT();
+}
+
+// Get ready for a compacting collection: drop the entries whose owners have
+// gone, and put the rest at the start, sorted by the address of their buffer.
+// Those that can't be moved in any case, including those that have been lent,
+// are pinned to begin with. Returns whether there are any that might be moved.
+static bool gc_compact_start(void) {
+    mp_gc_movable_t *movable = MP_STATE_MEM(gc_movable);
+    size_t len = 0;
+    bool any = false;
+    for (size_t i = 0; i < MP_STATE_MEM(gc_movable_len); i++) {
+        mp_gc_movable_t m = movable[i];
+        movable[i].owner = 0;
+        movable[i].handle = 0;
+        if (m.owner == 0 || !gc_movable_owner_ok(&m)) {
+            continue;
+        }
+        // Only a pointer to the start of an object can be moved. Any other
+        // one is left out of the search by gc_compact_note().
+        byte *buf = *MOVABLE_SHOW(byte **, m.handle);
+        m.buf = m.buf_end = MOVABLE_HIDE(NULL);
+        m.pinned = true;
+        mp_state_mem_area_t *area = gc_compact_area(buf);
+        if (area != NULL && ((uintptr_t)buf & (BYTES_PER_BLOCK - 1)) == 0
+            && ATB_KIND_IS_LIVE_HEAD(ATB_GET_KIND(area, BLOCK_FROM_PTR(area, buf)))) {
+            size_t block = BLOCK_FROM_PTR(area, buf);
+            size_t n_blocks = gc_compact_n_blocks(area, block);
+            m.buf = MOVABLE_HIDE(buf);
+            m.buf_end = MOVABLE_HIDE(buf + n_blocks * BYTES_PER_BLOCK);
+            m.pinned = m.lent == m.buf;
+            #if MICROPY_ENABLE_FINALISER
+            m.pinned = m.pinned || FTB_GET(area, block);
+            #endif
+        }
+        // insert in order
+        size_t j = len++;
+        for (; j > 0 && MOVABLE_SHOW(byte *, movable[j - 1].buf) > MOVABLE_SHOW(byte *, m.buf); j--) {
+            movable[j] = movable[j - 1];
+        }
+        movable[j] = m;
+        any = any || !m.pinned;
+    }
+    // A buffer with two owners stays where it is
+    for (size_t i = 1; i < len; i++) {
+        if (movable[i].buf != MOVABLE_HIDE(NULL) && movable[i].buf == movable[i - 1].buf) {
+            movable[i].pinned = movable[i - 1].pinned = true;
+        }
+    }
+    MP_STATE_MEM(gc_compact_len) = any ? len : 0;
+    return any;
+}
+
+// A word at slot, seen while marking, has the value ptr. Unless slot is the
+// handle, a buffer that ptr points into can't move. Interior pointers count,
+// since C code may hold one to a buffer that is otherwise only reachable
+// through its owner. A pointer just past the end doesn't, as that is where the
+// next object starts.
+static void gc_compact_note(void **slot, const void *ptr) {
+    mp_gc_movable_t *movable = MP_STATE_MEM(gc_movable);
+    // find the last buffer that starts at or before ptr
+    size_t lo = 0;
+    size_t hi = MP_STATE_MEM(gc_compact_len);
+    while (lo < hi) {
+        size_t mid = (lo + hi) / 2;
+        if ((const byte *)ptr >= MOVABLE_SHOW(byte *, movable[mid].buf)) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    if (lo > 0) {
+        mp_gc_movable_t *m = &movable[lo - 1];
+        if ((const byte *)ptr < MOVABLE_SHOW(byte *, m->buf_end) && slot != MOVABLE_SHOW(void **, m->handle)) {
+            m->pinned = true;
+        }
+    }
+}
+
+// The lowest block that the object of n_blocks at block can move down to:
+// the start of the first free run that is either long enough, or that reaches
+// up to the object so that it can slide down into it.
+static size_t gc_compact_find(mp_state_mem_area_t *area, size_t block, size_t n_blocks) {
+    size_t n_free = 0;
+    for (size_t b = area->gc_first_free_atb_index[0] * BLOCKS_PER_ATB; b < block; b++) {
+        MICROPY_GC_HOOK_LOOP(b);
+        if (ATB_GET_KIND(area, b) != AT_FREE) {
+            n_free = 0;
+        } else if (++n_free == n_blocks) {
+            return b + 1 - n_blocks;
+        }
+    }
+    return block - n_free;
+}
+
+// Once marking is done: a buffer stays where it is unless its owner is live.
+static void gc_compact_check_owners(void) {
+    mp_gc_movable_t *movable = MP_STATE_MEM(gc_movable);
+    for (size_t i = 0; i < MP_STATE_MEM(gc_compact_len); i++) {
+        mp_gc_movable_t *m = &movable[i];
+        mp_obj_base_t *owner = MOVABLE_SHOW(mp_obj_base_t *, m->owner);
+        mp_state_mem_area_t *area = gc_compact_area(owner);
+        if (ATB_GET_KIND(area, BLOCK_FROM_PTR(area, owner)) != AT_MARK) {
+            m->pinned = true;
+        }
+    }
+}
+
+// Once the heap is swept: move the buffers that can be moved, lowest first,
+// down to the lowest place they fit, so the space they leave joins up with
+// the free space above them.
+static void gc_compact_move(void) {
+    mp_gc_movable_t *movable = MP_STATE_MEM(gc_movable);
+    for (size_t i = 0; i < MP_STATE_MEM(gc_compact_len); i++) {
+        mp_gc_movable_t *m = &movable[i];
+        if (m->pinned) {
+            continue;
+        }
+        byte *from = MOVABLE_SHOW(byte *, m->buf);
+        mp_state_mem_area_t *area = gc_compact_area(from);
+        size_t block = BLOCK_FROM_PTR(area, from);
+        size_t n_blocks = (MOVABLE_SHOW(byte *, m->buf_end) - from) / BYTES_PER_BLOCK;
+        size_t to = gc_compact_find(area, block, n_blocks);
+        if (to == block) {
+            continue;
+        }
+        for (size_t b = block; b < block + n_blocks; b++) {
+            ATB_ANY_TO_FREE(area, b);
+        }
+        ATB_FREE_TO_HEAD(area, to);
+        for (size_t b = to + 1; b < to + n_blocks; b++) {
+            ATB_FREE_TO_TAIL(area, b);
+        }
+        byte *buf = (byte *)PTR_FROM_BLOCK(area, to);
+        memmove(buf, from, n_blocks * BYTES_PER_BLOCK);
+        *MOVABLE_SHOW(void **, m->handle) = buf;
+        gc_free_hints_lower(area, MAX(to + n_blocks, block));
+        DEBUG_printf("gc_compact_move(%p -> %p)\n", from, buf);
+    }
+}
+
+// Clear the part of the stack that gc_compact_start() used, so that the
+// collection doesn't take the buffer addresses it left there as references.
+static MP_NOINLINE void gc_compact_clear_stack(void) {
+    volatile uintptr_t words[64];
+    for (size_t i = 0; i < MP_ARRAY_SIZE(words); i++) {
+        words[i] = 0;
+    }
+}
+
+// Collect, moving what buffers can be moved. Returns false, having done
+// nothing, if there are none that might be.
+static bool gc_compact(void) {
+    #ifdef MICROPY_GC_COMPACT_OTHER_THREADS
+    // Without the GIL, another thread may use a buffer as it moves. If there
+    // are no others, none can start until this one is done.
+    if (MICROPY_GC_COMPACT_OTHER_THREADS()) {
+        return false;
+    }
+    #endif
+    GC_ENTER();
+    bool any = gc_compact_start();
+    GC_EXIT();
+    if (any) {
+        gc_compact_clear_stack();
+        gc_collect();
+    }
+    return any;
+}
+
+#endif // MICROPY_GC_COMPACT
+
 // Take the given block as the topmost block on the stack. Check all it's
 // children: mark the unmarked child blocks and put those newly marked
 // blocks on the stack. When all children have been checked, pop off the
@@ -452,6 +1105,12 @@ static void MP_NO_INSTRUMENT PLACE_IN_ITCM(gc_mark_subtree)(size_t block)
         for (size_t i = n_blocks * BYTES_PER_BLOCK / sizeof(void *); i > 0; i--, ptrs++) {
             MICROPY_GC_HOOK_LOOP(i);
             void *ptr = *ptrs;
+            // CIRCUITPY-CHANGE
+            #if MICROPY_GC_COMPACT
+            if (MP_STATE_MEM(gc_compact_len) != 0) {
+                gc_compact_note(ptrs, ptr);
+            }
+            #endif
             // If this is a heap pointer that hasn't been marked, mark it and push
             // it's children to the stack.
             #if MICROPY_GC_SPLIT_HEAP
@@ -471,6 +1130,12 @@ static void MP_NO_INSTRUMENT PLACE_IN_ITCM(gc_mark_subtree)(size_t block)
                 // This block is already marked.
                 continue;
             }
+            // CIRCUITPY-CHANGE: a minor collection only marks the nursery
+            #if MICROPY_GC_NURSERY
+            if (MP_STATE_MEM(gc_minor) && !GC_BLOCK_IN_NURSERY(ptr_area, ptr_block)) {
+                continue;
+            }
+            #endif
             // An unmarked head. Mark it, and push it on gc stack.
             TRACE_MARK(ptr_block, ptr);
             ATB_HEAD_TO_MARK(ptr_area, ptr_block);
@@ -520,74 +1185,449 @@ static void gc_deal_with_stack_overflow(void) {
     }
 }
 
-static void gc_sweep(void) {
-    #if MICROPY_PY_GC_COLLECT_RETVAL
-    MP_STATE_MEM(gc_collected) = 0;
-    #endif
-    // free unmarked heads and their tails
-    int free_tail = 0;
-    #if MICROPY_GC_SPLIT_HEAP_AUTO
-    mp_state_mem_area_t *prev_area = NULL;
-    #endif
-    for (mp_state_mem_area_t *area = &MP_STATE_MEM(area); area != NULL; area = NEXT_AREA(area)) {
-        size_t end_block = area->gc_alloc_table_byte_len * BLOCKS_PER_ATB;
-        if (area->gc_last_used_block < end_block) {
-            end_block = area->gc_last_used_block + 1;
-        }
-
-        size_t last_used_block = 0;
+// CIRCUITPY-CHANGE
+#if MICROPY_GC_PARALLEL_MARK
+// Parallel marking. Each thread marks from its own stack, and takes entries
+// from the shared stacks, its own first, when that runs out. As other threads
+// mark blocks in the same ATB bytes, the ATB is only read and changed with
+// atomic operations here. The heap itself doesn't change while marking.
 
-        for (size_t block = 0; block < end_block; block++) {
-            MICROPY_GC_HOOK_LOOP(block);
-            switch (ATB_GET_KIND(area, block)) {
-                case AT_HEAD:
-                    #if MICROPY_ENABLE_FINALISER
-                    if (FTB_GET(area, block)) {
-                        mp_obj_base_t *obj = (mp_obj_base_t *)PTR_FROM_BLOCK(area, block);
-                        if (obj->type != NULL) {
-                            // if the object has a type then see if it has a __del__ method
-                            mp_obj_t dest[2];
-                            mp_load_method_maybe(MP_OBJ_FROM_PTR(obj), MP_QSTR___del__, dest);
-                            if (dest[0] != MP_OBJ_NULL) {
-                                // load_method returned a method, execute it in a protected environment
-                                #if MICROPY_ENABLE_SCHEDULER
-                                mp_sched_lock();
-                                #endif
-                                mp_call_function_1_protected(dest[0], dest[1]);
-                                #if MICROPY_ENABLE_SCHEDULER
-                                mp_sched_unlock();
-                                #endif
-                            }
-                        }
-                        // clear finaliser flag
-                        FTB_CLEAR(area, block);
-                    }
-                    #endif
-                    free_tail = 1;
-                    DEBUG_printf("gc_sweep(%p)\n", (void *)PTR_FROM_BLOCK(area, block));
-                    #if MICROPY_PY_GC_COLLECT_RETVAL
-                    MP_STATE_MEM(gc_collected)++;
-                    #endif
-                    // fall through to free the head
-                    MP_FALLTHROUGH
+#if MICROPY_GC_SPLIT_HEAP
+#define GC_MARK_ENTRY_AREA(entry) ((entry)->area)
+#else
+#define GC_MARK_ENTRY_AREA(entry) (&MP_STATE_MEM(area))
+#endif
 
-                case AT_TAIL:
-                    if (free_tail) {
-                        ATB_ANY_TO_FREE(area, block);
-                        #if CLEAR_ON_SWEEP
-                        memset((void *)PTR_FROM_BLOCK(area, block), 0, BYTES_PER_BLOCK);
-                        #endif
-                    } else {
-                        last_used_block = block;
-                    }
-                    break;
+static inline int gc_mark_get_kind(mp_state_mem_area_t *area, size_t block) {
+    byte atb = __atomic_load_n(&area->gc_alloc_table_start[block / BLOCKS_PER_ATB], __ATOMIC_RELAXED);
+    return (atb >> BLOCK_SHIFT(block)) & 3;
+}
 
-                case AT_MARK:
-                    ATB_MARK_TO_HEAD(area, block);
-                    free_tail = 0;
-                    last_used_block = block;
-                    break;
+// Marks a head, returning whether it was this thread that marked it
+static inline bool gc_mark_head(mp_state_mem_area_t *area, size_t block) {
+    if (gc_mark_get_kind(area, block) != AT_HEAD) {
+        return false;
+    }
+    byte atb = __atomic_fetch_or(&area->gc_alloc_table_start[block / BLOCKS_PER_ATB],
+        AT_MARK << BLOCK_SHIFT(block), __ATOMIC_RELAXED);
+    return ((atb >> BLOCK_SHIFT(block)) & 3) == AT_HEAD;
+}
+
+static void gc_mark_lock(mp_gc_mark_thread_t *t) {
+    while (__atomic_test_and_set(&t->lock, __ATOMIC_ACQUIRE)) {
+        while (__atomic_load_n(&t->lock, __ATOMIC_RELAXED)) {
+        }
+    }
+}
+
+static void gc_mark_unlock(mp_gc_mark_thread_t *t) {
+    __atomic_clear(&t->lock, __ATOMIC_RELEASE);
+}
+
+// Move the oldest half of the thread's own entries to its shared stack, as
+// far as there is room
+static void gc_mark_share(mp_gc_mark_thread_t *t) {
+    gc_mark_lock(t);
+    size_t n = MIN(t->n_own / 2, MICROPY_ALLOC_GC_STACK_SIZE - t->n_shared);
+    memcpy(&t->shared[t->n_shared], t->own, n * sizeof(mp_gc_mark_entry_t));
+    __atomic_store_n(&t->n_shared, t->n_shared + n, __ATOMIC_RELAXED);
+    gc_mark_unlock(t);
+    t->n_own -= n;
+    memmove(t->own, &t->own[n], t->n_own * sizeof(mp_gc_mark_entry_t));
+}
+
+// Take half of the entries on the shared stack of another thread, or of this
+// one, when this thread's own stack is empty. Returns whether there were any.
+static bool gc_mark_take(mp_gc_mark_thread_t *t, mp_gc_mark_thread_t *from) {
+    if (__atomic_load_n(&from->n_shared, __ATOMIC_RELAXED) == 0) {
+        return false;
+    }
+    gc_mark_lock(from);
+    size_t n = (from->n_shared + 1) / 2;
+    size_t start = from->n_shared - n;
+    memcpy(t->own, &from->shared[start], n * sizeof(mp_gc_mark_entry_t));
+    __atomic_store_n(&from->n_shared, start, __ATOMIC_RELAXED);
+    gc_mark_unlock(from);
+    t->n_own = n;
+    return n > 0;
+}
+
+static void gc_mark_push(mp_gc_mark_thread_t *t, mp_state_mem_area_t *area, size_t block) {
+    if (t->n_own == MICROPY_ALLOC_GC_STACK_SIZE) {
+        gc_mark_share(t);
+        if (t->n_own == MICROPY_ALLOC_GC_STACK_SIZE) {
+            // The block stays marked, for gc_deal_with_stack_overflow to find
+            __atomic_store_n(&MP_STATE_MEM(gc_stack_overflow), 1, __ATOMIC_RELAXED);
+            return;
+        }
+    }
+    mp_gc_mark_entry_t *entry = &t->own[t->n_own++];
+    entry->block = block;
+    #if MICROPY_GC_SPLIT_HEAP
+    entry->area = area;
+    #endif
+}
+
+// Mark the children of the block on top of the thread's own stack, as
+// gc_mark_subtree does, and share some of the stack if the thread's shared
+// stack has run out
+static void gc_mark_pop(mp_gc_mark_thread_t *t) {
+    mp_gc_mark_entry_t *entry = &t->own[--t->n_own];
+    mp_state_mem_area_t *area = GC_MARK_ENTRY_AREA(entry);
+    size_t block = entry->block;
+    bool collecting_thread = t == &MP_STATE_MEM(gc_mark_threads)[0];
+    (void)collecting_thread;
+
+    size_t n_blocks = 0;
+    do {
+        n_blocks += 1;
+    } while (gc_mark_get_kind(area, block + n_blocks) == AT_TAIL);
+
+    void **ptrs = (void **)PTR_FROM_BLOCK(area, block);
+    for (size_t i = n_blocks * BYTES_PER_BLOCK / sizeof(void *); i > 0; i--, ptrs++) {
+        if (collecting_thread) {
+            MICROPY_GC_HOOK_LOOP(i);
+        }
+        void *ptr = *ptrs;
+        #if MICROPY_GC_SPLIT_HEAP
+        mp_state_mem_area_t *ptr_area = gc_get_ptr_area(ptr);
+        if (!ptr_area) {
+            continue;
+        }
+        #else
+        if (!VERIFY_PTR(ptr)) {
+            continue;
+        }
+        mp_state_mem_area_t *ptr_area = area;
+        #endif
+        size_t ptr_block = BLOCK_FROM_PTR(ptr_area, ptr);
+        #if MICROPY_GC_NURSERY
+        if (MP_STATE_MEM(gc_minor) && !GC_BLOCK_IN_NURSERY(ptr_area, ptr_block)) {
+            continue;
+        }
+        #endif
+        if (gc_mark_head(ptr_area, ptr_block)) {
+            TRACE_MARK(ptr_block, ptr);
+            gc_mark_push(t, ptr_area, ptr_block);
+        }
+    }
+
+    if (t->n_own > 1 && __atomic_load_n(&t->n_shared, __ATOMIC_RELAXED) == 0) {
+        gc_mark_share(t);
+    }
+}
+
+static bool gc_mark_any_shared(void) {
+    for (size_t i = 0; i < MP_STATE_MEM(gc_mark_n_threads); i++) {
+        if (__atomic_load_n(&MP_STATE_MEM(gc_mark_threads)[i].n_shared, __ATOMIC_RELAXED) != 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Mark until every thread is out of work. The collecting thread only runs
+// this once it has marked all the roots, so until then the others keep
+// waiting for more.
+static void gc_mark_run(size_t index) {
+    mp_gc_mark_thread_t *threads = MP_STATE_MEM(gc_mark_threads);
+    mp_gc_mark_thread_t *t = &threads[index];
+    for (;;) {
+        while (t->n_own > 0) {
+            gc_mark_pop(t);
+        }
+        size_t n_threads = __atomic_load_n(&MP_STATE_MEM(gc_mark_n_threads), __ATOMIC_SEQ_CST);
+        bool found = false;
+        for (size_t i = 0; i < n_threads && !found; i++) {
+            found = gc_mark_take(t, &threads[(index + i) % n_threads]);
+        }
+        if (found) {
+            continue;
+        }
+        // Only a thread with work shares any, so once all of them are out of
+        // work, none can get any more
+        __atomic_add_fetch(&MP_STATE_MEM(gc_mark_n_idle), 1, __ATOMIC_SEQ_CST);
+        for (;;) {
+            if (__atomic_load_n(&MP_STATE_MEM(gc_mark_n_idle), __ATOMIC_SEQ_CST)
+                == __atomic_load_n(&MP_STATE_MEM(gc_mark_n_threads), __ATOMIC_SEQ_CST)) {
+                return;
+            }
+            if (gc_mark_any_shared()) {
+                __atomic_sub_fetch(&MP_STATE_MEM(gc_mark_n_idle), 1, __ATOMIC_SEQ_CST);
+                break;
             }
+            MICROPY_GC_MARK_IDLE_HOOK();
+        }
+    }
+}
+
+void gc_mark_helper(size_t index) {
+    gc_mark_run(index);
+}
+
+// Start the helpers at the start of a collection
+static void gc_mark_parallel_start(void) {
+    MP_STATE_MEM(gc_mark_parallel) = false;
+    #if MICROPY_GC_COMPACT
+    // Compaction notes where pointers are as it marks, which isn't thread safe
+    if (MP_STATE_MEM(gc_compact_len) != 0) {
+        return;
+    }
+    #endif
+    for (size_t i = 0; i < MICROPY_GC_MARK_THREADS; i++) {
+        mp_gc_mark_thread_t *t = &MP_STATE_MEM(gc_mark_threads)[i];
+        t->lock = 0;
+        t->n_shared = 0;
+        t->n_own = 0;
+    }
+    // The collecting thread isn't idle until it has marked all the roots, so
+    // the helpers can't finish before then, however many of them start
+    MP_STATE_MEM(gc_mark_n_idle) = 0;
+    __atomic_store_n(&MP_STATE_MEM(gc_mark_n_threads), MICROPY_GC_MARK_THREADS, __ATOMIC_SEQ_CST);
+    size_t n_helpers = gc_mark_helpers_start(MICROPY_GC_MARK_THREADS - 1);
+    __atomic_store_n(&MP_STATE_MEM(gc_mark_n_threads), n_helpers + 1, __ATOMIC_SEQ_CST);
+    MP_STATE_MEM(gc_mark_parallel) = n_helpers > 0;
+}
+
+// Mark a root, sharing it with the helpers, and mark from the collecting
+// thread's stack if it is getting full
+static void gc_mark_parallel_root(mp_state_mem_area_t *area, size_t block) {
+    mp_gc_mark_thread_t *t = &MP_STATE_MEM(gc_mark_threads)[0];
+    if (!gc_mark_head(area, block)) {
+        return;
+    }
+    gc_mark_push(t, area, block);
+    while (t->n_own > MICROPY_ALLOC_GC_STACK_SIZE / 2) {
+        gc_mark_pop(t);
+    }
+    if (t->n_own > 1 && __atomic_load_n(&t->n_shared, __ATOMIC_RELAXED) == 0) {
+        gc_mark_share(t);
+    }
+}
+
+// Once all the roots are marked, help mark the rest and wait for the helpers
+static void gc_mark_parallel_end(void) {
+    if (!MP_STATE_MEM(gc_mark_parallel)) {
+        return;
+    }
+    gc_mark_run(0);
+    gc_mark_helpers_wait();
+    MP_STATE_MEM(gc_mark_parallel) = false;
+}
+#endif
+
+// CIRCUITPY-CHANGE
+// A run of free blocks found while sweeping, used to rebuild the size class
+// hints from where free runs first reach each size
+typedef struct {
+    size_t start;
+    size_t len;
+    size_t classes_found;
+} gc_sweep_free_run_t;
+
+// An incremental sweep has no run: the hints are moved back as blocks are
+// freed instead, since allocations may already have used the space before.
+static inline void gc_sweep_free_blocks(mp_state_mem_area_t *area, gc_sweep_free_run_t *run, size_t block, size_t n) {
+    if (run == NULL) {
+        return;
+    }
+    if (run->len == 0) {
+        run->start = block;
+    }
+    run->len += n;
+    while (run->classes_found < MICROPY_GC_ALLOC_SIZE_CLASSES && run->len > run->classes_found) {
+        area->gc_first_free_atb_index[run->classes_found++] = run->start / BLOCKS_PER_ATB;
+    }
+}
+
+static inline void gc_sweep_used_block(gc_sweep_free_run_t *run, size_t *last_used_block, size_t block) {
+    if (run != NULL) {
+        run->len = 0;
+    }
+    *last_used_block = block;
+}
+
+// Sweep a word of the ATB in one go, if it is simple enough: free blocks
+// only, tails only, marked objects only, or unmarked objects without
+// finalisers only. Returns false, having done nothing, if it isn't.
+static bool gc_sweep_word(mp_state_mem_area_t *area, size_t block, int *free_tail,
+    gc_sweep_free_run_t *run, size_t *last_used_block) {
+    byte *atb = &area->gc_alloc_table_start[block / BLOCKS_PER_ATB];
+    atb_word_t w = atb_word_get(atb);
+    atb_word_t heads = ATB_WORD_HEADS(w);
+    atb_word_t marks = ATB_WORD_MARKS(w);
+    atb_word_t swept;
+    if (heads == 0 && marks == 0) {
+        // free blocks and the tails of the object before
+        swept = *free_tail ? 0 : w;
+    } else if (heads == 0 && !*free_tail) {
+        // marked objects only, which become unmarked
+        swept = w ^ (marks << 1);
+    } else if (marks == 0 && *free_tail) {
+        // unmarked objects only, which are freed unless they have finalisers
+        #if MICROPY_ENABLE_FINALISER
+        for (size_t i = 0; i < BLOCKS_PER_ATB_WORD / BLOCKS_PER_FTB; i++) {
+            if (area->gc_finaliser_table_start[block / BLOCKS_PER_FTB + i] != 0) {
+                return false;
+            }
+        }
+        #endif
+        #if MICROPY_PY_GC_COLLECT_RETVAL
+        MP_STATE_MEM(gc_collected) += __builtin_popcountl(heads);
+        #endif
+        swept = 0;
+    } else {
+        return false;
+    }
+    if (swept != w) {
+        atb_word_set(atb, swept);
+        #if CLEAR_ON_SWEEP
+        if (swept == 0) {
+            memset((void *)PTR_FROM_BLOCK(area, block), 0, BLOCKS_PER_ATB_WORD * BYTES_PER_BLOCK);
+        }
+        #endif
+    }
+
+    atb_word_t used = ATB_WORD_USED(swept);
+    if (run == NULL && used != ATB_WORD_USED(w)) {
+        gc_free_hints_lower(area, block);
+    }
+    if (used == 0) {
+        gc_sweep_free_blocks(area, run, block, BLOCKS_PER_ATB_WORD);
+    } else if (used == ATB_WORD_LOW_BITS) {
+        gc_sweep_used_block(run, last_used_block, block + BLOCKS_PER_ATB_WORD - 1);
+    } else {
+        for (size_t b = block; b < block + BLOCKS_PER_ATB_WORD; b++) {
+            if (ATB_GET_KIND(area, b) == AT_FREE) {
+                gc_sweep_free_blocks(area, run, b, 1);
+            } else {
+                gc_sweep_used_block(run, last_used_block, b);
+            }
+        }
+    }
+    return true;
+}
+
+#if MICROPY_ENABLE_FINALISER
+// Run the finaliser of the object whose head is block, if it has one, and
+// clear its finaliser flag
+static void gc_run_finaliser(mp_state_mem_area_t *area, size_t block) {
+    mp_obj_base_t *obj = (mp_obj_base_t *)PTR_FROM_BLOCK(area, block);
+    if (obj->type != NULL) {
+        // if the object has a type then see if it has a __del__ method
+        mp_obj_t dest[2];
+        mp_load_method_maybe(MP_OBJ_FROM_PTR(obj), MP_QSTR___del__, dest);
+        if (dest[0] != MP_OBJ_NULL) {
+            // load_method returned a method, execute it in a protected environment
+            #if MICROPY_ENABLE_SCHEDULER
+            mp_sched_lock();
+            #endif
+            mp_call_function_1_protected(dest[0], dest[1]);
+            #if MICROPY_ENABLE_SCHEDULER
+            mp_sched_unlock();
+            #endif
+        }
+    }
+    // clear finaliser flag
+    FTB_CLEAR(area, block);
+}
+#endif
+
+// Sweep the blocks of an area from block up to end_block, taking the number
+// swept from the budget. Once that runs out, stop at the next object, and
+// return the first block not swept. Stopping only between objects means that
+// the tail blocks following on from where a sweep resumes belong to a live
+// object.
+static size_t gc_sweep_blocks(mp_state_mem_area_t *area, size_t block, size_t end_block,
+    size_t *budget, gc_sweep_free_run_t *run, size_t *last_used_block) {
+    int free_tail = 0;
+    bool words = ATB_WORD_ALIGNED(area->gc_alloc_table_start);
+
+    for (; block < end_block; block++) {
+        MICROPY_GC_HOOK_LOOP(block);
+        if (*budget == 0 && ATB_GET_KIND(area, block) != AT_TAIL) {
+            break;
+        }
+        // CIRCUITPY-CHANGE: a word at a time where possible
+        if (words && block % BLOCKS_PER_ATB_WORD == 0 && block + BLOCKS_PER_ATB_WORD <= end_block
+            && gc_sweep_word(area, block, &free_tail, run, last_used_block)) {
+            block += BLOCKS_PER_ATB_WORD - 1;
+            *budget -= MIN(*budget, BLOCKS_PER_ATB_WORD);
+            continue;
+        }
+        bool block_free = true;
+        switch (ATB_GET_KIND(area, block)) {
+            case AT_HEAD:
+                #if MICROPY_ENABLE_FINALISER
+                if (FTB_GET(area, block)) {
+                    gc_run_finaliser(area, block);
+                }
+                #endif
+                free_tail = 1;
+                DEBUG_printf("gc_sweep(%p)\n", (void *)PTR_FROM_BLOCK(area, block));
+                #if MICROPY_PY_GC_COLLECT_RETVAL
+                MP_STATE_MEM(gc_collected)++;
+                #endif
+                if (run == NULL) {
+                    gc_free_hints_lower(area, block);
+                }
+                // fall through to free the head
+                MP_FALLTHROUGH
+
+            case AT_TAIL:
+                if (free_tail) {
+                    ATB_ANY_TO_FREE(area, block);
+                    #if CLEAR_ON_SWEEP
+                    memset((void *)PTR_FROM_BLOCK(area, block), 0, BYTES_PER_BLOCK);
+                    #endif
+                } else {
+                    block_free = false;
+                }
+                break;
+
+            case AT_MARK:
+                ATB_MARK_TO_HEAD(area, block);
+                free_tail = 0;
+                block_free = false;
+                break;
+        }
+
+        if (block_free) {
+            gc_sweep_free_blocks(area, run, block, 1);
+        } else {
+            gc_sweep_used_block(run, last_used_block, block);
+        }
+        *budget -= MIN(*budget, 1);
+    }
+    return block;
+}
+
+static void gc_sweep(void) {
+    #if MICROPY_PY_GC_COLLECT_RETVAL
+    MP_STATE_MEM(gc_collected) = 0;
+    #endif
+    // free unmarked heads and their tails
+    #if MICROPY_GC_SPLIT_HEAP_AUTO
+    mp_state_mem_area_t *prev_area = NULL;
+    #endif
+    for (mp_state_mem_area_t *area = &MP_STATE_MEM(area); area != NULL; area = NEXT_AREA(area)) {
+        size_t end_block = area->gc_alloc_table_byte_len * BLOCKS_PER_ATB;
+        if (area->gc_last_used_block < end_block) {
+            end_block = area->gc_last_used_block + 1;
+        }
+
+        size_t last_used_block = 0;
+        // CIRCUITPY-CHANGE
+        gc_sweep_free_run_t run = { 0, 0, 0 };
+        size_t budget = SIZE_MAX;
+        gc_sweep_blocks(area, 0, end_block, &budget, &run, &last_used_block);
+
+        // Everything after end_block is free
+        if (run.len == 0) {
+            run.start = end_block;
+        }
+        while (run.classes_found < MICROPY_GC_ALLOC_SIZE_CLASSES) {
+            area->gc_first_free_atb_index[run.classes_found++] = run.start / BLOCKS_PER_ATB;
         }
 
         area->gc_last_used_block = last_used_block;
@@ -605,14 +1645,617 @@ static void gc_sweep(void) {
     }
 }
 
+#if MICROPY_GC_INCREMENTAL_SWEEP
+// CIRCUITPY-CHANGE
+// Leave the heap as marking left it, to be swept by gc_sweep_incremental,
+// once the finalisers of everything it will free have run. Running them all
+// now, with the GC locked, means that none of them can find that another
+// object it looks at has been freed and its blocks allocated again.
+static void gc_sweep_start_incremental(void) {
+    #if MICROPY_PY_GC_COLLECT_RETVAL
+    MP_STATE_MEM(gc_collected) = 0;
+    #endif
+    #if MICROPY_ENABLE_FINALISER
+    for (mp_state_mem_area_t *area = &MP_STATE_MEM(area); area != NULL; area = NEXT_AREA(area)) {
+        size_t ftb_len = area->gc_last_used_block / BLOCKS_PER_FTB + 1;
+        for (size_t ftb = 0; ftb < ftb_len; ftb++) {
+            MICROPY_GC_HOOK_LOOP(ftb);
+            byte bits = area->gc_finaliser_table_start[ftb];
+            for (size_t block = ftb * BLOCKS_PER_FTB; bits != 0; block++, bits >>= 1) {
+                if ((bits & 1) && ATB_GET_KIND(area, block) == AT_HEAD) {
+                    gc_run_finaliser(area, block);
+                }
+            }
+        }
+    }
+    #endif
+    for (mp_state_mem_area_t *area = &MP_STATE_MEM(area); area != NULL; area = NEXT_AREA(area)) {
+        area->gc_sweep_block = 0;
+    }
+    MP_STATE_MEM(gc_sweep_area) = &MP_STATE_MEM(area);
+    MP_STATE_MEM(gc_sweep_last_used_block) = 0;
+}
+
+// Sweep about budget blocks more of a pending incremental sweep, if there is
+// one. The caller must hold the GC and have it locked. There are no
+// finalisers left to run.
+static void gc_sweep_incremental(size_t budget) {
+    for (mp_state_mem_area_t *area = MP_STATE_MEM(gc_sweep_area); area != NULL; area = NEXT_AREA(area)) {
+        MP_STATE_MEM(gc_sweep_area) = area;
+        if (area->gc_sweep_block == SIZE_MAX) {
+            // added since the collection, so there is nothing to sweep
+            continue;
+        }
+
+        // Allocations during the sweep move the end along
+        size_t end_block = area->gc_alloc_table_byte_len * BLOCKS_PER_ATB;
+        if (area->gc_last_used_block < end_block) {
+            end_block = area->gc_last_used_block + 1;
+        }
+        area->gc_sweep_block = gc_sweep_blocks(area, area->gc_sweep_block, end_block, &budget,
+            NULL, &MP_STATE_MEM(gc_sweep_last_used_block));
+
+        #if MICROPY_GC_SPLIT_HEAP
+        // See comment in gc_free.
+        MP_STATE_MEM(gc_last_free_area) = &MP_STATE_MEM(area);
+        #endif
+
+        if (area->gc_sweep_block < end_block) {
+            return;
+        }
+        // Done with this area. Empty areas are left for the next full sweep
+        // to free.
+        area->gc_sweep_block = SIZE_MAX;
+        area->gc_last_used_block = MP_STATE_MEM(gc_sweep_last_used_block);
+        MP_STATE_MEM(gc_sweep_last_used_block) = 0;
+    }
+    #if MICROPY_GC_NURSERY
+    if (MP_STATE_MEM(gc_sweep_area) != NULL) {
+        // what was allocated in the nursery since the collection is old now
+        gc_nursery_remember_all();
+        gc_nursery_place();
+    }
+    #endif
+    MP_STATE_MEM(gc_sweep_area) = NULL;
+}
+
+// Blocks that an allocation has just taken, that may be before where the
+// sweep has got to in its area
+static inline void gc_sweep_note_used(mp_state_mem_area_t *area, size_t end_block) {
+    if (area == MP_STATE_MEM(gc_sweep_area)) {
+        MP_STATE_MEM(gc_sweep_last_used_block) = MAX(MP_STATE_MEM(gc_sweep_last_used_block), end_block);
+    }
+}
+#endif
+
+// CIRCUITPY-CHANGE
+// Mark the object whose head is block, if it isn't already, and its children
+static void gc_mark_root_block(mp_state_mem_area_t *area, size_t block) {
+    #if MICROPY_GC_PARALLEL_MARK
+    if (MP_STATE_MEM(gc_mark_parallel)) {
+        gc_mark_parallel_root(area, block);
+        return;
+    }
+    #endif
+    if (ATB_GET_KIND(area, block) == AT_HEAD) {
+        // An unmarked head: mark it, and mark all its children
+        ATB_HEAD_TO_MARK(area, block);
+        #if MICROPY_GC_SPLIT_HEAP
+        gc_mark_subtree(area, block);
+        #else
+        gc_mark_subtree(block);
+        #endif
+    }
+}
+
+#if MICROPY_GC_INCREMENTAL_MARK
+// CIRCUITPY-CHANGE
+// Incremental marking. The collection that starts it marks what the roots
+// point to, and remembers it, as what has it may still fill it in without the
+// write barrier. Slices then look in what is marked, as gc_mark_subtree does,
+// marking what that points to in turn, while objects allocated meanwhile are
+// marked and remembered. The collection that finishes marking looks in all the
+// remembered blocks of marked objects, and in marked objects that the roots
+// point to then, for what was stored in them since marking started.
+
+// Mark the object whose head is block, for a slice to look in later. If there
+// is no room left on the stack, it is remembered instead, for the slices to
+// find once the stack is empty.
+static void gc_mark_later(mp_state_mem_area_t *area, size_t block) {
+    ATB_HEAD_TO_MARK(area, block);
+    size_t sp = MP_STATE_MEM(gc_mark_sp);
+    if (sp == MICROPY_ALLOC_GC_STACK_SIZE) {
+        gc_remember_head(area, block);
+        MP_STATE_MEM(gc_stack_overflow) = 1;
+        return;
+    }
+    MP_STATE_MEM(gc_block_stack)[sp] = block;
+    #if MICROPY_GC_SPLIT_HEAP
+    MP_STATE_MEM(gc_area_stack)[sp] = area;
+    #endif
+    MP_STATE_MEM(gc_mark_sp) = sp + 1;
+}
+
+// Mark what blocks block up to end_block point to: now, with their children,
+// or for a slice to look in later
+static void gc_mark_from_blocks(mp_state_mem_area_t *area, size_t block, size_t end_block, bool later) {
+    void **ptrs = (void **)PTR_FROM_BLOCK(area, block);
+    for (size_t i = (end_block - block) * BYTES_PER_BLOCK / sizeof(void *); i > 0; i--, ptrs++) {
+        MICROPY_GC_HOOK_LOOP(i);
+        void *ptr = *ptrs;
+        #if MICROPY_GC_SPLIT_HEAP
+        mp_state_mem_area_t *ptr_area = gc_get_ptr_area(ptr);
+        if (!ptr_area) {
+            continue;
+        }
+        #else
+        if (!VERIFY_PTR(ptr)) {
+            continue;
+        }
+        mp_state_mem_area_t *ptr_area = area;
+        #endif
+        size_t ptr_block = BLOCK_FROM_PTR(ptr_area, ptr);
+        if (ATB_GET_KIND(ptr_area, ptr_block) != AT_HEAD) {
+            continue;
+        }
+        if (later) {
+            gc_mark_later(ptr_area, ptr_block);
+        } else {
+            gc_mark_root_block(ptr_area, ptr_block);
+        }
+    }
+}
+
+// Whether block is part of a marked object. Blocks are asked about in order,
+// with *prev the one asked about last, so the walk back to the head of a tail
+// block never goes back over the same blocks.
+static bool gc_mark_block_is_marked(mp_state_mem_area_t *area, size_t block, size_t *prev, bool *prev_marked) {
+    size_t head = block;
+    while (head > 0 && head - 1 != *prev && ATB_GET_KIND(area, head) == AT_TAIL) {
+        head--;
+    }
+    int kind = ATB_GET_KIND(area, head);
+    bool marked = kind == AT_TAIL ? *prev_marked : kind == AT_MARK;
+    *prev = block;
+    *prev_marked = marked;
+    return marked;
+}
+
+// Look in about budget blocks for what is still to be marked: first the
+// objects on the stack, and then the remembered blocks of marked objects,
+// which include those that didn't fit on it. Returns whether there is
+// nothing left for slices to do.
+static bool gc_mark_incremental(size_t budget) {
+    for (;;) {
+        while (MP_STATE_MEM(gc_mark_sp) > 0) {
+            if (budget == 0) {
+                return false;
+            }
+            size_t sp = --MP_STATE_MEM(gc_mark_sp);
+            size_t block = MP_STATE_MEM(gc_block_stack)[sp];
+            #if MICROPY_GC_SPLIT_HEAP
+            mp_state_mem_area_t *area = MP_STATE_MEM(gc_area_stack)[sp];
+            #else
+            mp_state_mem_area_t *area = &MP_STATE_MEM(area);
+            #endif
+            if (ATB_GET_KIND(area, block) != AT_MARK) {
+                // freed since
+                continue;
+            }
+            size_t end_block = block + 1;
+            while (ATB_GET_KIND(area, end_block) == AT_TAIL) {
+                end_block++;
+            }
+            gc_mark_from_blocks(area, block, end_block, true);
+            budget -= MIN(budget, end_block - block);
+        }
+
+        if (MP_STATE_MEM(gc_mark_walk_area) == NULL) {
+            if (!MP_STATE_MEM(gc_stack_overflow)) {
+                return true;
+            }
+            MP_STATE_MEM(gc_stack_overflow) = 0;
+            MP_STATE_MEM(gc_mark_walk_area) = &MP_STATE_MEM(area);
+            MP_STATE_MEM(gc_mark_walk_block) = 0;
+        }
+
+        // The remembered bits are left set, for the collection that finishes
+        // marking, as what the roots pointed to is among them
+        mp_state_mem_area_t *area = MP_STATE_MEM(gc_mark_walk_area);
+        size_t block = MP_STATE_MEM(gc_mark_walk_block);
+        size_t prev = SIZE_MAX;
+        bool prev_marked = false;
+        while (MP_STATE_MEM(gc_mark_sp) == 0 && budget > 0) {
+            if (block > area->gc_last_used_block) {
+                area = NEXT_AREA(area);
+                block = 0;
+                prev = SIZE_MAX;
+                if (area == NULL) {
+                    break;
+                }
+                continue;
+            }
+            budget--;
+            if (block % BLOCKS_PER_RTB == 0 && area->gc_remembered_table_start[block / BLOCKS_PER_RTB] == 0) {
+                block += BLOCKS_PER_RTB;
+                continue;
+            }
+            if (RTB_GET(area, block) && gc_mark_block_is_marked(area, block, &prev, &prev_marked)) {
+                gc_mark_from_blocks(area, block, block + 1, true);
+            }
+            block++;
+        }
+        MP_STATE_MEM(gc_mark_walk_area) = area;
+        MP_STATE_MEM(gc_mark_walk_block) = block;
+        if (area != NULL && budget == 0) {
+            return false;
+        }
+    }
+}
+
+// Unmark everything, and forget incremental marking, if it is under way
+static void gc_mark_abandon(void) {
+    if (MP_STATE_MEM(gc_mark_phase) != GC_MARK_SLICES) {
+        return;
+    }
+    for (mp_state_mem_area_t *area = &MP_STATE_MEM(area); area != NULL; area = NEXT_AREA(area)) {
+        for (size_t block = 0; block <= area->gc_last_used_block; block++) {
+            if (ATB_GET_KIND(area, block) == AT_MARK) {
+                ATB_MARK_TO_HEAD(area, block);
+            }
+        }
+    }
+    MP_STATE_MEM(gc_mark_sp) = 0;
+    MP_STATE_MEM(gc_mark_walk_area) = NULL;
+    MP_STATE_MEM(gc_stack_overflow) = 0;
+    MP_STATE_MEM(gc_mark_phase) = GC_MARK_AT_ONCE;
+}
+
+// Work out how the collection starting marks, from what was asked for and
+// whether incremental marking is under way
+static void gc_mark_phase_start(void) {
+    bool incremental = MP_STATE_THREAD(gc_collect_incremental);
+    MP_STATE_THREAD(gc_collect_incremental) = false;
+    if (MP_STATE_MEM(gc_mark_phase) == GC_MARK_SLICES) {
+        bool for_alloc = MP_STATE_MEM(gc_sweep_lazily);
+        #if MICROPY_GC_NURSERY
+        for_alloc = for_alloc || MP_STATE_MEM(gc_minor);
+        MP_STATE_MEM(gc_minor) = false;
+        #endif
+        if (for_alloc) {
+            // An allocation finishes the marking under way
+            MP_STATE_MEM(gc_mark_phase) = GC_MARK_FINISHING;
+            MP_STATE_MEM(gc_sweep_lazily) = true;
+            return;
+        }
+        // Anything else, such as gc.collect(), is to free all the garbage
+        // there is now, including what has become garbage since marking
+        // started, so starts again
+        gc_mark_abandon();
+    }
+    #if MICROPY_GC_NURSERY
+    incremental = incremental && !MP_STATE_MEM(gc_minor);
+    #endif
+    if (incremental) {
+        MP_STATE_MEM(gc_mark_phase) = GC_MARK_STARTING;
+    }
+}
+
+// Before the collection that finishes marking looks at the roots, look in the
+// remembered blocks of marked objects, and forget them. The objects still on
+// the stack are among them.
+static void gc_mark_finish_start(void) {
+    while (MP_STATE_MEM(gc_mark_sp) > 0) {
+        size_t sp = --MP_STATE_MEM(gc_mark_sp);
+        #if MICROPY_GC_SPLIT_HEAP
+        gc_remember_head(MP_STATE_MEM(gc_area_stack)[sp], MP_STATE_MEM(gc_block_stack)[sp]);
+        #else
+        gc_remember_head(&MP_STATE_MEM(area), MP_STATE_MEM(gc_block_stack)[sp]);
+        #endif
+    }
+    MP_STATE_MEM(gc_mark_walk_area) = NULL;
+    for (mp_state_mem_area_t *area = &MP_STATE_MEM(area); area != NULL; area = NEXT_AREA(area)) {
+        size_t rtb_len = area->gc_last_used_block / BLOCKS_PER_RTB + 1;
+        size_t prev = SIZE_MAX;
+        bool prev_marked = false;
+        for (size_t rtb = 0; rtb < rtb_len; rtb++) {
+            MICROPY_GC_HOOK_LOOP(rtb);
+            byte bits = area->gc_remembered_table_start[rtb];
+            if (bits == 0) {
+                continue;
+            }
+            area->gc_remembered_table_start[rtb] = 0;
+            for (size_t block = rtb * BLOCKS_PER_RTB; bits != 0; block++, bits >>= 1) {
+                if ((bits & 1) && gc_mark_block_is_marked(area, block, &prev, &prev_marked)) {
+                    gc_mark_from_blocks(area, block, block + 1, false);
+                }
+            }
+        }
+    }
+}
+
+#if CHECK_WRITE_BARRIER
+// Report pointers from marked objects to unmarked ones
+static void gc_mark_check_barrier(void) {
+    for (mp_state_mem_area_t *area = &MP_STATE_MEM(area); area != NULL; area = NEXT_AREA(area)) {
+        bool marked = false;
+        for (size_t block = 0; block <= area->gc_last_used_block; block++) {
+            int kind = ATB_GET_KIND(area, block);
+            if (kind != AT_TAIL) {
+                marked = kind == AT_MARK;
+            }
+            if (!marked) {
+                continue;
+            }
+            void **ptrs = (void **)PTR_FROM_BLOCK(area, block);
+            for (size_t i = 0; i < BYTES_PER_BLOCK / sizeof(void *); i++) {
+                mp_state_mem_area_t *ptr_area = gc_remember_area(ptrs[i]);
+                if (ptr_area != NULL && ((uintptr_t)ptrs[i] & (BYTES_PER_BLOCK - 1)) == 0
+                    && ATB_GET_KIND(ptr_area, BLOCK_FROM_PTR(ptr_area, ptrs[i])) == AT_HEAD) {
+                    mp_printf(&mp_plat_print, "gc: %p points to unmarked %p\n", &ptrs[i], ptrs[i]);
+                }
+            }
+        }
+    }
+}
+#endif
+
+// A root, while marking incrementally. Returns whether it has been dealt with.
+static bool gc_mark_root_incremental(mp_state_mem_area_t *area, size_t block) {
+    switch (MP_STATE_MEM(gc_mark_phase)) {
+        case GC_MARK_STARTING:
+            if (ATB_GET_KIND(area, block) == AT_HEAD) {
+                gc_mark_later(area, block);
+            }
+            gc_remember_head(area, block);
+            return true;
+        case GC_MARK_FINISHING:
+            // A marked object may have had others stored in it since, so it
+            // is looked in again, once. Being remembered, for the next
+            // collection as for the nursery, says that it has been.
+            if (!RTB_GET(area, block)) {
+                size_t end_block = gc_remember_head(area, block);
+                if (ATB_GET_KIND(area, block) == AT_MARK) {
+                    gc_mark_from_blocks(area, block, end_block, false);
+                } else {
+                    gc_mark_root_block(area, block);
+                }
+            }
+            return true;
+        default:
+            return false;
+    }
+}
+#endif
+
+#if MICROPY_GC_INCREMENTAL_SWEEP
+void gc_sweep_step(void) {
+    if (MP_STATE_THREAD(gc_lock_depth) > 0) {
+        return;
+    }
+    #if MICROPY_GC_INCREMENTAL_MARK
+    if (MP_STATE_MEM(gc_mark_phase) == GC_MARK_SLICES) {
+        GC_ENTER();
+        // checked again, with the GC held
+        if (MP_STATE_MEM(gc_mark_phase) == GC_MARK_SLICES) {
+            gc_mark_incremental(MICROPY_GC_MARK_SLICE_BLOCKS);
+        }
+        GC_EXIT();
+        return;
+    }
+    #endif
+    if (MP_STATE_MEM(gc_sweep_area) == NULL) {
+        return;
+    }
+    GC_ENTER();
+    MP_STATE_THREAD(gc_lock_depth)++;
+    gc_sweep_incremental(MICROPY_GC_SWEEP_SLICE_BLOCKS);
+    MP_STATE_THREAD(gc_lock_depth)--;
+    GC_EXIT();
+}
+#endif
+
+#if MICROPY_GC_NURSERY
+// CIRCUITPY-CHANGE
+// Find n_blocks free blocks in a row in the nursery, from where the last
+// allocation there ended. On success, returns true and sets *end_block to the
+// last of them.
+static bool gc_nursery_find(size_t n_blocks, size_t *end_block) {
+    mp_state_mem_area_t *area = &MP_STATE_MEM(area);
+    size_t n_free = 0;
+    for (size_t block = MP_STATE_MEM(gc_nursery_next); block < MP_STATE_MEM(gc_nursery_end); block++) {
+        if (ATB_GET_KIND(area, block) != AT_FREE) {
+            n_free = 0;
+        } else if (++n_free == n_blocks) {
+            MP_STATE_MEM(gc_nursery_next) = block + 1;
+            *end_block = block;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Mark what block, outside the nursery, points to in it. Telling pointers into
+// the nursery apart is a single compare, as it is one run of blocks.
+static void gc_nursery_mark_from_block(mp_state_mem_area_t *area, size_t block) {
+    mp_state_mem_area_t *nursery_area = &MP_STATE_MEM(area);
+    uintptr_t nursery_ptr = PTR_FROM_BLOCK(nursery_area, MP_STATE_MEM(gc_nursery_start));
+    uintptr_t nursery_len = (MP_STATE_MEM(gc_nursery_end) - MP_STATE_MEM(gc_nursery_start)) * BYTES_PER_BLOCK;
+    void **ptrs = (void **)PTR_FROM_BLOCK(area, block);
+    for (size_t i = 0; i < WORDS_PER_BLOCK; i++) {
+        uintptr_t offset = (uintptr_t)ptrs[i] - nursery_ptr;
+        if (offset < nursery_len && (offset & (BYTES_PER_BLOCK - 1)) == 0) {
+            gc_mark_root_block(nursery_area, MP_STATE_MEM(gc_nursery_start) + offset / BYTES_PER_BLOCK);
+        }
+    }
+}
+
+// A minor collection takes the objects outside the nursery to be live, so
+// the nursery objects that they point to are too. Apart from the old objects
+// that roots point to, only the blocks remembered since the last collection
+// can point to them: stored into through the write barrier, allocated outside
+// the nursery, or pointed to by a root of the last collection.
+static void gc_nursery_mark_from_remembered(void) {
+    for (mp_state_mem_area_t *area = &MP_STATE_MEM(area); area != NULL; area = NEXT_AREA(area)) {
+        size_t rtb_len = area->gc_last_used_block / BLOCKS_PER_RTB + 1;
+        for (size_t rtb = 0; rtb < rtb_len; rtb++) {
+            MICROPY_GC_HOOK_LOOP(rtb);
+            byte bits = area->gc_remembered_table_start[rtb];
+            if (bits == 0) {
+                continue;
+            }
+            area->gc_remembered_table_start[rtb] = 0;
+            for (size_t block = rtb * BLOCKS_PER_RTB; bits != 0; block++, bits >>= 1) {
+                if ((bits & 1) && ATB_GET_KIND(area, block) != AT_FREE && !GC_BLOCK_IN_NURSERY(area, block)) {
+                    gc_nursery_mark_from_block(area, block);
+                }
+            }
+        }
+    }
+}
+
+// What a root points to may still be being filled in, without the write
+// barrier, by the code that has it, and is old after this collection, so it
+// is remembered for the next one. In a minor collection, it is looked in now
+// too, if it is already old, rather than marked. Returns whether it was old.
+static bool gc_nursery_root(mp_state_mem_area_t *area, size_t block) {
+    if (!MP_STATE_MEM(gc_minor) || GC_BLOCK_IN_NURSERY(area, block)) {
+        gc_remember_head(area, block);
+        return false;
+    }
+    // remembered already, if it is, by a root before this one
+    if (!RTB_GET(area, block)) {
+        size_t end_block = gc_remember_head(area, block);
+        for (; block < end_block; block++) {
+            gc_nursery_mark_from_block(area, block);
+        }
+    }
+    return true;
+}
+
+#if CHECK_WRITE_BARRIER
+// Report pointers from outside the nursery to what it hasn't marked, which are
+// stores that missed the write barrier unless they are in garbage
+static void gc_nursery_check_barrier(void) {
+    mp_state_mem_area_t *nursery_area = &MP_STATE_MEM(area);
+    uintptr_t nursery_ptr = PTR_FROM_BLOCK(nursery_area, MP_STATE_MEM(gc_nursery_start));
+    uintptr_t nursery_len = (MP_STATE_MEM(gc_nursery_end) - MP_STATE_MEM(gc_nursery_start)) * BYTES_PER_BLOCK;
+    for (mp_state_mem_area_t *area = &MP_STATE_MEM(area); area != NULL; area = NEXT_AREA(area)) {
+        for (size_t block = 0; block <= area->gc_last_used_block; block++) {
+            if (ATB_GET_KIND(area, block) == AT_FREE || GC_BLOCK_IN_NURSERY(area, block)) {
+                continue;
+            }
+            void **ptrs = (void **)PTR_FROM_BLOCK(area, block);
+            for (size_t i = 0; i < WORDS_PER_BLOCK; i++) {
+                uintptr_t offset = (uintptr_t)ptrs[i] - nursery_ptr;
+                if (offset < nursery_len && (offset & (BYTES_PER_BLOCK - 1)) == 0
+                    && ATB_GET_KIND(nursery_area, MP_STATE_MEM(gc_nursery_start) + offset / BYTES_PER_BLOCK) == AT_HEAD) {
+                    mp_printf(&mp_plat_print, "gc: %p points to unmarked %p\n", &ptrs[i], ptrs[i]);
+                }
+            }
+        }
+    }
+}
+#endif
+
+// Sweep the nursery only. What survives is then old, and stays where it is,
+// while the nursery moves on to the longest free run.
+static void gc_nursery_sweep(void) {
+    mp_state_mem_area_t *area = &MP_STATE_MEM(area);
+    size_t budget = SIZE_MAX;
+    size_t last_used_block = 0;
+    gc_sweep_blocks(area, MP_STATE_MEM(gc_nursery_start), MP_STATE_MEM(gc_nursery_end),
+        &budget, NULL, &last_used_block);
+    gc_nursery_place();
+}
+#endif
+
+#if MICROPY_GC_ALLOC_CACHE
+// CIRCUITPY-CHANGE
+// Each thread claims runs of blocks from the heap with one allocation, split
+// up into objects of one size, and hands those out without the GC mutex. That
+// only changes the thread's own cache, never the ATB, so a collection just
+// stops the threads taking objects and empties their caches before marking.
+// The sweep then frees what is left of the runs.
+
+// Called with the GC mutex held. The collection clears
+// gc_alloc_cache_blocked when it ends.
+static void gc_alloc_cache_flush(void) {
+    __atomic_store_n(&MP_STATE_MEM(gc_alloc_cache_blocked), 1, __ATOMIC_SEQ_CST);
+    __atomic_store_n(&MP_STATE_MEM(gc_alloc_cache_no_run), false, __ATOMIC_RELAXED);
+    for (mp_gc_alloc_cache_t *c = MP_STATE_MEM(gc_alloc_caches); c != NULL; c = c->next_cache) {
+        // wait for a thread part way through taking an object
+        while (__atomic_load_n(&c->busy, __ATOMIC_SEQ_CST)) {
+            MICROPY_GC_ALLOC_CACHE_WAIT_HOOK();
+        }
+        memset(c->next, 0, sizeof(c->next));
+        memset(c->end, 0, sizeof(c->end));
+    }
+}
+#endif
+
 void gc_collect_start(void) {
     GC_ENTER();
     MP_STATE_THREAD(gc_lock_depth)++;
+    // CIRCUITPY-CHANGE: only the thread that asked for a minor collection has one
+    #if MICROPY_GC_NURSERY
+    MP_STATE_MEM(gc_minor) = MP_STATE_THREAD(gc_collect_minor);
+    MP_STATE_THREAD(gc_collect_minor) = false;
+    #endif
+    #if MICROPY_GC_INCREMENTAL_SWEEP
+    MP_STATE_MEM(gc_sweep_lazily) = MP_STATE_THREAD(gc_collect_lazily);
+    MP_STATE_THREAD(gc_collect_lazily) = false;
+    #endif
+    #if MICROPY_GC_INCREMENTAL_MARK
+    gc_mark_phase_start();
+    #endif
+    // CIRCUITPY-CHANGE: the caches' objects are garbage unless handed out
+    #if MICROPY_GC_ALLOC_CACHE
+    gc_alloc_cache_flush();
+    #endif
+    // CIRCUITPY-CHANGE: marking needs the heap fully swept
+    #if MICROPY_GC_INCREMENTAL_SWEEP
+    gc_sweep_incremental(SIZE_MAX);
+    #endif
     #if MICROPY_GC_ALLOC_THRESHOLD
+    // CIRCUITPY-CHANGE: the threshold is for full collections
+    #if MICROPY_GC_NURSERY
+    if (!MP_STATE_MEM(gc_minor))
+    #endif
     MP_STATE_MEM(gc_alloc_amount) = 0;
     #endif
     MP_STATE_MEM(gc_stack_overflow) = 0;
 
+    // CIRCUITPY-CHANGE
+    #if MICROPY_GC_MARK_HISTOGRAM
+    MP_STATE_MEM(gc_mark_start_us) = mp_hal_ticks_us();
+    #endif
+    #if MICROPY_GC_PARALLEL_MARK
+    // CIRCUITPY-CHANGE: the roots of incremental marking are only marked
+    #if MICROPY_GC_INCREMENTAL_MARK
+    if (MP_STATE_MEM(gc_mark_phase) != GC_MARK_STARTING)
+    #endif
+    gc_mark_parallel_start();
+    #endif
+
+    // CIRCUITPY-CHANGE: what is remembered is looked at before the roots
+    // remember anything for the next collection
+    #if MICROPY_GC_WRITE_BARRIER
+    #if MICROPY_GC_INCREMENTAL_MARK
+    if (MP_STATE_MEM(gc_mark_phase) == GC_MARK_FINISHING) {
+        gc_mark_finish_start();
+    } else
+    #endif
+    #if MICROPY_GC_NURSERY
+    if (MP_STATE_MEM(gc_minor)) {
+        gc_nursery_mark_from_remembered();
+    } else
+    #endif
+    {
+        gc_remember_clear();
+    }
+    #endif
+
     // Trace root pointers.  This relies on the root pointers being organised
     // correctly in the mp_state_ctx structure.  We scan nlr_top, dict_locals,
     // dict_globals, then the root pointer section of mp_state_vm.
@@ -621,6 +2264,12 @@ void gc_collect_start(void) {
     size_t root_end = offsetof(mp_state_ctx_t, vm.qstr_last_chunk);
     gc_collect_root(ptrs + root_start / sizeof(void *), (root_end - root_start) / sizeof(void *));
 
+    // CIRCUITPY-CHANGE: the table of movable buffers, which has no pointers
+    // in it that the GC can see
+    #if MICROPY_GC_COMPACT
+    gc_collect_root((void **)&MP_STATE_MEM(gc_movable), 1);
+    #endif
+
     #if MICROPY_ENABLE_PYSTACK
     // Trace root pointers from the Python stack.
     ptrs = (void **)(void *)MP_STATE_THREAD(pystack_start);
@@ -657,6 +2306,12 @@ void gc_collect_root(void **ptrs, size_t len) {
     for (size_t i = 0; i < len; i++) {
         MICROPY_GC_HOOK_LOOP(i);
         void *ptr = gc_get_ptr(ptrs, i);
+        // CIRCUITPY-CHANGE
+        #if MICROPY_GC_COMPACT
+        if (MP_STATE_MEM(gc_compact_len) != 0) {
+            gc_compact_note(&ptrs[i], ptr);
+        }
+        #endif
         #if MICROPY_GC_SPLIT_HEAP
         mp_state_mem_area_t *area = gc_get_ptr_area(ptr);
         if (!area) {
@@ -668,27 +2323,110 @@ void gc_collect_root(void **ptrs, size_t len) {
         }
         #endif
         size_t block = BLOCK_FROM_PTR(area, ptr);
-        if (ATB_GET_KIND(area, block) == AT_HEAD) {
-            // An unmarked head: mark it, and mark all its children
-            ATB_HEAD_TO_MARK(area, block);
-            #if MICROPY_GC_SPLIT_HEAP
-            gc_mark_subtree(area, block);
-            #else
-            gc_mark_subtree(block);
-            #endif
+        // CIRCUITPY-CHANGE
+        #if MICROPY_GC_INCREMENTAL_MARK
+        if (gc_mark_root_incremental(area, block)) {
+            continue;
+        }
+        #endif
+        // CIRCUITPY-CHANGE: a minor collection only marks the nursery
+        #if MICROPY_GC_NURSERY
+        if (gc_nursery_root(area, block)) {
+            continue;
         }
+        #endif
+        gc_mark_root_block(area, block);
+    }
+}
+
+// CIRCUITPY-CHANGE
+#if MICROPY_GC_MARK_HISTOGRAM
+static void gc_mark_histogram_add(mp_uint_t us) {
+    size_t bucket = 0;
+    while (us > 0 && bucket < MICROPY_GC_MARK_HISTOGRAM_BUCKETS - 1) {
+        us >>= 1;
+        bucket++;
     }
+    MP_STATE_MEM(gc_mark_histogram)[bucket]++;
 }
+#endif
 
 void gc_collect_end(void) {
+    // CIRCUITPY-CHANGE
+    #if MICROPY_GC_PARALLEL_MARK
+    gc_mark_parallel_end();
+    #endif
+    // CIRCUITPY-CHANGE: slices mark the rest, and the sweep waits for them
+    #if MICROPY_GC_INCREMENTAL_MARK
+    if (MP_STATE_MEM(gc_mark_phase) == GC_MARK_STARTING) {
+        #if MICROPY_GC_MARK_HISTOGRAM
+        gc_mark_histogram_add(mp_hal_ticks_us() - MP_STATE_MEM(gc_mark_start_us));
+        #endif
+        MP_STATE_MEM(gc_mark_phase) = GC_MARK_SLICES;
+        MP_STATE_MEM(gc_sweep_lazily) = false;
+        goto done;
+    }
+    if (MP_STATE_MEM(gc_mark_phase) == GC_MARK_FINISHING) {
+        MP_STATE_MEM(gc_mark_phase) = GC_MARK_AT_ONCE;
+        #if CHECK_WRITE_BARRIER
+        gc_deal_with_stack_overflow();
+        gc_mark_check_barrier();
+        #endif
+    }
+    #endif
     gc_deal_with_stack_overflow();
+    // CIRCUITPY-CHANGE
+    #if MICROPY_GC_MARK_HISTOGRAM
+    gc_mark_histogram_add(mp_hal_ticks_us() - MP_STATE_MEM(gc_mark_start_us));
+    #endif
+    // CIRCUITPY-CHANGE
+    #if MICROPY_GC_COMPACT
+    bool compacting = MP_STATE_MEM(gc_compact_len) != 0;
+    if (compacting) {
+        gc_compact_check_owners();
+    }
+    #endif
+    // CIRCUITPY-CHANGE
+    #if MICROPY_GC_NURSERY
+    bool minor = MP_STATE_MEM(gc_minor);
+    if (minor) {
+        #if CHECK_WRITE_BARRIER
+        gc_nursery_check_barrier();
+        #endif
+        MP_STATE_MEM(gc_minor) = false;
+        gc_nursery_sweep();
+    } else
+    #endif
+    #if MICROPY_GC_INCREMENTAL_SWEEP
+    if (MP_STATE_MEM(gc_sweep_lazily)) {
+        MP_STATE_MEM(gc_sweep_lazily) = false;
+        gc_sweep_start_incremental();
+    } else
+    #endif
     gc_sweep();
+    // CIRCUITPY-CHANGE
+    #if MICROPY_GC_COMPACT
+    if (compacting) {
+        gc_compact_move();
+        MP_STATE_MEM(gc_compact_len) = 0;
+    }
+    #endif
+    // CIRCUITPY-CHANGE: a pending sweep places the nursery again when it is done
+    #if MICROPY_GC_NURSERY
+    if (!minor) {
+        gc_nursery_place();
+    }
+    #endif
     #if MICROPY_GC_SPLIT_HEAP
     MP_STATE_MEM(gc_last_free_area) = &MP_STATE_MEM(area);
     #endif
-    for (mp_state_mem_area_t *area = &MP_STATE_MEM(area); area != NULL; area = NEXT_AREA(area)) {
-        area->gc_last_free_atb_index = 0;
-    }
+    // CIRCUITPY-CHANGE
+    #if MICROPY_GC_INCREMENTAL_MARK
+done:
+    #endif
+    #if MICROPY_GC_ALLOC_CACHE
+    __atomic_store_n(&MP_STATE_MEM(gc_alloc_cache_blocked), 0, __ATOMIC_RELEASE);
+    #endif
     MP_STATE_THREAD(gc_lock_depth)--;
     GC_EXIT();
 }
@@ -697,9 +2435,156 @@ void gc_sweep_all(void) {
     GC_ENTER();
     MP_STATE_THREAD(gc_lock_depth)++;
     MP_STATE_MEM(gc_stack_overflow) = 0;
+    // CIRCUITPY-CHANGE: unmark what a pending sweep hasn't reached, so that
+    // everything is freed
+    #if MICROPY_GC_INCREMENTAL_SWEEP
+    gc_sweep_incremental(SIZE_MAX);
+    MP_STATE_MEM(gc_sweep_lazily) = false;
+    #endif
+    #if MICROPY_GC_INCREMENTAL_MARK
+    gc_mark_abandon();
+    #endif
+    // CIRCUITPY-CHANGE: the table of movable buffers is freed with the rest
+    #if MICROPY_GC_COMPACT
+    MP_STATE_MEM(gc_movable) = NULL;
+    MP_STATE_MEM(gc_movable_len) = 0;
+    #endif
     gc_collect_end();
 }
 
+// CIRCUITPY-CHANGE
+#if MICROPY_GC_HEAP_WALK
+// Lock the heap, with any pending sweep finished so that every head left is live,
+// and any incremental marking given up so that none of them are marked
+static void gc_walk_enter(void) {
+    GC_ENTER();
+    MP_STATE_THREAD(gc_lock_depth)++;
+    #if MICROPY_GC_INCREMENTAL_SWEEP
+    gc_sweep_incremental(SIZE_MAX);
+    #endif
+    #if MICROPY_GC_INCREMENTAL_MARK
+    gc_mark_abandon();
+    #endif
+}
+
+static void gc_walk_exit(void) {
+    MP_STATE_THREAD(gc_lock_depth)--;
+    GC_EXIT();
+}
+
+static mp_state_mem_area_t *gc_walk_ptr_area(const void *ptr) {
+    #if MICROPY_GC_SPLIT_HEAP
+    return gc_get_ptr_area(ptr);
+    #else
+    return VERIFY_PTR(ptr) ? &MP_STATE_MEM(area) : NULL;
+    #endif
+}
+
+#if MICROPY_GC_SPLIT_HEAP
+#define GC_WALK_MARK_SUBTREE(area, block) gc_mark_subtree(area, block)
+#else
+#define GC_WALK_MARK_SUBTREE(area, block) gc_mark_subtree(block)
+#endif
+
+static size_t gc_head_bytes(mp_state_mem_area_t *area, size_t block) {
+    size_t n_blocks = 0;
+    do {
+        n_blocks += 1;
+    } while (ATB_GET_KIND(area, block + n_blocks) == AT_TAIL);
+    return n_blocks * BYTES_PER_BLOCK;
+}
+
+void gc_heap_walk(gc_heap_walk_fun_t fun, void *arg) {
+    gc_walk_enter();
+    for (mp_state_mem_area_t *area = &MP_STATE_MEM(area); area != NULL; area = NEXT_AREA(area)) {
+        size_t end_block = area->gc_alloc_table_byte_len * BLOCKS_PER_ATB;
+        for (size_t block = 0; block < end_block; block++) {
+            if (ATB_GET_KIND(area, block) == AT_HEAD) {
+                size_t n_bytes = gc_head_bytes(area, block);
+                fun((void *)PTR_FROM_BLOCK(area, block), n_bytes, arg);
+                block += n_bytes / BYTES_PER_BLOCK - 1;
+            }
+        }
+    }
+    gc_walk_exit();
+}
+
+static bool gc_walk_ptr_in(void **ptrs, size_t n_ptrs, const void *ptr) {
+    for (size_t i = 0; i < n_ptrs; i++) {
+        if (ptrs[i] == ptr) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Marks from the roots with the collector's own stack, leaving out the stops,
+// then counts and clears the marks. Stops are marked first so that marking
+// doesn't go into them.
+size_t gc_reachable_bytes(void **roots, size_t n_roots, void **stops, size_t n_stops) {
+    gc_walk_enter();
+    MP_STATE_MEM(gc_stack_overflow) = 0;
+    size_t stop_bytes = 0;
+    for (size_t i = 0; i < n_stops; i++) {
+        mp_state_mem_area_t *area = gc_walk_ptr_area(stops[i]);
+        if (area != NULL) {
+            size_t block = BLOCK_FROM_PTR(area, stops[i]);
+            if (ATB_GET_KIND(area, block) == AT_HEAD) {
+                ATB_HEAD_TO_MARK(area, block);
+                stop_bytes += gc_head_bytes(area, block);
+            }
+        }
+    }
+    for (size_t i = 0; i < n_roots; i++) {
+        mp_state_mem_area_t *area = gc_walk_ptr_area(roots[i]);
+        if (area == NULL) {
+            continue;
+        }
+        size_t block = BLOCK_FROM_PTR(area, roots[i]);
+        int kind = ATB_GET_KIND(area, block);
+        if (kind == AT_HEAD) {
+            ATB_HEAD_TO_MARK(area, block);
+        } else if (kind == AT_MARK && gc_walk_ptr_in(stops, n_stops, (void *)PTR_FROM_BLOCK(area, block))
+                   && !gc_walk_ptr_in(roots, i, roots[i])) {
+            // A root that is also a stop is counted, but only its own children
+            // are marked from it. A root given twice is only counted once.
+            stop_bytes -= gc_head_bytes(area, block);
+        } else {
+            continue;
+        }
+        GC_WALK_MARK_SUBTREE(area, block);
+    }
+    // As gc_deal_with_stack_overflow, but without going into the stops that
+    // aren't also roots
+    while (MP_STATE_MEM(gc_stack_overflow)) {
+        MP_STATE_MEM(gc_stack_overflow) = 0;
+        for (mp_state_mem_area_t *area = &MP_STATE_MEM(area); area != NULL; area = NEXT_AREA(area)) {
+            for (size_t block = 0; block < area->gc_alloc_table_byte_len * BLOCKS_PER_ATB; block++) {
+                if (ATB_GET_KIND(area, block) != AT_MARK) {
+                    continue;
+                }
+                void *ptr = (void *)PTR_FROM_BLOCK(area, block);
+                if (!gc_walk_ptr_in(stops, n_stops, ptr) || gc_walk_ptr_in(roots, n_roots, ptr)) {
+                    GC_WALK_MARK_SUBTREE(area, block);
+                }
+            }
+        }
+    }
+    size_t n_bytes = 0;
+    for (mp_state_mem_area_t *area = &MP_STATE_MEM(area); area != NULL; area = NEXT_AREA(area)) {
+        size_t end_block = area->gc_alloc_table_byte_len * BLOCKS_PER_ATB;
+        for (size_t block = 0; block < end_block; block++) {
+            if (ATB_GET_KIND(area, block) == AT_MARK) {
+                ATB_MARK_TO_HEAD(area, block);
+                n_bytes += gc_head_bytes(area, block);
+            }
+        }
+    }
+    gc_walk_exit();
+    return n_bytes - stop_bytes;
+}
+#endif
+
 void gc_info(gc_info_t *info) {
     GC_ENTER();
     info->total = 0;
@@ -709,9 +2594,16 @@ void gc_info(gc_info_t *info) {
     info->num_1block = 0;
     info->num_2block = 0;
     info->max_block = 0;
+    #if MICROPY_GC_PLACEMENT
+    info->fast_total = 0;
+    info->fast_used = 0;
+    #endif
     for (mp_state_mem_area_t *area = &MP_STATE_MEM(area); area != NULL; area = NEXT_AREA(area)) {
         bool finish = false;
         info->total += area->gc_pool_end - area->gc_pool_start;
+        #if MICROPY_GC_PLACEMENT
+        size_t used_before = info->used;
+        #endif
         for (size_t block = 0, len = 0, len_free = 0; !finish;) {
             MICROPY_GC_HOOK_LOOP(block);
             size_t kind = ATB_GET_KIND(area, block);
@@ -723,6 +2615,11 @@ void gc_info(gc_info_t *info) {
                     break;
 
                 case AT_HEAD:
+                // CIRCUITPY-CHANGE: a live object that a pending incremental
+                // sweep hasn't reached
+                #if MICROPY_GC_INCREMENTAL_SWEEP
+                case AT_MARK:
+                #endif
                     info->used += 1;
                     len = 1;
                     break;
@@ -732,9 +2629,11 @@ void gc_info(gc_info_t *info) {
                     len += 1;
                     break;
 
+                #if !MICROPY_GC_INCREMENTAL_SWEEP
                 case AT_MARK:
                     // shouldn't happen
                     break;
+                #endif
             }
 
             block++;
@@ -744,7 +2643,7 @@ void gc_info(gc_info_t *info) {
                 kind = ATB_GET_KIND(area, block);
             }
 
-            if (finish || kind == AT_FREE || kind == AT_HEAD) {
+            if (finish || kind == AT_FREE || ATB_KIND_IS_LIVE_HEAD(kind)) {
                 if (len == 1) {
                     info->num_1block += 1;
                 } else if (len == 2) {
@@ -753,7 +2652,7 @@ void gc_info(gc_info_t *info) {
                 if (len > info->max_block) {
                     info->max_block = len;
                 }
-                if (finish || kind == AT_HEAD) {
+                if (finish || ATB_KIND_IS_LIVE_HEAD(kind)) {
                     if (len_free > info->max_free) {
                         info->max_free = len_free;
                     }
@@ -761,6 +2660,12 @@ void gc_info(gc_info_t *info) {
                 }
             }
         }
+        #if MICROPY_GC_PLACEMENT
+        if (area->gc_fast) {
+            info->fast_total += area->gc_pool_end - area->gc_pool_start;
+            info->fast_used += (info->used - used_before) * BYTES_PER_BLOCK;
+        }
+        #endif
     }
 
     info->used *= BYTES_PER_BLOCK;
@@ -779,7 +2684,8 @@ bool gc_alloc_possible(void) {
     return MP_STATE_MEM(area).gc_pool_start != 0;
 }
 
-void *gc_alloc(size_t n_bytes, unsigned int alloc_flags) {
+// CIRCUITPY-CHANGE: for_cache is set for a run of objects for a thread's cache
+static void *gc_alloc_blocks(size_t n_bytes, unsigned int alloc_flags, bool for_cache) {
     bool has_finaliser = alloc_flags & GC_ALLOC_FLAG_HAS_FINALISER;
     size_t n_blocks = ((n_bytes + BYTES_PER_BLOCK - 1) & (~(BYTES_PER_BLOCK - 1))) / BYTES_PER_BLOCK;
     DEBUG_printf("gc_alloc(" UINT_FMT " bytes -> " UINT_FMT " blocks)\n", n_bytes, n_blocks);
@@ -796,6 +2702,21 @@ void *gc_alloc(size_t n_bytes, unsigned int alloc_flags) {
 
     GC_ENTER();
 
+    // CIRCUITPY-CHANGE: each allocation sweeps a slice of what the last
+    // automatic collection left unswept
+    #if MICROPY_GC_INCREMENTAL_SWEEP
+    if (MP_STATE_MEM(gc_sweep_area) != NULL) {
+        MP_STATE_THREAD(gc_lock_depth)++;
+        gc_sweep_incremental(MICROPY_GC_SWEEP_SLICE_BLOCKS);
+        MP_STATE_THREAD(gc_lock_depth)--;
+    }
+    #endif
+    // CIRCUITPY-CHANGE: and marks a slice of what the last one left unmarked
+    #if MICROPY_GC_INCREMENTAL_MARK
+    bool marked_all = MP_STATE_MEM(gc_mark_phase) == GC_MARK_SLICES
+        && gc_mark_incremental(MICROPY_GC_MARK_SLICE_BLOCKS);
+    #endif
+
     mp_state_mem_area_t *area;
     size_t i;
     size_t end_block;
@@ -805,13 +2726,88 @@ void *gc_alloc(size_t n_bytes, unsigned int alloc_flags) {
     #if MICROPY_GC_SPLIT_HEAP_AUTO
     bool added = false;
     #endif
+    // CIRCUITPY-CHANGE
+    #if MICROPY_GC_COMPACT
+    bool compacted = false;
+    #endif
+    // CIRCUITPY-CHANGE: small objects try fast RAM first, and bulk data slow
+    // RAM, before trying anywhere
+    #if MICROPY_GC_PLACEMENT
+    bool want_fast = !(alloc_flags & GC_ALLOC_FLAG_BULK) && n_bytes < MICROPY_GC_PLACEMENT_BULK_BYTES;
+    bool anywhere = false;
+    #endif
+
+    // CIRCUITPY-CHANGE: once slices have nothing left to mark, finish marking
+    #if MICROPY_GC_INCREMENTAL_MARK
+    if (!collected && marked_all) {
+        GC_EXIT();
+        MP_STATE_THREAD(gc_collect_lazily) = true;
+        gc_collect();
+        collected = 1;
+        GC_ENTER();
+    }
+    #endif
 
     #if MICROPY_GC_ALLOC_THRESHOLD
     if (!collected && MP_STATE_MEM(gc_alloc_amount) >= MP_STATE_MEM(gc_alloc_threshold)) {
         GC_EXIT();
+        // CIRCUITPY-CHANGE
+        #if MICROPY_GC_INCREMENTAL_SWEEP
+        MP_STATE_THREAD(gc_collect_lazily) = true;
+        #endif
+        #if MICROPY_GC_INCREMENTAL_MARK
+        MP_STATE_THREAD(gc_collect_incremental) = true;
+        #endif
         gc_collect();
-        collected = 1;
         GC_ENTER();
+        // CIRCUITPY-CHANGE: marking in slices hasn't freed anything yet
+        #if MICROPY_GC_INCREMENTAL_MARK
+        collected = MP_STATE_MEM(gc_mark_phase) != GC_MARK_SLICES;
+        #else
+        collected = 1;
+        #endif
+    }
+    #endif
+
+    // CIRCUITPY-CHANGE: small new objects go in the nursery while it has room,
+    // with a minor collection when it fills up
+    #if MICROPY_GC_NURSERY
+    bool in_nursery = false;
+    bool try_nursery = n_blocks <= MICROPY_GC_NURSERY_MAX_BLOCKS && gc_nursery_exists();
+    #if MICROPY_GC_ALLOC_CACHE
+    // the run holds small objects
+    try_nursery = try_nursery || (for_cache && gc_nursery_exists());
+    #endif
+    #if MICROPY_GC_PLACEMENT
+    // it is in the first area
+    try_nursery = try_nursery && MP_STATE_MEM(area).gc_fast == want_fast;
+    #endif
+    if (try_nursery) {
+        in_nursery = gc_nursery_find(n_blocks, &i);
+        bool minor = !in_nursery && !collected;
+        #if MICROPY_GC_INCREMENTAL_MARK
+        // not while marking in slices, which would have to finish first
+        minor = minor && MP_STATE_MEM(gc_mark_phase) != GC_MARK_SLICES;
+        #endif
+        if (minor) {
+            GC_EXIT();
+            MP_STATE_THREAD(gc_collect_minor) = true;
+            gc_collect();
+            GC_ENTER();
+            in_nursery = gc_nursery_exists() && gc_nursery_find(n_blocks, &i);
+        }
+        if (in_nursery) {
+            area = &MP_STATE_MEM(area);
+            n_free = n_blocks;
+            goto found;
+        }
+        #if MICROPY_GC_ALLOC_CACHE
+        // Young objects elsewhere would only be freed by a full collection
+        if (for_cache) {
+            GC_EXIT();
+            return NULL;
+        }
+        #endif
     }
     #endif
 
@@ -828,10 +2824,40 @@ void *gc_alloc(size_t n_bytes, unsigned int alloc_flags) {
             reset_into_safe_mode(SAFE_MODE_GC_ALLOC_OUTSIDE_VM);
         }
 
-        // look for a run of n_blocks available blocks
+        // look for a run of n_blocks available blocks, skipping the part of
+        // the heap known to have no run that large
         for (; area != NULL; area = NEXT_AREA(area), i = 0) {
+            // CIRCUITPY-CHANGE
+            #if MICROPY_GC_PLACEMENT
+            if (!anywhere && area->gc_fast != want_fast) {
+                continue;
+            }
+            #endif
             n_free = 0;
-            for (i = area->gc_last_free_atb_index; i < area->gc_alloc_table_byte_len; i++) {
+            i = area->gc_first_free_atb_index[SIZE_CLASS(n_blocks)];
+            #if MICROPY_GC_ALLOC_CACHE
+            if (for_cache) {
+                i = area->gc_first_free_run_atb_index;
+            }
+            #endif
+            // CIRCUITPY-CHANGE: the nursery has its own allocator, so look
+            // before it and then after it
+            size_t atb_len = area->gc_alloc_table_byte_len;
+            size_t scanned_atb_len = atb_len;
+            #if MICROPY_GC_NURSERY
+            size_t nursery_atb = 0;
+            if (area == &MP_STATE_MEM(area) && gc_nursery_exists()) {
+                nursery_atb = MP_STATE_MEM(gc_nursery_start) / BLOCKS_PER_ATB;
+                if (i < nursery_atb) {
+                    atb_len = scanned_atb_len = nursery_atb;
+                } else {
+                    i = MAX(i, MP_STATE_MEM(gc_nursery_end) / BLOCKS_PER_ATB);
+                    nursery_atb = 0;
+                }
+            }
+        scan:
+            #endif
+            for (; i < atb_len; i++) {
                 MICROPY_GC_HOOK_LOOP(i);
                 byte a = area->gc_alloc_table_start[i];
                 // *FORMAT-OFF*
@@ -842,19 +2868,81 @@ void *gc_alloc(size_t n_bytes, unsigned int alloc_flags) {
                 // *FORMAT-ON*
             }
 
-            // No free blocks found on this heap. Mark this heap as
-            // filled, so we won't try to find free space here again until
-            // space is freed.
-            #if MICROPY_GC_SPLIT_HEAP
-            if (n_blocks == 1) {
-                area->gc_last_free_atb_index = (i + 1) / BLOCKS_PER_ATB; // or (size_t)-1
+            // No run of free blocks this large found on this heap. Mark this
+            // heap as filled for this size, so we won't look for space here
+            // again until space is freed.
+            #if MICROPY_GC_NURSERY
+            if (nursery_atb != 0) {
+                i = MP_STATE_MEM(gc_nursery_end) / BLOCKS_PER_ATB;
+                atb_len = area->gc_alloc_table_byte_len;
+                n_free = 0;
+                nursery_atb = 0;
+                goto scan;
             }
             #endif
+            gc_free_hints_raise(area, n_blocks, scanned_atb_len);
+        }
+
+        // CIRCUITPY-CHANGE: then the other kind of RAM
+        #if MICROPY_GC_PLACEMENT
+        if (!anywhere) {
+            anywhere = true;
+            continue;
+        }
+        #endif
+
+        // CIRCUITPY-CHANGE: sweep some more of what the last collection
+        // found, before collecting again
+        #if MICROPY_GC_INCREMENTAL_SWEEP
+        if (MP_STATE_MEM(gc_sweep_area) != NULL) {
+            MP_STATE_THREAD(gc_lock_depth)++;
+            gc_sweep_incremental(MICROPY_GC_SWEEP_SLICE_BLOCKS);
+            MP_STATE_THREAD(gc_lock_depth)--;
+            continue;
+        }
+        #endif
+
+        // CIRCUITPY-CHANGE: the nursery is the last place left to look. After
+        // a full collection, give it up rather than fail, as the free run
+        // needed may overlap it.
+        #if MICROPY_GC_NURSERY
+        if (gc_nursery_exists()) {
+            if (gc_nursery_find(n_blocks, &i)) {
+                in_nursery = true;
+                area = &MP_STATE_MEM(area);
+                n_free = n_blocks;
+                goto found;
+            }
+            if (collected) {
+                gc_nursery_remember_all();
+                MP_STATE_MEM(gc_nursery_start) = MP_STATE_MEM(gc_nursery_end) = 0;
+                continue;
+            }
         }
+        #endif
 
         GC_EXIT();
         // nothing found!
+        // CIRCUITPY-CHANGE: a run is only worth taking from free memory
+        #if MICROPY_GC_ALLOC_CACHE
+        if (for_cache) {
+            return NULL;
+        }
+        #else
+        (void)for_cache;
+        #endif
         if (collected) {
+            // CIRCUITPY-CHANGE: join up free space by moving buffers, before
+            // taking more memory for the heap
+            #if MICROPY_GC_COMPACT
+            if (!compacted) {
+                compacted = true;
+                if (gc_compact()) {
+                    GC_ENTER();
+                    continue;
+                }
+            }
+            #endif
             #if MICROPY_GC_SPLIT_HEAP_AUTO
             if (!added && gc_try_add_heap(n_bytes)) {
                 added = true;
@@ -869,6 +2957,10 @@ void *gc_alloc(size_t n_bytes, unsigned int alloc_flags) {
             return NULL;
         }
         DEBUG_printf("gc_alloc(" UINT_FMT "): no free mem, triggering GC\n", n_bytes);
+        // CIRCUITPY-CHANGE
+        #if MICROPY_GC_INCREMENTAL_SWEEP
+        MP_STATE_THREAD(gc_collect_lazily) = true;
+        #endif
         gc_collect();
         collected = 1;
         GC_ENTER();
@@ -880,17 +2972,26 @@ found:
     end_block = i;
     start_block = i - n_free + 1;
 
-    // Set last free ATB index to block after last block we found, for start of
-    // next scan.  To reduce fragmentation, we only do this if we were looking
-    // for a single free block, which guarantees that there are no free blocks
-    // before this one.  Also, whenever we free or shink a block we must check
-    // if this index needs adjusting (see gc_realloc and gc_free).
+    // Set the free ATB index of this size class, and the larger ones, to the
+    // block after the last block we found, for the start of the next scan. This
+    // is the first run of this size, so there is none before it. Also, whenever
+    // we free or shrink a block we must check if the indices need adjusting
+    // (see gc_realloc and gc_free).
+    #if MICROPY_GC_SPLIT_HEAP
+    // CIRCUITPY-CHANGE: areas of the other kind of RAM may have been skipped
+    #if MICROPY_GC_PLACEMENT
+    if (n_free == 1 && anywhere) {
+    #else
     if (n_free == 1) {
-        #if MICROPY_GC_SPLIT_HEAP
+    #endif
         MP_STATE_MEM(gc_last_free_area) = area;
-        #endif
-        area->gc_last_free_atb_index = (i + 1) / BLOCKS_PER_ATB;
     }
+    #endif
+    // CIRCUITPY-CHANGE: the hints are for the heap outside the nursery
+    #if MICROPY_GC_NURSERY
+    if (!in_nursery)
+    #endif
+    gc_free_hints_raise(area, n_free, (i + 1) / BLOCKS_PER_ATB);
 
     // CIRCUITPY-CHANGE
     #ifdef LOG_HEAP_ACTIVITY
@@ -902,12 +3003,37 @@ found:
     // mark first block as used head
     ATB_FREE_TO_HEAD(area, start_block);
 
+    // CIRCUITPY-CHANGE: where a pending sweep is still to come, live objects
+    // are marked
+    #if MICROPY_GC_INCREMENTAL_SWEEP
+    gc_sweep_note_used(area, end_block);
+    if (start_block >= area->gc_sweep_block) {
+        ATB_HEAD_TO_MARK(area, start_block);
+    }
+    #endif
+
     // mark rest of blocks as used tail
     // TODO for a run of many blocks can make this more efficient
     for (size_t bl = start_block + 1; bl <= end_block; bl++) {
         ATB_FREE_TO_TAIL(area, bl);
     }
 
+    // CIRCUITPY-CHANGE: an object outside the nursery is old from the start,
+    // so whatever it is filled in with is remembered
+    #if MICROPY_GC_NURSERY
+    if (!in_nursery) {
+        gc_remember_blocks(area, start_block, end_block + 1);
+    }
+    #endif
+    // CIRCUITPY-CHANGE: marking in slices takes it to be live, and looks in it
+    // once marking finishes
+    #if MICROPY_GC_INCREMENTAL_MARK
+    if (MP_STATE_MEM(gc_mark_phase) == GC_MARK_SLICES) {
+        ATB_HEAD_TO_MARK(area, start_block);
+        gc_remember_blocks(area, start_block, end_block + 1);
+    }
+    #endif
+
     // get pointer to first block
     // we must create this pointer before unlocking the GC so a collection can find it
     void *ret_ptr = (void *)(area->gc_pool_start + start_block * BYTES_PER_BLOCK);
@@ -948,12 +3074,123 @@ found:
     gc_dump_alloc_table(&mp_plat_print);
     #endif
 
+    return ret_ptr;
+}
+
+#if MICROPY_GC_ALLOC_CACHE
+// CIRCUITPY-CHANGE
+// Thread allocation caches, see gc_alloc_cache_flush
+
+// Take an object of n_blocks from the thread's run of them, if there is one
+static void *gc_alloc_cache_take(mp_gc_alloc_cache_t *c, size_t n_blocks) {
+    // Either gc_alloc_cache_flush sees busy set, and waits, or this sees it
+    // blocking and leaves the cache alone
+    __atomic_store_n(&c->busy, 1, __ATOMIC_SEQ_CST);
+    byte *ptr = NULL;
+    if (!__atomic_load_n(&MP_STATE_MEM(gc_alloc_cache_blocked), __ATOMIC_SEQ_CST)
+        && c->next[n_blocks - 1] != c->end[n_blocks - 1]) {
+        ptr = c->next[n_blocks - 1];
+        c->next[n_blocks - 1] = ptr + n_blocks * BYTES_PER_BLOCK;
+    }
+    __atomic_store_n(&c->busy, 0, __ATOMIC_RELEASE);
+    return ptr;
+}
+
+// Claim a new run of objects of n_blocks, and take the first of them. Once
+// there is no free run, looking for one again waits for a collection.
+static void *gc_alloc_cache_refill(mp_gc_alloc_cache_t *c, size_t n_blocks) {
+    if (__atomic_load_n(&MP_STATE_MEM(gc_alloc_cache_no_run), __ATOMIC_RELAXED)) {
+        return NULL;
+    }
+    size_t n_objs = MICROPY_GC_ALLOC_CACHE_RUN_BLOCKS / n_blocks;
+    byte *run = gc_alloc_blocks(MICROPY_GC_ALLOC_CACHE_RUN_BLOCKS * BYTES_PER_BLOCK, 0, true);
+    if (run == NULL) {
+        __atomic_store_n(&MP_STATE_MEM(gc_alloc_cache_no_run), true, __ATOMIC_RELAXED);
+        return NULL;
+    }
+    #if !MICROPY_GC_CONSERVATIVE_CLEAR
+    // The objects are handed out without being cleared, and gc_alloc_blocks
+    // only clears what is past the bytes asked for, which here is nothing
+    memset(run, 0, MICROPY_GC_ALLOC_CACHE_RUN_BLOCKS * BYTES_PER_BLOCK);
+    #endif
+
+    GC_ENTER();
+    #if MICROPY_GC_SPLIT_HEAP
+    mp_state_mem_area_t *area = gc_get_ptr_area(run);
+    #else
+    mp_state_mem_area_t *area = &MP_STATE_MEM(area);
+    #endif
+    // Split the run up. It is zeroed by now. A collection since it was
+    // allocated found it on the stack and kept it whole. Any blocks left
+    // over at the end are a shorter object that is never handed out.
+    size_t block = BLOCK_FROM_PTR(area, run);
+    size_t end_block = block + MICROPY_GC_ALLOC_CACHE_RUN_BLOCKS;
+    for (block += n_blocks; block < end_block; block += n_blocks) {
+        ATB_ANY_TO_FREE(area, block);
+        ATB_FREE_TO_HEAD(area, block);
+        #if MICROPY_GC_INCREMENTAL_SWEEP
+        if (block >= area->gc_sweep_block) {
+            ATB_HEAD_TO_MARK(area, block);
+        }
+        #endif
+        #if MICROPY_GC_INCREMENTAL_MARK
+        if (MP_STATE_MEM(gc_mark_phase) == GC_MARK_SLICES) {
+            ATB_HEAD_TO_MARK(area, block);
+        }
+        #endif
+    }
+    if (!c->listed) {
+        c->next_cache = MP_STATE_MEM(gc_alloc_caches);
+        MP_STATE_MEM(gc_alloc_caches) = c;
+        c->listed = true;
+    }
+    c->next[n_blocks - 1] = run + n_blocks * BYTES_PER_BLOCK;
+    c->end[n_blocks - 1] = run + n_objs * n_blocks * BYTES_PER_BLOCK;
+    GC_EXIT();
+    return run;
+}
+
+void gc_alloc_cache_release(void) {
+    mp_gc_alloc_cache_t *c = &MP_STATE_THREAD(gc_alloc_cache);
+    GC_ENTER();
+    for (mp_gc_alloc_cache_t **p = &MP_STATE_MEM(gc_alloc_caches); *p != NULL; p = &(*p)->next_cache) {
+        if (*p == c) {
+            *p = c->next_cache;
+            break;
+        }
+    }
+    memset(c, 0, sizeof(*c));
+    GC_EXIT();
+}
+#endif
+
+void *gc_alloc(size_t n_bytes, unsigned int alloc_flags) {
+    void *ptr = NULL;
+
+    // CIRCUITPY-CHANGE: small objects come from the thread's cache if it can
+    #if MICROPY_GC_ALLOC_CACHE
+    size_t n_blocks = (n_bytes + BYTES_PER_BLOCK - 1) / BYTES_PER_BLOCK;
+    // n_blocks - 1 wraps round for 0 blocks, which gc_alloc_blocks handles
+    if (alloc_flags == 0 && n_blocks - 1 < MICROPY_GC_ALLOC_CACHE_MAX_BLOCKS
+        && MP_STATE_THREAD(gc_lock_depth) == 0) {
+        mp_gc_alloc_cache_t *c = &MP_STATE_THREAD(gc_alloc_cache);
+        ptr = gc_alloc_cache_take(c, n_blocks);
+        if (ptr == NULL) {
+            ptr = gc_alloc_cache_refill(c, n_blocks);
+        }
+    }
+    if (ptr == NULL)
+    #endif
+    ptr = gc_alloc_blocks(n_bytes, alloc_flags, false);
+
     // CIRCUITPY-CHANGE
     #if CIRCUITPY_MEMORYMONITOR
-    memorymonitor_track_allocation(end_block - start_block + 1);
+    if (ptr != NULL) {
+        memorymonitor_track_allocation((n_bytes + BYTES_PER_BLOCK - 1) / BYTES_PER_BLOCK);
+    }
     #endif
 
-    return ret_ptr;
+    return ptr;
 }
 
 /*
@@ -1002,7 +3239,7 @@ void gc_free(void *ptr) {
     #endif
 
     size_t block = BLOCK_FROM_PTR(area, ptr);
-    assert(ATB_GET_KIND(area, block) == AT_HEAD);
+    assert(ATB_KIND_IS_LIVE_HEAD(ATB_GET_KIND(area, block)));
 
     #if MICROPY_ENABLE_FINALISER
     FTB_CLEAR(area, block);
@@ -1013,20 +3250,19 @@ void gc_free(void *ptr) {
         // We freed something but it isn't the current area. Reset the
         // last free area to the start for a rescan. Note that this won't
         // give much of a performance hit, since areas that are completely
-        // filled will likely be skipped (the gc_last_free_atb_index
+        // filled will likely be skipped (the gc_first_free_atb_index
         // points to the last block).
         // The reason why this is necessary is because it is not possible
         // to see which area came first (like it is possible to adjust
-        // gc_last_free_atb_index based on whether the freed block is
-        // before the last free block).
+        // gc_first_free_atb_index based on whether the freed block is
+        // before the first free block).
         MP_STATE_MEM(gc_last_free_area) = &MP_STATE_MEM(area);
     }
     #endif
 
-    // set the last_free pointer to this block if it's earlier in the heap
-    if (block / BLOCKS_PER_ATB < area->gc_last_free_atb_index) {
-        area->gc_last_free_atb_index = block / BLOCKS_PER_ATB;
-    }
+    // move the free ATB indices back if the free run around this block is
+    // earlier in the heap
+    gc_free_hints_lower(area, block);
 
     // CIRCUITPY-CHANGE
     #ifdef LOG_HEAP_ACTIVITY
@@ -1062,7 +3298,7 @@ size_t gc_nbytes(const void *ptr) {
 
     if (area) {
         size_t block = BLOCK_FROM_PTR(area, ptr);
-        if (ATB_GET_KIND(area, block) == AT_HEAD) {
+        if (ATB_KIND_IS_LIVE_HEAD(ATB_GET_KIND(area, block))) {
             // work out number of consecutive blocks in the chain starting with this on
             size_t n_blocks = 0;
             do {
@@ -1137,7 +3373,7 @@ void *gc_realloc(void *ptr_in, size_t n_bytes, bool allow_move) {
     area = &MP_STATE_MEM(area);
     #endif
     size_t block = BLOCK_FROM_PTR(area, ptr);
-    assert(ATB_GET_KIND(area, block) == AT_HEAD);
+    assert(ATB_KIND_IS_LIVE_HEAD(ATB_GET_KIND(area, block)));
 
     // compute number of new blocks that are requested
     size_t new_blocks = (n_bytes + BYTES_PER_BLOCK - 1) / BYTES_PER_BLOCK;
@@ -1151,6 +3387,12 @@ void *gc_realloc(void *ptr_in, size_t n_bytes, bool allow_move) {
     size_t n_free = 0;
     size_t n_blocks = 1; // counting HEAD block
     size_t max_block = area->gc_alloc_table_byte_len * BLOCKS_PER_ATB;
+    // CIRCUITPY-CHANGE: objects in the nursery don't grow out of it
+    #if MICROPY_GC_NURSERY
+    if (GC_BLOCK_IN_NURSERY(area, block)) {
+        max_block = MP_STATE_MEM(gc_nursery_end);
+    }
+    #endif
     for (size_t bl = block + n_blocks; bl < max_block; bl++) {
         byte block_type = ATB_GET_KIND(area, bl);
         if (block_type == AT_TAIL) {
@@ -1188,10 +3430,9 @@ void *gc_realloc(void *ptr_in, size_t n_bytes, bool allow_move) {
         }
         #endif
 
-        // set the last_free pointer to end of this block if it's earlier in the heap
-        if ((block + new_blocks) / BLOCKS_PER_ATB < area->gc_last_free_atb_index) {
-            area->gc_last_free_atb_index = (block + new_blocks) / BLOCKS_PER_ATB;
-        }
+        // move the free ATB indices back if the free run around the freed
+        // tail is earlier in the heap
+        gc_free_hints_lower(area, block + new_blocks);
 
         GC_EXIT();
 
@@ -1221,6 +3462,17 @@ void *gc_realloc(void *ptr_in, size_t n_bytes, bool allow_move) {
         }
 
         area->gc_last_used_block = MAX(area->gc_last_used_block, end_block);
+        // CIRCUITPY-CHANGE
+        #if MICROPY_GC_INCREMENTAL_SWEEP
+        gc_sweep_note_used(area, end_block);
+        #endif
+        #if MICROPY_GC_NURSERY
+        gc_nursery_grown_into(area, block, end_block);
+        #endif
+        #if MICROPY_GC_WRITE_BARRIER
+        // what the object is filled in with there may be new, or unmarked
+        gc_remember_blocks(area, block, end_block);
+        #endif
 
         GC_EXIT();
 
@@ -48,6 +48,13 @@ void gc_add(void *start, void *end);
 // RAM to allocate a new heap area into using MP_PLAT_ALLOC_HEAP.
 size_t gc_get_max_new_split(void);
 #endif // MICROPY_GC_SPLIT_HEAP_AUTO
+
+#if MICROPY_GC_PLACEMENT
+// CIRCUITPY-CHANGE
+// Port must implement this function to return whether the RAM that a new heap
+// area starts at is fast, such as internal SRAM rather than PSRAM.
+bool gc_ram_is_fast(void *ptr);
+#endif
 #endif // MICROPY_GC_SPLIT_HEAP
 
 // These lock/unlock functions can be nested.
@@ -64,6 +71,18 @@ void gc_collect_ptr(void *ptr);
 void gc_collect_root(void **ptrs, size_t len);
 void gc_collect_end(void);
 
+#if MICROPY_GC_PARALLEL_MARK
+// CIRCUITPY-CHANGE
+// Port must implement these. gc_mark_helpers_start has up to n_helpers other
+// threads call gc_mark_helper(1), gc_mark_helper(2) and so on, and returns how
+// many it started. gc_mark_helpers_wait returns once those calls have all
+// returned. The helpers must not use the VM or take the GC lock.
+size_t gc_mark_helpers_start(size_t n_helpers);
+void gc_mark_helpers_wait(void);
+// Marks alongside the collecting thread until all the marking is done
+void gc_mark_helper(size_t index);
+#endif
+
 // CIRCUITPY-CHANGE
 // Is the gc heap available?
 bool gc_alloc_possible(void);
@@ -71,20 +90,96 @@ bool gc_alloc_possible(void);
 // Use this function to sweep the whole heap and run all finalisers
 void gc_sweep_all(void);
 
+#if MICROPY_GC_INCREMENTAL_SWEEP
+// CIRCUITPY-CHANGE
+// Sweep one slice of what the last automatic collection left unswept, or with
+// MICROPY_GC_INCREMENTAL_MARK mark one slice of what it left unmarked, if
+// anything, unless the GC is locked. Allocations do this too. No finalisers
+// are run, as the collection runs them all before sweeping.
+void gc_sweep_step(void);
+#endif
+
 enum {
     GC_ALLOC_FLAG_HAS_FINALISER = 1,
+    // CIRCUITPY-CHANGE: large buffer data, such as bitmaps and audio, that
+    // is better off in slow RAM than taking fast RAM from small objects
+    GC_ALLOC_FLAG_BULK = 2,
 };
 
 void *gc_alloc(size_t n_bytes, unsigned int alloc_flags);
+#if MICROPY_GC_ALLOC_CACHE
+// CIRCUITPY-CHANGE
+// Call before the state of a thread that may have allocated goes away
+void gc_alloc_cache_release(void);
+#endif
 void gc_free(void *ptr); // does not call finaliser
 size_t gc_nbytes(const void *ptr);
 void *gc_realloc(void *ptr, size_t n_bytes, bool allow_move);
 
+#if MICROPY_GC_COMPACT
+// CIRCUITPY-CHANGE
+// The object at owner has a pointer at handle to a buffer of n_bytes that
+// compaction may move, updating the pointer, while nothing else points into it.
+void gc_movable_add(void *owner, void **handle, size_t n_bytes);
+// The buffer that buf points into has been handed out, to code that may keep
+// it where the GC can't see, so compaction leaves it where it is from now on.
+void gc_movable_lend(const void *buf);
+#endif
+
+// CIRCUITPY-CHANGE
+// Call when the owner's buffer is allocated or grows to n_bytes.
+static inline void gc_movable(void *owner, void **handle, size_t n_bytes) {
+    #if MICROPY_GC_COMPACT
+    if (n_bytes >= MICROPY_GC_COMPACT_MIN_BYTES) {
+        gc_movable_add(owner, handle, n_bytes);
+    }
+    #endif
+}
+
+#if MICROPY_GC_WRITE_BARRIER
+// CIRCUITPY-CHANGE
+void gc_remember(const void *ptr);
+void gc_remember_obj(const void *ptr);
+#endif
+
+// CIRCUITPY-CHANGE
+// Call after storing a pointer at ptr, if that may be in a heap object that
+// wasn't allocated since the last allocation, so that a collection of new
+// objects only finds the ones stored. gc_write_barrier_obj is for stores
+// anywhere in the object that ptr points into, such as by a method it has.
+static inline void gc_write_barrier(const void *ptr) {
+    #if MICROPY_GC_WRITE_BARRIER
+    gc_remember(ptr);
+    #else
+    (void)ptr;
+    #endif
+}
+
+static inline void gc_write_barrier_obj(const void *ptr) {
+    #if MICROPY_GC_WRITE_BARRIER
+    gc_remember_obj(ptr);
+    #else
+    (void)ptr;
+    #endif
+}
+
 // CIRCUITPY-CHANGE
 // True if the pointer is on the MP heap. Doesn't require that it is the start
 // of a block.
 bool gc_ptr_on_heap(void *ptr);
 
+// CIRCUITPY-CHANGE
+#if MICROPY_GC_HEAP_WALK
+// Calls fun for each allocated block, with the heap locked. fun must not
+// allocate or call other gc functions.
+typedef void (*gc_heap_walk_fun_t)(void *ptr, size_t n_bytes, void *arg);
+void gc_heap_walk(gc_heap_walk_fun_t fun, void *arg);
+// Returns the bytes of heap reachable from the roots, without allocating or
+// recursing. Marking stops at the stops, which aren't counted unless they are
+// also roots.
+size_t gc_reachable_bytes(void **roots, size_t n_roots, void **stops, size_t n_stops);
+#endif
+
 typedef struct _gc_info_t {
     size_t total;
     size_t used;
@@ -96,6 +191,11 @@ typedef struct _gc_info_t {
     #if MICROPY_GC_SPLIT_HEAP_AUTO
     size_t max_new_split;
     #endif
+    // CIRCUITPY-CHANGE: the part of total and used in fast RAM
+    #if MICROPY_GC_PLACEMENT
+    size_t fast_total;
+    size_t fast_used;
+    #endif
 } gc_info_t;
 
 void gc_info(gc_info_t *info);
@@ -58,6 +58,8 @@
 #undef realloc
 #define malloc(b) gc_alloc((b), false)
 #define malloc_with_finaliser(b) gc_alloc((b), true)
+// CIRCUITPY-CHANGE
+#define malloc_bulk(b) gc_alloc((b), GC_ALLOC_FLAG_BULK)
 #define free gc_free
 #define realloc(ptr, n) gc_realloc(ptr, n, true)
 #define realloc_ext(ptr, n, mv) gc_realloc(ptr, n, mv)
@@ -69,6 +71,9 @@
 #error MICROPY_ENABLE_FINALISER requires MICROPY_ENABLE_GC
 #endif
 
+// CIRCUITPY-CHANGE
+#define malloc_bulk(b) malloc(b)
+
 static void *realloc_ext(void *ptr, size_t n_bytes, bool allow_move) {
     if (allow_move) {
         return realloc(ptr, n_bytes);
@@ -82,7 +87,19 @@ static void *realloc_ext(void *ptr, size_t n_bytes, bool allow_move) {
 
 #endif // MICROPY_ENABLE_GC
 
-void *m_malloc(size_t num_bytes) {
+// CIRCUITPY-CHANGE
+#if CIRCUITPY_MEMORYMONITOR
+#include "shared-module/memorymonitor/__init__.h"
+// Allocations are attributed to the C code that called into this file.
+#define CALLER() __builtin_return_address(0)
+#define PROFILE_ALLOCATION(num_bytes, caller) memorymonitor_profile_allocation((num_bytes), (caller))
+#else
+#define CALLER() NULL
+#define PROFILE_ALLOCATION(num_bytes, caller) (void)(caller)
+#endif
+
+// CIRCUITPY-CHANGE: shared by m_malloc and m_malloc0 so both see their own caller
+static inline void *m_malloc_from(size_t num_bytes, void *caller) {
     void *ptr = malloc(num_bytes);
     if (ptr == NULL && num_bytes != 0) {
         m_malloc_fail(num_bytes);
@@ -92,10 +109,15 @@ void *m_malloc(size_t num_bytes) {
     MP_STATE_MEM(current_bytes_allocated) += num_bytes;
     UPDATE_PEAK();
     #endif
+    PROFILE_ALLOCATION(num_bytes, caller);
     DEBUG_printf("malloc %d : %p\n", num_bytes, ptr);
     return ptr;
 }
 
+void *m_malloc(size_t num_bytes) {
+    return m_malloc_from(num_bytes, CALLER());
+}
+
 void *m_malloc_maybe(size_t num_bytes) {
     void *ptr = malloc(num_bytes);
     #if MICROPY_MEM_STATS
@@ -103,6 +125,10 @@ void *m_malloc_maybe(size_t num_bytes) {
     MP_STATE_MEM(current_bytes_allocated) += num_bytes;
     UPDATE_PEAK();
     #endif
+    // CIRCUITPY-CHANGE
+    if (ptr != NULL) {
+        PROFILE_ALLOCATION(num_bytes, CALLER());
+    }
     DEBUG_printf("malloc %d : %p\n", num_bytes, ptr);
     return ptr;
 }
@@ -118,13 +144,33 @@ void *m_malloc_with_finaliser(size_t num_bytes) {
     MP_STATE_MEM(current_bytes_allocated) += num_bytes;
     UPDATE_PEAK();
     #endif
+    // CIRCUITPY-CHANGE
+    PROFILE_ALLOCATION(num_bytes, CALLER());
     DEBUG_printf("malloc %d : %p\n", num_bytes, ptr);
     return ptr;
 }
 #endif
 
+// CIRCUITPY-CHANGE
+void *m_malloc_bulk(size_t num_bytes) {
+    void *ptr = malloc_bulk(num_bytes);
+    if (ptr == NULL && num_bytes != 0) {
+        m_malloc_fail(num_bytes);
+    }
+    #if MICROPY_MEM_STATS
+    MP_STATE_MEM(total_bytes_allocated) += num_bytes;
+    MP_STATE_MEM(current_bytes_allocated) += num_bytes;
+    UPDATE_PEAK();
+    #endif
+    // CIRCUITPY-CHANGE
+    PROFILE_ALLOCATION(num_bytes, CALLER());
+    DEBUG_printf("malloc %d : %p\n", num_bytes, ptr);
+    return ptr;
+}
+
 void *m_malloc0(size_t num_bytes) {
-    void *ptr = m_malloc(num_bytes);
+    // CIRCUITPY-CHANGE
+    void *ptr = m_malloc_from(num_bytes, CALLER());
     // If this config is set then the GC clears all memory, so we don't need to.
     #if !MICROPY_GC_CONSERVATIVE_CLEAR
     memset(ptr, 0, num_bytes);
@@ -153,6 +199,13 @@ void *m_realloc(void *ptr, size_t new_num_bytes)
     MP_STATE_MEM(current_bytes_allocated) += diff;
     UPDATE_PEAK();
     #endif
+    // CIRCUITPY-CHANGE: only growth is profiled, as a new allocation of the new size
+    #if MICROPY_MALLOC_USES_ALLOCATED_SIZE
+    if (new_num_bytes > old_num_bytes)
+    #endif
+    {
+        PROFILE_ALLOCATION(new_num_bytes, CALLER());
+    }
     #if MICROPY_MALLOC_USES_ALLOCATED_SIZE
     DEBUG_printf("realloc %p, %d, %d : %p\n", ptr, old_num_bytes, new_num_bytes, new_ptr);
     #else
@@ -182,6 +235,14 @@ void *m_realloc_maybe(void *ptr, size_t new_num_bytes, bool allow_move)
         UPDATE_PEAK();
     }
     #endif
+    // CIRCUITPY-CHANGE
+    if (new_ptr != NULL
+        #if MICROPY_MALLOC_USES_ALLOCATED_SIZE
+        && new_num_bytes > old_num_bytes
+        #endif
+        ) {
+        PROFILE_ALLOCATION(new_num_bytes, CALLER());
+    }
     #if MICROPY_MALLOC_USES_ALLOCATED_SIZE
     DEBUG_printf("realloc %p, %d, %d : %p\n", ptr, old_num_bytes, new_num_bytes, new_ptr);
     #else
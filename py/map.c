@@ -32,6 +32,8 @@
 #include "py/mpconfig.h"
 #include "py/misc.h"
 #include "py/runtime.h"
+// CIRCUITPY-CHANGE
+#include "py/gc.h"
 
 #if MICROPY_DEBUG_VERBOSE // print debugging info
 #define DEBUG_PRINT (1)
@@ -93,6 +95,8 @@ void mp_map_init(mp_map_t *map, size_t n) {
     } else {
         map->alloc = n;
         map->table = m_new0(mp_map_elem_t, map->alloc);
+        // CIRCUITPY-CHANGE
+        gc_write_barrier(&map->table);
     }
     map->used = 0;
     map->all_keys_are_qstrs = 1;
@@ -139,6 +143,8 @@ static void mp_map_rehash(mp_map_t *map) {
     map->used = 0;
     map->all_keys_are_qstrs = 1;
     map->table = new_table;
+    // CIRCUITPY-CHANGE
+    gc_write_barrier(&map->table);
     for (size_t i = 0; i < old_alloc; i++) {
         if (old_table[i].key != MP_OBJ_NULL && old_table[i].key != MP_OBJ_SENTINEL) {
             mp_map_lookup(map, old_table[i].key, MP_MAP_LOOKUP_ADD_IF_NOT_FOUND)->value = old_table[i].value;
@@ -153,6 +159,8 @@ static void mp_map_rehash(mp_map_t *map) {
 //  - returns slot, with key non-null and value=MP_OBJ_NULL if it was added
 // MP_MAP_LOOKUP_REMOVE_IF_FOUND behaviour:
 //  - returns NULL if not found, else the slot if was found in with key null and value non-null
+// CIRCUITPY-CHANGE: a slot returned for MP_MAP_LOOKUP_ADD_IF_NOT_FOUND has
+// been through the write barrier, so the caller can store its value
 mp_map_elem_t *MICROPY_WRAP_MP_MAP_LOOKUP(mp_map_lookup)(mp_map_t * map, mp_obj_t index, mp_map_lookup_kind_t lookup_kind) {
     // If the map is a fixed array then we must only be called for a lookup
     assert(!map->is_fixed || lookup_kind == MP_MAP_LOOKUP);
@@ -164,6 +172,10 @@ mp_map_elem_t *MICROPY_WRAP_MP_MAP_LOOKUP(mp_map_lookup)(mp_map_t * map, mp_obj_
         // Note: Just comparing key for value equality will have false negatives, but
         // these will be handled by the regular path below.
         if (slot->key == index) {
+            // CIRCUITPY-CHANGE
+            if (lookup_kind == MP_MAP_LOOKUP_ADD_IF_NOT_FOUND) {
+                gc_write_barrier(slot);
+            }
             return slot;
         }
     }
@@ -203,8 +215,14 @@ mp_map_elem_t *MICROPY_WRAP_MP_MAP_LOOKUP(mp_map_lookup)(mp_map_t * map, mp_obj_
                     elem = &map->table[map->used];
                     elem->key = MP_OBJ_NULL;
                     elem->value = value;
+                    // CIRCUITPY-CHANGE
+                    gc_write_barrier_obj(map->table);
                 }
                 #endif
+                // CIRCUITPY-CHANGE
+                if (lookup_kind == MP_MAP_LOOKUP_ADD_IF_NOT_FOUND) {
+                    gc_write_barrier(elem);
+                }
                 MAP_CACHE_SET(index, elem - map->table);
                 return elem;
             }
@@ -217,11 +235,15 @@ mp_map_elem_t *MICROPY_WRAP_MP_MAP_LOOKUP(mp_map_lookup)(mp_map_t * map, mp_obj_
             // TODO: Alloc policy
             map->alloc += 4;
             map->table = m_renew(mp_map_elem_t, map->table, map->used, map->alloc);
+            // CIRCUITPY-CHANGE
+            gc_write_barrier(&map->table);
             mp_seq_clear(map->table, map->used, map->alloc, sizeof(*map->table));
         }
         mp_map_elem_t *elem = map->table + map->used++;
         elem->key = index;
         elem->value = MP_OBJ_NULL;
+        // CIRCUITPY-CHANGE
+        gc_write_barrier(elem);
         if (!mp_obj_is_qstr(index)) {
             map->all_keys_are_qstrs = 0;
         }
@@ -263,6 +285,8 @@ mp_map_elem_t *MICROPY_WRAP_MP_MAP_LOOKUP(mp_map_lookup)(mp_map_t * map, mp_obj_
                 }
                 avail_slot->key = index;
                 avail_slot->value = MP_OBJ_NULL;
+                // CIRCUITPY-CHANGE
+                gc_write_barrier(avail_slot);
                 if (!mp_obj_is_qstr(index)) {
                     map->all_keys_are_qstrs = 0;
                 }
@@ -289,6 +313,10 @@ mp_map_elem_t *MICROPY_WRAP_MP_MAP_LOOKUP(mp_map_lookup)(mp_map_t * map, mp_obj_
                 }
                 // keep slot->value so that caller can access it if needed
             }
+            // CIRCUITPY-CHANGE
+            if (lookup_kind == MP_MAP_LOOKUP_ADD_IF_NOT_FOUND) {
+                gc_write_barrier(slot);
+            }
             MAP_CACHE_SET(index, pos);
             return slot;
         }
@@ -304,6 +332,8 @@ mp_map_elem_t *MICROPY_WRAP_MP_MAP_LOOKUP(mp_map_lookup)(mp_map_t * map, mp_obj_
                     map->used++;
                     avail_slot->key = index;
                     avail_slot->value = MP_OBJ_NULL;
+                    // CIRCUITPY-CHANGE
+                    gc_write_barrier(avail_slot);
                     if (!mp_obj_is_qstr(index)) {
                         map->all_keys_are_qstrs = 0;
                     }
@@ -330,6 +360,8 @@ void mp_set_init(mp_set_t *set, size_t n) {
     set->alloc = n;
     set->used = 0;
     set->table = m_new0(mp_obj_t, set->alloc);
+    // CIRCUITPY-CHANGE
+    gc_write_barrier(&set->table);
 }
 
 static void mp_set_rehash(mp_set_t *set) {
@@ -338,6 +370,8 @@ static void mp_set_rehash(mp_set_t *set) {
     set->alloc = get_hash_alloc_greater_or_equal_to(set->alloc + 1);
     set->used = 0;
     set->table = m_new0(mp_obj_t, set->alloc);
+    // CIRCUITPY-CHANGE
+    gc_write_barrier(&set->table);
     for (size_t i = 0; i < old_alloc; i++) {
         if (old_table[i] != MP_OBJ_NULL && old_table[i] != MP_OBJ_SENTINEL) {
             mp_set_lookup(set, old_table[i], MP_MAP_LOOKUP_ADD_IF_NOT_FOUND);
@@ -371,6 +405,8 @@ mp_obj_t mp_set_lookup(mp_set_t *set, mp_obj_t index, mp_map_lookup_kind_t looku
                 }
                 set->used++;
                 *avail_slot = index;
+                // CIRCUITPY-CHANGE
+                gc_write_barrier(avail_slot);
                 return index;
             } else {
                 return MP_OBJ_NULL;
@@ -405,6 +441,8 @@ mp_obj_t mp_set_lookup(mp_set_t *set, mp_obj_t index, mp_map_lookup_kind_t looku
                     // there was an available slot, so use that
                     set->used++;
                     *avail_slot = index;
+                    // CIRCUITPY-CHANGE
+                    gc_write_barrier(avail_slot);
                     return index;
                 } else {
                     // not enough room in table, rehash it
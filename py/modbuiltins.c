@@ -34,6 +34,8 @@
 #include "py/runtime.h"
 #include "py/builtin.h"
 #include "py/stream.h"
+// CIRCUITPY-CHANGE
+#include "py/gc.h"
 
 #if MICROPY_PY_BUILTINS_FLOAT
 #include <math.h>
@@ -82,6 +84,8 @@ static mp_obj_t mp_builtin___build_class__(size_t n_args, const mp_obj_t *args)
     // store into cell if needed
     if (cell != mp_const_none) {
         mp_obj_cell_set(cell, new_class);
+        // CIRCUITPY-CHANGE
+        gc_write_barrier(MP_OBJ_TO_PTR(cell));
     }
 
     return new_class;
@@ -24,6 +24,8 @@
  * THE SOFTWARE.
  */
 
+#include <string.h>
+
 #include "py/mpstate.h"
 #include "py/obj.h"
 #include "py/gc.h"
@@ -100,6 +102,23 @@ static mp_obj_t gc_threshold(size_t n_args, const mp_obj_t *args) {
 MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(gc_threshold_obj, 0, 1, gc_threshold);
 #endif
 
+// CIRCUITPY-CHANGE
+#if MICROPY_GC_MARK_HISTOGRAM
+// mark_histogram([clear]): return the number of collections whose mark phase
+// took under 2**i microseconds, and at least half that, for each i
+static mp_obj_t gc_mark_histogram(size_t n_args, const mp_obj_t *args) {
+    mp_obj_t items[MICROPY_GC_MARK_HISTOGRAM_BUCKETS];
+    for (size_t i = 0; i < MICROPY_GC_MARK_HISTOGRAM_BUCKETS; i++) {
+        items[i] = mp_obj_new_int_from_uint(MP_STATE_MEM(gc_mark_histogram)[i]);
+    }
+    if (n_args > 0 && mp_obj_is_true(args[0])) {
+        memset(MP_STATE_MEM(gc_mark_histogram), 0, sizeof(MP_STATE_MEM(gc_mark_histogram)));
+    }
+    return mp_obj_new_tuple(MICROPY_GC_MARK_HISTOGRAM_BUCKETS, items);
+}
+MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(gc_mark_histogram_obj, 0, 1, gc_mark_histogram);
+#endif
+
 static const mp_rom_map_elem_t mp_module_gc_globals_table[] = {
     { MP_ROM_QSTR(MP_QSTR___name__), MP_ROM_QSTR(MP_QSTR_gc) },
     { MP_ROM_QSTR(MP_QSTR_collect), MP_ROM_PTR(&gc_collect_obj) },
@@ -111,6 +130,10 @@ static const mp_rom_map_elem_t mp_module_gc_globals_table[] = {
     #if MICROPY_GC_ALLOC_THRESHOLD
     { MP_ROM_QSTR(MP_QSTR_threshold), MP_ROM_PTR(&gc_threshold_obj) },
     #endif
+    // CIRCUITPY-CHANGE
+    #if MICROPY_GC_MARK_HISTOGRAM
+    { MP_ROM_QSTR(MP_QSTR_mark_histogram), MP_ROM_PTR(&gc_mark_histogram_obj) },
+    #endif
 };
 
 static MP_DEFINE_CONST_DICT(mp_module_gc_globals, mp_module_gc_globals_table);
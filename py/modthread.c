@@ -29,6 +29,8 @@
 
 #include "py/runtime.h"
 #include "py/stackctrl.h"
+// CIRCUITPY-CHANGE
+#include "py/gc.h"
 
 #if MICROPY_PY_THREAD
 
@@ -210,6 +212,11 @@ static void *thread_entry(void *args_in) {
 
     DEBUG_printf("[thread] finish ts=%p\n", &ts);
 
+    // CIRCUITPY-CHANGE: ts is about to go
+    #if MICROPY_GC_ALLOC_CACHE
+    gc_alloc_cache_release();
+    #endif
+
     // signal that we are finished
     mp_thread_finish();
 
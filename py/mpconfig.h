@@ -196,6 +196,185 @@
 #define MICROPY_GC_STACK_ENTRY_TYPE size_t
 #endif
 
+// CIRCUITPY-CHANGE
+// Number of allocation size classes, counted in blocks, for which the GC
+// remembers where in the heap to start looking for free space. Allocations
+// of this many blocks or more share the last class. With 1, only single block
+// allocations avoid rescanning the start of the heap.
+#ifndef MICROPY_GC_ALLOC_SIZE_CLASSES
+#define MICROPY_GC_ALLOC_SIZE_CLASSES (8)
+#endif
+
+// CIRCUITPY-CHANGE
+// Whether a collection that gc_alloc starts, because the heap is full or the
+// allocation threshold has been passed, frees the garbage it finds a slice at a
+// time from later allocations and gc_sweep_step, rather than all at once. The
+// pause then covers marking only. Explicit collections always sweep at once.
+#ifndef MICROPY_GC_INCREMENTAL_SWEEP
+#define MICROPY_GC_INCREMENTAL_SWEEP (0)
+#endif
+
+// The number of blocks swept in each slice of an incremental sweep. The
+// finalisers of everything to be freed have all run by the time the sweep
+// starts.
+#ifndef MICROPY_GC_SWEEP_SLICE_BLOCKS
+#define MICROPY_GC_SWEEP_SLICE_BLOCKS (1024)
+#endif
+
+// CIRCUITPY-CHANGE
+// Whether a collection that gc_alloc starts on the allocation threshold marks
+// in slices too. It marks what the roots point to, and then later allocations
+// and gc_sweep_step mark what that points to in turn, while objects allocated
+// meanwhile are taken to be live. When there is nothing left to mark, or an
+// allocation can't be met, a final pause marks what the roots point to now and
+// what was stored through the write barrier since marking started, and the
+// sweep follows as for MICROPY_GC_INCREMENTAL_SWEEP. Requires
+// MICROPY_GC_INCREMENTAL_SWEEP, and the same use of gc_write_barrier as
+// MICROPY_GC_NURSERY.
+#ifndef MICROPY_GC_INCREMENTAL_MARK
+#define MICROPY_GC_INCREMENTAL_MARK (0)
+#endif
+
+// The number of blocks looked in for pointers in each slice of incremental
+// marking
+#ifndef MICROPY_GC_MARK_SLICE_BLOCKS
+#define MICROPY_GC_MARK_SLICE_BLOCKS (256)
+#endif
+
+// CIRCUITPY-CHANGE
+// Whether new objects are allocated from a nursery, which is the longest free
+// run in the first heap area. When it fills, a minor collection frees what is
+// unreachable there, taking everything outside it to be live, and what
+// survives stays where it is as the nursery moves to the longest free run
+// again. Full collections happen when no run is long enough, and on the
+// allocation threshold. The nursery objects that old ones point to are found
+// through the write barrier, so all code that stores a pointer into a heap
+// object that it didn't just allocate must call gc_write_barrier.
+#ifndef MICROPY_GC_NURSERY
+#define MICROPY_GC_NURSERY (0)
+#endif
+
+// The largest allocation, in blocks, that goes in the nursery first. Larger
+// ones only go there when there is no room elsewhere, as the ones that live
+// on would break up the free run that it is.
+#ifndef MICROPY_GC_NURSERY_MAX_BLOCKS
+#define MICROPY_GC_NURSERY_MAX_BLOCKS (8)
+#endif
+
+// CIRCUITPY-CHANGE
+// Whether the GC keeps a bit for each block, set by gc_write_barrier when a
+// pointer is stored there, so that it can find the old objects that may point
+// to new ones, or the marked objects that may point to unmarked ones, without
+// looking at all of them.
+#ifndef MICROPY_GC_WRITE_BARRIER
+#define MICROPY_GC_WRITE_BARRIER (MICROPY_GC_NURSERY || MICROPY_GC_INCREMENTAL_MARK)
+#endif
+
+// CIRCUITPY-CHANGE
+// Whether gc_alloc places allocations by how fast the RAM of each heap area
+// is, as reported by gc_ram_is_fast(). Small objects try fast areas first,
+// and bulk data (GC_ALLOC_FLAG_BULK, or at least
+// MICROPY_GC_PLACEMENT_BULK_BYTES) slow ones, before trying any area.
+// Requires MICROPY_GC_SPLIT_HEAP.
+#ifndef MICROPY_GC_PLACEMENT
+#define MICROPY_GC_PLACEMENT (0)
+#endif
+
+#ifndef MICROPY_GC_PLACEMENT_BULK_BYTES
+#define MICROPY_GC_PLACEMENT_BULK_BYTES (4096)
+#endif
+
+// CIRCUITPY-CHANGE: When an allocation fails even after a collection, move
+// large buffers that only their owning object points to, such as the items of
+// a list or bytearray, down the heap so that the free space joins up, and try
+// again. Owners register with gc_movable(). Any other pointer into a buffer
+// that the GC can see, including one on the C stack, keeps it in place, as
+// does handing it out through the buffer protocol. So this must not be enabled
+// where something else the GC can't see, such as DMA, uses a registered
+// buffer. With threads and no GIL, the port must define
+// MICROPY_GC_COMPACT_OTHER_THREADS() to say whether any threads but the
+// calling one exist, and there is no compaction while they do.
+#ifndef MICROPY_GC_COMPACT
+#define MICROPY_GC_COMPACT (0)
+#endif
+
+// The number of owners of movable buffers there is room for at first. The
+// table of them doubles in size on the heap when it is full.
+#ifndef MICROPY_GC_COMPACT_MOVABLE_INIT
+#define MICROPY_GC_COMPACT_MOVABLE_INIT (16)
+#endif
+
+// The size of the smallest buffer worth moving
+#ifndef MICROPY_GC_COMPACT_MIN_BYTES
+#define MICROPY_GC_COMPACT_MIN_BYTES (1024)
+#endif
+
+// CIRCUITPY-CHANGE
+// Whether to provide gc_heap_walk and gc_reachable_bytes, for heap analysis
+// such as the uheap module
+#ifndef MICROPY_GC_HEAP_WALK
+#define MICROPY_GC_HEAP_WALK (0)
+#endif
+
+// CIRCUITPY-CHANGE
+// Whether the mark phase of a collection is shared with helper threads, such
+// as one on the other core of a dual core chip. The port starts them with
+// gc_mark_helpers_start(). Marks are set with atomic operations, and each
+// thread keeps a mark stack that the others steal work from when they run
+// out. Not used while compacting.
+#ifndef MICROPY_GC_PARALLEL_MARK
+#define MICROPY_GC_PARALLEL_MARK (0)
+#endif
+
+// The number of threads that mark, including the one collecting
+#ifndef MICROPY_GC_MARK_THREADS
+#define MICROPY_GC_MARK_THREADS (2)
+#endif
+
+// Called while a marking thread waits for work, for example to yield
+#ifndef MICROPY_GC_MARK_IDLE_HOOK
+#define MICROPY_GC_MARK_IDLE_HOOK()
+#endif
+
+// CIRCUITPY-CHANGE
+// Whether to keep a histogram of how long the mark phase of each collection
+// takes, using mp_hal_ticks_us(), for gc.mark_histogram(). Bucket i counts
+// mark phases that took under 2**i microseconds, and at least half that. The
+// last bucket counts all the longer ones too.
+#ifndef MICROPY_GC_MARK_HISTOGRAM
+#define MICROPY_GC_MARK_HISTOGRAM (0)
+#endif
+
+#ifndef MICROPY_GC_MARK_HISTOGRAM_BUCKETS
+#define MICROPY_GC_MARK_HISTOGRAM_BUCKETS (20)
+#endif
+
+// CIRCUITPY-CHANGE
+// Whether each thread keeps runs of small free objects, claimed from the heap
+// with one take of the GC mutex, and allocates from them without taking it.
+// Only useful with threads and no GIL. A collection empties all the runs, so
+// that the sweep frees what is left of them.
+#ifndef MICROPY_GC_ALLOC_CACHE
+#define MICROPY_GC_ALLOC_CACHE (0)
+#endif
+
+// The largest allocation, in blocks, that comes from a run. Each size up to
+// this has its own run.
+#ifndef MICROPY_GC_ALLOC_CACHE_MAX_BLOCKS
+#define MICROPY_GC_ALLOC_CACHE_MAX_BLOCKS (4)
+#endif
+
+// The number of blocks claimed for a run at a time
+#ifndef MICROPY_GC_ALLOC_CACHE_RUN_BLOCKS
+#define MICROPY_GC_ALLOC_CACHE_RUN_BLOCKS (64)
+#endif
+
+// Called while a collection waits for a thread to finish taking an object
+// from its runs, for example to yield
+#ifndef MICROPY_GC_ALLOC_CACHE_WAIT_HOOK
+#define MICROPY_GC_ALLOC_CACHE_WAIT_HOOK()
+#endif
+
 // Be conservative and always clear to zero newly (re)allocated memory in the GC.
 // This helps eliminate stray pointers that hold on to memory that's no longer
 // used.  It decreases performance due to unnecessary memory clearing.
@@ -1558,6 +1737,18 @@ typedef double mp_float_t;
 #define MICROPY_PY_SYS_SETTRACE (0)
 #endif
 
+// CIRCUITPY-CHANGE
+// Whether the VM keeps MP_STATE_THREAD(current_code_state) pointing at the
+// innermost running bytecode function, so that code outside the VM (such as
+// the allocation profiler) can find the current source line.
+// This costs two stores per call. sys.settrace needs it.
+#ifndef MICROPY_TRACK_CODE_STATE
+#define MICROPY_TRACK_CODE_STATE (MICROPY_PY_SYS_SETTRACE)
+#endif
+#if MICROPY_PY_SYS_SETTRACE && !MICROPY_TRACK_CODE_STATE
+#error MICROPY_PY_SYS_SETTRACE requires MICROPY_TRACK_CODE_STATE
+#endif
+
 // Whether to provide "sys.getsizeof" function
 #ifndef MICROPY_PY_SYS_GETSIZEOF
 #define MICROPY_PY_SYS_GETSIZEOF (MICROPY_CONFIG_ROM_LEVEL_AT_LEAST_EVERYTHING)
@@ -100,13 +100,91 @@ typedef struct _mp_state_mem_area_t {
     #if MICROPY_ENABLE_FINALISER
     byte *gc_finaliser_table_start;
     #endif
+    // CIRCUITPY-CHANGE
+    #if MICROPY_GC_WRITE_BARRIER
+    byte *gc_remembered_table_start;
+    #endif
     byte *gc_pool_start;
     byte *gc_pool_end;
 
-    size_t gc_last_free_atb_index;
+    // CIRCUITPY-CHANGE
+    // For each size class, the ATB index before which there is no run of
+    // free blocks of that size (for the last class, of at least that size)
+    size_t gc_first_free_atb_index[MICROPY_GC_ALLOC_SIZE_CLASSES];
+    #if MICROPY_GC_ALLOC_CACHE
+    // The same, for runs for the threads' allocation caches
+    size_t gc_first_free_run_atb_index;
+    #endif
     size_t gc_last_used_block; // The block ID of the highest block allocated in the area
+    #if MICROPY_GC_INCREMENTAL_SWEEP
+    // CIRCUITPY-CHANGE
+    // The first block that a pending incremental sweep hasn't reached yet, or
+    // SIZE_MAX when none is pending. From there on, live objects are marked.
+    size_t gc_sweep_block;
+    #endif
+    #if MICROPY_GC_PLACEMENT
+    // CIRCUITPY-CHANGE
+    bool gc_fast; // Whether the area is in fast RAM, such as internal SRAM
+    #endif
 } mp_state_mem_area_t;
 
+#if MICROPY_GC_PARALLEL_MARK
+// CIRCUITPY-CHANGE
+// A marked block whose children are still to be marked
+typedef struct _mp_gc_mark_entry_t {
+    MICROPY_GC_STACK_ENTRY_TYPE block;
+    #if MICROPY_GC_SPLIT_HEAP
+    mp_state_mem_area_t *area;
+    #endif
+} mp_gc_mark_entry_t;
+
+// The mark stacks of one marking thread. It pushes and pops its own stack
+// without locking. When its shared stack is empty, it moves the oldest of its
+// own entries there, for any thread to take under the lock.
+typedef struct _mp_gc_mark_thread_t {
+    uint8_t lock;
+    size_t n_shared;
+    mp_gc_mark_entry_t shared[MICROPY_ALLOC_GC_STACK_SIZE];
+    size_t n_own;
+    mp_gc_mark_entry_t own[MICROPY_ALLOC_GC_STACK_SIZE];
+} mp_gc_mark_thread_t;
+#endif
+
+#if MICROPY_GC_ALLOC_CACHE
+// CIRCUITPY-CHANGE
+// The runs of free objects of one thread, one run for each size in blocks.
+// The objects from next up to end are allocated and zeroed, and not handed
+// out yet. The thread takes them without the GC mutex, and a collection
+// empties the runs of every thread.
+typedef struct _mp_gc_alloc_cache_t {
+    // The next cache in the list of all of them
+    struct _mp_gc_alloc_cache_t *next_cache;
+    // Set while the thread takes an object, for a collection to wait on
+    uint8_t busy;
+    bool listed;
+    byte *next[MICROPY_GC_ALLOC_CACHE_MAX_BLOCKS];
+    byte *end[MICROPY_GC_ALLOC_CACHE_MAX_BLOCKS];
+} mp_gc_alloc_cache_t;
+#endif
+
+#if MICROPY_GC_COMPACT
+// CIRCUITPY-CHANGE
+// An object with a pointer to a buffer that compaction may move. The pointers
+// are kept inverted, as the GC looks in the table of these.
+typedef struct _mp_gc_movable_t {
+    uintptr_t owner; // 0 if the entry is unused
+    uintptr_t type; // The owner's type, to tell if it has been freed
+    uintptr_t handle; // Where in the owner the pointer is
+    uintptr_t lent; // The buffer last handed out through the buffer protocol
+    size_t n_bytes; // The size of the buffer when it was registered
+    // Set up for a compacting collection: the buffer, and whether anything
+    // other than the handle points into it
+    uintptr_t buf;
+    uintptr_t buf_end;
+    bool pinned;
+} mp_gc_movable_t;
+#endif
+
 // This structure hold information about the memory allocation system.
 typedef struct _mp_state_mem_t {
     #if MICROPY_MEM_STATS
@@ -142,6 +220,77 @@ typedef struct _mp_state_mem_t {
     size_t gc_collected;
     #endif
 
+    #if MICROPY_GC_INCREMENTAL_SWEEP
+    // CIRCUITPY-CHANGE
+    // The area being swept incrementally, or NULL when no sweep is pending
+    mp_state_mem_area_t *gc_sweep_area;
+    // The highest block found in use in it so far
+    size_t gc_sweep_last_used_block;
+    // Whether the collection in progress is to be swept incrementally
+    bool gc_sweep_lazily;
+    #endif
+
+    #if MICROPY_GC_INCREMENTAL_MARK
+    // CIRCUITPY-CHANGE
+    // Where incremental marking has got to, and how many blocks are left on
+    // gc_block_stack for it to look in. Those that didn't fit are looked for
+    // among the remembered blocks, from gc_mark_walk_block of
+    // gc_mark_walk_area on, unless that is NULL.
+    uint8_t gc_mark_phase;
+    size_t gc_mark_sp;
+    mp_state_mem_area_t *gc_mark_walk_area;
+    size_t gc_mark_walk_block;
+    #endif
+
+    #if MICROPY_GC_NURSERY
+    // CIRCUITPY-CHANGE
+    // The nursery is blocks gc_nursery_start up to gc_nursery_end of the
+    // first area, or none if they are the same. Allocations there carry on
+    // from gc_nursery_next.
+    size_t gc_nursery_start;
+    size_t gc_nursery_end;
+    size_t gc_nursery_next;
+    // Whether the collection in progress is a minor one
+    bool gc_minor;
+    #endif
+
+    #if MICROPY_GC_COMPACT
+    // CIRCUITPY-CHANGE
+    // The table of owners of movable buffers, on the heap, which grows as
+    // needed
+    mp_gc_movable_t *gc_movable;
+    size_t gc_movable_len;
+    // During a compacting collection, the number of entries at the start of
+    // gc_movable, in buffer address order, that are being considered; else 0
+    size_t gc_compact_len;
+    #endif
+
+    #if MICROPY_GC_PARALLEL_MARK
+    // CIRCUITPY-CHANGE
+    mp_gc_mark_thread_t gc_mark_threads[MICROPY_GC_MARK_THREADS];
+    // Whether the collection in progress marks in parallel
+    bool gc_mark_parallel;
+    // The number of threads marking, and how many of them are out of work
+    size_t gc_mark_n_threads;
+    size_t gc_mark_n_idle;
+    #endif
+
+    #if MICROPY_GC_MARK_HISTOGRAM
+    // CIRCUITPY-CHANGE
+    mp_uint_t gc_mark_start_us;
+    size_t gc_mark_histogram[MICROPY_GC_MARK_HISTOGRAM_BUCKETS];
+    #endif
+
+    #if MICROPY_GC_ALLOC_CACHE
+    // CIRCUITPY-CHANGE
+    // The caches of the threads that have used them, whether a collection
+    // has stopped the threads taking objects from them, and whether there
+    // was no free run for one since the last collection
+    mp_gc_alloc_cache_t *gc_alloc_caches;
+    uint8_t gc_alloc_cache_blocked;
+    bool gc_alloc_cache_no_run;
+    #endif
+
     #if MICROPY_PY_THREAD && !MICROPY_PY_THREAD_GIL
     // This is a global mutex used to make the GC thread-safe.
     mp_thread_mutex_t gc_mutex;
@@ -294,6 +443,26 @@ typedef struct _mp_state_thread_t {
     // Locking of the GC is done per thread.
     uint16_t gc_lock_depth;
 
+    // CIRCUITPY-CHANGE
+    #if MICROPY_GC_NURSERY
+    // Whether the next collection this thread starts is to be a minor one.
+    // gc_collect_start takes it up with the GC mutex held.
+    bool gc_collect_minor;
+    #endif
+    #if MICROPY_GC_INCREMENTAL_SWEEP
+    // Likewise whether it is to be swept incrementally
+    bool gc_collect_lazily;
+    #endif
+    #if MICROPY_GC_INCREMENTAL_MARK
+    // and marked incrementally
+    bool gc_collect_incremental;
+    #endif
+
+    // CIRCUITPY-CHANGE
+    #if MICROPY_GC_ALLOC_CACHE
+    mp_gc_alloc_cache_t gc_alloc_cache;
+    #endif
+
     ////////////////////////////////////////////////////////////
     // START ROOT POINTER SECTION
     // Everything that needs GC scanning must start here, and
@@ -315,6 +484,9 @@ typedef struct _mp_state_thread_t {
     #if MICROPY_PY_SYS_SETTRACE
     mp_obj_t prof_trace_callback;
     bool prof_callback_is_executing;
+    #endif
+    // CIRCUITPY-CHANGE
+    #if MICROPY_TRACK_CODE_STATE
     struct _mp_code_state_t *current_code_state;
     #endif
 
@@ -256,6 +256,11 @@ static double mp_obj_get_float_to_d(mp_obj_t o) {
 
 #endif
 
+// CIRCUITPY-CHANGE
+static void mp_native_gc_write_barrier(const void *ptr) {
+    gc_write_barrier(ptr);
+}
+
 // these must correspond to the respective enum in nativeglue.h
 const mp_fun_table_t mp_fun_table = {
     mp_const_none,
@@ -357,6 +362,8 @@ const mp_fun_table_t mp_fun_table = {
     &mp_stream_readinto_obj,
     &mp_stream_unbuffered_readline_obj,
     &mp_stream_write_obj,
+    // CIRCUITPY-CHANGE
+    mp_native_gc_write_barrier,
 };
 
 #elif MICROPY_EMIT_NATIVE && MICROPY_DYNAMIC_COMPILER
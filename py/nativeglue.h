@@ -27,6 +27,7 @@
 #define MICROPY_INCLUDED_PY_NATIVEGLUE_H
 
 #include <stdarg.h>
+#include <stddef.h>
 #include "py/obj.h"
 #include "py/persistentcode.h"
 #include "py/stream.h"
@@ -182,8 +183,13 @@ typedef struct _mp_fun_table_t {
     const mp_obj_fun_builtin_var_t *stream_readinto_obj;
     const mp_obj_fun_builtin_var_t *stream_unbuffered_readline_obj;
     const mp_obj_fun_builtin_var_t *stream_write_obj;
+    // CIRCUITPY-CHANGE: last, so that the entries above keep their indices
+    void (*gc_write_barrier)(const void *ptr);
 } mp_fun_table_t;
 
+// CIRCUITPY-CHANGE: the index of an entry past MP_F_NUMBER_OF, for emit_call
+#define MP_F_GC_WRITE_BARRIER ((mp_fun_kind_t)(offsetof(mp_fun_table_t, gc_write_barrier) / sizeof(void *)))
+
 #if (MICROPY_EMIT_NATIVE && !MICROPY_DYNAMIC_COMPILER) || MICROPY_ENABLE_DYNRUNTIME
 extern const mp_fun_table_t mp_fun_table;
 #elif MICROPY_EMIT_NATIVE && MICROPY_DYNAMIC_COMPILER
@@ -32,6 +32,8 @@
 // CIRCUITPY-CHANGE
 #include "shared/runtime/interrupt_char.h"
 #include "py/obj.h"
+// CIRCUITPY-CHANGE
+#include "py/gc.h"
 #include "py/objtype.h"
 #include "py/objint.h"
 #include "py/objstr.h"
@@ -646,6 +648,10 @@ mp_obj_t mp_obj_subscr(mp_obj_t base, mp_obj_t index, mp_obj_t value) {
         // May have called port specific C code. Make sure it didn't mess up the heap.
         assert_heap_ok();
         if (ret != MP_OBJ_NULL) {
+            // CIRCUITPY-CHANGE: wherever in base it was stored
+            if (value != MP_OBJ_SENTINEL) {
+                gc_write_barrier_obj(MP_OBJ_TO_PTR(base));
+            }
             return ret;
         }
         // TODO: call base classes here?
@@ -726,6 +732,10 @@ bool mp_get_buffer(mp_obj_t obj, mp_buffer_info_t *bufinfo, mp_uint_t flags) {
     const mp_obj_type_t *type = mp_obj_get_type(obj);
     if (MP_OBJ_TYPE_HAS_SLOT(type, buffer)
         && MP_OBJ_TYPE_GET_SLOT(type, buffer)(obj, bufinfo, flags & MP_BUFFER_RW) == 0) {
+        // CIRCUITPY-CHANGE: whatever is given the buffer may keep it
+        #if MICROPY_GC_COMPACT
+        gc_movable_lend(bufinfo->buf);
+        #endif
         return true;
     }
     if (flags & MP_BUFFER_RAISE_IF_UNSUPPORTED) {
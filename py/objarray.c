@@ -31,6 +31,8 @@
 
 #include "py/runtime.h"
 #include "py/binary.h"
+// CIRCUITPY-CHANGE
+#include "py/gc.h"
 #include "py/objstr.h"
 #include "py/objarray.h"
 
@@ -117,6 +119,8 @@ static mp_obj_array_t *array_new(char typecode, size_t n) {
     o->free = 0;
     o->len = n;
     o->items = m_new(byte, typecode_size * o->len);
+    // CIRCUITPY-CHANGE
+    gc_movable(o, &o->items, typecode_size * o->len);
     return o;
 }
 #endif
@@ -348,6 +352,8 @@ static mp_obj_t array_binary_op(mp_binary_op_t op, mp_obj_t lhs_in, mp_obj_t rhs
                 res = lhs;
                 size_t item_sz = mp_binary_get_size('@', lhs->typecode, NULL);
                 lhs->items = m_renew(byte, lhs->items, (lhs->len + lhs->free) * item_sz, lhs->len * repeat * item_sz);
+                // CIRCUITPY-CHANGE
+                gc_movable(lhs, &lhs->items, lhs->len * repeat * item_sz);
                 lhs->len = lhs->len * repeat;
                 lhs->free = 0;
                 if (!repeat) {
@@ -469,6 +475,8 @@ static mp_obj_t array_append(mp_obj_t self_in, mp_obj_t arg) {
         // TODO: alloc policy
         self->free = 8;
         self->items = m_renew(byte, self->items, item_sz * self->len, item_sz * (self->len + self->free));
+        // CIRCUITPY-CHANGE
+        gc_movable(self, &self->items, item_sz * (self->len + self->free));
         mp_seq_clear(self->items, self->len + 1, self->len + self->free, item_sz);
     }
     mp_binary_set_val_array(self->typecode, self->items, self->len, arg);
@@ -498,6 +506,8 @@ static mp_obj_t array_extend(mp_obj_t self_in, mp_obj_t arg_in) {
         // TODO: alloc policy; at the moment we go conservative
         if (self->free < len) {
             self->items = m_renew(byte, self->items, (self->len + self->free) * sz, (self->len + len) * sz);
+            // CIRCUITPY-CHANGE
+            gc_movable(self, &self->items, (self->len + len) * sz);
             self->free = 0;
         } else {
             self->free -= len;
@@ -649,6 +659,8 @@ static mp_obj_t array_subscr(mp_obj_t self_in, mp_obj_t index_in, mp_obj_t value
                         // TODO: alloc policy; at the moment we go conservative
                         o->items = m_renew(byte, o->items, (o->len + o->free) * item_sz, (o->len + len_adj) * item_sz);
                         o->free = len_adj;
+                        // CIRCUITPY-CHANGE
+                        gc_movable(o, &o->items, (o->len + len_adj) * item_sz);
                         // m_renew may have moved o->items
                         if (src_items == dest_items) {
                             src_items = o->items;
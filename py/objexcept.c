@@ -667,6 +667,8 @@ void mp_obj_exception_add_traceback(mp_obj_t self_in, qstr file, size_t line, qs
         }
         // populate traceback object
         *self->traceback = mp_const_empty_traceback_obj;
+        // CIRCUITPY-CHANGE
+        gc_write_barrier(&self->traceback);
     }
 
     // append the provided traceback info to traceback data
@@ -692,6 +694,8 @@ void mp_obj_exception_add_traceback(mp_obj_t self_in, qstr file, size_t line, qs
         } else {
             // Allocated the traceback data on the heap
             self->traceback->alloc = TRACEBACK_ENTRY_LEN;
+            // CIRCUITPY-CHANGE
+            gc_write_barrier(&self->traceback->data);
         }
         self->traceback->len = 0;
     } else if (self->traceback->len + TRACEBACK_ENTRY_LEN > self->traceback->alloc) {
@@ -709,6 +713,8 @@ void mp_obj_exception_add_traceback(mp_obj_t self_in, qstr file, size_t line, qs
         }
         self->traceback->data = tb_data;
         self->traceback->alloc += TRACEBACK_ENTRY_LEN;
+        // CIRCUITPY-CHANGE
+        gc_write_barrier(&self->traceback->data);
     }
 
     size_t *tb_data = &self->traceback->data[self->traceback->len];
@@ -31,6 +31,8 @@
 #include "py/objtuple.h"
 #include "py/objfun.h"
 #include "py/runtime.h"
+// CIRCUITPY-CHANGE
+#include "py/gc.h"
 #include "py/bc.h"
 #include "py/stackctrl.h"
 
@@ -48,6 +50,10 @@
 /******************************************************************************/
 /* builtin functions                                                          */
 
+// CIRCUITPY-CHANGE
+// A builtin may store into the first object that it is passed, such as a
+// method into its self, so that goes through the write barrier
+
 // CIRCUITPY-CHANGE: PLACE_IN_ITCM
 static mp_obj_t PLACE_IN_ITCM(fun_builtin_0_call)(mp_obj_t self_in, size_t n_args, size_t n_kw, const mp_obj_t *args) {
     (void)args;
@@ -67,6 +73,8 @@ static mp_obj_t PLACE_IN_ITCM(fun_builtin_1_call)(mp_obj_t self_in, size_t n_arg
     assert(mp_obj_is_type(self_in, &mp_type_fun_builtin_1));
     mp_obj_fun_builtin_fixed_t *self = MP_OBJ_TO_PTR(self_in);
     mp_arg_check_num(n_args, n_kw, 1, 1, false);
+    // CIRCUITPY-CHANGE
+    gc_write_barrier_obj(MP_OBJ_TO_PTR(args[0]));
     return self->fun._1(args[0]);
 }
 
@@ -79,6 +87,8 @@ static mp_obj_t fun_builtin_2_call(mp_obj_t self_in, size_t n_args, size_t n_kw,
     assert(mp_obj_is_type(self_in, &mp_type_fun_builtin_2));
     mp_obj_fun_builtin_fixed_t *self = MP_OBJ_TO_PTR(self_in);
     mp_arg_check_num(n_args, n_kw, 2, 2, false);
+    // CIRCUITPY-CHANGE
+    gc_write_barrier_obj(MP_OBJ_TO_PTR(args[0]));
     return self->fun._2(args[0], args[1]);
 }
 
@@ -92,6 +102,8 @@ static mp_obj_t PLACE_IN_ITCM(fun_builtin_3_call)(mp_obj_t self_in, size_t n_arg
     assert(mp_obj_is_type(self_in, &mp_type_fun_builtin_3));
     mp_obj_fun_builtin_fixed_t *self = MP_OBJ_TO_PTR(self_in);
     mp_arg_check_num(n_args, n_kw, 3, 3, false);
+    // CIRCUITPY-CHANGE
+    gc_write_barrier_obj(MP_OBJ_TO_PTR(args[0]));
     return self->fun._3(args[0], args[1], args[2]);
 }
 
@@ -106,6 +118,10 @@ static mp_obj_t fun_builtin_var_call(mp_obj_t self_in, size_t n_args, size_t n_k
 
     // check number of arguments
     mp_arg_check_num_sig(n_args, n_kw, self->sig);
+    // CIRCUITPY-CHANGE
+    if (n_args > 0) {
+        gc_write_barrier_obj(MP_OBJ_TO_PTR(args[0]));
+    }
 
     if (self->sig & 1) {
         // function allows keywords
@@ -30,6 +30,8 @@
 
 #include "py/runtime.h"
 #include "py/bc.h"
+// CIRCUITPY-CHANGE
+#include "py/gc.h"
 #include "py/objstr.h"
 #include "py/objgenerator.h"
 #include "py/objfun.h"
@@ -277,6 +279,9 @@ mp_vm_return_kind_t mp_obj_gen_resume(mp_obj_t self_in, mp_obj_t send_value, mp_
     // Mark as not running
     self->pend_exc = mp_const_none;
 
+    // CIRCUITPY-CHANGE: for what it stored in its state while it ran
+    gc_write_barrier_obj(self);
+
     switch (ret_kind) {
         case MP_VM_RETURN_NORMAL:
         default:
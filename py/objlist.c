@@ -27,6 +27,8 @@
 #include <string.h>
 #include <assert.h>
 
+// CIRCUITPY-CHANGE
+#include "py/gc.h"
 #include "py/objlist.h"
 #include "py/runtime.h"
 #include "py/stackctrl.h"
@@ -188,6 +190,8 @@ static mp_obj_t list_subscr(mp_obj_t self_in, mp_obj_t index, mp_obj_t value) {
             // Clear "freed" elements at the end of list
             mp_seq_clear(self->items, self->len + len_adj, self->len, sizeof(*self->items));
             self->len += len_adj;
+            // CIRCUITPY-CHANGE
+            gc_write_barrier_obj(self->items);
             return mp_const_none;
         }
         #endif
@@ -227,6 +231,9 @@ static mp_obj_t list_subscr(mp_obj_t self_in, mp_obj_t index, mp_obj_t value) {
                     // be grown inplace or not
                     self->items = m_renew(mp_obj_t, self->items, self->alloc, self->len + len_adj);
                     self->alloc = self->len + len_adj;
+                    // CIRCUITPY-CHANGE
+                    gc_movable(self, (void **)&self->items, self->alloc * sizeof(mp_obj_t));
+                    gc_write_barrier(&self->items);
                 }
                 mp_seq_replace_slice_grow_inplace(self->items, self->len,
                     slice_out.start, slice_out.stop, value_items, value_len, len_adj, sizeof(*self->items));
@@ -238,6 +245,8 @@ static mp_obj_t list_subscr(mp_obj_t self_in, mp_obj_t index, mp_obj_t value) {
                 // TODO: apply allocation policy re: alloc_size
             }
             self->len += len_adj;
+            // CIRCUITPY-CHANGE
+            gc_write_barrier_obj(self->items);
             return mp_const_none;
         }
         #endif
@@ -257,8 +266,13 @@ mp_obj_t mp_obj_list_append(mp_obj_t self_in, mp_obj_t arg) {
     if (self->len >= self->alloc) {
         self->items = m_renew(mp_obj_t, self->items, self->alloc, self->alloc * 2);
         self->alloc *= 2;
+        // CIRCUITPY-CHANGE
+        gc_movable(self, (void **)&self->items, self->alloc * sizeof(mp_obj_t));
+        gc_write_barrier(&self->items);
         mp_seq_clear(self->items, self->len + 1, self->alloc, sizeof(*self->items));
     }
+    // CIRCUITPY-CHANGE
+    gc_write_barrier(&self->items[self->len]);
     self->items[self->len++] = arg;
     return mp_const_none; // return None, as per CPython
 }
@@ -274,11 +288,16 @@ static mp_obj_t list_extend(mp_obj_t self_in, mp_obj_t arg_in) {
             // TODO: use alloc policy for "4"
             self->items = m_renew(mp_obj_t, self->items, self->alloc, self->len + arg->len + 4);
             self->alloc = self->len + arg->len + 4;
+            // CIRCUITPY-CHANGE
+            gc_movable(self, (void **)&self->items, self->alloc * sizeof(mp_obj_t));
+            gc_write_barrier(&self->items);
             mp_seq_clear(self->items, self->len + arg->len, self->alloc, sizeof(*self->items));
         }
 
         memcpy(self->items + self->len, arg->items, sizeof(mp_obj_t) * arg->len);
         self->len += arg->len;
+        // CIRCUITPY-CHANGE
+        gc_write_barrier_obj(self->items);
     } else {
         list_extend_from_iter(self_in, arg_in);
     }
@@ -296,9 +315,15 @@ inline mp_obj_t mp_obj_list_pop(mp_obj_list_t *self, size_t index) {
     memmove(self->items + index, self->items + index + 1, (self->len - index) * sizeof(mp_obj_t));
     // Clear stale pointer from slot which just got freed to prevent GC issues
     self->items[self->len] = MP_OBJ_NULL;
+    // CIRCUITPY-CHANGE: the items after it have moved
+    if (index < self->len) {
+        gc_write_barrier_obj(self->items);
+    }
     if (self->alloc > LIST_MIN_ALLOC && self->alloc > 2 * self->len) {
         self->items = m_renew(mp_obj_t, self->items, self->alloc, self->alloc / 2);
         self->alloc /= 2;
+        // CIRCUITPY-CHANGE
+        gc_write_barrier(&self->items);
     }
     return ret;
 }
@@ -365,6 +390,8 @@ mp_obj_t mp_obj_list_sort(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_
         mp_quicksort(self->items, self->items + self->len - 1,
             args.key.u_obj == mp_const_none ? MP_OBJ_NULL : args.key.u_obj,
             args.reverse.u_bool ? mp_const_false : mp_const_true);
+        // CIRCUITPY-CHANGE
+        gc_write_barrier_obj(self->items);
     }
 
     return mp_const_none;
@@ -378,6 +405,8 @@ mp_obj_t mp_obj_list_clear(mp_obj_t self_in) {
     self->len = 0;
     self->items = m_renew(mp_obj_t, self->items, self->alloc, LIST_MIN_ALLOC);
     self->alloc = LIST_MIN_ALLOC;
+    // CIRCUITPY-CHANGE
+    gc_write_barrier(&self->items);
     mp_seq_clear(self->items, 0, self->alloc, sizeof(*self->items));
     return mp_const_none;
 }
@@ -411,6 +440,8 @@ inline void mp_obj_list_insert(mp_obj_list_t *self, size_t index, mp_obj_t obj)
         self->items[i] = self->items[i - 1];
     }
     self->items[index] = obj;
+    // CIRCUITPY-CHANGE
+    gc_write_barrier_obj(self->items);
 }
 
 static mp_obj_t list_insert(mp_obj_t self_in, mp_obj_t idx, mp_obj_t obj) {
@@ -452,6 +483,8 @@ static mp_obj_t list_reverse(mp_obj_t self_in) {
         self->items[i] = self->items[len - i - 1];
         self->items[len - i - 1] = a;
     }
+    // CIRCUITPY-CHANGE
+    gc_write_barrier_obj(self->items);
 
     return mp_const_none;
 }
@@ -505,6 +538,8 @@ void mp_obj_list_init(mp_obj_list_t *o, size_t n) {
     o->alloc = n < LIST_MIN_ALLOC ? LIST_MIN_ALLOC : n;
     o->len = n;
     o->items = m_new(mp_obj_t, o->alloc);
+    // CIRCUITPY-CHANGE
+    gc_movable(o, (void **)&o->items, o->alloc * sizeof(mp_obj_t));
     mp_seq_clear(o->items, n, o->alloc, sizeof(*o->items));
 }
 
@@ -543,6 +578,8 @@ void mp_obj_list_store(mp_obj_t self_in, mp_obj_t index, mp_obj_t value) {
     mp_obj_list_t *self = native_list(self_in);
     size_t i = mp_get_index(self->base.type, self->len, index, false);
     self->items[i] = value;
+    // CIRCUITPY-CHANGE
+    gc_write_barrier(&self->items[i]);
 }
 
 /******************************************************************************/
@@ -282,6 +282,8 @@ static qstr qstr_add(mp_uint_t len, const char *q_ptr) {
     #endif
     MP_STATE_VM(last_pool)->lengths[at] = len;
     MP_STATE_VM(last_pool)->qstrs[at] = q_ptr;
+    // CIRCUITPY-CHANGE
+    gc_write_barrier(&MP_STATE_VM(last_pool)->qstrs[at]);
     MP_STATE_VM(last_pool)->len++;
 
     // return id for the newly-added qstr
@@ -172,6 +172,9 @@ void mp_init(void) {
     #if MICROPY_PY_SYS_SETTRACE
     MP_STATE_THREAD(prof_trace_callback) = MP_OBJ_NULL;
     MP_STATE_THREAD(prof_callback_is_executing) = false;
+    #endif
+    // CIRCUITPY-CHANGE
+    #if MICROPY_TRACK_CODE_STATE
     MP_STATE_THREAD(current_code_state) = NULL;
     #endif
 
@@ -648,6 +651,10 @@ generic_binary_op:
     if (MP_OBJ_TYPE_HAS_SLOT(type, binary_op)) {
         mp_obj_t result = MP_OBJ_TYPE_GET_SLOT(type, binary_op)(op, lhs, rhs);
         if (result != MP_OBJ_NULL) {
+            // CIRCUITPY-CHANGE: an inplace op may have stored into lhs
+            if (op >= MP_BINARY_OP_INPLACE_OR && op <= MP_BINARY_OP_INPLACE_POWER) {
+                gc_write_barrier_obj(MP_OBJ_TO_PTR(lhs));
+            }
             return result;
         }
     }
@@ -1326,6 +1333,8 @@ void mp_store_attr(mp_obj_t base, qstr attr, mp_obj_t value) {
         MP_OBJ_TYPE_GET_SLOT(type, attr)(base, attr, dest);
         if (dest[0] == MP_OBJ_NULL) {
             // success
+            // CIRCUITPY-CHANGE: wherever in base it was stored
+            gc_write_barrier_obj(MP_OBJ_TO_PTR(base));
             return;
         }
         // CIRCUITPY-CHANGE: https://github.com/adafruit/circuitpython/pull/50
@@ -193,11 +193,31 @@ static inline void mp_thread_init_state(mp_state_thread_t *ts, size_t stack_size
 
     // GC starts off unlocked
     ts->gc_lock_depth = 0;
+    // CIRCUITPY-CHANGE
+    #if MICROPY_GC_NURSERY
+    ts->gc_collect_minor = false;
+    #endif
+    #if MICROPY_GC_INCREMENTAL_SWEEP
+    ts->gc_collect_lazily = false;
+    #endif
+    #if MICROPY_GC_INCREMENTAL_MARK
+    ts->gc_collect_incremental = false;
+    #endif
 
     // There are no pending jump callbacks or exceptions yet
     ts->nlr_jump_callback_top = NULL;
     ts->mp_pending_exception = MP_OBJ_NULL;
 
+    // CIRCUITPY-CHANGE: no bytecode is running in the new thread yet
+    #if MICROPY_TRACK_CODE_STATE
+    ts->current_code_state = NULL;
+    #endif
+
+    // CIRCUITPY-CHANGE: nor any runs of free objects
+    #if MICROPY_GC_ALLOC_CACHE
+    memset(&ts->gc_alloc_cache, 0, sizeof(ts->gc_alloc_cache));
+    #endif
+
     // If locals/globals are not given, inherit from main thread
     if (locals == NULL) {
         locals = mp_state_ctx.thread.dict_locals;
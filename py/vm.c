@@ -34,6 +34,8 @@
 #include "py/objfun.h"
 #include "py/runtime.h"
 #include "py/bc0.h"
+// CIRCUITPY-CHANGE
+#include "py/gc.h"
 #include "py/profile.h"
 
 // *FORMAT-OFF*
@@ -187,6 +189,24 @@
     } \
 } while(0)
 
+// CIRCUITPY-CHANGE: track the current code state without the rest of settrace
+#elif MICROPY_TRACK_CODE_STATE
+
+#define FRAME_SETUP() do { \
+    MP_STATE_THREAD(current_code_state) = code_state; \
+} while(0)
+
+#define FRAME_ENTER() do { \
+    code_state->prev_state = MP_STATE_THREAD(current_code_state); \
+} while(0)
+
+#define FRAME_LEAVE() do { \
+    MP_STATE_THREAD(current_code_state) = code_state->prev_state; \
+} while(0)
+
+#define FRAME_UPDATE()
+#define TRACE_TICK(current_ip, current_sp, is_exception)
+
 #else // MICROPY_PY_SYS_SETTRACE
 #define FRAME_SETUP()
 #define FRAME_ENTER()
@@ -478,6 +498,8 @@ dispatch_loop:
                 ENTRY(MP_BC_STORE_DEREF): {
                     DECODE_UINT;
                     mp_obj_cell_set(fastn[-unum], POP());
+                    // CIRCUITPY-CHANGE
+                    gc_write_barrier(MP_OBJ_TO_PTR(fastn[-unum]));
                     DISPATCH();
                 }
 
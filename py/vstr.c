@@ -33,6 +33,8 @@
 #include "py/mpconfig.h"
 #include "py/runtime.h"
 #include "py/mpprint.h"
+// CIRCUITPY-CHANGE
+#include "py/gc.h"
 
 // returned value is always at least 1 greater than argument
 #define ROUND_ALLOC(a) (((a) & ((~0U) - 7)) + 8)
@@ -45,6 +47,8 @@ void vstr_init(vstr_t *vstr, size_t alloc) {
     vstr->alloc = alloc;
     vstr->len = 0;
     vstr->buf = m_new(char, vstr->alloc);
+    // CIRCUITPY-CHANGE: the vstr itself may be in the heap
+    gc_write_barrier(&vstr->buf);
     vstr->fixed_buf = false;
 }
 
@@ -105,6 +109,8 @@ char *vstr_extend(vstr_t *vstr, size_t size) {
     char *p = new_buf + vstr->alloc;
     vstr->alloc += size;
     vstr->buf = new_buf;
+    // CIRCUITPY-CHANGE
+    gc_write_barrier(&vstr->buf);
     return p;
 }
 
@@ -119,6 +125,8 @@ static void vstr_ensure_extra(vstr_t *vstr, size_t size) {
         char *new_buf = m_renew(char, vstr->buf, vstr->alloc, new_alloc);
         vstr->alloc = new_alloc;
         vstr->buf = new_buf;
+        // CIRCUITPY-CHANGE
+        gc_write_barrier(&vstr->buf);
     }
 }
 
@@ -150,6 +150,16 @@ static const mp_rom_map_elem_t analogbufio_bufferedin_locals_dict_table[] = {
 
 static MP_DEFINE_CONST_DICT(analogbufio_bufferedin_locals_dict, analogbufio_bufferedin_locals_dict_table);
 
+#if CIRCUITPY_ANALOGBUFIO_CAPTURE
+MP_DEFINE_CONST_OBJ_TYPE(
+    analogbufio_bufferedin_type,
+    MP_QSTR_BufferedIn,
+    MP_TYPE_FLAG_NONE,
+    make_new, analogbufio_bufferedin_make_new,
+    locals_dict, &analogbufio_bufferedin_locals_dict,
+    protocol, &analogbufio_bufferedin_capture_proto
+    );
+#else
 MP_DEFINE_CONST_OBJ_TYPE(
     analogbufio_bufferedin_type,
     MP_QSTR_BufferedIn,
@@ -157,3 +167,4 @@ MP_DEFINE_CONST_OBJ_TYPE(
     make_new, analogbufio_bufferedin_make_new,
     locals_dict, &analogbufio_bufferedin_locals_dict
     );
+#endif
@@ -0,0 +1,349 @@
+// This file is part of the CircuitPython project: https://circuitpython.org
+//
+// SPDX-FileCopyrightText: Copyright (c) 2025 Adafruit Industries LLC
+//
+// SPDX-License-Identifier: MIT
+
+#include <stdint.h>
+
+#include "shared-bindings/audioanalysis/Analyzer.h"
+#include "shared-bindings/audiocore/__init__.h"
+
+#include "shared/runtime/context_manager_helpers.h"
+#include "py/objproperty.h"
+#include "py/runtime.h"
+#include "shared-bindings/util.h"
+
+//| class Analyzer:
+//|     """Measures the audio that passes through it"""
+//|
+//|     def __init__(
+//|         self,
+//|         fft_size: int = 0,
+//|         attack: float = 0.01,
+//|         release: float = 0.3,
+//|         buffer_size: int = 512,
+//|         sample_rate: int = 8000,
+//|         bits_per_sample: int = 16,
+//|         samples_signed: bool = True,
+//|         channel_count: int = 1,
+//|     ) -> None:
+//|         """Create an Analyzer that plays a sample unchanged while measuring its level and,
+//|            optionally, its spectrum.
+//|
+//|            The Analyzer can be placed anywhere an audio sample can be played: between a
+//|            sample and an effect, in a `audiomixer.Mixer` voice or right before the audio
+//|            output. The measurements are updated each time a buffer is passed through, in
+//|            the background, so reading them from Python is cheap.
+//|
+//|         :param int fft_size: The number of frames in each spectrum transform, a power of 2
+//|             from 16 to 2048, or 0 to not measure the spectrum.
+//|         :param float attack: The time in seconds the `envelope` takes to rise most of the way to a louder level.
+//|         :param float release: The time in seconds the `envelope` takes to fall most of the way to a quieter level.
+//|         :param int buffer_size: The largest size in bytes of each buffer passed through
+//|         :param int sample_rate: The sample rate to be used
+//|         :param int channel_count: The number of channels the source samples contain. 1 = mono; 2 = stereo.
+//|         :param int bits_per_sample: The bits per sample of the output
+//|         :param bool samples_signed: Output is signed (True) or unsigned (False)
+//|
+//|         Lighting a bar graph from the spectrum of a synth::
+//|
+//|           import board
+//|           import audiobusio
+//|           import synthio
+//|           import audioanalysis
+//|
+//|           audio = audiobusio.I2SOut(bit_clock=board.GP20, word_select=board.GP21, data=board.GP22)
+//|           synth = synthio.Synthesizer(channel_count=1, sample_rate=22050)
+//|           analyzer = audioanalysis.Analyzer(fft_size=256, buffer_size=1024, channel_count=1, sample_rate=22050)
+//|           analyzer.play(synth)
+//|           audio.play(analyzer)
+//|
+//|           synth.press(synthio.Note(440))
+//|           spectrum = analyzer.spectrum
+//|           while True:
+//|               # Each bin is 22050 / 256 Hz wide
+//|               bars = [min(spectrum[i] >> 11, 7) for i in range(0, 32, 4)]
+//|               print(analyzer.envelope, bars)"""
+//|         ...
+//|
+
+static mp_obj_t audioanalysis_analyzer_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *all_args) {
+    enum { ARG_fft_size, ARG_attack, ARG_release, ARG_buffer_size, ARG_sample_rate, ARG_bits_per_sample, ARG_samples_signed, ARG_channel_count, };
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_fft_size, MP_ARG_INT | MP_ARG_KW_ONLY, {.u_int = 0} },
+        { MP_QSTR_attack, MP_ARG_OBJ | MP_ARG_KW_ONLY, {.u_obj = MP_OBJ_NULL} },
+        { MP_QSTR_release, MP_ARG_OBJ | MP_ARG_KW_ONLY, {.u_obj = MP_OBJ_NULL} },
+        { MP_QSTR_buffer_size, MP_ARG_INT | MP_ARG_KW_ONLY, {.u_int = 512} },
+        { MP_QSTR_sample_rate, MP_ARG_INT | MP_ARG_KW_ONLY, {.u_int = 8000} },
+        { MP_QSTR_bits_per_sample, MP_ARG_INT | MP_ARG_KW_ONLY, {.u_int = 16} },
+        { MP_QSTR_samples_signed, MP_ARG_BOOL | MP_ARG_KW_ONLY, {.u_bool = true} },
+        { MP_QSTR_channel_count, MP_ARG_INT | MP_ARG_KW_ONLY, {.u_int = 1 } },
+    };
+
+    mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all_kw_array(n_args, n_kw, all_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
+
+    mp_int_t channel_count = mp_arg_validate_int_range(args[ARG_channel_count].u_int, 1, 2, MP_QSTR_channel_count);
+    mp_int_t sample_rate = mp_arg_validate_int_min(args[ARG_sample_rate].u_int, 1, MP_QSTR_sample_rate);
+    mp_int_t bits_per_sample = args[ARG_bits_per_sample].u_int;
+    if (bits_per_sample != 8 && bits_per_sample != 16) {
+        mp_raise_ValueError(MP_ERROR_TEXT("bits_per_sample must be 8 or 16"));
+    }
+    // Room for at least one frame
+    mp_int_t buffer_size = mp_arg_validate_int_min(args[ARG_buffer_size].u_int, 4, MP_QSTR_buffer_size);
+
+    mp_int_t fft_size = args[ARG_fft_size].u_int;
+    if (fft_size != 0) {
+        mp_arg_validate_int_range(fft_size, 16, 2048, MP_QSTR_fft_size);
+        if ((fft_size & (fft_size - 1)) != 0) {
+            mp_raise_ValueError_varg(MP_ERROR_TEXT("%q must be power of 2"), MP_QSTR_fft_size);
+        }
+    }
+
+    mp_float_t attack = mp_arg_validate_obj_float_non_negative(args[ARG_attack].u_obj, MICROPY_FLOAT_CONST(0.01), MP_QSTR_attack);
+    mp_float_t release = mp_arg_validate_obj_float_non_negative(args[ARG_release].u_obj, MICROPY_FLOAT_CONST(0.3), MP_QSTR_release);
+
+    audioanalysis_analyzer_obj_t *self = mp_obj_malloc(audioanalysis_analyzer_obj_t, &audioanalysis_analyzer_type);
+    common_hal_audioanalysis_analyzer_construct(self, fft_size, attack, release, buffer_size, bits_per_sample, args[ARG_samples_signed].u_bool, channel_count, sample_rate);
+    return MP_OBJ_FROM_PTR(self);
+}
+
+//|     def deinit(self) -> None:
+//|         """Deinitialises the Analyzer."""
+//|         ...
+//|
+static mp_obj_t audioanalysis_analyzer_deinit(mp_obj_t self_in) {
+    audioanalysis_analyzer_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    common_hal_audioanalysis_analyzer_deinit(self);
+    return mp_const_none;
+}
+static MP_DEFINE_CONST_FUN_OBJ_1(audioanalysis_analyzer_deinit_obj, audioanalysis_analyzer_deinit);
+
+static void check_for_deinit(audioanalysis_analyzer_obj_t *self) {
+    audiosample_check_for_deinit(&self->base);
+}
+
+//|     def __enter__(self) -> Analyzer:
+//|         """No-op used by Context Managers."""
+//|         ...
+//|
+//  Provided by context manager helper.
+
+//|     def __exit__(self) -> None:
+//|         """Automatically deinitializes when exiting a context. See
+//|         :ref:`lifetime-and-contextmanagers` for more info."""
+//|         ...
+//|
+//  Provided by context manager helper.
+
+
+//|     rms: float
+//|     """The root mean square level of the last buffer passed through, from 0.0 to 1.0 of full
+//|     scale. A full scale sine wave has an rms level of about 0.707. (read-only)"""
+static mp_obj_t audioanalysis_analyzer_obj_get_rms(mp_obj_t self_in) {
+    audioanalysis_analyzer_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    check_for_deinit(self);
+    return mp_obj_new_float(common_hal_audioanalysis_analyzer_get_rms(self));
+}
+MP_DEFINE_CONST_FUN_OBJ_1(audioanalysis_analyzer_get_rms_obj, audioanalysis_analyzer_obj_get_rms);
+
+MP_PROPERTY_GETTER(audioanalysis_analyzer_rms_obj,
+    (mp_obj_t)&audioanalysis_analyzer_get_rms_obj);
+
+
+//|     peak: float
+//|     """The largest absolute sample value in the last buffer passed through, from 0.0 to 1.0 of
+//|     full scale. (read-only)"""
+static mp_obj_t audioanalysis_analyzer_obj_get_peak(mp_obj_t self_in) {
+    audioanalysis_analyzer_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    check_for_deinit(self);
+    return mp_obj_new_float(common_hal_audioanalysis_analyzer_get_peak(self));
+}
+MP_DEFINE_CONST_FUN_OBJ_1(audioanalysis_analyzer_get_peak_obj, audioanalysis_analyzer_obj_get_peak);
+
+MP_PROPERTY_GETTER(audioanalysis_analyzer_peak_obj,
+    (mp_obj_t)&audioanalysis_analyzer_get_peak_obj);
+
+
+//|     envelope: float
+//|     """The peak level smoothed by `attack` and `release`, from 0.0 to 1.0 of full scale. It
+//|     follows the audio without flickering, which suits meters and lights. (read-only)"""
+static mp_obj_t audioanalysis_analyzer_obj_get_envelope(mp_obj_t self_in) {
+    audioanalysis_analyzer_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    check_for_deinit(self);
+    return mp_obj_new_float(common_hal_audioanalysis_analyzer_get_envelope(self));
+}
+MP_DEFINE_CONST_FUN_OBJ_1(audioanalysis_analyzer_get_envelope_obj, audioanalysis_analyzer_obj_get_envelope);
+
+MP_PROPERTY_GETTER(audioanalysis_analyzer_envelope_obj,
+    (mp_obj_t)&audioanalysis_analyzer_get_envelope_obj);
+
+
+//|     attack: float
+//|     """The time in seconds the `envelope` takes to rise most of the way to a louder level."""
+static mp_obj_t audioanalysis_analyzer_obj_get_attack(mp_obj_t self_in) {
+    audioanalysis_analyzer_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    check_for_deinit(self);
+    return mp_obj_new_float(common_hal_audioanalysis_analyzer_get_attack(self));
+}
+MP_DEFINE_CONST_FUN_OBJ_1(audioanalysis_analyzer_get_attack_obj, audioanalysis_analyzer_obj_get_attack);
+
+static mp_obj_t audioanalysis_analyzer_obj_set_attack(mp_obj_t self_in, mp_obj_t attack_in) {
+    audioanalysis_analyzer_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    check_for_deinit(self);
+    common_hal_audioanalysis_analyzer_set_attack(self, mp_arg_validate_obj_float_non_negative(attack_in, MICROPY_FLOAT_CONST(0.0), MP_QSTR_attack));
+    return mp_const_none;
+}
+MP_DEFINE_CONST_FUN_OBJ_2(audioanalysis_analyzer_set_attack_obj, audioanalysis_analyzer_obj_set_attack);
+
+MP_PROPERTY_GETSET(audioanalysis_analyzer_attack_obj,
+    (mp_obj_t)&audioanalysis_analyzer_get_attack_obj,
+    (mp_obj_t)&audioanalysis_analyzer_set_attack_obj);
+
+
+//|     release: float
+//|     """The time in seconds the `envelope` takes to fall most of the way to a quieter level."""
+static mp_obj_t audioanalysis_analyzer_obj_get_release(mp_obj_t self_in) {
+    audioanalysis_analyzer_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    check_for_deinit(self);
+    return mp_obj_new_float(common_hal_audioanalysis_analyzer_get_release(self));
+}
+MP_DEFINE_CONST_FUN_OBJ_1(audioanalysis_analyzer_get_release_obj, audioanalysis_analyzer_obj_get_release);
+
+static mp_obj_t audioanalysis_analyzer_obj_set_release(mp_obj_t self_in, mp_obj_t release_in) {
+    audioanalysis_analyzer_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    check_for_deinit(self);
+    common_hal_audioanalysis_analyzer_set_release(self, mp_arg_validate_obj_float_non_negative(release_in, MICROPY_FLOAT_CONST(0.0), MP_QSTR_release));
+    return mp_const_none;
+}
+MP_DEFINE_CONST_FUN_OBJ_2(audioanalysis_analyzer_set_release_obj, audioanalysis_analyzer_obj_set_release);
+
+MP_PROPERTY_GETSET(audioanalysis_analyzer_release_obj,
+    (mp_obj_t)&audioanalysis_analyzer_get_release_obj,
+    (mp_obj_t)&audioanalysis_analyzer_set_release_obj);
+
+
+//|     fft_size: int
+//|     """The number of frames in each spectrum transform, or 0 when the spectrum is not measured. (read-only)"""
+static mp_obj_t audioanalysis_analyzer_obj_get_fft_size(mp_obj_t self_in) {
+    audioanalysis_analyzer_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    check_for_deinit(self);
+    return MP_OBJ_NEW_SMALL_INT(common_hal_audioanalysis_analyzer_get_fft_size(self));
+}
+MP_DEFINE_CONST_FUN_OBJ_1(audioanalysis_analyzer_get_fft_size_obj, audioanalysis_analyzer_obj_get_fft_size);
+
+MP_PROPERTY_GETTER(audioanalysis_analyzer_fft_size_obj,
+    (mp_obj_t)&audioanalysis_analyzer_get_fft_size_obj);
+
+
+//|     spectrum: Optional[memoryview]
+//|     """The magnitude spectrum of the last `fft_size` frames passed through, as ``fft_size // 2``
+//|     unsigned 16 bit integers, or None when `fft_size` is 0. Bin ``i`` is centred on
+//|     ``i * sample_rate / fft_size`` Hz. Stereo audio is measured as the average of both channels.
+//|
+//|     A full scale sine wave centred on a bin reads as about 16384 in that bin. The spectrum is
+//|     measured through a Hann window and updated each time at least half of `fft_size` new frames
+//|     have passed through.
+//|
+//|     The same memoryview is returned every time and its contents change in the background, so
+//|     it can be kept and read without allocating. (read-only)"""
+static mp_obj_t audioanalysis_analyzer_obj_get_spectrum(mp_obj_t self_in) {
+    audioanalysis_analyzer_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    check_for_deinit(self);
+    return common_hal_audioanalysis_analyzer_get_spectrum(self);
+}
+MP_DEFINE_CONST_FUN_OBJ_1(audioanalysis_analyzer_get_spectrum_obj, audioanalysis_analyzer_obj_get_spectrum);
+
+MP_PROPERTY_GETTER(audioanalysis_analyzer_spectrum_obj,
+    (mp_obj_t)&audioanalysis_analyzer_get_spectrum_obj);
+
+
+//|     playing: bool
+//|     """True when the analyzer is playing a sample. (read-only)"""
+//|
+static mp_obj_t audioanalysis_analyzer_obj_get_playing(mp_obj_t self_in) {
+    audioanalysis_analyzer_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    check_for_deinit(self);
+    return mp_obj_new_bool(common_hal_audioanalysis_analyzer_get_playing(self));
+}
+MP_DEFINE_CONST_FUN_OBJ_1(audioanalysis_analyzer_get_playing_obj, audioanalysis_analyzer_obj_get_playing);
+
+MP_PROPERTY_GETTER(audioanalysis_analyzer_playing_obj,
+    (mp_obj_t)&audioanalysis_analyzer_get_playing_obj);
+
+//|     def play(self, sample: circuitpython_typing.AudioSample, *, loop: bool = False) -> None:
+//|         """Plays the sample once when loop=False and continuously when loop=True.
+//|         Does not block. Use `playing` to block.
+//|
+//|         The sample must have the sample rate given in the constructor. Its other encoding
+//|         settings are converted to the ones given in the constructor as it plays. When they
+//|         already match, the sample's buffers are passed through without being copied."""
+//|         ...
+//|
+static mp_obj_t audioanalysis_analyzer_obj_play(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    enum { ARG_sample, ARG_loop };
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_sample,    MP_ARG_OBJ | MP_ARG_REQUIRED, {} },
+        { MP_QSTR_loop,      MP_ARG_BOOL | MP_ARG_KW_ONLY, {.u_bool = false} },
+    };
+    audioanalysis_analyzer_obj_t *self = MP_OBJ_TO_PTR(pos_args[0]);
+    check_for_deinit(self);
+    mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all(n_args - 1, pos_args + 1, kw_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
+
+    mp_obj_t sample = args[ARG_sample].u_obj;
+    common_hal_audioanalysis_analyzer_play(self, sample, args[ARG_loop].u_bool);
+
+    return mp_const_none;
+}
+MP_DEFINE_CONST_FUN_OBJ_KW(audioanalysis_analyzer_play_obj, 1, audioanalysis_analyzer_obj_play);
+
+//|     def stop(self) -> None:
+//|         """Stops playback of the sample."""
+//|         ...
+//|
+//|
+static mp_obj_t audioanalysis_analyzer_obj_stop(mp_obj_t self_in) {
+    audioanalysis_analyzer_obj_t *self = MP_OBJ_TO_PTR(self_in);
+
+    common_hal_audioanalysis_analyzer_stop(self);
+    return mp_const_none;
+}
+MP_DEFINE_CONST_FUN_OBJ_1(audioanalysis_analyzer_stop_obj, audioanalysis_analyzer_obj_stop);
+
+static const mp_rom_map_elem_t audioanalysis_analyzer_locals_dict_table[] = {
+    // Methods
+    { MP_ROM_QSTR(MP_QSTR_deinit), MP_ROM_PTR(&audioanalysis_analyzer_deinit_obj) },
+    { MP_ROM_QSTR(MP_QSTR___enter__), MP_ROM_PTR(&default___enter___obj) },
+    { MP_ROM_QSTR(MP_QSTR___exit__), MP_ROM_PTR(&default___exit___obj) },
+    { MP_ROM_QSTR(MP_QSTR_play), MP_ROM_PTR(&audioanalysis_analyzer_play_obj) },
+    { MP_ROM_QSTR(MP_QSTR_stop), MP_ROM_PTR(&audioanalysis_analyzer_stop_obj) },
+
+    // Properties
+    { MP_ROM_QSTR(MP_QSTR_playing), MP_ROM_PTR(&audioanalysis_analyzer_playing_obj) },
+    { MP_ROM_QSTR(MP_QSTR_rms), MP_ROM_PTR(&audioanalysis_analyzer_rms_obj) },
+    { MP_ROM_QSTR(MP_QSTR_peak), MP_ROM_PTR(&audioanalysis_analyzer_peak_obj) },
+    { MP_ROM_QSTR(MP_QSTR_envelope), MP_ROM_PTR(&audioanalysis_analyzer_envelope_obj) },
+    { MP_ROM_QSTR(MP_QSTR_attack), MP_ROM_PTR(&audioanalysis_analyzer_attack_obj) },
+    { MP_ROM_QSTR(MP_QSTR_release), MP_ROM_PTR(&audioanalysis_analyzer_release_obj) },
+    { MP_ROM_QSTR(MP_QSTR_fft_size), MP_ROM_PTR(&audioanalysis_analyzer_fft_size_obj) },
+    { MP_ROM_QSTR(MP_QSTR_spectrum), MP_ROM_PTR(&audioanalysis_analyzer_spectrum_obj) },
+    AUDIOSAMPLE_FIELDS,
+};
+static MP_DEFINE_CONST_DICT(audioanalysis_analyzer_locals_dict, audioanalysis_analyzer_locals_dict_table);
+
+static const audiosample_p_t audioanalysis_analyzer_proto = {
+    MP_PROTO_IMPLEMENT(MP_QSTR_protocol_audiosample)
+    .reset_buffer = (audiosample_reset_buffer_fun)audioanalysis_analyzer_reset_buffer,
+    .get_buffer = (audiosample_get_buffer_fun)audioanalysis_analyzer_get_buffer,
+};
+
+MP_DEFINE_CONST_OBJ_TYPE(
+    audioanalysis_analyzer_type,
+    MP_QSTR_Analyzer,
+    MP_TYPE_FLAG_HAS_SPECIAL_ACCESSORS,
+    make_new, audioanalysis_analyzer_make_new,
+    locals_dict, &audioanalysis_analyzer_locals_dict,
+    protocol, &audioanalysis_analyzer_proto
+    );
@@ -0,0 +1,35 @@
+// This file is part of the CircuitPython project: https://circuitpython.org
+//
+// SPDX-FileCopyrightText: Copyright (c) 2025 Adafruit Industries LLC
+//
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include "shared-module/audioanalysis/Analyzer.h"
+
+extern const mp_obj_type_t audioanalysis_analyzer_type;
+
+void common_hal_audioanalysis_analyzer_construct(audioanalysis_analyzer_obj_t *self,
+    uint32_t fft_size, mp_float_t attack, mp_float_t release,
+    uint32_t buffer_size, uint8_t bits_per_sample, bool samples_signed,
+    uint8_t channel_count, uint32_t sample_rate);
+
+void common_hal_audioanalysis_analyzer_deinit(audioanalysis_analyzer_obj_t *self);
+
+mp_float_t common_hal_audioanalysis_analyzer_get_rms(audioanalysis_analyzer_obj_t *self);
+mp_float_t common_hal_audioanalysis_analyzer_get_peak(audioanalysis_analyzer_obj_t *self);
+mp_float_t common_hal_audioanalysis_analyzer_get_envelope(audioanalysis_analyzer_obj_t *self);
+
+mp_float_t common_hal_audioanalysis_analyzer_get_attack(audioanalysis_analyzer_obj_t *self);
+void common_hal_audioanalysis_analyzer_set_attack(audioanalysis_analyzer_obj_t *self, mp_float_t attack);
+
+mp_float_t common_hal_audioanalysis_analyzer_get_release(audioanalysis_analyzer_obj_t *self);
+void common_hal_audioanalysis_analyzer_set_release(audioanalysis_analyzer_obj_t *self, mp_float_t release);
+
+uint32_t common_hal_audioanalysis_analyzer_get_fft_size(audioanalysis_analyzer_obj_t *self);
+mp_obj_t common_hal_audioanalysis_analyzer_get_spectrum(audioanalysis_analyzer_obj_t *self);
+
+bool common_hal_audioanalysis_analyzer_get_playing(audioanalysis_analyzer_obj_t *self);
+void common_hal_audioanalysis_analyzer_play(audioanalysis_analyzer_obj_t *self, mp_obj_t sample, bool loop);
+void common_hal_audioanalysis_analyzer_stop(audioanalysis_analyzer_obj_t *self);
@@ -0,0 +1,35 @@
+// This file is part of the CircuitPython project: https://circuitpython.org
+//
+// SPDX-FileCopyrightText: Copyright (c) 2025 Adafruit Industries LLC
+//
+// SPDX-License-Identifier: MIT
+
+#include <stdint.h>
+
+#include "py/obj.h"
+#include "py/runtime.h"
+
+#include "shared-bindings/audioanalysis/__init__.h"
+#include "shared-bindings/audioanalysis/Analyzer.h"
+
+
+//| """Support for measuring audio as it plays
+//|
+//| The `audioanalysis` module contains classes that measure the audio passing through them,
+//| such as its level and spectrum, for meters and visualisers.
+//|
+//| """
+
+static const mp_rom_map_elem_t audioanalysis_module_globals_table[] = {
+    { MP_ROM_QSTR(MP_QSTR___name__), MP_ROM_QSTR(MP_QSTR_audioanalysis) },
+    { MP_ROM_QSTR(MP_QSTR_Analyzer), MP_ROM_PTR(&audioanalysis_analyzer_type) },
+};
+
+static MP_DEFINE_CONST_DICT(audioanalysis_module_globals, audioanalysis_module_globals_table);
+
+const mp_obj_module_t audioanalysis_module = {
+    .base = { &mp_type_module },
+    .globals = (mp_obj_dict_t *)&audioanalysis_module_globals,
+};
+
+MP_REGISTER_MODULE(MP_QSTR_audioanalysis, audioanalysis_module);
@@ -230,4 +230,7 @@ MP_DEFINE_CONST_OBJ_TYPE(
     #if CIRCUITPY_AUDIOBUSIO_PDMIN
     , locals_dict, &audiobusio_pdmin_locals_dict
     #endif
+    #if CIRCUITPY_AUDIOBUSIO_PDMIN_CAPTURE
+    , protocol, &audiobusio_pdmin_capture_proto
+    #endif
     );
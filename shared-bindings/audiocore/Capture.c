@@ -0,0 +1,281 @@
+// This file is part of the CircuitPython project: https://circuitpython.org
+//
+// SPDX-FileCopyrightText: Copyright (c) 2025 Adafruit Industries LLC
+//
+// SPDX-License-Identifier: MIT
+
+#include <stdint.h>
+#include <string.h>
+
+#include "shared/runtime/context_manager_helpers.h"
+#include "py/objproperty.h"
+#include "py/runtime.h"
+#include "py/stream.h"
+#include "shared-bindings/audiocore/Capture.h"
+#include "shared-bindings/audiocore/__init__.h"
+#include "shared-bindings/util.h"
+
+#if CIRCUITPY_AUDIOCORE_CAPTURE
+
+//| class Capture:
+//|     """Plays audio as it is captured from an input"""
+//|
+//|     def __init__(self, source: Union[analogbufio.BufferedIn, audiobusio.PDMIn], *, block_size: int = 512, block_count: int = 8) -> None:
+//|         """Capture audio continuously from ``source`` into a ring of blocks, and play
+//|         the blocks as they fill. A Capture can be played anywhere an audio sample can:
+//|         through effects, by a `audiomixer.Mixer` or directly by an audio output.
+//|
+//|         Capturing starts right away, and the blocks are handed out as they are, without being
+//|         copied. If the audio graph falls behind, the oldest blocks are dropped and counted in
+//|         `overruns`, so that the delay from input to output never grows beyond about
+//|         ``block_count - 2`` blocks. If it gets ahead, it is given silence, counted in `underruns`.
+//|         Smaller blocks mean less delay, and more blocks mean more room for the two to drift.
+//|
+//|         The sample rate and encoding of the capture are those of the source.
+//|
+//|         :param ~analogbufio.BufferedIn source: The input to capture from. On the RP2 ports this can
+//|             be an `analogbufio.BufferedIn`, which captures 16 bit unsigned mono samples.
+//|             On the ESP32-S3 it can be an `audiobusio.PDMIn` with a ``bit_depth`` of 16, which
+//|             captures 16 bit signed samples, mono or stereo as the PDMIn was constructed.
+//|         :param int block_size: The size in bytes of each block
+//|         :param int block_count: The number of blocks in the ring, from 4 to 64
+//|
+//|         Playing a microphone on an ADC pin through an echo::
+//|
+//|           import analogbufio
+//|           import audiocore
+//|           import audiodelays
+//|           import audiopwmio
+//|           import board
+//|
+//|           adc = analogbufio.BufferedIn(board.A0, sample_rate=22050)
+//|           mic = audiocore.Capture(adc, block_size=256)
+//|           echo = audiodelays.Echo(delay_ms=250, decay=0.5, sample_rate=22050, samples_signed=False)
+//|           echo.play(mic)
+//|           audio = audiopwmio.PWMAudioOut(board.GP0)
+//|           audio.play(echo)"""
+//|         ...
+//|
+static mp_obj_t audiocore_capture_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *all_args) {
+    enum { ARG_source, ARG_block_size, ARG_block_count };
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_source, MP_ARG_OBJ | MP_ARG_REQUIRED, {} },
+        { MP_QSTR_block_size, MP_ARG_INT | MP_ARG_KW_ONLY, {.u_int = 512} },
+        { MP_QSTR_block_count, MP_ARG_INT | MP_ARG_KW_ONLY, {.u_int = 8} },
+    };
+    mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all_kw_array(n_args, n_kw, all_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
+
+    mp_int_t block_size = mp_arg_validate_int_min(args[ARG_block_size].u_int, 1, MP_QSTR_block_size);
+    mp_int_t block_count = mp_arg_validate_int_range(args[ARG_block_count].u_int, 4, 64, MP_QSTR_block_count);
+
+    audiocore_capture_obj_t *self = mp_obj_malloc_with_finaliser(audiocore_capture_obj_t, &audiocore_capture_type);
+    common_hal_audiocore_capture_construct(self, args[ARG_source].u_obj, block_size, block_count);
+    return MP_OBJ_FROM_PTR(self);
+}
+
+//|     def deinit(self) -> None:
+//|         """Stops capturing and releases the buffers."""
+//|         ...
+//|
+static mp_obj_t audiocore_capture_deinit(mp_obj_t self_in) {
+    audiocore_capture_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    common_hal_audiocore_capture_deinit(self);
+    return mp_const_none;
+}
+static MP_DEFINE_CONST_FUN_OBJ_1(audiocore_capture_deinit_obj, audiocore_capture_deinit);
+
+static void check_for_deinit(audiocore_capture_obj_t *self) {
+    audiosample_check_for_deinit(&self->base);
+}
+
+//|     def __enter__(self) -> Capture:
+//|         """No-op used by Context Managers."""
+//|         ...
+//|
+//  Provided by context manager helper.
+
+//|     def __exit__(self) -> None:
+//|         """Automatically deinitializes the hardware when exiting a context. See
+//|         :ref:`lifetime-and-contextmanagers` for more info."""
+//|         ...
+//|
+//  Provided by context manager helper.
+
+//|     overruns: int
+//|     """The number of captured blocks dropped because they were not played in time. (read-only)"""
+static mp_obj_t audiocore_capture_obj_get_overruns(mp_obj_t self_in) {
+    audiocore_capture_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    check_for_deinit(self);
+    return mp_obj_new_int_from_uint(common_hal_audiocore_capture_get_overruns(self));
+}
+MP_DEFINE_CONST_FUN_OBJ_1(audiocore_capture_get_overruns_obj, audiocore_capture_obj_get_overruns);
+
+MP_PROPERTY_GETTER(audiocore_capture_overruns_obj,
+    (mp_obj_t)&audiocore_capture_get_overruns_obj);
+
+//|     underruns: int
+//|     """The number of silent blocks played because nothing new had been captured. Blocks
+//|     played before the first capture since playback started are not counted. (read-only)"""
+//|
+static mp_obj_t audiocore_capture_obj_get_underruns(mp_obj_t self_in) {
+    audiocore_capture_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    check_for_deinit(self);
+    return mp_obj_new_int_from_uint(common_hal_audiocore_capture_get_underruns(self));
+}
+MP_DEFINE_CONST_FUN_OBJ_1(audiocore_capture_get_underruns_obj, audiocore_capture_obj_get_underruns);
+
+MP_PROPERTY_GETTER(audiocore_capture_underruns_obj,
+    (mp_obj_t)&audiocore_capture_get_underruns_obj);
+
+static const mp_rom_map_elem_t audiocore_capture_locals_dict_table[] = {
+    // Methods
+    { MP_ROM_QSTR(MP_QSTR___del__), MP_ROM_PTR(&audiocore_capture_deinit_obj) },
+    { MP_ROM_QSTR(MP_QSTR_deinit), MP_ROM_PTR(&audiocore_capture_deinit_obj) },
+    { MP_ROM_QSTR(MP_QSTR___enter__), MP_ROM_PTR(&default___enter___obj) },
+    { MP_ROM_QSTR(MP_QSTR___exit__), MP_ROM_PTR(&default___exit___obj) },
+
+    // Properties
+    { MP_ROM_QSTR(MP_QSTR_overruns), MP_ROM_PTR(&audiocore_capture_overruns_obj) },
+    { MP_ROM_QSTR(MP_QSTR_underruns), MP_ROM_PTR(&audiocore_capture_underruns_obj) },
+    AUDIOSAMPLE_FIELDS,
+};
+static MP_DEFINE_CONST_DICT(audiocore_capture_locals_dict, audiocore_capture_locals_dict_table);
+
+static const audiosample_p_t audiocore_capture_proto = {
+    MP_PROTO_IMPLEMENT(MP_QSTR_protocol_audiosample)
+    .reset_buffer = (audiosample_reset_buffer_fun)audiocore_capture_reset_buffer,
+    .get_buffer = (audiosample_get_buffer_fun)audiocore_capture_get_buffer,
+};
+
+MP_DEFINE_CONST_OBJ_TYPE(
+    audiocore_capture_type,
+    MP_QSTR_Capture,
+    MP_TYPE_FLAG_HAS_SPECIAL_ACCESSORS,
+    make_new, audiocore_capture_make_new,
+    locals_dict, &audiocore_capture_locals_dict,
+    protocol, &audiocore_capture_proto
+    );
+
+#if CIRCUITPY_AUDIOCORE_DEBUG
+// A capture source that reads from a file, a block each time capture() is
+// called, in place of the interrupt of a real source. It lets the capture ring
+// be tested on the unix port.
+// (no docstrings so that it is not shown on docs.circuitpython.org)
+
+typedef struct {
+    mp_obj_base_t base;
+    mp_obj_t file;
+    audiocore_capture_ring_t *ring;
+    uint32_t sample_rate;
+    uint8_t channel_count;
+    uint8_t bits_per_sample;
+    bool samples_signed;
+} audiocore_filecapturesource_obj_t;
+
+static void filecapturesource_get_format(mp_obj_t self_in, audiosample_base_t *format) {
+    audiocore_filecapturesource_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    format->sample_rate = self->sample_rate;
+    format->channel_count = self->channel_count;
+    format->bits_per_sample = self->bits_per_sample;
+    format->samples_signed = self->samples_signed;
+}
+
+static void filecapturesource_start(mp_obj_t self_in, audiocore_capture_ring_t *ring) {
+    audiocore_filecapturesource_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    if (self->ring != NULL) {
+        mp_raise_RuntimeError(MP_ERROR_TEXT("Already running"));
+    }
+    self->ring = ring;
+}
+
+static void filecapturesource_stop(mp_obj_t self_in) {
+    audiocore_filecapturesource_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    self->ring = NULL;
+}
+
+static mp_obj_t audiocore_filecapturesource_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *all_args) {
+    enum { ARG_file, ARG_sample_rate, ARG_channel_count, ARG_bits_per_sample, ARG_samples_signed };
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_file, MP_ARG_OBJ | MP_ARG_REQUIRED, {} },
+        { MP_QSTR_sample_rate, MP_ARG_INT | MP_ARG_KW_ONLY, {.u_int = 8000} },
+        { MP_QSTR_channel_count, MP_ARG_INT | MP_ARG_KW_ONLY, {.u_int = 1} },
+        { MP_QSTR_bits_per_sample, MP_ARG_INT | MP_ARG_KW_ONLY, {.u_int = 16} },
+        { MP_QSTR_samples_signed, MP_ARG_BOOL | MP_ARG_KW_ONLY, {.u_bool = true} },
+    };
+    mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all_kw_array(n_args, n_kw, all_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
+
+    mp_get_stream_raise(args[ARG_file].u_obj, MP_STREAM_OP_READ);
+    mp_int_t bits_per_sample = args[ARG_bits_per_sample].u_int;
+    if (bits_per_sample != 8 && bits_per_sample != 16) {
+        mp_raise_ValueError(MP_ERROR_TEXT("bits_per_sample must be 8 or 16"));
+    }
+
+    audiocore_filecapturesource_obj_t *self = mp_obj_malloc(audiocore_filecapturesource_obj_t, type);
+    self->file = args[ARG_file].u_obj;
+    self->ring = NULL;
+    self->sample_rate = mp_arg_validate_int_min(args[ARG_sample_rate].u_int, 1, MP_QSTR_sample_rate);
+    self->channel_count = mp_arg_validate_int_range(args[ARG_channel_count].u_int, 1, 2, MP_QSTR_channel_count);
+    self->bits_per_sample = bits_per_sample;
+    self->samples_signed = args[ARG_samples_signed].u_bool;
+    return MP_OBJ_FROM_PTR(self);
+}
+
+// Capture up to count blocks from the file, as if they had arrived by DMA.
+// Returns the number of blocks, which is less than count at the end of the file.
+static mp_obj_t audiocore_filecapturesource_capture(mp_obj_t self_in, mp_obj_t count_in) {
+    audiocore_filecapturesource_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    mp_int_t count = mp_obj_get_int(count_in);
+    audiocore_capture_ring_t *ring = self->ring;
+    mp_int_t captured = 0;
+    while (ring != NULL && captured < count) {
+        int errcode;
+        uint8_t *block = audiocore_capture_ring_block(ring, ring->write_count);
+        mp_uint_t len = mp_stream_read_exactly(self->file, block, ring->block_length, &errcode);
+        if (len == MP_STREAM_ERROR) {
+            mp_raise_OSError(errcode);
+        }
+        if (len < ring->block_length) {
+            break;
+        }
+        audiocore_capture_ring_commit(ring);
+        captured++;
+    }
+    return MP_OBJ_NEW_SMALL_INT(captured);
+}
+static MP_DEFINE_CONST_FUN_OBJ_2(audiocore_filecapturesource_capture_obj, audiocore_filecapturesource_capture);
+
+static mp_obj_t audiocore_filecapturesource_get_running(mp_obj_t self_in) {
+    audiocore_filecapturesource_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    return mp_obj_new_bool(self->ring != NULL);
+}
+MP_DEFINE_CONST_FUN_OBJ_1(audiocore_filecapturesource_get_running_obj, audiocore_filecapturesource_get_running);
+
+MP_PROPERTY_GETTER(audiocore_filecapturesource_running_obj,
+    (mp_obj_t)&audiocore_filecapturesource_get_running_obj);
+
+static const mp_rom_map_elem_t audiocore_filecapturesource_locals_dict_table[] = {
+    { MP_ROM_QSTR(MP_QSTR_capture), MP_ROM_PTR(&audiocore_filecapturesource_capture_obj) },
+    { MP_ROM_QSTR(MP_QSTR_running), MP_ROM_PTR(&audiocore_filecapturesource_running_obj) },
+};
+static MP_DEFINE_CONST_DICT(audiocore_filecapturesource_locals_dict, audiocore_filecapturesource_locals_dict_table);
+
+static const audiocore_capture_source_p_t audiocore_filecapturesource_proto = {
+    MP_PROTO_IMPLEMENT(MP_QSTR_protocol_audiocapture)
+    .get_format = filecapturesource_get_format,
+    .start = filecapturesource_start,
+    .stop = filecapturesource_stop,
+};
+
+MP_DEFINE_CONST_OBJ_TYPE(
+    audiocore_filecapturesource_type,
+    MP_QSTR_FileCaptureSource,
+    MP_TYPE_FLAG_HAS_SPECIAL_ACCESSORS,
+    make_new, audiocore_filecapturesource_make_new,
+    locals_dict, &audiocore_filecapturesource_locals_dict,
+    protocol, &audiocore_filecapturesource_proto
+    );
+#endif
+
+#endif
@@ -0,0 +1,22 @@
+// This file is part of the CircuitPython project: https://circuitpython.org
+//
+// SPDX-FileCopyrightText: Copyright (c) 2025 Adafruit Industries LLC
+//
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include "shared-module/audiocore/Capture.h"
+
+extern const mp_obj_type_t audiocore_capture_type;
+
+void common_hal_audiocore_capture_construct(audiocore_capture_obj_t *self,
+    mp_obj_t source, uint32_t block_size, uint32_t block_count);
+void common_hal_audiocore_capture_deinit(audiocore_capture_obj_t *self);
+
+uint32_t common_hal_audiocore_capture_get_overruns(audiocore_capture_obj_t *self);
+uint32_t common_hal_audiocore_capture_get_underruns(audiocore_capture_obj_t *self);
+
+#if CIRCUITPY_AUDIOCORE_DEBUG
+extern const mp_obj_type_t audiocore_filecapturesource_type;
+#endif
@@ -21,14 +21,37 @@
 //|     be 8 bit unsigned or 16 bit signed. If a buffer is provided, it will be used instead of allocating
 //|     an internal buffer, which can prevent memory fragmentation."""
 //|
-//|     def __init__(self, file: Union[str, typing.BinaryIO], buffer: WriteableBuffer) -> None:
+//|     def __init__(
+//|         self,
+//|         file: Union[str, typing.BinaryIO, ReadableBuffer],
+//|         buffer: Optional[WriteableBuffer] = None,
+//|         *,
+//|         readahead: int = 0,
+//|         preload: bool = False,
+//|         outside_heap: bool = False,
+//|     ) -> None:
 //|         """Load a .wav file for playback with `audioio.AudioOut` or `audiobusio.I2SOut`.
 //|
-//|         :param Union[str, typing.BinaryIO] file: The name of a wave file (preferred) or an already opened wave file
+//|         :param Union[str, typing.BinaryIO, ~circuitpython_typing.ReadableBuffer] file: The name of a wave
+//|           file (preferred), an already opened wave file, or a buffer holding the contents of a wave file.
+//|           A buffer is played in place, without copying the audio data, so it can be memory-mapped
+//|           flash or `memorymap.AddressRange` memory. If the audio data in the buffer is not aligned
+//|           to a multiple of 4 bytes, it is copied as if ``preload`` were given.
 //|         :param ~circuitpython_typing.WriteableBuffer buffer: Optional pre-allocated buffer,
 //|           that will be split in half and used for double-buffering of the data.
 //|           The buffer must be 8 to 1024 bytes long.
 //|           If not provided, two 256 byte buffers are initially allocated internally.
+//|         :param int readahead: Number of bytes of audio data to read from the file ahead of
+//|           playback. Reading ahead happens in the background, so that playback does not stall
+//|           when the filesystem is briefly busy, for instance during USB access.
+//|           0 reads the file only as each buffer is needed.
+//|         :param bool preload: Read all of the audio data into memory up front. Suitable for
+//|           short clips, which then play without any further file access.
+//|         :param bool outside_heap: Allocate the ``readahead`` or ``preload`` memory outside of
+//|           the VM heap. On boards with PSRAM, this memory comes from PSRAM.
+//|
+//|         ``buffer`` cannot be combined with ``readahead`` or ``preload``, and none of ``buffer``,
+//|         ``readahead`` or ``outside_heap`` can be given when ``file`` is a buffer.
 //|
 //|         Playing a wave file from flash::
 //|
@@ -52,28 +75,59 @@
 //|         """
 //|         ...
 //|
-static mp_obj_t audioio_wavefile_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *args) {
-    mp_arg_check_num(n_args, n_kw, 1, 2, false);
-    mp_obj_t arg = args[0];
+static mp_obj_t audioio_wavefile_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *all_args) {
+    enum { ARG_file, ARG_buffer, ARG_readahead, ARG_preload, ARG_outside_heap };
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_file, MP_ARG_OBJ | MP_ARG_REQUIRED, {} },
+        { MP_QSTR_buffer, MP_ARG_OBJ, {.u_obj = mp_const_none} },
+        { MP_QSTR_readahead, MP_ARG_INT | MP_ARG_KW_ONLY, {.u_int = 0} },
+        { MP_QSTR_preload, MP_ARG_BOOL | MP_ARG_KW_ONLY, {.u_bool = false} },
+        { MP_QSTR_outside_heap, MP_ARG_BOOL | MP_ARG_KW_ONLY, {.u_bool = false} },
+    };
+    mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all_kw_array(n_args, n_kw, all_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
+    mp_obj_t arg = args[ARG_file].u_obj;
 
     if (mp_obj_is_str(arg)) {
         arg = mp_call_function_2(MP_OBJ_FROM_PTR(&mp_builtin_open_obj), arg, MP_ROM_QSTR(MP_QSTR_rb));
     }
 
-    audioio_wavefile_obj_t *self = mp_obj_malloc(audioio_wavefile_obj_t, &audioio_wavefile_type);
+    audioio_wavefile_obj_t *self;
+    mp_buffer_info_t source_info;
+    if (!mp_obj_is_type(arg, &mp_type_vfs_fat_fileio) && mp_get_buffer(arg, &source_info, MP_BUFFER_READ)) {
+        if (args[ARG_buffer].u_obj != mp_const_none) {
+            mp_arg_error_invalid(MP_QSTR_buffer);
+        }
+        if (args[ARG_readahead].u_int != 0) {
+            mp_arg_error_invalid(MP_QSTR_readahead);
+        }
+        if (args[ARG_outside_heap].u_bool) {
+            mp_arg_error_invalid(MP_QSTR_outside_heap);
+        }
+        self = mp_obj_malloc_with_finaliser(audioio_wavefile_obj_t, &audioio_wavefile_type);
+        common_hal_audioio_wavefile_construct_from_buffer(self, arg);
+        return MP_OBJ_FROM_PTR(self);
+    }
+
     if (!mp_obj_is_type(arg, &mp_type_vfs_fat_fileio)) {
         mp_raise_TypeError(MP_ERROR_TEXT("file must be a file opened in byte mode"));
     }
+    mp_int_t readahead = mp_arg_validate_int_min(args[ARG_readahead].u_int, 0, MP_QSTR_readahead);
+    bool preload = args[ARG_preload].u_bool;
     uint8_t *buffer = NULL;
     size_t buffer_size = 0;
-    if (n_args >= 2) {
+    if (args[ARG_buffer].u_obj != mp_const_none) {
+        if (readahead || preload) {
+            mp_arg_error_invalid(MP_QSTR_buffer);
+        }
         mp_buffer_info_t bufinfo;
-        mp_get_buffer_raise(args[1], &bufinfo, MP_BUFFER_WRITE);
+        mp_get_buffer_raise(args[ARG_buffer].u_obj, &bufinfo, MP_BUFFER_WRITE);
         buffer = bufinfo.buf;
         buffer_size = mp_arg_validate_length_range(bufinfo.len, 8, 1024, MP_QSTR_buffer);
     }
+    self = mp_obj_malloc_with_finaliser(audioio_wavefile_obj_t, &audioio_wavefile_type);
     common_hal_audioio_wavefile_construct(self, MP_OBJ_TO_PTR(arg),
-        buffer, buffer_size);
+        buffer, buffer_size, readahead, preload, args[ARG_outside_heap].u_bool);
 
     return MP_OBJ_FROM_PTR(self);
 }
@@ -113,15 +167,45 @@ static MP_DEFINE_CONST_FUN_OBJ_1(audioio_wavefile_deinit_obj, audioio_wavefile_d
 //|     channel_count: int
 //|     """Number of audio channels. (read only)"""
 //|
+//|     readahead_stalls: int
+//|     """Number of times playback needed data that had not been read ahead yet, so it had to
+//|     wait for the file to be read. Only counted when ``readahead`` is used. (read only)"""
 //|
+static mp_obj_t audioio_wavefile_obj_get_readahead_stalls(mp_obj_t self_in) {
+    audioio_wavefile_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    audiosample_check_for_deinit(&self->base);
+    return mp_obj_new_int_from_uint(common_hal_audioio_wavefile_get_readahead_stalls(self));
+}
+MP_DEFINE_CONST_FUN_OBJ_1(audioio_wavefile_get_readahead_stalls_obj, audioio_wavefile_obj_get_readahead_stalls);
+
+MP_PROPERTY_GETTER(audioio_wavefile_readahead_stalls_obj,
+    (mp_obj_t)&audioio_wavefile_get_readahead_stalls_obj);
+
+//|     readahead_refills: int
+//|     """Number of buffers of audio data read ahead of playback in the background. (read only)"""
+//|
+//|
+static mp_obj_t audioio_wavefile_obj_get_readahead_refills(mp_obj_t self_in) {
+    audioio_wavefile_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    audiosample_check_for_deinit(&self->base);
+    return mp_obj_new_int_from_uint(common_hal_audioio_wavefile_get_readahead_refills(self));
+}
+MP_DEFINE_CONST_FUN_OBJ_1(audioio_wavefile_get_readahead_refills_obj, audioio_wavefile_obj_get_readahead_refills);
+
+MP_PROPERTY_GETTER(audioio_wavefile_readahead_refills_obj,
+    (mp_obj_t)&audioio_wavefile_get_readahead_refills_obj);
+
 
 static const mp_rom_map_elem_t audioio_wavefile_locals_dict_table[] = {
     // Methods
     { MP_ROM_QSTR(MP_QSTR_deinit), MP_ROM_PTR(&audioio_wavefile_deinit_obj) },
+    { MP_ROM_QSTR(MP_QSTR___del__), MP_ROM_PTR(&audioio_wavefile_deinit_obj) },
     { MP_ROM_QSTR(MP_QSTR___enter__), MP_ROM_PTR(&default___enter___obj) },
     { MP_ROM_QSTR(MP_QSTR___exit__), MP_ROM_PTR(&default___exit___obj) },
 
     // Properties
+    { MP_ROM_QSTR(MP_QSTR_readahead_stalls), MP_ROM_PTR(&audioio_wavefile_readahead_stalls_obj) },
+    { MP_ROM_QSTR(MP_QSTR_readahead_refills), MP_ROM_PTR(&audioio_wavefile_readahead_refills_obj) },
     AUDIOSAMPLE_FIELDS,
 };
 static MP_DEFINE_CONST_DICT(audioio_wavefile_locals_dict, audioio_wavefile_locals_dict_table);
@@ -14,6 +14,12 @@
 extern const mp_obj_type_t audioio_wavefile_type;
 
 void common_hal_audioio_wavefile_construct(audioio_wavefile_obj_t *self,
-    pyb_file_obj_t *file, uint8_t *buffer, size_t buffer_size);
+    pyb_file_obj_t *file, uint8_t *buffer, size_t buffer_size,
+    uint32_t readahead, bool preload, bool outside_heap);
+void common_hal_audioio_wavefile_construct_from_buffer(audioio_wavefile_obj_t *self,
+    mp_obj_t source);
 
 void common_hal_audioio_wavefile_deinit(audioio_wavefile_obj_t *self);
+
+uint32_t common_hal_audioio_wavefile_get_readahead_stalls(audioio_wavefile_obj_t *self);
+uint32_t common_hal_audioio_wavefile_get_readahead_refills(audioio_wavefile_obj_t *self);
@@ -12,6 +12,7 @@
 #include "py/runtime.h"
 
 #include "shared-bindings/audiocore/__init__.h"
+#include "shared-bindings/audiocore/Capture.h"
 #include "shared-bindings/audiocore/RawSample.h"
 #include "shared-bindings/audiocore/WaveFile.h"
 #include "shared-bindings/util.h"
@@ -71,6 +72,11 @@ static mp_obj_t audiocore_get_structure(mp_obj_t sample_in) {
 }
 static MP_DEFINE_CONST_FUN_OBJ_1(audiocore_get_structure_obj, audiocore_get_structure);
 
+static mp_obj_t audiocore_get_silent(mp_obj_t sample_in) {
+    return mp_obj_new_bool(audiosample_check(sample_in)->silent);
+}
+static MP_DEFINE_CONST_FUN_OBJ_1(audiocore_get_silent_obj, audiocore_get_silent);
+
 static mp_obj_t audiocore_reset_buffer(mp_obj_t sample_in) {
     audiosample_reset_buffer(sample_in, false, 0);
     return mp_const_none;
@@ -83,10 +89,17 @@ static const mp_rom_map_elem_t audiocore_module_globals_table[] = {
     { MP_ROM_QSTR(MP_QSTR___name__), MP_ROM_QSTR(MP_QSTR_audiocore) },
     { MP_ROM_QSTR(MP_QSTR_RawSample), MP_ROM_PTR(&audioio_rawsample_type) },
     { MP_ROM_QSTR(MP_QSTR_WaveFile), MP_ROM_PTR(&audioio_wavefile_type) },
+    #if CIRCUITPY_AUDIOCORE_CAPTURE
+    { MP_ROM_QSTR(MP_QSTR_Capture), MP_ROM_PTR(&audiocore_capture_type) },
+    #endif
     #if CIRCUITPY_AUDIOCORE_DEBUG
     { MP_ROM_QSTR(MP_QSTR_get_buffer), MP_ROM_PTR(&audiocore_get_buffer_obj) },
     { MP_ROM_QSTR(MP_QSTR_reset_buffer), MP_ROM_PTR(&audiocore_reset_buffer_obj) },
     { MP_ROM_QSTR(MP_QSTR_get_structure), MP_ROM_PTR(&audiocore_get_structure_obj) },
+    { MP_ROM_QSTR(MP_QSTR_get_silent), MP_ROM_PTR(&audiocore_get_silent_obj) },
+    #if CIRCUITPY_AUDIOCORE_CAPTURE
+    { MP_ROM_QSTR(MP_QSTR_FileCaptureSource), MP_ROM_PTR(&audiocore_filecapturesource_type) },
+    #endif
     #endif
 };
 
@@ -30,6 +30,8 @@
 //|         bits_per_sample: int = 16,
 //|         samples_signed: bool = True,
 //|         channel_count: int = 1,
+//|         quality: int = 2,
+//|         internal_memory: bool = False,
 //|     ) -> None:
 //|         """Create a Reverb effect simulating the audio taking place in a large room where you get echos
 //|            off of various surfaces at various times. The size of the room can be adjusted as well as how
@@ -46,6 +48,18 @@
 //|         :param int channel_count: The number of channels the source samples contain. 1 = mono; 2 = stereo.
 //|         :param int bits_per_sample: The bits per sample of the effect. Freeverb requires 16 bits.
 //|         :param bool samples_signed: Effect is signed (True) or unsigned (False). Freeverb requires signed (True).
+//|         :param int quality: How much work goes into the reverb, from 0 to 2. See below.
+//|         :param bool internal_memory: Place the delay lines in internal RAM rather than PSRAM, when the
+//|            board has PSRAM. Internal RAM is faster, but there is much less of it.
+//|
+//|         The quality trades the richness of the reverb against CPU time and memory. The delay lines take
+//|         about 25kB per channel at quality 2, and the time is mostly spent in the comb filters:
+//|
+//|         * 2: A bank of 8 comb filters and a set of 4 allpass filters per channel, the classic Freeverb.
+//|         * 1: Stereo sources are mixed to mono and share one bank of 8 comb filters, followed by a set of
+//|           allpass filters per channel, so the output is still stereo. About half the time and memory of 2 in stereo.
+//|         * 0: One bank of 4 comb filters and one set of allpass filters, shared by all channels. About a
+//|           quarter of the time and memory of 2 in stereo, half in mono.
 //|
 //|         Playing adding reverb to a synth::
 //|
@@ -70,7 +84,7 @@
 //|         ...
 //|
 static mp_obj_t audiofreeverb_freeverb_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *all_args) {
-    enum { ARG_roomsize, ARG_damp, ARG_mix, ARG_buffer_size, ARG_sample_rate, ARG_bits_per_sample, ARG_samples_signed, ARG_channel_count, };
+    enum { ARG_roomsize, ARG_damp, ARG_mix, ARG_buffer_size, ARG_sample_rate, ARG_bits_per_sample, ARG_samples_signed, ARG_channel_count, ARG_quality, ARG_internal_memory, };
     static const mp_arg_t allowed_args[] = {
         { MP_QSTR_roomsize, MP_ARG_OBJ | MP_ARG_KW_ONLY,  {.u_obj = MP_OBJ_NULL} },
         { MP_QSTR_damp, MP_ARG_OBJ | MP_ARG_KW_ONLY,  {.u_obj = MP_OBJ_NULL} },
@@ -80,6 +94,8 @@ static mp_obj_t audiofreeverb_freeverb_make_new(const mp_obj_type_t *type, size_
         { MP_QSTR_bits_per_sample, MP_ARG_INT | MP_ARG_KW_ONLY, {.u_int = 16} },
         { MP_QSTR_samples_signed, MP_ARG_BOOL | MP_ARG_KW_ONLY, {.u_bool = true} },
         { MP_QSTR_channel_count, MP_ARG_INT | MP_ARG_KW_ONLY, {.u_int = 1 } },
+        { MP_QSTR_quality, MP_ARG_INT | MP_ARG_KW_ONLY, {.u_int = 2 } },
+        { MP_QSTR_internal_memory, MP_ARG_BOOL | MP_ARG_KW_ONLY, {.u_bool = false } },
     };
 
     mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
@@ -87,6 +103,7 @@ static mp_obj_t audiofreeverb_freeverb_make_new(const mp_obj_type_t *type, size_
 
     mp_int_t channel_count = mp_arg_validate_int_range(args[ARG_channel_count].u_int, 1, 2, MP_QSTR_channel_count);
     mp_int_t sample_rate = mp_arg_validate_int_min(args[ARG_sample_rate].u_int, 1, MP_QSTR_sample_rate);
+    mp_int_t quality = mp_arg_validate_int_range(args[ARG_quality].u_int, 0, 2, MP_QSTR_quality);
     if (args[ARG_samples_signed].u_bool != true) {
         mp_raise_ValueError(MP_ERROR_TEXT("samples_signed must be true"));
     }
@@ -95,8 +112,8 @@ static mp_obj_t audiofreeverb_freeverb_make_new(const mp_obj_type_t *type, size_
         mp_raise_ValueError(MP_ERROR_TEXT("bits_per_sample must be 16"));
     }
 
-    audiofreeverb_freeverb_obj_t *self = mp_obj_malloc(audiofreeverb_freeverb_obj_t, &audiofreeverb_freeverb_type);
-    common_hal_audiofreeverb_freeverb_construct(self, args[ARG_roomsize].u_obj, args[ARG_damp].u_obj, args[ARG_mix].u_obj, args[ARG_buffer_size].u_int, bits_per_sample, args[ARG_samples_signed].u_bool, channel_count, sample_rate);
+    audiofreeverb_freeverb_obj_t *self = mp_obj_malloc_with_finaliser(audiofreeverb_freeverb_obj_t, &audiofreeverb_freeverb_type);
+    common_hal_audiofreeverb_freeverb_construct(self, args[ARG_roomsize].u_obj, args[ARG_damp].u_obj, args[ARG_mix].u_obj, args[ARG_buffer_size].u_int, bits_per_sample, args[ARG_samples_signed].u_bool, channel_count, sample_rate, quality, args[ARG_internal_memory].u_bool);
 
     return MP_OBJ_FROM_PTR(self);
 }
@@ -183,6 +200,18 @@ MP_PROPERTY_GETSET(audiofreeverb_freeverb_mix_obj,
     (mp_obj_t)&audiofreeverb_freeverb_get_mix_obj,
     (mp_obj_t)&audiofreeverb_freeverb_set_mix_obj);
 
+//|     quality: int
+//|     """The quality given when the effect was created. (read-only)"""
+static mp_obj_t audiofreeverb_freeverb_obj_get_quality(mp_obj_t self_in) {
+    audiofreeverb_freeverb_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    check_for_deinit(self);
+    return MP_OBJ_NEW_SMALL_INT(common_hal_audiofreeverb_freeverb_get_quality(self));
+}
+MP_DEFINE_CONST_FUN_OBJ_1(audiofreeverb_freeverb_get_quality_obj, audiofreeverb_freeverb_obj_get_quality);
+
+MP_PROPERTY_GETTER(audiofreeverb_freeverb_quality_obj,
+    (mp_obj_t)&audiofreeverb_freeverb_get_quality_obj);
+
 //|     playing: bool
 //|     """True when the effect is playing a sample. (read-only)"""
 //|
@@ -200,7 +229,8 @@ MP_PROPERTY_GETTER(audiofreeverb_freeverb_playing_obj,
 //|         """Plays the sample once when loop=False and continuously when loop=True.
 //|         Does not block. Use `playing` to block.
 //|
-//|         The sample must match the encoding settings given in the constructor."""
+//|         The sample must have the sample rate given in the constructor. Its other encoding
+//|         settings are converted to the ones given in the constructor as it plays."""
 //|         ...
 //|
 static mp_obj_t audiofreeverb_freeverb_obj_play(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
@@ -238,6 +268,7 @@ MP_DEFINE_CONST_FUN_OBJ_1(audiofreeverb_freeverb_stop_obj, audiofreeverb_freever
 static const mp_rom_map_elem_t audiofreeverb_freeverb_locals_dict_table[] = {
     // Methods
     { MP_ROM_QSTR(MP_QSTR_deinit), MP_ROM_PTR(&audiofreeverb_freeverb_deinit_obj) },
+    { MP_ROM_QSTR(MP_QSTR___del__), MP_ROM_PTR(&audiofreeverb_freeverb_deinit_obj) },
     { MP_ROM_QSTR(MP_QSTR___enter__), MP_ROM_PTR(&default___enter___obj) },
     { MP_ROM_QSTR(MP_QSTR___exit__), MP_ROM_PTR(&default___exit___obj) },
     { MP_ROM_QSTR(MP_QSTR_play), MP_ROM_PTR(&audiofreeverb_freeverb_play_obj) },
@@ -248,6 +279,7 @@ static const mp_rom_map_elem_t audiofreeverb_freeverb_locals_dict_table[] = {
     { MP_ROM_QSTR(MP_QSTR_roomsize), MP_ROM_PTR(&audiofreeverb_freeverb_roomsize_obj) },
     { MP_ROM_QSTR(MP_QSTR_damp), MP_ROM_PTR(&audiofreeverb_freeverb_damp_obj) },
     { MP_ROM_QSTR(MP_QSTR_mix), MP_ROM_PTR(&audiofreeverb_freeverb_mix_obj) },
+    { MP_ROM_QSTR(MP_QSTR_quality), MP_ROM_PTR(&audiofreeverb_freeverb_quality_obj) },
     AUDIOSAMPLE_FIELDS,
 };
 static MP_DEFINE_CONST_DICT(audiofreeverb_freeverb_locals_dict, audiofreeverb_freeverb_locals_dict_table);
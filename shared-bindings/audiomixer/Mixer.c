@@ -31,6 +31,10 @@
 //|         """Create a Mixer object that can mix multiple channels with the same sample rate.
 //|         Samples are accessed and controlled with the mixer's `audiomixer.MixerVoice` objects.
 //|
+//|         Voices are summed at full precision. When more than one voice is
+//|         playing, peaks above about 85% of full scale are compressed so that
+//|         the sum fits in the output range instead of clipping.
+//|
 //|         :param int voice_count: The maximum number of voices to mix
 //|         :param int buffer_size: The total size in bytes of the buffers to mix into
 //|         :param int channel_count: The number of channels the source samples contain. 1 = mono; 2 = stereo.
@@ -166,7 +170,8 @@ MP_PROPERTY_GETTER(audiomixer_mixer_voice_obj,
 //|
 //|         Sample must be an `audiocore.WaveFile`, `audiocore.RawSample`, `audiomixer.Mixer` or `audiomp3.MP3Decoder`.
 //|
-//|         The sample must match the Mixer's encoding settings given in the constructor."""
+//|         The sample must have the Mixer's sample rate. Its other encoding settings are converted
+//|         to the Mixer's as it plays."""
 //|         ...
 //|
 static mp_obj_t audiomixer_mixer_obj_play(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
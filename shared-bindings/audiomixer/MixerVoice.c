@@ -42,7 +42,8 @@ static mp_obj_t audiomixer_mixervoice_make_new(const mp_obj_type_t *type, size_t
 //|
 //|         Sample must be an `audiocore.WaveFile`, `audiocore.RawSample`, `audiomixer.Mixer` or `audiomp3.MP3Decoder`.
 //|
-//|         The sample must match the `audiomixer.Mixer`'s encoding settings given in the constructor.
+//|         The sample must have the `audiomixer.Mixer`'s sample rate. Its other encoding settings
+//|         are converted to the `audiomixer.Mixer`'s as it plays.
 //|         """
 //|         ...
 //|
@@ -25,11 +25,18 @@
 //|         https://learn.adafruit.com/Memory-saving-tips-for-CircuitPython/reducing-memory-fragmentation
 //|     """
 //|
-//|     def __init__(self, file: Union[str, typing.BinaryIO], buffer: WriteableBuffer) -> None:
+//|     def __init__(
+//|         self,
+//|         file: Union[str, typing.BinaryIO],
+//|         buffer: Optional[WriteableBuffer] = None,
+//|         *,
+//|         frames_ahead: int = 0,
+//|     ) -> None:
 //|         """Load a .mp3 file for playback with `audioio.AudioOut` or `audiobusio.I2SOut`.
 //|
 //|         :param Union[str, typing.BinaryIO] file: The name of a mp3 file (preferred) or an already opened mp3 file
 //|         :param ~circuitpython_typing.WriteableBuffer buffer: Optional pre-allocated buffer, that will be split and used for buffering the data. The buffer is split into two parts for decoded data and the remainder is used for pre-decoded data. When playing from a socket, a larger buffer can help reduce playback glitches at the expense of increased memory usage.
+//|         :param int frames_ahead: Number of frames to decode ahead of playback in the background. Each frame uses about 4.5kB. With a nonzero value, decoding happens outside the audio pull, so a slow frame does not cause a glitch as long as the decoder keeps up on average; ``buffer`` is then used entirely for undecoded data.
 //|
 //|         Playback of mp3 audio is CPU intensive, and the
 //|         exact limit depends on many factors such as the particular
@@ -72,6 +79,9 @@
 //|                 stream.seek(128000 * 30 // 8) # Seek about 30s into a 128kbit/s stream
 //|                 decoder.file = stream
 //|
+//|         or use `seek`, which jumps using a table of frame offsets gathered while
+//|         decoding, the table of contents stored in most VBR files, or the bitrate.
+//|
 //|         If the stream is played with ``loop = True``, the loop will start at the beginning.
 //|
 //|         It is possible to stream an mp3 from a socket, including a secure socket.
@@ -83,9 +93,17 @@
 //|         ...
 //|
 
-static mp_obj_t audiomp3_mp3file_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *args) {
-    mp_arg_check_num(n_args, n_kw, 1, 2, false);
-    mp_obj_t stream = args[0];
+static mp_obj_t audiomp3_mp3file_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *all_args) {
+    enum { ARG_file, ARG_buffer, ARG_frames_ahead };
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_file, MP_ARG_OBJ | MP_ARG_REQUIRED, {} },
+        { MP_QSTR_buffer, MP_ARG_OBJ, {.u_obj = mp_const_none} },
+        { MP_QSTR_frames_ahead, MP_ARG_INT | MP_ARG_KW_ONLY, {.u_int = 0} },
+    };
+    mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all_kw_array(n_args, n_kw, all_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
+    mp_obj_t stream = args[ARG_file].u_obj;
+    mp_int_t frames_ahead = mp_arg_validate_int_range(args[ARG_frames_ahead].u_int, 0, 32, MP_QSTR_frames_ahead);
 
     if (mp_obj_is_str(stream)) {
         stream = mp_call_function_2(MP_OBJ_FROM_PTR(&mp_builtin_open_obj), stream, MP_ROM_QSTR(MP_QSTR_rb));
@@ -100,13 +118,13 @@ static mp_obj_t audiomp3_mp3file_make_new(const mp_obj_type_t *type, size_t n_ar
     }
     uint8_t *buffer = NULL;
     size_t buffer_size = 0;
-    if (n_args >= 2) {
+    if (args[ARG_buffer].u_obj != mp_const_none) {
         mp_buffer_info_t bufinfo;
-        mp_get_buffer_raise(args[1], &bufinfo, MP_BUFFER_WRITE);
+        mp_get_buffer_raise(args[ARG_buffer].u_obj, &bufinfo, MP_BUFFER_WRITE);
         buffer = bufinfo.buf;
         buffer_size = bufinfo.len;
     }
-    common_hal_audiomp3_mp3file_construct(self, stream, buffer, buffer_size);
+    common_hal_audiomp3_mp3file_construct(self, stream, buffer, buffer_size, frames_ahead);
 
     return MP_OBJ_FROM_PTR(self);
 }
@@ -181,6 +199,27 @@ MP_PROPERTY_GETSET(audiomp3_mp3file_file_obj,
     (mp_obj_t)&audiomp3_mp3file_get_file_obj,
     (mp_obj_t)&audiomp3_mp3file_set_file_obj);
 
+//|     def seek(self, position: float) -> None:
+//|         """Move playback to ``position`` seconds from the start of the file.
+//|
+//|         Positions already decoded, or passed by an earlier seek, are reached
+//|         exactly from an index of frame offsets. Further positions are reached
+//|         in a single jump, to within a frame or so, using the table of contents
+//|         in a Xing or VBRI header. Files without either header are taken to have
+//|         a constant bitrate until a frame with another bitrate is decoded or
+//|         jumped to. From then on, and in files with a header but no usable table
+//|         of contents, further positions are read through to frame header by
+//|         frame header instead. The file must be seekable."""
+//|         ...
+//|
+static mp_obj_t audiomp3_mp3file_obj_seek(mp_obj_t self_in, mp_obj_t position) {
+    audiomp3_mp3file_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    check_for_deinit(self);
+    common_hal_audiomp3_mp3file_seek(self, mp_obj_get_float(position));
+    return mp_const_none;
+}
+MP_DEFINE_CONST_FUN_OBJ_2(audiomp3_mp3file_seek_obj, audiomp3_mp3file_obj_seek);
+
 
 
 //|     sample_rate: int
@@ -208,8 +247,6 @@ MP_PROPERTY_GETTER(audiomp3_mp3file_rms_level_obj,
 
 //|     samples_decoded: int
 //|     """The number of audio samples decoded from the current file. (read only)"""
-//|
-//|
 static mp_obj_t audiomp3_mp3file_obj_get_samples_decoded(mp_obj_t self_in) {
     audiomp3_mp3file_obj_t *self = MP_OBJ_TO_PTR(self_in);
     check_for_deinit(self);
@@ -220,9 +257,39 @@ MP_DEFINE_CONST_FUN_OBJ_1(audiomp3_mp3file_get_samples_decoded_obj, audiomp3_mp3
 MP_PROPERTY_GETTER(audiomp3_mp3file_samples_decoded_obj,
     (mp_obj_t)&audiomp3_mp3file_get_samples_decoded_obj);
 
+//|     decode_time: float
+//|     """Time in seconds spent decoding the most recent frame. Compare it with the
+//|     duration of a frame (1152 samples at the `sample_rate` for most files) to
+//|     see how much of the CPU mp3 playback needs. (read only)"""
+static mp_obj_t audiomp3_mp3file_obj_get_decode_time(mp_obj_t self_in) {
+    audiomp3_mp3file_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    check_for_deinit(self);
+    return mp_obj_new_float(common_hal_audiomp3_mp3file_get_decode_time(self));
+}
+MP_DEFINE_CONST_FUN_OBJ_1(audiomp3_mp3file_get_decode_time_obj, audiomp3_mp3file_obj_get_decode_time);
+
+MP_PROPERTY_GETTER(audiomp3_mp3file_decode_time_obj,
+    (mp_obj_t)&audiomp3_mp3file_get_decode_time_obj);
+
+//|     underruns: int
+//|     """The number of times playback needed a frame before it had been decoded
+//|     ahead, since the file was set. Always 0 when ``frames_ahead`` is 0. (read only)"""
+//|
+//|
+static mp_obj_t audiomp3_mp3file_obj_get_underruns(mp_obj_t self_in) {
+    audiomp3_mp3file_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    check_for_deinit(self);
+    return mp_obj_new_int_from_uint(common_hal_audiomp3_mp3file_get_underruns(self));
+}
+MP_DEFINE_CONST_FUN_OBJ_1(audiomp3_mp3file_get_underruns_obj, audiomp3_mp3file_obj_get_underruns);
+
+MP_PROPERTY_GETTER(audiomp3_mp3file_underruns_obj,
+    (mp_obj_t)&audiomp3_mp3file_get_underruns_obj);
+
 static const mp_rom_map_elem_t audiomp3_mp3file_locals_dict_table[] = {
     // Methods
     { MP_ROM_QSTR(MP_QSTR_open), MP_ROM_PTR(&audiomp3_mp3file_open_obj) },
+    { MP_ROM_QSTR(MP_QSTR_seek), MP_ROM_PTR(&audiomp3_mp3file_seek_obj) },
     { MP_ROM_QSTR(MP_QSTR_deinit), MP_ROM_PTR(&audiomp3_mp3file_deinit_obj) },
     { MP_ROM_QSTR(MP_QSTR___del__), MP_ROM_PTR(&audiomp3_mp3file_deinit_obj) },
     { MP_ROM_QSTR(MP_QSTR___enter__), MP_ROM_PTR(&default___enter___obj) },
@@ -232,6 +299,8 @@ static const mp_rom_map_elem_t audiomp3_mp3file_locals_dict_table[] = {
     { MP_ROM_QSTR(MP_QSTR_file), MP_ROM_PTR(&audiomp3_mp3file_file_obj) },
     { MP_ROM_QSTR(MP_QSTR_rms_level), MP_ROM_PTR(&audiomp3_mp3file_rms_level_obj) },
     { MP_ROM_QSTR(MP_QSTR_samples_decoded), MP_ROM_PTR(&audiomp3_mp3file_samples_decoded_obj) },
+    { MP_ROM_QSTR(MP_QSTR_decode_time), MP_ROM_PTR(&audiomp3_mp3file_decode_time_obj) },
+    { MP_ROM_QSTR(MP_QSTR_underruns), MP_ROM_PTR(&audiomp3_mp3file_underruns_obj) },
     AUDIOSAMPLE_FIELDS,
 };
 static MP_DEFINE_CONST_DICT(audiomp3_mp3file_locals_dict, audiomp3_mp3file_locals_dict_table);
@@ -20,12 +20,29 @@
 //|
 //|     Multiple AddressRanges may overlap. There is no "claiming" of addresses.
 //|
+//|     An AddressRange of plain memory, such as RAM or memory-mapped flash, also
+//|     supports the buffer protocol, so it can be used in place wherever a
+//|     `ReadableBuffer` is accepted, for instance by `audiocore.RawSample` and
+//|     `audiocore.WaveFile`. Read-only memory, such as flash, can't be used where a
+//|     `WriteableBuffer` is needed. Ranges of registers don't support the buffer
+//|     protocol; use indexing for them instead.
+//|
 //|     Example usage on ESP32-S2::
 //|
 //|        import memorymap
 //|        rtc_slow_mem = memorymap.AddressRange(start=0x50000000, length=0x2000)
 //|        rtc_slow_mem[0:3] = b"\xcc\x10\x00"
 //|
+//|     On ESP32 boards, a ``start`` below the memory-mapped region is an offset into
+//|     flash. The range must lie within one data partition, and it is mapped
+//|     read-only. Mapped flash supports the buffer protocol, so a .wav file stored
+//|     in a data partition can be played without copying it into RAM::
+//|
+//|        import audiocore
+//|        import memorymap
+//|        clip = memorymap.AddressRange(start=0x310000, length=48044)
+//|        wave = audiocore.WaveFile(clip)
+//|
 //|     Example I/O register usage on RP2040::
 //|
 //|        import binascii
@@ -116,6 +133,17 @@ static mp_obj_t memorymap_addressrange_unary_op(mp_unary_op_t op, mp_obj_t self_
     }
 }
 
+static mp_int_t memorymap_addressrange_get_buffer(mp_obj_t self_in, mp_buffer_info_t *bufinfo, mp_uint_t flags) {
+    memorymap_addressrange_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    if (!common_hal_memorymap_addressrange_is_memory(self, (flags & MP_BUFFER_WRITE) != 0)) {
+        return 1;
+    }
+    bufinfo->buf = self->start_address;
+    bufinfo->len = common_hal_memorymap_addressrange_get_length(self);
+    bufinfo->typecode = 'B';
+    return 0;
+}
+
 static const mp_rom_map_elem_t memorymap_addressrange_locals_dict_table[] = {
 };
 
@@ -224,5 +252,6 @@ MP_DEFINE_CONST_OBJ_TYPE(
     make_new, memorymap_addressrange_make_new,
     locals_dict, (mp_obj_t)&memorymap_addressrange_locals_dict,
     subscr, memorymap_addressrange_subscr,
+    buffer, memorymap_addressrange_get_buffer,
     unary_op, memorymap_addressrange_unary_op
     );
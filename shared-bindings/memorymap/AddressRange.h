@@ -14,6 +14,10 @@ void common_hal_memorymap_addressrange_construct(memorymap_addressrange_obj_t *s
 
 size_t common_hal_memorymap_addressrange_get_length(const memorymap_addressrange_obj_t *self);
 
+// Whether the range is plain memory that can be read (or, when writable is
+// true, written) in place, rather than registers that need sized accesses.
+bool common_hal_memorymap_addressrange_is_memory(const memorymap_addressrange_obj_t *self, bool writable);
+
 void common_hal_memorymap_addressrange_set_bytes(const memorymap_addressrange_obj_t *self,
     size_t start_index, uint8_t *values, size_t len);
 
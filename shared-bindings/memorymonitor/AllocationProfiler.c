@@ -0,0 +1,183 @@
+// This file is part of the CircuitPython project: https://circuitpython.org
+//
+// SPDX-FileCopyrightText: Copyright (c) 2026 Adafruit Industries LLC
+//
+// SPDX-License-Identifier: MIT
+
+#include <stdint.h>
+
+#include "py/objproperty.h"
+#include "py/runtime.h"
+#include "shared-bindings/memorymonitor/AllocationProfiler.h"
+
+//| class AllocationProfiler:
+//|     def __init__(self, *, every: int = 1, every_bytes: int = 0, max_sites: int = 32) -> None:
+//|         """Samples allocations and adds them up by the place that made them.
+//|
+//|         A place is the line of Python code that was running, together with the address
+//|         of the C function that asked for the memory. The address can be looked up in the
+//|         firmware's map file. Allocations made while no Python code is running, such as
+//|         while compiling, have no file, function or line.
+//|
+//|         Every ``every`` th allocation is sampled or, when ``every_bytes`` is given,
+//|         the allocation that takes the total past each multiple of ``every_bytes``. Counts
+//|         and sizes are of the sampled allocations only, so with sampling they need to be
+//|         scaled up to estimate the real totals.
+//|
+//|         Up to ``max_sites`` places are kept. Samples from places after that are counted
+//|         in `dropped`.
+//|
+//|         Reallocations that grow a buffer count as an allocation of the new size.
+//|
+//|         :param int every: Sample one in this many allocations
+//|         :param int every_bytes: Sample once per this many bytes allocated, instead
+//|         :param int max_sites: Number of places to keep, up to 256
+//|
+//|         Find what allocates the most::
+//|
+//|           import memorymonitor
+//|
+//|           profiler = memorymonitor.AllocationProfiler()
+//|           with profiler:
+//|               do_something()
+//|
+//|           for file, function, line, caller, count, size in profiler.report()[:5]:
+//|               print(file, function, line, hex(caller), count, size)
+//|
+//|         """
+//|         ...
+//|
+static mp_obj_t memorymonitor_allocationprofiler_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *all_args) {
+    enum { ARG_every, ARG_every_bytes, ARG_max_sites };
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_every, MP_ARG_KW_ONLY | MP_ARG_INT, {.u_int = 1} },
+        { MP_QSTR_every_bytes, MP_ARG_KW_ONLY | MP_ARG_INT, {.u_int = 0} },
+        { MP_QSTR_max_sites, MP_ARG_KW_ONLY | MP_ARG_INT, {.u_int = 32} },
+    };
+    mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all_kw_array(n_args, n_kw, all_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
+
+    mp_int_t every = mp_arg_validate_int_min(args[ARG_every].u_int, 1, MP_QSTR_every);
+    mp_int_t every_bytes = mp_arg_validate_int_min(args[ARG_every_bytes].u_int, 0, MP_QSTR_every_bytes);
+    mp_int_t max_sites = mp_arg_validate_int_range(args[ARG_max_sites].u_int, 1, ALLOCATION_PROFILER_MAX_SITES, MP_QSTR_max_sites);
+
+    memorymonitor_allocationprofiler_obj_t *self =
+        mp_obj_malloc(memorymonitor_allocationprofiler_obj_t, &memorymonitor_allocationprofiler_type);
+
+    common_hal_memorymonitor_allocationprofiler_construct(self, every, every_bytes, max_sites);
+
+    return MP_OBJ_FROM_PTR(self);
+}
+
+//|     def __enter__(self) -> AllocationProfiler:
+//|         """Clears what has been recorded and starts profiling."""
+//|         ...
+//|
+static mp_obj_t memorymonitor_allocationprofiler_obj___enter__(mp_obj_t self_in) {
+    memorymonitor_allocationprofiler_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    common_hal_memorymonitor_allocationprofiler_clear(self);
+    common_hal_memorymonitor_allocationprofiler_resume(self);
+    return self_in;
+}
+static MP_DEFINE_CONST_FUN_OBJ_1(memorymonitor_allocationprofiler___enter___obj, memorymonitor_allocationprofiler_obj___enter__);
+
+//|     def __exit__(self) -> None:
+//|         """Stops profiling, keeping what has been recorded. See
+//|         :ref:`lifetime-and-contextmanagers` for more info."""
+//|         ...
+//|
+static mp_obj_t memorymonitor_allocationprofiler_obj___exit__(size_t n_args, const mp_obj_t *args) {
+    (void)n_args;
+    common_hal_memorymonitor_allocationprofiler_pause(MP_OBJ_TO_PTR(args[0]));
+    return mp_const_none;
+}
+static MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(memorymonitor_allocationprofiler___exit___obj, 4, 4, memorymonitor_allocationprofiler_obj___exit__);
+
+//|     def report(self) -> List[Tuple[Optional[str], Optional[str], int, int, int, int]]:
+//|         """Returns a list of ``(file, function, line, caller, count, bytes)`` tuples,
+//|         one for each place that allocated, with the most bytes first. The report's
+//|         own allocations are not recorded. It can be called while profiling."""
+//|         ...
+//|
+static mp_obj_t memorymonitor_allocationprofiler_obj_report(mp_obj_t self_in) {
+    return common_hal_memorymonitor_allocationprofiler_report(MP_OBJ_TO_PTR(self_in));
+}
+static MP_DEFINE_CONST_FUN_OBJ_1(memorymonitor_allocationprofiler_report_obj, memorymonitor_allocationprofiler_obj_report);
+
+//|     def clear(self) -> None:
+//|         """Forgets what has been recorded."""
+//|         ...
+//|
+static mp_obj_t memorymonitor_allocationprofiler_obj_clear(mp_obj_t self_in) {
+    common_hal_memorymonitor_allocationprofiler_clear(MP_OBJ_TO_PTR(self_in));
+    return mp_const_none;
+}
+static MP_DEFINE_CONST_FUN_OBJ_1(memorymonitor_allocationprofiler_clear_obj, memorymonitor_allocationprofiler_obj_clear);
+
+//|     running: bool
+//|     """True while profiling."""
+//|
+static mp_obj_t memorymonitor_allocationprofiler_obj_get_running(mp_obj_t self_in) {
+    return mp_obj_new_bool(common_hal_memorymonitor_allocationprofiler_get_running(MP_OBJ_TO_PTR(self_in)));
+}
+MP_DEFINE_CONST_FUN_OBJ_1(memorymonitor_allocationprofiler_get_running_obj, memorymonitor_allocationprofiler_obj_get_running);
+
+MP_PROPERTY_GETTER(memorymonitor_allocationprofiler_running_obj,
+    (mp_obj_t)&memorymonitor_allocationprofiler_get_running_obj);
+
+//|     total_allocations: int
+//|     """Number of allocations seen, sampled or not."""
+//|
+static mp_obj_t memorymonitor_allocationprofiler_obj_get_total_allocations(mp_obj_t self_in) {
+    return mp_obj_new_int_from_uint(common_hal_memorymonitor_allocationprofiler_get_total_allocations(MP_OBJ_TO_PTR(self_in)));
+}
+MP_DEFINE_CONST_FUN_OBJ_1(memorymonitor_allocationprofiler_get_total_allocations_obj, memorymonitor_allocationprofiler_obj_get_total_allocations);
+
+MP_PROPERTY_GETTER(memorymonitor_allocationprofiler_total_allocations_obj,
+    (mp_obj_t)&memorymonitor_allocationprofiler_get_total_allocations_obj);
+
+//|     total_bytes: int
+//|     """Number of bytes allocated, sampled or not."""
+//|
+static mp_obj_t memorymonitor_allocationprofiler_obj_get_total_bytes(mp_obj_t self_in) {
+    return mp_obj_new_int_from_uint(common_hal_memorymonitor_allocationprofiler_get_total_bytes(MP_OBJ_TO_PTR(self_in)));
+}
+MP_DEFINE_CONST_FUN_OBJ_1(memorymonitor_allocationprofiler_get_total_bytes_obj, memorymonitor_allocationprofiler_obj_get_total_bytes);
+
+MP_PROPERTY_GETTER(memorymonitor_allocationprofiler_total_bytes_obj,
+    (mp_obj_t)&memorymonitor_allocationprofiler_get_total_bytes_obj);
+
+//|     dropped: int
+//|     """Number of samples left out because all ``max_sites`` places were in use."""
+//|
+//|
+static mp_obj_t memorymonitor_allocationprofiler_obj_get_dropped(mp_obj_t self_in) {
+    return mp_obj_new_int_from_uint(common_hal_memorymonitor_allocationprofiler_get_dropped(MP_OBJ_TO_PTR(self_in)));
+}
+MP_DEFINE_CONST_FUN_OBJ_1(memorymonitor_allocationprofiler_get_dropped_obj, memorymonitor_allocationprofiler_obj_get_dropped);
+
+MP_PROPERTY_GETTER(memorymonitor_allocationprofiler_dropped_obj,
+    (mp_obj_t)&memorymonitor_allocationprofiler_get_dropped_obj);
+
+static const mp_rom_map_elem_t memorymonitor_allocationprofiler_locals_dict_table[] = {
+    // Methods
+    { MP_ROM_QSTR(MP_QSTR___enter__), MP_ROM_PTR(&memorymonitor_allocationprofiler___enter___obj) },
+    { MP_ROM_QSTR(MP_QSTR___exit__), MP_ROM_PTR(&memorymonitor_allocationprofiler___exit___obj) },
+    { MP_ROM_QSTR(MP_QSTR_report), MP_ROM_PTR(&memorymonitor_allocationprofiler_report_obj) },
+    { MP_ROM_QSTR(MP_QSTR_clear), MP_ROM_PTR(&memorymonitor_allocationprofiler_clear_obj) },
+
+    // Properties
+    { MP_ROM_QSTR(MP_QSTR_running), MP_ROM_PTR(&memorymonitor_allocationprofiler_running_obj) },
+    { MP_ROM_QSTR(MP_QSTR_total_allocations), MP_ROM_PTR(&memorymonitor_allocationprofiler_total_allocations_obj) },
+    { MP_ROM_QSTR(MP_QSTR_total_bytes), MP_ROM_PTR(&memorymonitor_allocationprofiler_total_bytes_obj) },
+    { MP_ROM_QSTR(MP_QSTR_dropped), MP_ROM_PTR(&memorymonitor_allocationprofiler_dropped_obj) },
+};
+static MP_DEFINE_CONST_DICT(memorymonitor_allocationprofiler_locals_dict, memorymonitor_allocationprofiler_locals_dict_table);
+
+MP_DEFINE_CONST_OBJ_TYPE(
+    memorymonitor_allocationprofiler_type,
+    MP_QSTR_AllocationProfiler,
+    MP_TYPE_FLAG_HAS_SPECIAL_ACCESSORS,
+    make_new, memorymonitor_allocationprofiler_make_new,
+    locals_dict, &memorymonitor_allocationprofiler_locals_dict
+    );
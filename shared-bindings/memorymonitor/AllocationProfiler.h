@@ -0,0 +1,22 @@
+// This file is part of the CircuitPython project: https://circuitpython.org
+//
+// SPDX-FileCopyrightText: Copyright (c) 2026 Adafruit Industries LLC
+//
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include "shared-module/memorymonitor/AllocationProfiler.h"
+
+extern const mp_obj_type_t memorymonitor_allocationprofiler_type;
+
+void common_hal_memorymonitor_allocationprofiler_construct(memorymonitor_allocationprofiler_obj_t *self,
+    uint32_t every, uint32_t every_bytes, uint16_t max_sites);
+void common_hal_memorymonitor_allocationprofiler_pause(memorymonitor_allocationprofiler_obj_t *self);
+void common_hal_memorymonitor_allocationprofiler_resume(memorymonitor_allocationprofiler_obj_t *self);
+void common_hal_memorymonitor_allocationprofiler_clear(memorymonitor_allocationprofiler_obj_t *self);
+bool common_hal_memorymonitor_allocationprofiler_get_running(memorymonitor_allocationprofiler_obj_t *self);
+uint32_t common_hal_memorymonitor_allocationprofiler_get_total_allocations(memorymonitor_allocationprofiler_obj_t *self);
+size_t common_hal_memorymonitor_allocationprofiler_get_total_bytes(memorymonitor_allocationprofiler_obj_t *self);
+uint32_t common_hal_memorymonitor_allocationprofiler_get_dropped(memorymonitor_allocationprofiler_obj_t *self);
+mp_obj_t common_hal_memorymonitor_allocationprofiler_report(memorymonitor_allocationprofiler_obj_t *self);
@@ -12,14 +12,12 @@
 void memorymonitor_exception_print(const mp_print_t *print, mp_obj_t o_in, mp_print_kind_t kind);
 
 #define MP_DEFINE_MEMORYMONITOR_EXCEPTION(exc_name, base_name) \
-    const mp_obj_type_t mp_type_memorymonitor_##exc_name = { \
-        { &mp_type_type }, \
-        .name = MP_QSTR_##exc_name, \
-        .print = memorymonitor_exception_print, \
-        .make_new = mp_obj_exception_make_new, \
-        .attr = mp_obj_exception_attr, \
-        .parent = &mp_type_##base_name, \
-    };
+    MP_DEFINE_CONST_OBJ_TYPE(mp_type_memorymonitor_##exc_name, MP_QSTR_##exc_name, MP_TYPE_FLAG_NONE, \
+    make_new, mp_obj_exception_make_new, \
+    print, memorymonitor_exception_print, \
+    attr, mp_obj_exception_attr, \
+    parent, &mp_type_##base_name \
+    );
 
 extern const mp_obj_type_t mp_type_memorymonitor_AllocationError;
 
@@ -7,6 +7,7 @@
 #pragma once
 
 #include "py/obj.h"
+#include "shared-bindings/synthio/__init__.h"
 
 typedef struct synthio_lfo_obj synthio_lfo_obj_t;
 extern const mp_obj_type_t synthio_lfo_type;
@@ -37,4 +38,4 @@ mp_float_t common_hal_synthio_lfo_get_value(synthio_lfo_obj_t *self);
 mp_float_t common_hal_synthio_lfo_get_phase(synthio_lfo_obj_t *self);
 
 void common_hal_synthio_lfo_retrigger(synthio_lfo_obj_t *self);
-mp_float_t common_hal_synthio_lfo_tick(mp_obj_t self_in);
+mp_float_t common_hal_synthio_lfo_tick(mp_obj_t self_in, const synthio_render_context_t *ctx);
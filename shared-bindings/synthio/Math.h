@@ -7,6 +7,7 @@
 #pragma once
 
 #include "py/obj.h"
+#include "shared-bindings/synthio/__init__.h"
 
 typedef enum {
     OP_SUM,
@@ -37,4 +38,4 @@ void common_hal_synthio_math_set_operation(synthio_math_obj_t *self, synthio_mat
 
 mp_float_t common_hal_synthio_math_get_value(synthio_math_obj_t *self);
 
-mp_float_t common_hal_synthio_math_tick(mp_obj_t self_in);
+mp_float_t common_hal_synthio_math_tick(mp_obj_t self_in, const synthio_render_context_t *ctx);
@@ -20,22 +20,28 @@
 //|
 //|     def __init__(
 //|         self,
-//|         buffer: ReadableBuffer,
+//|         buffer: Union[ReadableBuffer, Sequence[ReadableBuffer]],
 //|         tempo: int,
 //|         *,
 //|         sample_rate: int = 11025,
 //|         waveform: Optional[ReadableBuffer] = None,
 //|         envelope: Optional[Envelope] = None,
+//|         ticks_per_beat: int = 0,
 //|     ) -> None:
 //|         """Create a MidiTrack from the given stream of MIDI events. Only "Note On" and "Note Off" events
 //|         are supported; channel numbers and key velocities are ignored. Up to two notes may be on at the
 //|         same time.
 //|
-//|         :param ~circuitpython_typing.ReadableBuffer buffer: Stream of MIDI events, as stored in a MIDI file track chunk
+//|         The events are decoded when the MidiTrack is created, and notes start and stop on the exact
+//|         sample where their events are due, not just at the start of a buffer.
+//|
+//|         :param ~circuitpython_typing.ReadableBuffer buffer: Stream of MIDI events, as stored in a MIDI file track chunk,
+//|           or a sequence of them, which are merged and played together
 //|         :param int tempo: Tempo of the streamed events, in MIDI ticks per second
 //|         :param int sample_rate: The desired playback sample rate; higher sample rate requires more memory
 //|         :param ReadableBuffer waveform: A single-cycle waveform. Default is a 50% duty cycle square wave. If specified, must be a ReadableBuffer of type 'h' (signed 16 bit)
 //|         :param Envelope envelope: An object that defines the loudness of a note over time. The default envelope provides no ramping, voices turn instantly on and off.
+//|         :param int ticks_per_beat: The number of MIDI ticks in a quarter note, from the MIDI file header. When it is not 0, "Set Tempo" meta events in the tracks change the tempo.
 //|
 //|         Simple melody::
 //|
@@ -55,31 +61,51 @@
 //|         ...
 //|
 static mp_obj_t synthio_miditrack_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *all_args) {
-    enum { ARG_buffer, ARG_tempo, ARG_sample_rate, ARG_waveform, ARG_envelope };
+    enum { ARG_buffer, ARG_tempo, ARG_sample_rate, ARG_waveform, ARG_envelope, ARG_ticks_per_beat };
     static const mp_arg_t allowed_args[] = {
         { MP_QSTR_buffer, MP_ARG_OBJ | MP_ARG_REQUIRED, {} },
         { MP_QSTR_tempo, MP_ARG_INT | MP_ARG_REQUIRED, {} },
         { MP_QSTR_sample_rate, MP_ARG_INT | MP_ARG_KW_ONLY, {.u_int = 11025} },
         { MP_QSTR_waveform, MP_ARG_OBJ | MP_ARG_KW_ONLY, {.u_obj = mp_const_none } },
         { MP_QSTR_envelope, MP_ARG_OBJ | MP_ARG_KW_ONLY, {.u_obj = mp_const_none } },
+        { MP_QSTR_ticks_per_beat, MP_ARG_INT | MP_ARG_KW_ONLY, {.u_int = 0 } },
     };
     mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
     mp_arg_parse_all_kw_array(n_args, n_kw, all_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
 
-    mp_buffer_info_t bufinfo;
-    mp_get_buffer_raise(args[ARG_buffer].u_obj, &bufinfo, MP_BUFFER_READ);
+    mp_int_t tempo = mp_arg_validate_int_range(args[ARG_tempo].u_int, 1, 0xffffff, MP_QSTR_tempo);
+    mp_int_t ticks_per_beat = mp_arg_validate_int_range(args[ARG_ticks_per_beat].u_int, 0, 0x7fff, MP_QSTR_ticks_per_beat);
+
+    // a single track, or a sequence of tracks to merge
+    mp_buffer_info_t single_track;
+    mp_buffer_info_t *tracks = &single_track;
+    size_t n_tracks = 1;
+    if (!mp_get_buffer(args[ARG_buffer].u_obj, &single_track, MP_BUFFER_READ)) {
+        mp_obj_t *items;
+        mp_obj_get_array(args[ARG_buffer].u_obj, &n_tracks, &items);
+        mp_arg_validate_length_min(n_tracks, 1, MP_QSTR_buffer);
+        tracks = m_new(mp_buffer_info_t, n_tracks);
+        for (size_t i = 0; i < n_tracks; i++) {
+            mp_get_buffer_raise(items[i], &tracks[i], MP_BUFFER_READ);
+        }
+    }
 
     synthio_miditrack_obj_t *self = mp_obj_malloc(synthio_miditrack_obj_t, &synthio_miditrack_type);
 
     common_hal_synthio_miditrack_construct(self,
-        (uint8_t *)bufinfo.buf, bufinfo.len,
-        args[ARG_tempo].u_int,
+        tracks, n_tracks,
+        tempo,
+        ticks_per_beat,
         args[ARG_sample_rate].u_int,
         args[ARG_waveform].u_obj,
         mp_const_none,
         args[ARG_envelope].u_obj
         );
 
+    if (tracks != &single_track) {
+        m_del(mp_buffer_info_t, tracks, n_tracks);
+    }
+
     return MP_OBJ_FROM_PTR(self);
 }
 
@@ -116,8 +142,8 @@ static void check_for_deinit(synthio_miditrack_obj_t *self) {
 //|
 
 //|     error_location: Optional[int]
-//|     """Offset, in bytes within the midi data, of a decoding error"""
-//|
+//|     """Offset, in bytes within the midi data, of a decoding error. With several tracks, this is within
+//|     the first track that has an error. Playback stops at the error."""
 //|
 static mp_obj_t synthio_miditrack_obj_get_error_location(mp_obj_t self_in) {
     synthio_miditrack_obj_t *self = MP_OBJ_TO_PTR(self_in);
@@ -133,6 +159,31 @@ MP_DEFINE_CONST_FUN_OBJ_1(synthio_miditrack_get_error_location_obj, synthio_midi
 MP_PROPERTY_GETTER(synthio_miditrack_error_location_obj,
     (mp_obj_t)&synthio_miditrack_get_error_location_obj);
 
+//|     tempo: int
+//|     """Tempo of the events, in MIDI ticks per second. Changing it while the track plays takes effect
+//|     immediately, without changing the time that has already been played."""
+//|
+//|
+static mp_obj_t synthio_miditrack_obj_get_tempo(mp_obj_t self_in) {
+    synthio_miditrack_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    check_for_deinit(self);
+    return MP_OBJ_NEW_SMALL_INT(common_hal_synthio_miditrack_get_tempo(self));
+}
+MP_DEFINE_CONST_FUN_OBJ_1(synthio_miditrack_get_tempo_obj, synthio_miditrack_obj_get_tempo);
+
+static mp_obj_t synthio_miditrack_obj_set_tempo(mp_obj_t self_in, mp_obj_t arg) {
+    synthio_miditrack_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    check_for_deinit(self);
+    mp_int_t tempo = mp_arg_validate_int_range(mp_obj_get_int(arg), 1, 0xffffff, MP_QSTR_tempo);
+    common_hal_synthio_miditrack_set_tempo(self, tempo);
+    return mp_const_none;
+}
+MP_DEFINE_CONST_FUN_OBJ_2(synthio_miditrack_set_tempo_obj, synthio_miditrack_obj_set_tempo);
+
+MP_PROPERTY_GETSET(synthio_miditrack_tempo_obj,
+    (mp_obj_t)&synthio_miditrack_get_tempo_obj,
+    (mp_obj_t)&synthio_miditrack_set_tempo_obj);
+
 static const mp_rom_map_elem_t synthio_miditrack_locals_dict_table[] = {
     // Methods
     { MP_ROM_QSTR(MP_QSTR_deinit), MP_ROM_PTR(&synthio_miditrack_deinit_obj) },
@@ -141,6 +192,7 @@ static const mp_rom_map_elem_t synthio_miditrack_locals_dict_table[] = {
 
     // Properties
     { MP_ROM_QSTR(MP_QSTR_error_location), MP_ROM_PTR(&synthio_miditrack_error_location_obj) },
+    { MP_ROM_QSTR(MP_QSTR_tempo), MP_ROM_PTR(&synthio_miditrack_tempo_obj) },
     AUDIOSAMPLE_FIELDS,
 };
 static MP_DEFINE_CONST_DICT(synthio_miditrack_locals_dict, synthio_miditrack_locals_dict_table);
@@ -11,7 +11,9 @@
 
 extern const mp_obj_type_t synthio_miditrack_type;
 
-void common_hal_synthio_miditrack_construct(synthio_miditrack_obj_t *self, const uint8_t *buffer, uint32_t len, uint32_t tempo, uint32_t sample_rate, mp_obj_t waveform_obj, mp_obj_t filter_obj, mp_obj_t envelope_obj);
+void common_hal_synthio_miditrack_construct(synthio_miditrack_obj_t *self, const mp_buffer_info_t *tracks, size_t n_tracks, uint32_t tempo, uint16_t ticks_per_beat, uint32_t sample_rate, mp_obj_t waveform_obj, mp_obj_t filter_obj, mp_obj_t envelope_obj);
 
 void common_hal_synthio_miditrack_deinit(synthio_miditrack_obj_t *self);
 mp_int_t common_hal_synthio_miditrack_get_error_location(synthio_miditrack_obj_t *self);
+mp_int_t common_hal_synthio_miditrack_get_tempo(synthio_miditrack_obj_t *self);
+void common_hal_synthio_miditrack_set_tempo(synthio_miditrack_obj_t *self, mp_int_t tempo);
@@ -35,6 +35,7 @@
 //|         channel_count: int = 1,
 //|         waveform: Optional[ReadableBuffer] = None,
 //|         envelope: Optional[Envelope] = None,
+//|         ramp: bool = False,
 //|     ) -> None:
 //|         """Create a synthesizer object.
 //|
@@ -48,15 +49,17 @@
 //|         :param int channel_count: The number of output channels (1=mono, 2=stereo)
 //|         :param ReadableBuffer waveform: A single-cycle waveform. Default is a 50% duty cycle square wave. If specified, must be a ReadableBuffer of type 'h' (signed 16 bit)
 //|         :param Optional[Envelope] envelope: An object that defines the loudness of a note over time. The default envelope, `None` provides no ramping, voices turn instantly on and off.
+//|         :param bool ramp: Ramp changes in loudness and filter settings smoothly across each block of samples, see `ramp`.
 //|         """
 //|
 static mp_obj_t synthio_synthesizer_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *all_args) {
-    enum { ARG_sample_rate, ARG_channel_count, ARG_waveform, ARG_envelope };
+    enum { ARG_sample_rate, ARG_channel_count, ARG_waveform, ARG_envelope, ARG_ramp };
     static const mp_arg_t allowed_args[] = {
         { MP_QSTR_sample_rate, MP_ARG_INT | MP_ARG_KW_ONLY, {.u_int = 11025} },
         { MP_QSTR_channel_count, MP_ARG_INT | MP_ARG_KW_ONLY, {.u_int = 1} },
         { MP_QSTR_waveform, MP_ARG_OBJ | MP_ARG_KW_ONLY, {.u_obj = mp_const_none } },
         { MP_QSTR_envelope, MP_ARG_OBJ | MP_ARG_KW_ONLY, {.u_obj = mp_const_none } },
+        { MP_QSTR_ramp, MP_ARG_BOOL | MP_ARG_KW_ONLY, {.u_bool = false } },
     };
     mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
     mp_arg_parse_all_kw_array(n_args, n_kw, all_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
@@ -67,7 +70,8 @@ static mp_obj_t synthio_synthesizer_make_new(const mp_obj_type_t *type, size_t n
         args[ARG_sample_rate].u_int,
         args[ARG_channel_count].u_int,
         args[ARG_waveform].u_obj,
-        args[ARG_envelope].u_obj);
+        args[ARG_envelope].u_obj,
+        args[ARG_ramp].u_bool);
 
     return MP_OBJ_FROM_PTR(self);
 }
@@ -226,6 +230,33 @@ MP_PROPERTY_GETSET(synthio_synthesizer_envelope_obj,
     (mp_obj_t)&synthio_synthesizer_get_envelope_obj,
     (mp_obj_t)&synthio_synthesizer_set_envelope_obj);
 
+//|     ramp: bool
+//|     """When `True`, changes to each note's loudness (from its envelope, `Note.amplitude` and
+//|     `Note.panning`) and to its `Note.filter` coefficients are ramped linearly across each block
+//|     of 256 samples, instead of taking effect at the start of the block. This avoids the audible
+//|     steps ("zipper noise") of fast modulation by an `LFO` or `Math` block, at a small cost in
+//|     speed. Pitch changes are not ramped.
+//|
+//|     Because a note starts from silence, it also fades in over its first block."""
+static mp_obj_t synthio_synthesizer_obj_get_ramp(mp_obj_t self_in) {
+    synthio_synthesizer_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    check_for_deinit(self);
+    return mp_obj_new_bool(common_hal_synthio_synthesizer_get_ramp(self));
+}
+MP_DEFINE_CONST_FUN_OBJ_1(synthio_synthesizer_get_ramp_obj, synthio_synthesizer_obj_get_ramp);
+
+static mp_obj_t synthio_synthesizer_obj_set_ramp(mp_obj_t self_in, mp_obj_t ramp) {
+    synthio_synthesizer_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    check_for_deinit(self);
+    common_hal_synthio_synthesizer_set_ramp(self, mp_obj_is_true(ramp));
+    return mp_const_none;
+}
+MP_DEFINE_CONST_FUN_OBJ_2(synthio_synthesizer_set_ramp_obj, synthio_synthesizer_obj_set_ramp);
+
+MP_PROPERTY_GETSET(synthio_synthesizer_ramp_obj,
+    (mp_obj_t)&synthio_synthesizer_get_ramp_obj,
+    (mp_obj_t)&synthio_synthesizer_set_ramp_obj);
+
 //|     sample_rate: int
 //|     """32 bit value that tells how quickly samples are played in Hertz (cycles per second)."""
 
@@ -298,6 +329,7 @@ static const mp_rom_map_elem_t synthio_synthesizer_locals_dict_table[] = {
     { MP_ROM_QSTR(MP_QSTR_pressed), MP_ROM_PTR(&synthio_synthesizer_pressed_obj) },
     { MP_ROM_QSTR(MP_QSTR_note_info), MP_ROM_PTR(&synthio_synthesizer_note_info_obj) },
     { MP_ROM_QSTR(MP_QSTR_blocks), MP_ROM_PTR(&synthio_synthesizer_blocks_obj) },
+    { MP_ROM_QSTR(MP_QSTR_ramp), MP_ROM_PTR(&synthio_synthesizer_ramp_obj) },
     AUDIOSAMPLE_FIELDS,
 };
 static MP_DEFINE_CONST_DICT(synthio_synthesizer_locals_dict, synthio_synthesizer_locals_dict_table);
@@ -176,7 +176,8 @@ const mp_obj_namedtuple_type_t synthio_envelope_type_obj = {
 //|     envelope: Optional[Envelope] = None,
 //| ) -> MidiTrack:
 //|     """Create an AudioSample from an already opened MIDI file.
-//|     Currently, only single-track MIDI (type 0) is supported.
+//|     Single-track (type 0) and multi-track (type 1) MIDI files are supported. The tracks of a type 1 file
+//|     are merged and played together, and "Set Tempo" meta events change the tempo.
 //|
 //|     :param typing.BinaryIO file: Already opened MIDI file
 //|     :param int sample_rate: The desired playback sample rate; higher sample rate requires more memory
@@ -222,48 +223,57 @@ static mp_obj_t synthio_from_file(size_t n_args, const mp_obj_t *pos_args, mp_ma
     if (f_read(&file->fp, chunk_header, sizeof(chunk_header), &bytes_read) != FR_OK) {
         mp_raise_OSError(MP_EIO);
     }
+    // format 0 has one track, format 1 has tracks that play together
+    size_t n_tracks = (chunk_header[10] << 8) | chunk_header[11];
     if (bytes_read != sizeof(chunk_header) ||
-        memcmp(chunk_header, "MThd\0\0\0\6\0\0\0\1", 12)) {
+        memcmp(chunk_header, "MThd\0\0\0\6\0", 9) || chunk_header[9] > 1 ||
+        n_tracks == 0 || (chunk_header[9] == 0 && n_tracks != 1)) {
         mp_arg_error_invalid(MP_QSTR_file);
-        // TODO: for a multi-track MIDI (type 1), return an AudioMixer
     }
 
     uint16_t tempo;
+    uint16_t ticks_per_beat = 0;
     if (chunk_header[12] & 0x80) {
         tempo = -(int8_t)chunk_header[12] * chunk_header[13];
     } else {
-        tempo = 2 * ((chunk_header[12] << 8) | chunk_header[13]);
+        // 120 beats per minute until a "Set Tempo" event
+        ticks_per_beat = (chunk_header[12] << 8) | chunk_header[13];
+        tempo = 2 * ticks_per_beat;
     }
 
-    if (f_read(&file->fp, chunk_header, 8, &bytes_read) != FR_OK) {
-        mp_raise_OSError(MP_EIO);
-    }
-    if (bytes_read != 8 || memcmp(chunk_header, "MTrk", 4)) {
-        mp_arg_error_invalid(MP_QSTR_file);
-    }
-    uint32_t track_size = (chunk_header[4] << 24) |
-        (chunk_header[5] << 16) | (chunk_header[6] << 8) | chunk_header[7];
-    uint8_t *buffer = m_malloc(track_size);
-    if (f_read(&file->fp, buffer, track_size, &bytes_read) != FR_OK) {
-        mp_raise_OSError(MP_EIO);
-    }
-    if (bytes_read != track_size) {
-        mp_arg_error_invalid(MP_QSTR_file);
+    mp_buffer_info_t *tracks = m_new0(mp_buffer_info_t, n_tracks);
+    for (size_t i = 0; i < n_tracks; i++) {
+        if (f_read(&file->fp, chunk_header, 8, &bytes_read) != FR_OK) {
+            mp_raise_OSError(MP_EIO);
+        }
+        if (bytes_read != 8 || memcmp(chunk_header, "MTrk", 4)) {
+            mp_arg_error_invalid(MP_QSTR_file);
+        }
+        uint32_t track_size = (chunk_header[4] << 24) |
+            (chunk_header[5] << 16) | (chunk_header[6] << 8) | chunk_header[7];
+        tracks[i].buf = m_malloc(track_size);
+        tracks[i].len = track_size;
+        if (f_read(&file->fp, tracks[i].buf, track_size, &bytes_read) != FR_OK) {
+            mp_raise_OSError(MP_EIO);
+        }
+        if (bytes_read != track_size) {
+            mp_arg_error_invalid(MP_QSTR_file);
+        }
     }
 
     synthio_miditrack_obj_t *result = mp_obj_malloc(synthio_miditrack_obj_t, &synthio_miditrack_type);
 
-    common_hal_synthio_miditrack_construct(result, buffer, track_size,
-        tempo, args[ARG_sample_rate].u_int, args[ARG_waveform].u_obj,
+    // the tracks are decoded here, so their buffers are not needed afterwards
+    common_hal_synthio_miditrack_construct(result, tracks, n_tracks,
+        tempo, ticks_per_beat, args[ARG_sample_rate].u_int, args[ARG_waveform].u_obj,
         mp_const_none,
         args[ARG_envelope].u_obj
         );
 
-    #if MICROPY_MALLOC_USES_ALLOCATED_SIZE
-    m_free(buffer, track_size);
-    #else
-    m_free(buffer);
-    #endif
+    for (size_t i = 0; i < n_tracks; i++) {
+        m_del(uint8_t, tracks[i].buf, tracks[i].len);
+    }
+    m_del(mp_buffer_info_t, tracks, n_tracks);
 
     return MP_OBJ_FROM_PTR(result);
 }
@@ -299,13 +309,15 @@ MP_DEFINE_CONST_FUN_OBJ_1(synthio_voct_to_hz_obj, voct_to_hz);
 //|
 
 #if CIRCUITPY_AUDIOCORE_DEBUG
+static synthio_render_context_t lfo_tick_context;
+
 static mp_obj_t synthio_lfo_tick(size_t n, const mp_obj_t *args) {
-    shared_bindings_synthio_lfo_tick(48000, SYNTHIO_MAX_DUR);
+    synthio_render_context_tick(&lfo_tick_context, 48000, SYNTHIO_MAX_DUR);
     mp_obj_t result[n];
     for (size_t i = 0; i < n; i++) {
         synthio_block_slot_t slot;
         synthio_block_assign_slot(args[i], &slot, MP_QSTR_arg);
-        mp_float_t value = synthio_block_slot_get(&slot);
+        mp_float_t value = synthio_block_slot_get(&lfo_tick_context, &slot);
         result[i] = mp_obj_new_float(value);
     }
     return mp_obj_new_tuple(n, result);
@@ -24,6 +24,7 @@ extern const mp_obj_type_t synthio_note_state_type;
 extern const cp_enum_obj_t bend_mode_VIBRATO_obj;
 extern const mp_obj_type_t synthio_bend_mode_type;
 typedef struct synthio_synth synthio_synth_t;
+typedef struct synthio_render_context synthio_render_context_t;
 extern int16_t shared_bindings_synthio_square_wave[];
 extern const mp_obj_namedtuple_type_t synthio_envelope_type_obj;
 void synthio_synth_envelope_set(synthio_synth_t *synth, mp_obj_t envelope_obj);
@@ -16,21 +16,55 @@
 //|
 
 //| def info(object: object) -> int:
-//|     """Prints memory debugging info for the given object and returns the
-//|     estimated size."""
+//|     """Returns the number of heap bytes that can be reached from the given
+//|     object, including the object itself. Modules and their globals are not
+//|     followed, unless ``object`` is a module, in which case its globals are
+//|     included."""
 //|     ...
 //|
 //|
 static mp_obj_t uheap_info(mp_obj_t obj) {
-    uint32_t size = shared_module_uheap_info(obj);
+    size_t size = shared_module_uheap_info(obj);
 
-    return MP_OBJ_NEW_SMALL_INT(size);
+    return mp_obj_new_int_from_uint(size);
 }
 static MP_DEFINE_CONST_FUN_OBJ_1(uheap_info_obj, uheap_info);
 
+//| def snapshot(
+//|     file: Optional[circuitpython_typing.ByteStream] = None,
+//| ) -> Tuple[
+//|     List[Tuple[Optional[str], int, int]], List[Tuple[str, int, int]]
+//| ]:
+//|     """Takes a snapshot of what is using the heap.
+//|
+//|     Returns two lists, each sorted largest first. The first has a
+//|     ``(type_name, count, bytes)`` tuple for each type of object on the heap.
+//|     Blocks that are not recognised as objects, such as the buffers of
+//|     lists and strings, are counted under a ``type_name`` of ``None``.
+//|
+//|     The second has a ``(module_name, retained, reachable)`` tuple for each
+//|     loaded module. ``reachable`` is the number of bytes that can be found
+//|     from the module's globals, not counting other modules. ``retained`` is
+//|     the part of that which no other module can reach, so it is roughly
+//|     what would be freed if the module were unloaded.
+//|
+//|     The heap is walked without recursion, so deeply nested objects are
+//|     safe to measure.
+//|
+//|     :param file: if given, the snapshot is also written to it in a compact
+//|       binary form that ``tools/uheap_snapshot.py`` can read"""
+//|     ...
+//|
+//|
+static mp_obj_t uheap_snapshot(size_t n_args, const mp_obj_t *args) {
+    return shared_module_uheap_snapshot(n_args > 0 ? args[0] : mp_const_none);
+}
+static MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(uheap_snapshot_obj, 0, 1, uheap_snapshot);
+
 static const mp_rom_map_elem_t uheap_module_globals_table[] = {
     { MP_ROM_QSTR(MP_QSTR___name__), MP_ROM_QSTR(MP_QSTR_uheap) },
     { MP_ROM_QSTR(MP_QSTR_info), MP_ROM_PTR(&uheap_info_obj) },
+    { MP_ROM_QSTR(MP_QSTR_snapshot), MP_ROM_PTR(&uheap_snapshot_obj) },
 };
 
 static MP_DEFINE_CONST_DICT(uheap_module_globals, uheap_module_globals_table);
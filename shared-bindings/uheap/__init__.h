@@ -8,4 +8,5 @@
 
 #include "py/obj.h"
 
-extern uint32_t shared_module_uheap_info(mp_obj_t obj);
+extern size_t shared_module_uheap_info(mp_obj_t obj);
+extern mp_obj_t shared_module_uheap_snapshot(mp_obj_t file);
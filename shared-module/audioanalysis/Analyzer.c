@@ -0,0 +1,394 @@
+// This file is part of the CircuitPython project: https://circuitpython.org
+//
+// SPDX-FileCopyrightText: Copyright (c) 2025 Adafruit Industries LLC
+//
+// SPDX-License-Identifier: MIT
+
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "py/obj.h"
+#include "py/runtime.h"
+#include "shared-bindings/audioanalysis/Analyzer.h"
+#include "shared-module/audioanalysis/Analyzer.h"
+#include "shared-bindings/audiocore/__init__.h"
+
+#define MP_PI MICROPY_FLOAT_CONST(3.14159265358979323846)
+
+// Frames converted to signed 16 bit at a time, for samples in other formats
+#define ANALYZER_CHUNK (128)
+
+void common_hal_audioanalysis_analyzer_construct(audioanalysis_analyzer_obj_t *self,
+    uint32_t fft_size, mp_float_t attack, mp_float_t release,
+    uint32_t buffer_size, uint8_t bits_per_sample, bool samples_signed,
+    uint8_t channel_count, uint32_t sample_rate) {
+
+    self->base.bits_per_sample = bits_per_sample;
+    self->base.samples_signed = samples_signed;
+    self->base.channel_count = channel_count;
+    self->base.sample_rate = sample_rate;
+    self->base.single_buffer = false;
+    self->base.max_buffer_length = buffer_size;
+
+    // Buffers are passed through a whole number of frames at a time
+    uint32_t frame_bytes = audiosample_format_frame_bytes(audiosample_get_format(&self->base));
+    self->buffer_len = buffer_size / frame_bytes * frame_bytes;
+
+    self->silence = m_malloc(self->buffer_len);
+    audiosample_fill_silence(&self->base, self->silence, self->buffer_len);
+
+    self->sample = NULL;
+    self->sample_remaining_buffer = NULL;
+    self->sample_buffer_length = 0;
+    self->loop = false;
+    self->more_data = false;
+
+    self->rms = MICROPY_FLOAT_CONST(0.0);
+    self->peak = MICROPY_FLOAT_CONST(0.0);
+    self->envelope = MICROPY_FLOAT_CONST(0.0);
+    self->attack = attack;
+    self->release = release;
+
+    self->fft_size = fft_size;
+    self->history_pos = 0;
+    self->history_new = 0;
+    self->spectrum = mp_const_none;
+    if (fft_size == 0) {
+        return;
+    }
+
+    uint32_t half = fft_size / 2;
+    self->history = m_malloc(fft_size * sizeof(int16_t));
+    memset(self->history, 0, fft_size * sizeof(int16_t));
+    self->window = m_malloc(fft_size * sizeof(int16_t));
+    self->twiddle = m_malloc(fft_size * sizeof(int16_t));
+    self->work = m_malloc(fft_size * sizeof(int32_t));
+    self->spectrum_data = m_malloc(half * sizeof(uint16_t));
+    memset(self->spectrum_data, 0, half * sizeof(uint16_t));
+
+    for (uint32_t i = 0; i < fft_size; i++) {
+        mp_float_t w = MICROPY_FLOAT_CONST(0.5) - MICROPY_FLOAT_CONST(0.5) * MICROPY_FLOAT_C_FUN(cos)(2 * MP_PI * i / fft_size);
+        self->window[i] = (int16_t)MICROPY_FLOAT_C_FUN(round)(w * 32767);
+    }
+    for (uint32_t k = 0; k < half; k++) {
+        mp_float_t theta = 2 * MP_PI * k / fft_size;
+        self->twiddle[k] = (int16_t)MICROPY_FLOAT_C_FUN(round)(MICROPY_FLOAT_C_FUN(cos)(theta) * 32767);
+        self->twiddle[half + k] = (int16_t)MICROPY_FLOAT_C_FUN(round)(MICROPY_FLOAT_C_FUN(sin)(theta) * 32767);
+    }
+
+    self->spectrum = mp_obj_new_memoryview('H', half, self->spectrum_data);
+}
+
+void common_hal_audioanalysis_analyzer_deinit(audioanalysis_analyzer_obj_t *self) {
+    audiosample_mark_deinit(&self->base);
+    self->silence = NULL;
+    self->history = NULL;
+    self->window = NULL;
+    self->twiddle = NULL;
+    self->work = NULL;
+    self->converter.scratch = NULL;
+    // The memoryview may still be held by Python code, so its data is left alone
+}
+
+mp_float_t common_hal_audioanalysis_analyzer_get_rms(audioanalysis_analyzer_obj_t *self) {
+    return self->rms;
+}
+
+mp_float_t common_hal_audioanalysis_analyzer_get_peak(audioanalysis_analyzer_obj_t *self) {
+    return self->peak;
+}
+
+mp_float_t common_hal_audioanalysis_analyzer_get_envelope(audioanalysis_analyzer_obj_t *self) {
+    return self->envelope;
+}
+
+mp_float_t common_hal_audioanalysis_analyzer_get_attack(audioanalysis_analyzer_obj_t *self) {
+    return self->attack;
+}
+
+void common_hal_audioanalysis_analyzer_set_attack(audioanalysis_analyzer_obj_t *self, mp_float_t attack) {
+    self->attack = attack;
+}
+
+mp_float_t common_hal_audioanalysis_analyzer_get_release(audioanalysis_analyzer_obj_t *self) {
+    return self->release;
+}
+
+void common_hal_audioanalysis_analyzer_set_release(audioanalysis_analyzer_obj_t *self, mp_float_t release) {
+    self->release = release;
+}
+
+uint32_t common_hal_audioanalysis_analyzer_get_fft_size(audioanalysis_analyzer_obj_t *self) {
+    return self->fft_size;
+}
+
+mp_obj_t common_hal_audioanalysis_analyzer_get_spectrum(audioanalysis_analyzer_obj_t *self) {
+    return self->spectrum;
+}
+
+void audioanalysis_analyzer_reset_buffer(audioanalysis_analyzer_obj_t *self,
+    bool single_channel_output,
+    uint8_t channel) {
+
+    self->rms = MICROPY_FLOAT_CONST(0.0);
+    self->peak = MICROPY_FLOAT_CONST(0.0);
+    self->envelope = MICROPY_FLOAT_CONST(0.0);
+    if (self->fft_size != 0) {
+        memset(self->history, 0, self->fft_size * sizeof(int16_t));
+        memset(self->spectrum_data, 0, self->fft_size / 2 * sizeof(uint16_t));
+        self->history_new = 0;
+    }
+}
+
+bool common_hal_audioanalysis_analyzer_get_playing(audioanalysis_analyzer_obj_t *self) {
+    return self->sample != NULL;
+}
+
+void common_hal_audioanalysis_analyzer_play(audioanalysis_analyzer_obj_t *self, mp_obj_t sample, bool loop) {
+    audiosample_converter_play(&self->converter, &self->base, sample, self->buffer_len);
+
+    self->sample = sample;
+    self->loop = loop;
+
+    audiosample_reset_buffer(self->sample, false, 0);
+    audioio_get_buffer_result_t result = audiosample_converter_get_buffer(&self->converter, self->sample, &self->sample_remaining_buffer, &self->sample_buffer_length);
+    self->more_data = result == GET_BUFFER_MORE_DATA;
+}
+
+void common_hal_audioanalysis_analyzer_stop(audioanalysis_analyzer_obj_t *self) {
+    self->sample = NULL;
+}
+
+// Load the next buffer from the sample once the current one is used up. When
+// the sample has ended and isn't looping, it is cleared.
+static void analyzer_load_sample_buffer(audioanalysis_analyzer_obj_t *self) {
+    if (self->sample_buffer_length != 0) {
+        return;
+    }
+    if (!self->more_data) {
+        if (self->loop && self->sample) {
+            audiosample_reset_buffer(self->sample, false, 0);
+        } else {
+            self->sample = NULL;
+        }
+    }
+    if (self->sample) {
+        audioio_get_buffer_result_t result = audiosample_converter_get_buffer(&self->converter, self->sample, &self->sample_remaining_buffer, &self->sample_buffer_length);
+        self->more_data = result == GET_BUFFER_MORE_DATA;
+    }
+}
+
+// Add n frames of signed 16 bit audio to the spectrum history, mixed down to mono
+static void analyzer_add_history(audioanalysis_analyzer_obj_t *self, const int16_t *src, uint32_t n) {
+    uint32_t mask = self->fft_size - 1;
+    uint32_t pos = self->history_pos;
+    int16_t *history = self->history;
+    if (self->base.channel_count == 1) {
+        for (uint32_t i = 0; i < n; i++) {
+            history[pos] = src[i];
+            pos = (pos + 1) & mask;
+        }
+    } else {
+        for (uint32_t i = 0; i < n; i++) {
+            history[pos] = (src[2 * i] + src[2 * i + 1]) >> 1;
+            pos = (pos + 1) & mask;
+        }
+    }
+    self->history_pos = pos;
+    self->history_new = MIN(self->history_new + n, self->fft_size);
+}
+
+static void analyzer_add_silent_history(audioanalysis_analyzer_obj_t *self, uint32_t n) {
+    uint32_t mask = self->fft_size - 1;
+    if (n >= self->fft_size) {
+        memset(self->history, 0, self->fft_size * sizeof(int16_t));
+    } else {
+        for (uint32_t i = 0; i < n; i++) {
+            self->history[(self->history_pos + i) & mask] = 0;
+        }
+    }
+    self->history_pos = (self->history_pos + n) & mask;
+    self->history_new = MIN(self->history_new + n, self->fft_size);
+}
+
+// In place complex FFT of the fft_size / 2 points in re and im, in fixed
+// point. Each stage halves its results so that they can't overflow, which
+// scales the result by 2 / fft_size.
+static void analyzer_fft(audioanalysis_analyzer_obj_t *self, int32_t *restrict re, int32_t *restrict im) {
+    uint32_t n = self->fft_size / 2;
+    const int16_t *cos_table = self->twiddle;
+    const int16_t *sin_table = self->twiddle + n;
+
+    for (uint32_t i = 1, j = 0; i < n; i++) {
+        uint32_t bit = n >> 1;
+        for (; j & bit; bit >>= 1) {
+            j ^= bit;
+        }
+        j ^= bit;
+        if (i < j) {
+            int32_t t = re[i];
+            re[i] = re[j];
+            re[j] = t;
+            t = im[i];
+            im[i] = im[j];
+            im[j] = t;
+        }
+    }
+
+    for (uint32_t size = 2; size <= n; size <<= 1) {
+        uint32_t half = size / 2;
+        // The twiddle table is for fft_size points, twice as many as n
+        uint32_t step = 2 * n / size;
+        for (uint32_t start = 0; start < n; start += size) {
+            for (uint32_t j = 0; j < half; j++) {
+                uint32_t a = start + j;
+                uint32_t b = a + half;
+                int32_t wr = cos_table[j * step];
+                int32_t wi = sin_table[j * step];
+                // (re + i im) * (wr - i wi)
+                int32_t tr = (re[b] * wr + im[b] * wi) >> 15;
+                int32_t ti = (im[b] * wr - re[b] * wi) >> 15;
+                re[b] = (re[a] - tr) >> 1;
+                im[b] = (im[a] - ti) >> 1;
+                re[a] = (re[a] + tr) >> 1;
+                im[a] = (im[a] + ti) >> 1;
+            }
+        }
+    }
+}
+
+static uint32_t analyzer_sqrt(uint32_t x) {
+    uint32_t root = 0;
+    for (uint32_t bit = 1u << 30; bit != 0; bit >>= 2) {
+        if (x >= root + bit) {
+            x -= root + bit;
+            root = (root >> 1) + bit;
+        } else {
+            root >>= 1;
+        }
+    }
+    return root;
+}
+
+// Transform the last fft_size frames into spectrum_data. The windowed real
+// frames are packed in pairs as complex points, so that a transform of half
+// the size does the work, and the two halves are then separated.
+static void analyzer_update_spectrum(audioanalysis_analyzer_obj_t *self) {
+    uint32_t n = self->fft_size / 2;
+    uint32_t mask = self->fft_size - 1;
+    int32_t *re = self->work;
+    int32_t *im = self->work + n;
+    const int16_t *cos_table = self->twiddle;
+    const int16_t *sin_table = self->twiddle + n;
+
+    for (uint32_t m = 0; m < n; m++) {
+        uint32_t pos = (self->history_pos + 2 * m) & mask;
+        re[m] = (self->history[pos] * self->window[2 * m]) >> 15;
+        im[m] = (self->history[(pos + 1) & mask] * self->window[2 * m + 1]) >> 15;
+    }
+
+    analyzer_fft(self, re, im);
+
+    for (uint32_t k = 0; k < n; k++) {
+        uint32_t k2 = (n - k) & (n - 1);
+        // The even frames' transform is (Z[k] + conj(Z[n-k])) / 2 and the
+        // odd frames' is -i (Z[k] - conj(Z[n-k])) / 2
+        int32_t even_re = (re[k] + re[k2]) >> 1;
+        int32_t even_im = (im[k] - im[k2]) >> 1;
+        int32_t odd_re = (im[k] + im[k2]) >> 1;
+        int32_t odd_im = (re[k2] - re[k]) >> 1;
+        int32_t wr = cos_table[k];
+        int32_t wi = sin_table[k];
+        int32_t x_re = even_re + ((odd_re * wr + odd_im * wi) >> 15);
+        int32_t x_im = even_im + ((odd_im * wr - odd_re * wi) >> 15);
+        // A full scale sine wave through the window comes out at 16384, and
+        // nothing can come out above 32768, so the squares fit
+        self->spectrum_data[k] = MIN(analyzer_sqrt((uint32_t)(x_re * x_re) + (uint32_t)(x_im * x_im)), 0xffff);
+    }
+    self->history_new = 0;
+}
+
+// Measure n bytes of buffer, which is in our format
+static void analyzer_measure(audioanalysis_analyzer_obj_t *self, const uint8_t *buffer, uint32_t n, bool silent) {
+    audiosample_format_t format = audiosample_get_format(&self->base);
+    uint32_t frame_bytes = audiosample_format_frame_bytes(format);
+    uint32_t channel_count = self->base.channel_count;
+    uint32_t frames = n / frame_bytes;
+    if (frames == 0) {
+        return;
+    }
+
+    int32_t peak = 0;
+    if (silent) {
+        self->rms = MICROPY_FLOAT_CONST(0.0);
+        if (self->fft_size != 0) {
+            analyzer_add_silent_history(self, frames);
+        }
+    } else {
+        audiosample_format_t s16_format = AUDIOSAMPLE_FORMAT(2, true, channel_count);
+        int16_t chunk[ANALYZER_CHUNK * 2];
+        uint64_t sum_squares = 0;
+        for (uint32_t done = 0; done < frames;) {
+            uint32_t count = frames - done;
+            const int16_t *src;
+            if (format == s16_format) {
+                src = (const int16_t *)(buffer + done * frame_bytes);
+            } else {
+                count = MIN(count, ANALYZER_CHUNK);
+                audiosample_convert(chunk, s16_format, buffer + done * frame_bytes, format, count);
+                src = chunk;
+            }
+            for (uint32_t i = 0; i < count * channel_count; i++) {
+                int32_t v = src[i];
+                sum_squares += (uint32_t)(v * v);
+                peak = MAX(peak, v < 0 ? -v : v);
+            }
+            if (self->fft_size != 0) {
+                analyzer_add_history(self, src, count);
+            }
+            done += count;
+        }
+        self->rms = MICROPY_FLOAT_C_FUN(sqrt)((mp_float_t)sum_squares / (frames * channel_count)) / 32768;
+    }
+    self->peak = (mp_float_t)peak / 32768;
+
+    // The envelope moves towards the peak level, a little more than half way
+    // in each time constant
+    mp_float_t time_constant = self->peak > self->envelope ? self->attack : self->release;
+    if (time_constant <= MICROPY_FLOAT_CONST(0.0)) {
+        self->envelope = self->peak;
+    } else {
+        mp_float_t duration = (mp_float_t)frames / self->base.sample_rate;
+        self->envelope += (self->peak - self->envelope) * (1 - MICROPY_FLOAT_C_FUN(exp)(-duration / time_constant));
+    }
+
+    if (self->fft_size != 0 && self->history_new >= self->fft_size / 2) {
+        analyzer_update_spectrum(self);
+    }
+}
+
+audioio_get_buffer_result_t audioanalysis_analyzer_get_buffer(audioanalysis_analyzer_obj_t *self, bool single_channel_output, uint8_t channel,
+    uint8_t **buffer, uint32_t *buffer_length) {
+
+    analyzer_load_sample_buffer(self);
+    if (self->sample == NULL) {
+        *buffer = self->silence;
+        *buffer_length = self->buffer_len;
+        self->base.silent = true;
+    } else {
+        // Hand out the rest of the current sample buffer, up to our buffer
+        // length, without copying it.
+        uint32_t n = MIN(self->sample_buffer_length, self->buffer_len);
+        *buffer = self->sample_remaining_buffer;
+        *buffer_length = n;
+        self->sample_remaining_buffer += n;
+        self->sample_buffer_length -= n;
+        self->base.silent = audiosample_get_silent(self->sample);
+    }
+
+    analyzer_measure(self, *buffer, *buffer_length, self->base.silent);
+
+    // The analyzer always returns more data, like the effects
+    return GET_BUFFER_MORE_DATA;
+}
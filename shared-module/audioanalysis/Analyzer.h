@@ -0,0 +1,55 @@
+// This file is part of the CircuitPython project: https://circuitpython.org
+//
+// SPDX-FileCopyrightText: Copyright (c) 2025 Adafruit Industries LLC
+//
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include "py/obj.h"
+
+#include "shared-module/audiocore/__init__.h"
+
+extern const mp_obj_type_t audioanalysis_analyzer_type;
+
+typedef struct {
+    audiosample_base_t base;
+
+    uint8_t *silence; // buffer_len bytes, handed out when there is nothing to play
+    uint32_t buffer_len; // max buffer in bytes, a whole number of frames
+
+    uint8_t *sample_remaining_buffer;
+    uint32_t sample_buffer_length; // in bytes
+
+    bool loop;
+    bool more_data;
+
+    mp_obj_t sample;
+    audiosample_converter_t converter; // to our format
+
+    // Levels as fractions of full scale
+    mp_float_t rms;
+    mp_float_t peak;
+    mp_float_t envelope;
+    mp_float_t attack; // seconds
+    mp_float_t release; // seconds
+
+    // Spectrum, all NULL when fft_size is 0. The transform is a complex FFT
+    // of fft_size / 2 points over pairs of real frames.
+    uint32_t fft_size;
+    uint32_t history_pos; // oldest frame in history
+    uint32_t history_new; // frames added since the last transform
+    int16_t *history; // the last fft_size frames, mixed down to mono
+    int16_t *window; // Hann window, 15 fractional bits
+    int16_t *twiddle; // cos then sin of 2 pi k / fft_size for k < fft_size / 2, 15 fractional bits
+    int32_t *work; // real then imaginary parts of the transform
+    uint16_t *spectrum_data;
+    mp_obj_t spectrum; // memoryview of spectrum_data, or None
+} audioanalysis_analyzer_obj_t;
+
+void audioanalysis_analyzer_reset_buffer(audioanalysis_analyzer_obj_t *self,
+    bool single_channel_output,
+    uint8_t channel);
+
+audioio_get_buffer_result_t audioanalysis_analyzer_get_buffer(audioanalysis_analyzer_obj_t *self,
+    bool single_channel_output, uint8_t channel,
+    uint8_t **buffer, uint32_t *buffer_length);
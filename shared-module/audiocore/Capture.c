@@ -0,0 +1,116 @@
+// This file is part of the CircuitPython project: https://circuitpython.org
+//
+// SPDX-FileCopyrightText: Copyright (c) 2025 Adafruit Industries LLC
+//
+// SPDX-License-Identifier: MIT
+
+#include "shared-bindings/audiocore/Capture.h"
+#include "shared-bindings/audiocore/__init__.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#include "py/runtime.h"
+
+#if CIRCUITPY_AUDIOCORE_CAPTURE
+
+void common_hal_audiocore_capture_construct(audiocore_capture_obj_t *self,
+    mp_obj_t source, uint32_t block_size, uint32_t block_count) {
+
+    self->source_proto = mp_proto_get_or_throw(MP_QSTR_protocol_audiocapture, source);
+    self->source = source;
+    self->source_proto->get_format(source, &self->base);
+    self->base.single_buffer = false;
+
+    // Blocks are a whole number of frames
+    uint32_t frame_bytes = audiosample_format_frame_bytes(audiosample_get_format(&self->base));
+    block_size = MAX(block_size / frame_bytes, 1) * frame_bytes;
+    self->base.max_buffer_length = block_size;
+
+    audiocore_capture_ring_t *ring = &self->ring;
+    ring->buffer = m_malloc(block_size * block_count);
+    audiosample_fill_silence(&self->base, ring->buffer, block_size * block_count);
+    ring->block_length = block_size;
+    ring->block_count = block_count;
+    ring->write_count = 0;
+    ring->read_count = 0;
+    ring->overruns = 0;
+    ring->underruns = 0;
+    ring->started = false;
+
+    self->silence = m_malloc(block_size);
+    audiosample_fill_silence(&self->base, self->silence, block_size);
+
+    self->source_proto->start(source, ring);
+}
+
+void common_hal_audiocore_capture_deinit(audiocore_capture_obj_t *self) {
+    if (audiosample_deinited(&self->base)) {
+        return;
+    }
+    // Stop the source before the ring it writes to can be freed
+    self->source_proto->stop(self->source);
+    audiosample_mark_deinit(&self->base);
+    self->source = mp_const_none;
+    self->ring.buffer = NULL;
+    self->silence = NULL;
+}
+
+uint32_t common_hal_audiocore_capture_get_overruns(audiocore_capture_obj_t *self) {
+    return self->ring.overruns;
+}
+
+uint32_t common_hal_audiocore_capture_get_underruns(audiocore_capture_obj_t *self) {
+    return self->ring.underruns;
+}
+
+void audiocore_capture_reset_buffer(audiocore_capture_obj_t *self,
+    bool single_channel_output,
+    uint8_t channel) {
+    // Start from what is captured next, rather than from whatever was
+    // captured before playback started
+    self->ring.read_count = self->ring.write_count;
+    self->ring.started = false;
+}
+
+audioio_get_buffer_result_t audiocore_capture_get_buffer(audiocore_capture_obj_t *self,
+    bool single_channel_output,
+    uint8_t channel,
+    uint8_t **buffer,
+    uint32_t *buffer_length) {
+
+    audiocore_capture_ring_t *ring = &self->ring;
+    uint32_t write_count = ring->write_count;
+    uint32_t waiting = write_count - ring->read_count;
+    // The producer may write to the two blocks after write_count, and the
+    // consumer of the block we handed out last time may still be using it. So
+    // once it is close to being written over, skip to the newest block.
+    if (waiting >= ring->block_count - 2) {
+        ring->overruns += waiting - 1;
+        ring->read_count = write_count - 1;
+        waiting = 1;
+    }
+
+    *buffer_length = ring->block_length;
+    if (waiting == 0) {
+        // Before the first block there is nothing to miss
+        if (ring->started) {
+            ring->underruns++;
+        }
+        *buffer = self->silence;
+        self->base.silent = true;
+    } else {
+        uint8_t *block = audiocore_capture_ring_block(ring, ring->read_count);
+        ring->read_count++;
+        ring->started = true;
+        if (self->source_proto->finish_block) {
+            self->source_proto->finish_block(self->source, block, ring->block_length);
+        }
+        *buffer = block;
+        self->base.silent = false;
+    }
+    // Live input never runs out
+    return GET_BUFFER_MORE_DATA;
+}
+
+#endif
@@ -0,0 +1,46 @@
+// This file is part of the CircuitPython project: https://circuitpython.org
+//
+// SPDX-FileCopyrightText: Copyright (c) 2025 Adafruit Industries LLC
+//
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include "py/obj.h"
+#include "py/proto.h"
+
+#include "shared-module/audiocore/__init__.h"
+#include "shared-module/audiocore/capture_ring.h"
+
+// Implemented by objects that can capture audio continuously into a ring, such
+// as an ADC or microphone driven by DMA.
+typedef struct _audiocore_capture_source_p_t {
+    MP_PROTOCOL_HEAD // MP_QSTR_protocol_audiocapture
+    // Set the sample_rate, channel_count, bits_per_sample and samples_signed
+    // of format to those of the captured samples
+    void (*get_format)(mp_obj_t source, audiosample_base_t *format);
+    // Start capturing into ring, committing each block as it is filled. Raise
+    // if the source can't start, for example because it is busy.
+    void (*start)(mp_obj_t source, audiocore_capture_ring_t *ring);
+    void (*stop)(mp_obj_t source);
+    // Optional. Turn a captured block into samples of the format, in place,
+    // just before it is handed out.
+    void (*finish_block)(mp_obj_t source, uint8_t *block, uint32_t length);
+} audiocore_capture_source_p_t;
+
+typedef struct {
+    audiosample_base_t base;
+    mp_obj_t source;
+    const audiocore_capture_source_p_t *source_proto;
+    audiocore_capture_ring_t ring;
+    uint8_t *silence; // one block, handed out on an underrun
+} audiocore_capture_obj_t;
+
+void audiocore_capture_reset_buffer(audiocore_capture_obj_t *self,
+    bool single_channel_output,
+    uint8_t channel);
+audioio_get_buffer_result_t audiocore_capture_get_buffer(audiocore_capture_obj_t *self,
+    bool single_channel_output,
+    uint8_t channel,
+    uint8_t **buffer,
+    uint32_t *buffer_length);
@@ -14,6 +14,18 @@
 
 #include "shared-module/audiocore/WaveFile.h"
 #include "shared-bindings/audiocore/__init__.h"
+#include "supervisor/background_callback.h"
+#include "supervisor/port_heap.h"
+
+#if defined(MICROPY_UNIX_COVERAGE)
+#define background_callback_add(buf, fn, arg) ((fn)((arg)))
+#endif
+
+#if defined(UNIX)
+#include <stdlib.h>
+#define port_free free
+#define port_malloc(sz, hint) (malloc(sz))
+#endif
 
 struct wave_format_chunk {
     uint16_t audio_format;
@@ -29,37 +41,107 @@ struct wave_format_chunk {
     uint8_t extended_guid[14];
 };
 
-void common_hal_audioio_wavefile_construct(audioio_wavefile_obj_t *self,
-    pyb_file_obj_t *file,
-    uint8_t *buffer,
-    size_t buffer_size) {
-    // Load the wave
-    self->file = file;
-    uint8_t chunk_header[16];
-    f_rewind(&self->file->fp);
+// Allocate memory for the read-ahead ring or preloaded data, either on the VM
+// heap or, when requested, from the port heap (PSRAM on boards that have it)
+static uint8_t *wavefile_allocate(audioio_wavefile_obj_t *self, size_t size) {
+    uint8_t *ptr = self->outside_heap ? port_malloc(size, false) : m_malloc_maybe(size);
+    if (ptr == NULL) {
+        common_hal_audioio_wavefile_deinit(self);
+        m_malloc_fail(size);
+    }
+    return ptr;
+}
+
+static void wavefile_free(audioio_wavefile_obj_t *self, uint8_t *ptr) {
+    if (ptr != NULL && self->outside_heap) {
+        port_free(ptr);
+    }
+}
+
+#define RING_SLOT(self, n) ((self)->ring + ((n) % (self)->ring_count) * (self)->len)
+
+// Slots that were handed out by the two most recent loads may still be in use
+// by the consumer, so only ring_count - 2 slots can be read ahead.
+#define RING_READ_AHEAD(self) ((self)->ring_count - 2)
+
+// Read the next len bytes (or less, at the end of the data) into the ring
+static bool wavefile_ring_fill_one(audioio_wavefile_obj_t *self) {
+    uint32_t num_bytes_to_load = MIN(self->len, self->ring_file_remaining);
+    UINT length_read;
+    if (f_read(&self->file->fp, RING_SLOT(self, self->ring_write), num_bytes_to_load, &length_read) != FR_OK || length_read != num_bytes_to_load) {
+        return false;
+    }
+    self->ring_file_remaining -= length_read;
+    self->ring_write += 1;
+    return true;
+}
+
+static void wavefile_ring_fill_cb(void *self_in) {
+    audioio_wavefile_obj_t *self = self_in;
+    if (audiosample_deinited(&self->base) || self->ring == NULL) {
+        return;
+    }
+    while (self->ring_file_remaining > 0 && self->ring_write - self->ring_read < RING_READ_AHEAD(self)) {
+        if (!wavefile_ring_fill_one(self)) {
+            return;
+        }
+        self->readahead_refills += 1;
+    }
+}
+
+static uint8_t *wavefile_ring_pop(audioio_wavefile_obj_t *self) {
+    if (self->ring_write == self->ring_read) {
+        // The background fill didn't keep up, so read synchronously
+        self->readahead_stalls += 1;
+        if (!wavefile_ring_fill_one(self)) {
+            return NULL;
+        }
+    }
+    uint8_t *slot = RING_SLOT(self, self->ring_read);
+    self->ring_read += 1;
+    background_callback_add(&self->ring_fill_cb, wavefile_ring_fill_cb, self);
+    return slot;
+}
+
+// Read up to len bytes of the header from the file or the source buffer
+static uint32_t wavefile_read(audioio_wavefile_obj_t *self, void *dest, uint32_t len) {
+    if (self->file == NULL) {
+        len = MIN(len, self->source_length - self->source_pos);
+        memcpy(dest, self->source + self->source_pos, len);
+        self->source_pos += len;
+        return len;
+    }
     UINT bytes_read;
-    if (f_read(&self->file->fp, chunk_header, 16, &bytes_read) != FR_OK) {
+    if (f_read(&self->file->fp, dest, len, &bytes_read) != FR_OK) {
         mp_raise_OSError(MP_EIO);
     }
-    if (bytes_read != 16 ||
+    return bytes_read;
+}
+
+static void wavefile_skip(audioio_wavefile_obj_t *self, uint32_t len) {
+    if (self->file == NULL) {
+        self->source_pos += MIN(len, self->source_length - self->source_pos);
+    } else if (f_lseek(&self->file->fp, f_tell(&self->file->fp) + len) != FR_OK) {
+        mp_raise_OSError(MP_EIO);
+    }
+}
+
+// Check the format and find the data chunk. The data starts at data_start and
+// is file_length bytes long.
+static void wavefile_read_header(audioio_wavefile_obj_t *self) {
+    uint8_t chunk_header[16];
+    if (wavefile_read(self, chunk_header, 16) != 16 ||
         memcmp(chunk_header, "RIFF", 4) != 0 ||
         memcmp(chunk_header + 8, "WAVEfmt ", 8) != 0) {
         mp_arg_error_invalid(MP_QSTR_file);
     }
     uint32_t format_size;
-    if (f_read(&self->file->fp, &format_size, 4, &bytes_read) != FR_OK) {
-        mp_raise_OSError(MP_EIO);
-    }
-    if (bytes_read != 4 ||
+    if (wavefile_read(self, &format_size, 4) != 4 ||
         format_size > sizeof(struct wave_format_chunk)) {
         mp_raise_ValueError(MP_ERROR_TEXT("Invalid format chunk size"));
     }
     struct wave_format_chunk format;
-    if (f_read(&self->file->fp, &format, format_size, &bytes_read) != FR_OK) {
-        mp_raise_OSError(MP_EIO);
-    }
-    if (bytes_read != format_size) {
-    }
+    wavefile_read(self, &format, format_size);
 
     if ((format_size != 40 && format.audio_format != 1) ||
         format.num_channels > 2 ||
@@ -84,36 +166,58 @@ void common_hal_audioio_wavefile_construct(audioio_wavefile_obj_t *self,
     bool found_data_chunk = false;
 
     while (!found_data_chunk) {
-        if (f_read(&self->file->fp, &chunk_tag, 4, &bytes_read) != FR_OK) {
-            mp_raise_OSError(MP_EIO);
-        }
-        if (bytes_read != 4) {
+        if (wavefile_read(self, &chunk_tag, 4) != 4) {
             mp_raise_OSError(MP_EIO);
         }
         if (memcmp((uint8_t *)chunk_tag, "data", 4) == 0) {
             found_data_chunk = true;
         }
 
-        if (f_read(&self->file->fp, &chunk_length, 4, &bytes_read) != FR_OK) {
-            mp_raise_OSError(MP_EIO);
-        }
-        if (bytes_read != 4) {
+        if (wavefile_read(self, &chunk_length, 4) != 4) {
             mp_raise_OSError(MP_EIO);
         }
 
         if (!found_data_chunk) {
-            if (f_lseek(&self->file->fp, f_tell(&self->file->fp) + chunk_length) != FR_OK) {
-                mp_raise_OSError(MP_EIO);
-            }
+            wavefile_skip(self, chunk_length);
         }
     }
 
     self->file_length = chunk_length;
-    self->data_start = self->file->fp.fptr;
+    self->data_start = self->file ? self->file->fp.fptr : self->source_pos;
+}
 
-    // Try to allocate two buffers, one will be loaded from file and the other
-    // DMAed to DAC.
-    if (buffer_size) {
+void common_hal_audioio_wavefile_construct(audioio_wavefile_obj_t *self,
+    pyb_file_obj_t *file,
+    uint8_t *buffer,
+    size_t buffer_size,
+    uint32_t readahead,
+    bool preload,
+    bool outside_heap) {
+    // Load the wave
+    self->file = file;
+    f_rewind(&self->file->fp);
+    wavefile_read_header(self);
+
+    self->outside_heap = outside_heap;
+    if (preload) {
+        // Preloaded data is played straight from memory, so no other buffers
+        // are needed.
+        self->len = 256;
+        // Extra room for padding the final buffer out to a whole word
+        self->preload = wavefile_allocate(self, self->file_length + sizeof(uint32_t));
+        UINT length_read;
+        if (f_read(&self->file->fp, self->preload, self->file_length, &length_read) != FR_OK || length_read != self->file_length) {
+            common_hal_audioio_wavefile_deinit(self);
+            mp_raise_OSError(MP_EIO);
+        }
+    } else if (readahead > 0) {
+        // The ring takes the place of the two buffers.
+        self->len = 256;
+        self->ring_count = 2 + (readahead + self->len - 1) / self->len;
+        self->ring = wavefile_allocate(self, self->ring_count * self->len + sizeof(uint32_t));
+    } else if (buffer_size) {
+        // Try to allocate two buffers, one will be loaded from file and the other
+        // DMAed to DAC.
         self->len = buffer_size / 2;
         self->buffer = buffer;
         self->second_buffer = buffer + self->len;
@@ -133,12 +237,57 @@ void common_hal_audioio_wavefile_construct(audioio_wavefile_obj_t *self,
     }
 }
 
+void common_hal_audioio_wavefile_construct_from_buffer(audioio_wavefile_obj_t *self,
+    mp_obj_t source) {
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(source, &bufinfo, MP_BUFFER_READ);
+    self->file = NULL;
+    self->outside_heap = false;
+    self->source_obj = source;
+    self->source = bufinfo.buf;
+    self->source_length = bufinfo.len;
+    self->source_pos = 0;
+    wavefile_read_header(self);
+
+    self->len = 256;
+    self->file_length = MIN(self->file_length, self->source_length - self->data_start);
+    const uint8_t *data = self->source + self->data_start;
+    if ((uintptr_t)data % sizeof(uint32_t) == 0) {
+        // Played in place. The data can't be padded out to a whole word at the
+        // end, so a partial word is left off instead.
+        self->file_length -= self->file_length % sizeof(uint32_t);
+        self->preload = (uint8_t *)data;
+    } else {
+        // Consumers read whole words, so unaligned data is copied
+        self->preload = wavefile_allocate(self, self->file_length + sizeof(uint32_t));
+        memcpy(self->preload, data, self->file_length);
+        self->source_obj = MP_OBJ_NULL;
+        self->source = NULL;
+    }
+}
+
 void common_hal_audioio_wavefile_deinit(audioio_wavefile_obj_t *self) {
     self->buffer = NULL;
     self->second_buffer = NULL;
+    if (self->source == NULL) {
+        wavefile_free(self, self->preload);
+    }
+    self->preload = NULL;
+    self->source_obj = MP_OBJ_NULL;
+    self->source = NULL;
+    wavefile_free(self, self->ring);
+    self->ring = NULL;
     audiosample_mark_deinit(&self->base);
 }
 
+uint32_t common_hal_audioio_wavefile_get_readahead_stalls(audioio_wavefile_obj_t *self) {
+    return self->readahead_stalls;
+}
+
+uint32_t common_hal_audioio_wavefile_get_readahead_refills(audioio_wavefile_obj_t *self) {
+    return self->readahead_refills;
+}
+
 void audioio_wavefile_reset_buffer(audioio_wavefile_obj_t *self,
     bool single_channel_output,
     uint8_t channel) {
@@ -148,10 +297,19 @@ void audioio_wavefile_reset_buffer(audioio_wavefile_obj_t *self,
     // We don't reset the buffer index in case we're looping and we have an odd number of buffer
     // loads
     self->bytes_remaining = self->file_length;
-    f_lseek(&self->file->fp, self->data_start);
     self->read_count = 0;
     self->left_read_count = 0;
     self->right_read_count = 0;
+    if (self->preload) {
+        return;
+    }
+    f_lseek(&self->file->fp, self->data_start);
+    if (self->ring) {
+        // Discard anything read ahead, but leave the slots in use alone
+        self->ring_write = self->ring_read;
+        self->ring_file_remaining = self->file_length;
+        background_callback_add(&self->ring_fill_cb, wavefile_ring_fill_cb, self);
+    }
 }
 
 audioio_get_buffer_result_t audioio_wavefile_get_buffer(audioio_wavefile_obj_t *self,
@@ -181,14 +339,23 @@ audioio_get_buffer_result_t audioio_wavefile_get_buffer(audioio_wavefile_obj_t *
         if (num_bytes_to_load > self->bytes_remaining) {
             num_bytes_to_load = self->bytes_remaining;
         }
-        UINT length_read;
-        if (self->buffer_index % 2 == 1) {
-            *buffer = self->second_buffer;
+        UINT length_read = num_bytes_to_load;
+        if (self->preload) {
+            *buffer = self->preload + (self->file_length - self->bytes_remaining);
+        } else if (self->ring) {
+            *buffer = wavefile_ring_pop(self);
+            if (*buffer == NULL) {
+                return GET_BUFFER_ERROR;
+            }
         } else {
-            *buffer = self->buffer;
-        }
-        if (f_read(&self->file->fp, *buffer, num_bytes_to_load, &length_read) != FR_OK || length_read != num_bytes_to_load) {
-            return GET_BUFFER_ERROR;
+            if (self->buffer_index % 2 == 1) {
+                *buffer = self->second_buffer;
+            } else {
+                *buffer = self->buffer;
+            }
+            if (f_read(&self->file->fp, *buffer, num_bytes_to_load, &length_read) != FR_OK || length_read != num_bytes_to_load) {
+                return GET_BUFFER_ERROR;
+            }
         }
         self->bytes_remaining -= length_read;
         // Pad the last buffer to word align it.
@@ -208,6 +375,7 @@ audioio_get_buffer_result_t audioio_wavefile_get_buffer(audioio_wavefile_obj_t *
             }
         }
         *buffer_length = length_read;
+        self->chunk[self->buffer_index % 2] = *buffer;
         if (self->buffer_index % 2 == 1) {
             self->second_buffer_length = length_read;
         } else {
@@ -219,10 +387,10 @@ audioio_get_buffer_result_t audioio_wavefile_get_buffer(audioio_wavefile_obj_t *
 
     uint32_t buffers_back = self->read_count - 1 - channel_read_count;
     if ((self->buffer_index - buffers_back) % 2 == 0) {
-        *buffer = self->second_buffer;
+        *buffer = self->chunk[1];
         *buffer_length = self->second_buffer_length;
     } else {
-        *buffer = self->buffer;
+        *buffer = self->chunk[0];
         *buffer_length = self->buffer_length;
     }
 
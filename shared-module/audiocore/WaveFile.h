@@ -8,6 +8,7 @@
 
 #include "extmod/vfs_fat.h"
 #include "py/obj.h"
+#include "supervisor/background_callback.h"
 
 #include "shared-module/audiocore/__init__.h"
 
@@ -28,6 +29,31 @@ typedef struct {
     uint32_t read_count;
     uint32_t left_read_count;
     uint32_t right_read_count;
+
+    // The data returned by the two most recent loads
+    uint8_t *chunk[2];
+
+    // The whole data chunk, when preloaded or played in place
+    uint8_t *preload;
+
+    // The buffer that the wave is played from in place, instead of a file
+    mp_obj_t source_obj;
+    const uint8_t *source;
+    uint32_t source_length;
+    uint32_t source_pos; // where the header is read from next
+
+    // Read-ahead ring of ring_count slots of len bytes each, refilled in the
+    // background. ring_read and ring_write are free-running slot counters.
+    uint8_t *ring;
+    uint32_t ring_count;
+    uint32_t ring_read;
+    uint32_t ring_write;
+    uint32_t ring_file_remaining; // bytes not yet read from the file into the ring
+    background_callback_t ring_fill_cb;
+    bool outside_heap; // ring or preload was allocated with port_malloc
+
+    uint32_t readahead_stalls;
+    uint32_t readahead_refills;
 } audioio_wavefile_obj_t;
 
 // These are not available from Python because it may be called in an interrupt.
@@ -6,6 +6,8 @@
 
 #include "shared-module/audioio/__init__.h"
 
+#include <string.h>
+
 #include "py/obj.h"
 #include "py/runtime.h"
 #include "shared-bindings/audiocore/RawSample.h"
@@ -29,185 +31,250 @@ audioio_get_buffer_result_t audiosample_get_buffer(mp_obj_t sample_obj,
     return proto->get_buffer(MP_OBJ_TO_PTR(sample_obj), single_channel_output, channel, buffer, buffer_length);
 }
 
-void audiosample_convert_u8m_s16s(int16_t *buffer_out, const uint8_t *buffer_in, size_t nframes) {
-    for (; nframes--;) {
-        int16_t sample = (*buffer_in++ - 0x80) << 8;
-        *buffer_out++ = sample;
-        *buffer_out++ = sample;
-    }
-}
+// Sample format conversion. Conversions to signed 16 bit, for I2S and mixing,
+// and to unsigned 8 bit, for DACs, are done in one pass, by a kernel for each
+// pair of formats. Any other goes through signed 16 bit: a decode kernel turns
+// frames of any format into signed 16 bit with the output channel count, and
+// an encode kernel then turns those samples into the output format. The
+// kernels are plain loops over restrict-qualified arrays with the formats
+// fixed at compile time, so that the compiler can vectorise them. A stereo
+// sample converted to mono keeps the left channel.
 
-void audiosample_convert_u8s_s16s(int16_t *buffer_out, const uint8_t *buffer_in, size_t nframes) {
-    size_t nsamples = 2 * nframes;
-    for (; nsamples--;) {
-        int16_t sample = (*buffer_in++ - 0x80) << 8;
-        *buffer_out++ = sample;
-    }
-}
+#define DECODE_U8(x) ((int16_t)(((x) - 0x80) << 8))
+#define DECODE_S8(x) ((int16_t)((x) << 8))
+#define DECODE_U16(x) ((int16_t)((x) ^ 0x8000))
+#define DECODE_S16(x) ((int16_t)(x))
+#define ENCODE_S16(x) (x)
+#define ENCODE_U8(x) ((uint8_t)((uint16_t)(x) >> 8) ^ 0x80)
 
-void audiosample_convert_s8m_s16s(int16_t *buffer_out, const int8_t *buffer_in, size_t nframes) {
-    for (; nframes--;) {
-        int16_t sample = (*buffer_in++) << 8;
-        *buffer_out++ = sample;
-        *buffer_out++ = sample;
-    }
-}
+// Frames are converted in blocks of a fixed size, which the compiler turns
+// into vector operations where it can, followed by the frames left over.
+#define CONVERT_BLOCK (16)
 
-void audiosample_convert_s8s_s16s(int16_t *buffer_out, const int8_t *buffer_in, size_t nframes) {
-    size_t nsamples = 2 * nframes;
-    for (; nsamples--;) {
-        int16_t sample = (*buffer_in++) << 8;
-        *buffer_out++ = sample;
+#define CONVERT_FRAME(i, in_channels, out_channels, decode, encode) \
+    out[(i) * out_channels] = encode(decode(in[(i) * in_channels])); \
+    if (out_channels == 2) { \
+        out[(i) * 2 + 1] = encode(decode(in[(i) * in_channels + in_channels - 1])); \
     }
-}
 
-void audiosample_convert_u16m_s16s(int16_t *buffer_out, const uint16_t *buffer_in, size_t nframes) {
-    for (; nframes--;) {
-        int16_t sample = *buffer_in++ - 0x8000;
-        *buffer_out++ = sample;
-        *buffer_out++ = sample;
+#define CONVERT_KERNEL(name, in_t, out_t, in_channels, out_channels, decode, encode) \
+    static void name(void *restrict buffer_out, const void *restrict buffer_in, size_t nframes) { \
+        out_t *restrict out = buffer_out; \
+        const in_t *restrict in = buffer_in; \
+        size_t i = 0; \
+        for (; i + CONVERT_BLOCK <= nframes; i += CONVERT_BLOCK) { \
+            for (size_t j = i; j < i + CONVERT_BLOCK; j++) { \
+                CONVERT_FRAME(j, in_channels, out_channels, decode, encode) \
+            } \
+        } \
+        for (; i < nframes; i++) { \
+            CONVERT_FRAME(i, in_channels, out_channels, decode, encode) \
+        } \
     }
-}
 
-void audiosample_convert_u16s_s16s(int16_t *buffer_out, const uint16_t *buffer_in, size_t nframes) {
-    size_t nsamples = 2 * nframes;
-    for (; nsamples--;) {
-        int16_t sample = *buffer_in++ - 0x8000;
-        *buffer_out++ = sample;
-    }
-}
+#define DECODE_KERNEL(name, in_t, in_channels, out_channels, decode) \
+    CONVERT_KERNEL(name, in_t, int16_t, in_channels, out_channels, decode, ENCODE_S16)
 
-void audiosample_convert_s16m_s16s(int16_t *buffer_out, const int16_t *buffer_in, size_t nframes) {
-    for (; nframes--;) {
-        int16_t sample = *buffer_in++;
-        *buffer_out++ = sample;
-        *buffer_out++ = sample;
-    }
-}
+DECODE_KERNEL(decode_u8m_s16m, uint8_t, 1, 1, DECODE_U8)
+DECODE_KERNEL(decode_u8m_s16s, uint8_t, 1, 2, DECODE_U8)
+DECODE_KERNEL(decode_u8s_s16m, uint8_t, 2, 1, DECODE_U8)
+DECODE_KERNEL(decode_u8s_s16s, uint8_t, 2, 2, DECODE_U8)
+DECODE_KERNEL(decode_s8m_s16m, int8_t, 1, 1, DECODE_S8)
+DECODE_KERNEL(decode_s8m_s16s, int8_t, 1, 2, DECODE_S8)
+DECODE_KERNEL(decode_s8s_s16m, int8_t, 2, 1, DECODE_S8)
+DECODE_KERNEL(decode_s8s_s16s, int8_t, 2, 2, DECODE_S8)
+DECODE_KERNEL(decode_u16m_s16m, uint16_t, 1, 1, DECODE_U16)
+DECODE_KERNEL(decode_u16m_s16s, uint16_t, 1, 2, DECODE_U16)
+DECODE_KERNEL(decode_u16s_s16m, uint16_t, 2, 1, DECODE_U16)
+DECODE_KERNEL(decode_u16s_s16s, uint16_t, 2, 2, DECODE_U16)
+DECODE_KERNEL(decode_s16m_s16s, int16_t, 1, 2, DECODE_S16)
+DECODE_KERNEL(decode_s16s_s16m, int16_t, 2, 1, DECODE_S16)
 
-
-void audiosample_convert_u8s_u8m(uint8_t *buffer_out, const uint8_t *buffer_in, size_t nframes) {
-    for (; nframes--;) {
-        uint8_t sample = *buffer_in++ + 0x80;
-        *buffer_out++ = sample;
-        buffer_in++;
-    }
+static void decode_s16m_s16m(void *buffer_out, const void *buffer_in, size_t nframes) {
+    memcpy(buffer_out, buffer_in, nframes * sizeof(int16_t));
 }
 
-void audiosample_convert_s8m_u8m(uint8_t *buffer_out, const int8_t *buffer_in, size_t nframes) {
-    for (; nframes--;) {
-        uint8_t sample = *buffer_in++ + 0x80;
-        *buffer_out++ = sample;
-    }
+static void decode_s16s_s16s(void *buffer_out, const void *buffer_in, size_t nframes) {
+    memcpy(buffer_out, buffer_in, nframes * 2 * sizeof(int16_t));
 }
 
-void audiosample_convert_s8s_u8m(uint8_t *buffer_out, const int8_t *buffer_in, size_t nframes) {
-    for (; nframes--;) {
-        uint8_t sample = *buffer_in++ + 0x80;
-        *buffer_out++ = sample;
-        buffer_in++;
-    }
-}
+// Indexed by input format, then by output channel count - 1
+static const audiosample_convert_fun decode_kernels[8][2] = {
+    [AUDIOSAMPLE_U8M] = { decode_u8m_s16m, decode_u8m_s16s },
+    [AUDIOSAMPLE_U16M] = { decode_u16m_s16m, decode_u16m_s16s },
+    [AUDIOSAMPLE_S8M] = { decode_s8m_s16m, decode_s8m_s16s },
+    [AUDIOSAMPLE_S16M] = { decode_s16m_s16m, decode_s16m_s16s },
+    [AUDIOSAMPLE_U8S] = { decode_u8s_s16m, decode_u8s_s16s },
+    [AUDIOSAMPLE_U16S] = { decode_u16s_s16m, decode_u16s_s16s },
+    [AUDIOSAMPLE_S8S] = { decode_s8s_s16m, decode_s8s_s16s },
+    [AUDIOSAMPLE_S16S] = { decode_s16s_s16m, decode_s16s_s16s },
+};
 
-void audiosample_convert_u16m_u8m(uint8_t *buffer_out, const uint16_t *buffer_in, size_t nframes) {
-    for (; nframes--;) {
-        uint8_t sample = (*buffer_in++) >> 8;
-        *buffer_out++ = sample;
-    }
-}
+#define TO_U8_KERNEL(name, in_t, in_channels, out_channels, decode) \
+    CONVERT_KERNEL(name, in_t, uint8_t, in_channels, out_channels, decode, ENCODE_U8)
 
-void audiosample_convert_u16s_u8m(uint8_t *buffer_out, const uint16_t *buffer_in, size_t nframes) {
-    for (; nframes--;) {
-        uint8_t sample = (*buffer_in++) >> 8;
-        *buffer_out++ = sample;
-        buffer_in++;
-    }
-}
+TO_U8_KERNEL(convert_u8m_u8s, uint8_t, 1, 2, DECODE_U8)
+TO_U8_KERNEL(convert_u8s_u8m, uint8_t, 2, 1, DECODE_U8)
+TO_U8_KERNEL(convert_s8m_u8m, int8_t, 1, 1, DECODE_S8)
+TO_U8_KERNEL(convert_s8m_u8s, int8_t, 1, 2, DECODE_S8)
+TO_U8_KERNEL(convert_s8s_u8m, int8_t, 2, 1, DECODE_S8)
+TO_U8_KERNEL(convert_s8s_u8s, int8_t, 2, 2, DECODE_S8)
+TO_U8_KERNEL(convert_u16m_u8m, uint16_t, 1, 1, DECODE_U16)
+TO_U8_KERNEL(convert_u16m_u8s, uint16_t, 1, 2, DECODE_U16)
+TO_U8_KERNEL(convert_u16s_u8m, uint16_t, 2, 1, DECODE_U16)
+TO_U8_KERNEL(convert_u16s_u8s, uint16_t, 2, 2, DECODE_U16)
+TO_U8_KERNEL(convert_s16m_u8m, int16_t, 1, 1, DECODE_S16)
+TO_U8_KERNEL(convert_s16m_u8s, int16_t, 1, 2, DECODE_S16)
+TO_U8_KERNEL(convert_s16s_u8m, int16_t, 2, 1, DECODE_S16)
+TO_U8_KERNEL(convert_s16s_u8s, int16_t, 2, 2, DECODE_S16)
 
-void audiosample_convert_s16m_u8m(uint8_t *buffer_out, const int16_t *buffer_in, size_t nframes) {
-    for (; nframes--;) {
-        uint8_t sample = (*buffer_in++ + 0x8000) >> 8;
-        *buffer_out++ = sample;
-    }
+static void convert_u8m_u8m(void *buffer_out, const void *buffer_in, size_t nframes) {
+    memcpy(buffer_out, buffer_in, nframes);
 }
 
-void audiosample_convert_s16s_u8m(uint8_t *buffer_out, const int16_t *buffer_in, size_t nframes) {
-    for (; nframes--;) {
-        uint8_t sample = (*buffer_in++ + 0x8000) >> 8;
-        *buffer_out++ = sample;
-        buffer_in++;
-    }
+static void convert_u8s_u8s(void *buffer_out, const void *buffer_in, size_t nframes) {
+    memcpy(buffer_out, buffer_in, nframes * 2);
 }
 
+// Indexed by input format, then by output channel count - 1
+static const audiosample_convert_fun to_u8_kernels[8][2] = {
+    [AUDIOSAMPLE_U8M] = { convert_u8m_u8m, convert_u8m_u8s },
+    [AUDIOSAMPLE_U16M] = { convert_u16m_u8m, convert_u16m_u8s },
+    [AUDIOSAMPLE_S8M] = { convert_s8m_u8m, convert_s8m_u8s },
+    [AUDIOSAMPLE_S16M] = { convert_s16m_u8m, convert_s16m_u8s },
+    [AUDIOSAMPLE_U8S] = { convert_u8s_u8m, convert_u8s_u8s },
+    [AUDIOSAMPLE_U16S] = { convert_u16s_u8m, convert_u16s_u8s },
+    [AUDIOSAMPLE_S8S] = { convert_s8s_u8m, convert_s8s_u8s },
+    [AUDIOSAMPLE_S16S] = { convert_s16s_u8m, convert_s16s_u8s },
+};
 
-void audiosample_convert_u8m_u8s(uint8_t *buffer_out, const uint8_t *buffer_in, size_t nframes) {
-    for (; nframes--;) {
-        uint8_t sample = *buffer_in++;
-        *buffer_out++ = sample;
-        *buffer_out++ = sample;
+// The encode kernels take a number of samples rather than frames
+static void encode_s16_s8(void *restrict buffer_out, const void *restrict buffer_in, size_t nsamples) {
+    int8_t *restrict out = buffer_out;
+    const int16_t *restrict in = buffer_in;
+    size_t i = 0;
+    for (; i + CONVERT_BLOCK <= nsamples; i += CONVERT_BLOCK) {
+        for (size_t j = i; j < i + CONVERT_BLOCK; j++) {
+            out[j] = (int8_t)(in[j] >> 8);
+        }
     }
-}
-
-void audiosample_convert_s8m_u8s(uint8_t *buffer_out, const int8_t *buffer_in, size_t nframes) {
-    for (; nframes--;) {
-        uint8_t sample = *buffer_in++ + 0x80;
-        *buffer_out++ = sample;
-        *buffer_out++ = sample;
+    for (; i < nsamples; i++) {
+        out[i] = (int8_t)(in[i] >> 8);
     }
 }
 
-void audiosample_convert_s8s_u8s(uint8_t *buffer_out, const int8_t *buffer_in, size_t nframes) {
-    size_t nsamples = 2 * nframes;
-    for (; nsamples--;) {
-        uint8_t sample = *buffer_in++ + 0x80;
-        *buffer_out++ = sample;
+static void encode_s16_u16(void *restrict buffer_out, const void *restrict buffer_in, size_t nsamples) {
+    uint16_t *restrict out = buffer_out;
+    const uint16_t *restrict in = buffer_in;
+    size_t i = 0;
+    for (; i + CONVERT_BLOCK <= nsamples; i += CONVERT_BLOCK) {
+        for (size_t j = i; j < i + CONVERT_BLOCK; j++) {
+            out[j] = in[j] ^ 0x8000;
+        }
     }
-}
-
-void audiosample_convert_u16m_u8s(uint8_t *buffer_out, const uint16_t *buffer_in, size_t nframes) {
-    for (; nframes--;) {
-        uint8_t sample = (*buffer_in++) >> 8;
-        *buffer_out++ = sample;
-        *buffer_out++ = sample;
+    for (; i < nsamples; i++) {
+        out[i] = in[i] ^ 0x8000;
     }
 }
 
-void audiosample_convert_u16s_u8s(uint8_t *buffer_out, const uint16_t *buffer_in, size_t nframes) {
-    size_t nsamples = 2 * nframes;
-    for (; nsamples--;) {
-        uint8_t sample = (*buffer_in++) >> 8;
-        *buffer_out++ = sample;
-    }
-}
+// Indexed by the mono equivalent of the output format, for the formats that
+// don't have kernels of their own
+static const audiosample_convert_fun encode_kernels[4] = {
+    [AUDIOSAMPLE_U16M] = encode_s16_u16,
+    [AUDIOSAMPLE_S8M] = encode_s16_s8,
+};
+
+// Samples decoded at a time when the output isn't signed 16 bit
+#define CONVERT_CHUNK_SAMPLES (128)
 
-void audiosample_convert_s16m_u8s(uint8_t *buffer_out, const int16_t *buffer_in, size_t nframes) {
-    for (; nframes--;) {
-        uint8_t sample = (*buffer_in++ + 0x8000) >> 8;
-        *buffer_out++ = sample;
-        *buffer_out++ = sample;
+void audiosample_convert(void *buffer_out, audiosample_format_t out_format,
+    const void *buffer_in, audiosample_format_t in_format, size_t nframes) {
+    size_t out_channels = audiosample_format_channel_count(out_format);
+    audiosample_convert_fun decode = decode_kernels[in_format][out_channels - 1];
+    switch (out_format & ~AUDIOSAMPLE_STEREO) {
+        case AUDIOSAMPLE_S16M:
+            decode(buffer_out, buffer_in, nframes);
+            return;
+        case AUDIOSAMPLE_U8M:
+            to_u8_kernels[in_format][out_channels - 1](buffer_out, buffer_in, nframes);
+            return;
+    }
+    audiosample_convert_fun encode = encode_kernels[out_format & ~AUDIOSAMPLE_STEREO];
+    if (in_format == (out_format | AUDIOSAMPLE_S16M)) {
+        // Already signed 16 bit with the right channel count
+        encode(buffer_out, buffer_in, nframes * out_channels);
+        return;
+    }
+    int16_t chunk[CONVERT_CHUNK_SAMPLES];
+    size_t chunk_frames = CONVERT_CHUNK_SAMPLES / out_channels;
+    const uint8_t *in = buffer_in;
+    uint8_t *out = buffer_out;
+    while (nframes > 0) {
+        size_t n = MIN(nframes, chunk_frames);
+        decode(chunk, in, n);
+        encode(out, chunk, n * out_channels);
+        in += n * audiosample_format_frame_bytes(in_format);
+        out += n * audiosample_format_frame_bytes(out_format);
+        nframes -= n;
     }
 }
 
-void audiosample_convert_s16s_u8s(uint8_t *buffer_out, const int16_t *buffer_in, size_t nframes) {
-    size_t nsamples = 2 * nframes;
-    for (; nsamples--;) {
-        uint8_t sample = (*buffer_in++ + 0x8000) >> 8;
-        *buffer_out++ = sample;
+void audiosample_converter_play(audiosample_converter_t *self, const audiosample_base_t *format,
+    mp_obj_t sample_in, uint32_t scratch_length) {
+    const audiosample_base_t *sample = audiosample_check(sample_in);
+    if (sample->sample_rate != format->sample_rate) {
+        mp_raise_ValueError_varg(MP_ERROR_TEXT("The sample's %q does not match"), MP_QSTR_sample_rate);
+    }
+    self->in_format = audiosample_get_format(sample);
+    self->out_format = audiosample_get_format(format);
+    self->remaining_length = 0;
+    if (self->in_format != self->out_format && self->scratch == NULL) {
+        self->scratch_length = scratch_length;
+        self->scratch = m_malloc(2 * scratch_length);
     }
 }
 
-void audiosample_must_match(audiosample_base_t *self, mp_obj_t other_in) {
-    const audiosample_base_t *other = audiosample_check(other_in);
-    if (other->sample_rate != self->sample_rate) {
-        mp_raise_ValueError_varg(MP_ERROR_TEXT("The sample's %q does not match"), MP_QSTR_sample_rate);
+audioio_get_buffer_result_t audiosample_converter_get_buffer(audiosample_converter_t *self,
+    mp_obj_t sample, uint8_t **buffer, uint32_t *buffer_length) {
+    if (self->in_format == self->out_format) {
+        return audiosample_get_buffer(sample, false, 0, buffer, buffer_length);
     }
-    if (other->channel_count != self->channel_count) {
-        mp_raise_ValueError_varg(MP_ERROR_TEXT("The sample's %q does not match"), MP_QSTR_channel_count);
+    if (self->remaining_length == 0) {
+        self->result = audiosample_get_buffer(sample, false, 0, (uint8_t **)&self->remaining, &self->remaining_length);
+        if (self->result == GET_BUFFER_ERROR) {
+            self->remaining_length = 0;
+            *buffer = NULL;
+            *buffer_length = 0;
+            return GET_BUFFER_ERROR;
+        }
     }
-    if (other->bits_per_sample != self->bits_per_sample) {
-        mp_raise_ValueError_varg(MP_ERROR_TEXT("The sample's %q does not match"), MP_QSTR_bits_per_sample);
+    uint32_t in_frame_bytes = audiosample_format_frame_bytes(self->in_format);
+    uint32_t out_frame_bytes = audiosample_format_frame_bytes(self->out_format);
+    uint32_t nframes = MIN(self->remaining_length / in_frame_bytes, self->scratch_length / out_frame_bytes);
+    // Alternate halves, so the last buffer handed out stays valid
+    self->second_half = !self->second_half;
+    *buffer = self->scratch + (self->second_half ? self->scratch_length : 0);
+    *buffer_length = nframes * out_frame_bytes;
+    audiosample_convert(*buffer, self->out_format, self->remaining, self->in_format, nframes);
+    self->remaining += nframes * in_frame_bytes;
+    self->remaining_length -= nframes * in_frame_bytes;
+    if (self->remaining_length < in_frame_bytes) {
+        self->remaining_length = 0;
+        return self->result;
     }
-    if (other->samples_signed != self->samples_signed) {
-        mp_raise_ValueError_varg(MP_ERROR_TEXT("The sample's %q does not match"), MP_QSTR_signedness);
+    return GET_BUFFER_MORE_DATA;
+}
+
+void audiosample_fill_silence(const audiosample_base_t *self, void *buffer, uint32_t length) {
+    if (self->samples_signed) {
+        memset(buffer, 0, length);
+    } else if (self->bits_per_sample == 16) {
+        // For unsigned samples the middle is "quiet"
+        uint16_t *uword_buffer = buffer;
+        for (uint32_t i = 0; i < length / sizeof(uint16_t); i++) {
+            uword_buffer[i] = 0x8000;
+        }
+    } else {
+        memset(buffer, 0x80, length);
     }
 }
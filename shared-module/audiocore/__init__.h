@@ -26,6 +26,10 @@ typedef struct audiosample_base {
     uint8_t channel_count;
     uint8_t samples_signed;
     bool single_buffer;
+    // Set by get_buffer when the buffer it returned is all silence, so that
+    // the consumer can skip mixing or converting it. Samples that can't tell
+    // cheaply leave it false.
+    bool silent;
 } audiosample_base_t;
 
 typedef void (*audiosample_reset_buffer_fun)(mp_obj_t,
@@ -56,6 +60,11 @@ static inline uint8_t audiosample_get_channel_count(audiosample_base_t *self) {
     return self->channel_count;
 }
 
+// Whether the buffer from the last call to get_buffer on sample_obj was silence
+static inline bool audiosample_get_silent(mp_obj_t sample_obj) {
+    return ((audiosample_base_t *)MP_OBJ_TO_PTR(sample_obj))->silent;
+}
+
 void audiosample_reset_buffer(mp_obj_t sample_obj, bool single_channel_output, uint8_t audio_channel);
 audioio_get_buffer_result_t audiosample_get_buffer(mp_obj_t sample_obj,
     bool single_channel_output,
@@ -89,28 +98,69 @@ static inline void audiosample_get_buffer_structure_checked(mp_obj_t self_in, bo
     audiosample_get_buffer_structure(audiosample_check(self_in), single_channel_output, single_buffer, samples_signed, max_buffer_length, spacing);
 }
 
-void audiosample_must_match(audiosample_base_t *self, mp_obj_t other);
-
-void audiosample_convert_u8m_s16s(int16_t *buffer_out, const uint8_t *buffer_in, size_t nframes);
-void audiosample_convert_u8s_s16s(int16_t *buffer_out, const uint8_t *buffer_in, size_t nframes);
-void audiosample_convert_s8m_s16s(int16_t *buffer_out, const int8_t *buffer_in, size_t nframes);
-void audiosample_convert_s8s_s16s(int16_t *buffer_out, const int8_t *buffer_in, size_t nframes);
-void audiosample_convert_u16m_s16s(int16_t *buffer_out, const uint16_t *buffer_in, size_t nframes);
-void audiosample_convert_u16s_s16s(int16_t *buffer_out, const uint16_t *buffer_in, size_t nframes);
-void audiosample_convert_s16m_s16s(int16_t *buffer_out, const int16_t *buffer_in, size_t nframes);
-
-void audiosample_convert_u8s_u8m(uint8_t *buffer_out, const uint8_t *buffer_in, size_t nframes);
-void audiosample_convert_s8m_u8m(uint8_t *buffer_out, const int8_t *buffer_in, size_t nframes);
-void audiosample_convert_s8s_u8m(uint8_t *buffer_out, const int8_t *buffer_in, size_t nframes);
-void audiosample_convert_u16m_u8m(uint8_t *buffer_out, const uint16_t *buffer_in, size_t nframes);
-void audiosample_convert_u16s_u8m(uint8_t *buffer_out, const uint16_t *buffer_in, size_t nframes);
-void audiosample_convert_s16m_u8m(uint8_t *buffer_out, const int16_t *buffer_in, size_t nframes);
-void audiosample_convert_s16s_u8m(uint8_t *buffer_out, const int16_t *buffer_in, size_t nframes);
-
-void audiosample_convert_u8m_u8s(uint8_t *buffer_out, const uint8_t *buffer_in, size_t nframes);
-void audiosample_convert_s8m_u8s(uint8_t *buffer_out, const int8_t *buffer_in, size_t nframes);
-void audiosample_convert_s8s_u8s(uint8_t *buffer_out, const int8_t *buffer_in, size_t nframes);
-void audiosample_convert_u16m_u8s(uint8_t *buffer_out, const uint16_t *buffer_in, size_t nframes);
-void audiosample_convert_u16s_u8s(uint8_t *buffer_out, const uint16_t *buffer_in, size_t nframes);
-void audiosample_convert_s16m_u8s(uint8_t *buffer_out, const int16_t *buffer_in, size_t nframes);
-void audiosample_convert_s16s_u8s(uint8_t *buffer_out, const int16_t *buffer_in, size_t nframes);
+// Fill length bytes of buffer with silence in the sample format of self
+void audiosample_fill_silence(const audiosample_base_t *self, void *buffer, uint32_t length);
+
+// A sample format: the sample size, signedness and channel count, one bit each
+typedef uint8_t audiosample_format_t;
+
+#define AUDIOSAMPLE_FORMAT(bytes_per_sample, is_signed, channel_count) \
+    ((audiosample_format_t)(((bytes_per_sample) == 2) | ((is_signed) ? 2 : 0) | ((channel_count) == 2 ? 4 : 0)))
+
+enum {
+    AUDIOSAMPLE_U8M = AUDIOSAMPLE_FORMAT(1, false, 1),
+    AUDIOSAMPLE_U16M = AUDIOSAMPLE_FORMAT(2, false, 1),
+    AUDIOSAMPLE_S8M = AUDIOSAMPLE_FORMAT(1, true, 1),
+    AUDIOSAMPLE_S16M = AUDIOSAMPLE_FORMAT(2, true, 1),
+    AUDIOSAMPLE_U8S = AUDIOSAMPLE_FORMAT(1, false, 2),
+    AUDIOSAMPLE_U16S = AUDIOSAMPLE_FORMAT(2, false, 2),
+    AUDIOSAMPLE_S8S = AUDIOSAMPLE_FORMAT(1, true, 2),
+    AUDIOSAMPLE_S16S = AUDIOSAMPLE_FORMAT(2, true, 2),
+    AUDIOSAMPLE_STEREO = 4, // the channel count bit
+};
+
+static inline audiosample_format_t audiosample_get_format(const audiosample_base_t *self) {
+    return AUDIOSAMPLE_FORMAT(self->bits_per_sample / 8, self->samples_signed, self->channel_count);
+}
+
+static inline uint32_t audiosample_format_channel_count(audiosample_format_t format) {
+    return format & AUDIOSAMPLE_STEREO ? 2 : 1;
+}
+
+static inline uint32_t audiosample_format_frame_bytes(audiosample_format_t format) {
+    return ((format & 1) + 1) * audiosample_format_channel_count(format);
+}
+
+typedef void (*audiosample_convert_fun)(void *buffer_out, const void *buffer_in, size_t nframes);
+
+// Convert nframes frames from in_format to out_format. A stereo input converted
+// to mono keeps the left channel; a mono input converted to stereo is copied to
+// both channels. The buffers must not overlap.
+void audiosample_convert(void *buffer_out, audiosample_format_t out_format,
+    const void *buffer_in, audiosample_format_t in_format, size_t nframes);
+
+// Hands out the buffers of a sample converted to the format of the object
+// playing it. Buffers in the same format are handed out as they are. Others
+// are converted a piece at a time into one half of a scratch buffer, switching
+// halves each time so that, as with a double buffered sample, the previous
+// buffer stays valid while the next one is converted.
+typedef struct {
+    const uint8_t *remaining; // the part of the sample's buffer not yet converted
+    uint32_t remaining_length;
+    uint8_t *scratch; // two halves of scratch_length bytes
+    uint32_t scratch_length;
+    audioio_get_buffer_result_t result; // what the sample returned for remaining
+    audiosample_format_t in_format;
+    audiosample_format_t out_format;
+    bool second_half;
+} audiosample_converter_t;
+
+// Start converting sample to the format of format, which is the object playing
+// it. Only the sample rates need to match. The scratch buffer is allocated the
+// first time a sample needs converting, with halves of scratch_length bytes.
+void audiosample_converter_play(audiosample_converter_t *self, const audiosample_base_t *format,
+    mp_obj_t sample, uint32_t scratch_length);
+
+// Use in place of audiosample_get_buffer(sample, false, 0, ...)
+audioio_get_buffer_result_t audiosample_converter_get_buffer(audiosample_converter_t *self,
+    mp_obj_t sample, uint8_t **buffer, uint32_t *buffer_length);
@@ -0,0 +1,42 @@
+// This file is part of the CircuitPython project: https://circuitpython.org
+//
+// SPDX-FileCopyrightText: Copyright (c) 2025 Adafruit Industries LLC
+//
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// A ring of equally sized blocks that a capture source fills, usually by DMA
+// from an interrupt, and that audiocore.Capture hands out to the audio graph
+// without copying. There is one producer and one consumer, and neither ever
+// waits for the other: when the consumer falls behind, the oldest blocks are
+// skipped (an overrun), and when it gets ahead, it is given silence (an
+// underrun). So the delay from input to output never grows beyond the ring.
+//
+// The producer owns write_count and the consumer owns the rest, so no locks
+// are needed. While the consumer has not fallen behind, the producer is free to
+// write to blocks write_count and write_count + 1, which allows for DMA that
+// chains from one block to the next.
+typedef struct {
+    uint8_t *buffer; // block_count blocks of block_length bytes
+    uint32_t block_length;
+    uint32_t block_count;
+    volatile uint32_t write_count; // blocks completed by the producer
+    uint32_t read_count; // blocks taken by the consumer, including skipped ones
+    uint32_t overruns; // blocks skipped because the consumer fell behind
+    uint32_t underruns; // silent buffers given out because nothing had been captured
+    bool started; // whether a block has been read since the last reset
+} audiocore_capture_ring_t;
+
+// Producer: the block with the given count, which is usually write_count or write_count + 1
+static inline uint8_t *audiocore_capture_ring_block(audiocore_capture_ring_t *ring, uint32_t count) {
+    return ring->buffer + (count % ring->block_count) * ring->block_length;
+}
+
+// Producer: block write_count is complete. Safe to call from an interrupt.
+static inline void audiocore_capture_ring_commit(audiocore_capture_ring_t *ring) {
+    ring->write_count = ring->write_count + 1;
+}
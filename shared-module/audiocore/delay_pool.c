@@ -0,0 +1,110 @@
+// This file is part of the CircuitPython project: https://circuitpython.org
+//
+// SPDX-FileCopyrightText: Copyright (c) 2025 Adafruit Industries LLC
+//
+// SPDX-License-Identifier: MIT
+
+#include <string.h>
+
+#include "py/gc.h"
+#include "py/runtime.h"
+#include "shared-module/audiocore/delay_pool.h"
+#include "supervisor/port_heap.h"
+
+#if defined(UNIX)
+#include <stdlib.h>
+#define port_free free
+#define port_malloc(sz, hint) (malloc(sz))
+#endif
+
+// Number of released blocks kept for reuse
+#define DELAY_POOL_CACHE_LEN (8)
+
+typedef struct {
+    void *ptr;
+    size_t size;
+} delay_pool_block_t;
+
+static delay_pool_block_t delay_pool_cache[DELAY_POOL_CACHE_LEN];
+
+// Take the smallest cached block that fits size without wasting more than
+// half of it.
+static void *delay_pool_take_cached(size_t size) {
+    delay_pool_block_t *best = NULL;
+    for (size_t i = 0; i < DELAY_POOL_CACHE_LEN; i++) {
+        delay_pool_block_t *block = &delay_pool_cache[i];
+        if (block->ptr && block->size >= size && block->size / 2 <= size
+            && (best == NULL || block->size < best->size)) {
+            best = block;
+        }
+    }
+    if (best == NULL) {
+        return NULL;
+    }
+    void *ptr = best->ptr;
+    best->ptr = NULL;
+    return ptr;
+}
+
+static void delay_pool_flush_cache(void) {
+    for (size_t i = 0; i < DELAY_POOL_CACHE_LEN; i++) {
+        if (delay_pool_cache[i].ptr) {
+            port_free(delay_pool_cache[i].ptr);
+            delay_pool_cache[i].ptr = NULL;
+        }
+    }
+}
+
+void audiocore_delay_pool_reset(void) {
+    delay_pool_flush_cache();
+}
+
+void *audiocore_delay_pool_alloc(size_t size, bool internal) {
+    void *ptr = NULL;
+    if (internal) {
+        // DMA capable memory is internal RAM on the ports that have PSRAM
+        ptr = port_malloc(size, true);
+    }
+    if (ptr == NULL) {
+        ptr = delay_pool_take_cached(size);
+    }
+    if (ptr == NULL) {
+        ptr = port_malloc(size, false);
+    }
+    if (ptr == NULL) {
+        // Cached blocks of the wrong size may be what is in the way
+        delay_pool_flush_cache();
+        ptr = port_malloc(size, false);
+    }
+    if (ptr == NULL) {
+        ptr = gc_alloc(size, internal ? 0 : GC_ALLOC_FLAG_BULK);
+    }
+    if (ptr == NULL) {
+        m_malloc_fail(size);
+    }
+    memset(ptr, 0, size);
+    return ptr;
+}
+
+void audiocore_delay_pool_free(void *ptr, size_t size, bool internal) {
+    if (ptr == NULL) {
+        return;
+    }
+    if (gc_ptr_on_heap(ptr)) {
+        m_del(uint8_t, ptr, size);
+        return;
+    }
+    if (internal) {
+        // internal RAM is scarce, so give it back right away
+        port_free(ptr);
+        return;
+    }
+    for (size_t i = 0; i < DELAY_POOL_CACHE_LEN; i++) {
+        if (delay_pool_cache[i].ptr == NULL) {
+            delay_pool_cache[i].ptr = ptr;
+            delay_pool_cache[i].size = size;
+            return;
+        }
+    }
+    port_free(ptr);
+}
@@ -0,0 +1,41 @@
+// This file is part of the CircuitPython project: https://circuitpython.org
+//
+// SPDX-FileCopyrightText: Copyright (c) 2025 Adafruit Industries LLC
+//
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Delay lines for the audio effects are allocated outside the VM heap, from
+// the port heap (PSRAM on boards that have it), so a chain of effects does not
+// fragment the VM heap. Released blocks are kept for the next effect that asks
+// for a similar size, so re-creating an effect reuses the same memory. When the
+// port heap is exhausted, the VM heap is used.
+
+// Return size bytes of zeroed memory. Raises MemoryError on failure. When
+// internal is true, internal RAM is tried first: it is faster than PSRAM for
+// the random access of a delay line, but there is less of it.
+void *audiocore_delay_pool_alloc(size_t size, bool internal);
+
+// Return a block from audiocore_delay_pool_alloc. size and internal must be
+// what it was allocated with. ptr may be NULL.
+void audiocore_delay_pool_free(void *ptr, size_t size, bool internal);
+
+// Free the released blocks kept for reuse. Called once the VM has stopped and
+// the effects' finalisers have given their blocks back.
+void audiocore_delay_pool_reset(void);
+
+// Read a delay line of len samples at pos, which has 8 fractional bits,
+// interpolating linearly between the two neighbouring samples. The sample
+// after the last one is the first one.
+static inline int16_t audiocore_delay_read_interpolated(const int16_t *buffer, uint32_t len, uint32_t pos) {
+    uint32_t i = pos >> 8;
+    int32_t frac = pos & 0xff;
+    int32_t a = buffer[i];
+    int32_t b = buffer[i + 1 < len ? i + 1 : 0];
+    return (int16_t)(a + (((b - a) * frac) >> 8));
+}
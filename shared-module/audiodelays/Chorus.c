@@ -4,11 +4,37 @@
 //
 // SPDX-License-Identifier: MIT
 #include "shared-bindings/audiodelays/Chorus.h"
+#include "shared-module/audiocore/delay_pool.h"
 
 #include <stdint.h>
 #include <math.h>
 #include "py/runtime.h"
 
+// Size the chorus buffer for f_delay_ms when delay_ms is a number. A BlockInput
+// changes the delay from the audio path, where the buffer can't be reallocated,
+// so it gets the maximum.
+static void chorus_allocate_buffer(audiodelays_chorus_obj_t *self, mp_float_t f_delay_ms) {
+    uint32_t needed = self->max_chorus_buffer_len;
+    if (!synthio_obj_is_block(self->delay_ms.obj)) {
+        f_delay_ms = MAX(f_delay_ms, self->sample_ms);
+        uint32_t len = (uint32_t)(self->base.sample_rate / MICROPY_FLOAT_CONST(1000.0) * f_delay_ms) * (self->base.channel_count * sizeof(uint16_t));
+        // Leave headroom so a delay raised a little at a time isn't reallocated at every step
+        needed = MIN(len + len / 4, needed);
+    }
+    // Keep whole 16-bit words
+    needed = MAX(needed & ~1, sizeof(uint16_t));
+    if (needed <= self->allocated_chorus_buffer_len) {
+        return;
+    }
+    int8_t *chorus_buffer = audiocore_delay_pool_alloc(needed, false);
+    if (self->chorus_buffer) {
+        memcpy(chorus_buffer, self->chorus_buffer, self->allocated_chorus_buffer_len);
+        audiocore_delay_pool_free(self->chorus_buffer, self->allocated_chorus_buffer_len, false);
+    }
+    self->chorus_buffer = chorus_buffer;
+    self->allocated_chorus_buffer_len = needed;
+}
+
 void common_hal_audiodelays_chorus_construct(audiodelays_chorus_obj_t *self, uint32_t max_delay_ms,
     mp_obj_t delay_ms, mp_obj_t voices, mp_obj_t mix,
     uint32_t buffer_size, uint8_t bits_per_sample,
@@ -72,24 +98,22 @@ void common_hal_audiodelays_chorus_construct(audiodelays_chorus_obj_t *self, uin
     synthio_block_assign_slot(mix, &self->mix, MP_QSTR_mix);
 
     // Many effects may need buffers of what was played this shows how it was done for the chorus
-    // A maximum length buffer was created and then the current chorus length can be dynamically changes
-    // without having to reallocate a large chunk of memory.
+    // The chorus buffer comes from the shared delay pool and is sized for the current delay,
+    // up to max_delay_ms, so the current chorus length can change without reallocating
+    // in the audio path.
 
-    // Allocate the chorus buffer for the max possible delay, chorus is always 16-bit
+    // The chorus buffer is always 16-bit
     self->max_delay_ms = max_delay_ms;
     self->max_chorus_buffer_len = (uint32_t)(self->base.sample_rate / MICROPY_FLOAT_CONST(1000.0) * max_delay_ms * (self->base.channel_count * sizeof(uint16_t))); // bytes
-    self->chorus_buffer = m_malloc(self->max_chorus_buffer_len);
-    if (self->chorus_buffer == NULL) {
-        common_hal_audiodelays_chorus_deinit(self);
-        m_malloc_fail(self->max_chorus_buffer_len);
-    }
-    memset(self->chorus_buffer, 0, self->max_chorus_buffer_len);
+    self->chorus_buffer = NULL;
+    self->allocated_chorus_buffer_len = 0;
 
     // calculate the length of a single sample in milliseconds
     self->sample_ms = MICROPY_FLOAT_CONST(1000.0) / self->base.sample_rate;
 
     // calculate everything needed for the current delay
-    mp_float_t f_delay_ms = synthio_block_slot_get(&self->delay_ms);
+    mp_float_t f_delay_ms = synthio_block_slot_get(&self->render_context, &self->delay_ms);
+    chorus_allocate_buffer(self, f_delay_ms);
     chorus_recalculate_delay(self, f_delay_ms);
 
     // where we are storing the next chorus sample
@@ -107,9 +131,12 @@ void common_hal_audiodelays_chorus_deinit(audiodelays_chorus_obj_t *self) {
     if (common_hal_audiodelays_chorus_deinited(self)) {
         return;
     }
+    audiocore_delay_pool_free(self->chorus_buffer, self->allocated_chorus_buffer_len, false);
     self->chorus_buffer = NULL;
+    self->allocated_chorus_buffer_len = 0;
     self->buffer[0] = NULL;
     self->buffer[1] = NULL;
+    self->converter.scratch = NULL;
 }
 
 mp_obj_t common_hal_audiodelays_chorus_get_delay_ms(audiodelays_chorus_obj_t *self) {
@@ -119,8 +146,9 @@ mp_obj_t common_hal_audiodelays_chorus_get_delay_ms(audiodelays_chorus_obj_t *se
 void common_hal_audiodelays_chorus_set_delay_ms(audiodelays_chorus_obj_t *self, mp_obj_t delay_ms) {
     synthio_block_assign_slot(delay_ms, &self->delay_ms, MP_QSTR_delay_ms);
 
-    mp_float_t f_delay_ms = synthio_block_slot_get(&self->delay_ms);
+    mp_float_t f_delay_ms = synthio_block_slot_get(&self->render_context, &self->delay_ms);
 
+    chorus_allocate_buffer(self, f_delay_ms);
     chorus_recalculate_delay(self, f_delay_ms);
 }
 
@@ -131,7 +159,7 @@ void chorus_recalculate_delay(audiodelays_chorus_obj_t *self, mp_float_t f_delay
     // Calculate the current chorus buffer length in bytes
     uint32_t new_chorus_buffer_len = (uint32_t)(self->base.sample_rate / MICROPY_FLOAT_CONST(1000.0) * f_delay_ms) * (self->base.channel_count * sizeof(uint16_t));
 
-    self->chorus_buffer_len = new_chorus_buffer_len;
+    self->chorus_buffer_len = MIN(new_chorus_buffer_len, self->allocated_chorus_buffer_len);
 
     self->current_delay_ms = f_delay_ms;
 }
@@ -150,7 +178,8 @@ void audiodelays_chorus_reset_buffer(audiodelays_chorus_obj_t *self,
 
     memset(self->buffer[0], 0, self->buffer_len);
     memset(self->buffer[1], 0, self->buffer_len);
-    memset(self->chorus_buffer, 0, self->chorus_buffer_len);
+    memset(self->chorus_buffer, 0, self->allocated_chorus_buffer_len);
+    self->buffer_silent = false;
 }
 
 mp_obj_t common_hal_audiodelays_chorus_get_mix(audiodelays_chorus_obj_t *self) {
@@ -166,13 +195,13 @@ bool common_hal_audiodelays_chorus_get_playing(audiodelays_chorus_obj_t *self) {
 }
 
 void common_hal_audiodelays_chorus_play(audiodelays_chorus_obj_t *self, mp_obj_t sample, bool loop) {
-    audiosample_must_match(&self->base, sample);
+    audiosample_converter_play(&self->converter, &self->base, sample, self->buffer_len);
 
     self->sample = sample;
     self->loop = loop;
 
     audiosample_reset_buffer(self->sample, false, 0);
-    audioio_get_buffer_result_t result = audiosample_get_buffer(self->sample, false, 0, (uint8_t **)&self->sample_remaining_buffer, &self->sample_buffer_length);
+    audioio_get_buffer_result_t result = audiosample_converter_get_buffer(&self->converter, self->sample, (uint8_t **)&self->sample_remaining_buffer, &self->sample_buffer_length);
 
     // Track remaining sample length in terms of bytes per sample
     self->sample_buffer_length /= (self->base.bits_per_sample / 8);
@@ -189,9 +218,101 @@ void common_hal_audiodelays_chorus_stop(audiodelays_chorus_obj_t *self) {
     return;
 }
 
+// Load the next buffer from the sample once the current one is used up. When
+// the sample has ended and isn't looping, it is cleared.
+static void chorus_load_sample_buffer(audiodelays_chorus_obj_t *self) {
+    if (self->sample_buffer_length != 0) {
+        return;
+    }
+    if (!self->more_data) { // The sample has indicated it has no more data to play
+        if (self->loop && self->sample) { // If we are supposed to loop reset the sample to the start
+            audiosample_reset_buffer(self->sample, false, 0);
+        } else { // If we were not supposed to loop the sample, stop playing it
+            self->sample = NULL;
+        }
+    }
+    if (self->sample) {
+        // Load another sample buffer to play
+        audioio_get_buffer_result_t result = audiosample_converter_get_buffer(&self->converter, self->sample, (uint8_t **)&self->sample_remaining_buffer, &self->sample_buffer_length);
+        // Track length in terms of words.
+        self->sample_buffer_length /= (self->base.bits_per_sample / 8);
+        self->more_data = result == GET_BUFFER_MORE_DATA;
+    }
+}
+
+// Return a buffer of silence. Once one of our buffers has been filled with
+// silence it is handed out again as is, until there is something to play.
+static void chorus_get_silence(audiodelays_chorus_obj_t *self, uint8_t **buffer, uint32_t *buffer_length) {
+    if (!self->buffer_silent) {
+        self->last_buf_idx = !self->last_buf_idx;
+        audiosample_fill_silence(&self->base, self->buffer[self->last_buf_idx], self->buffer_len);
+        self->buffer_silent = true;
+    }
+    *buffer = (uint8_t *)self->buffer[self->last_buf_idx];
+    *buffer_length = self->buffer_len;
+    self->base.silent = true;
+}
+
+// Hand out the rest of the current sample buffer, up to our buffer length,
+// without copying it. The sample double buffers, so it stays valid until the
+// sample is asked for its next buffer but one. The chorus buffer is still
+// filled so the voices are there as soon as mix is raised.
+static void chorus_pass_through(audiodelays_chorus_obj_t *self, uint8_t **buffer, uint32_t *buffer_length) {
+    uint32_t bytes_per_sample = self->base.bits_per_sample / 8;
+    uint32_t n = MIN(self->sample_buffer_length, self->buffer_len / bytes_per_sample);
+    int16_t *chorus_buffer = (int16_t *)self->chorus_buffer;
+    uint32_t max_chorus_buf_len = self->allocated_chorus_buffer_len / sizeof(uint16_t);
+    for (uint32_t i = 0; i < n; i++) {
+        int16_t sample_word;
+        if (MP_LIKELY(self->base.bits_per_sample == 16)) {
+            sample_word = ((int16_t *)self->sample_remaining_buffer)[i];
+        } else if (self->base.samples_signed) {
+            sample_word = ((int8_t *)self->sample_remaining_buffer)[i];
+        } else {
+            sample_word = (int8_t)(self->sample_remaining_buffer[i] ^ 0x80);
+        }
+        chorus_buffer[self->chorus_buffer_pos++] = sample_word;
+        if (self->chorus_buffer_pos >= max_chorus_buf_len) {
+            self->chorus_buffer_pos = 0;
+        }
+    }
+    *buffer = self->sample_remaining_buffer;
+    *buffer_length = n * bytes_per_sample;
+    self->sample_remaining_buffer += n * bytes_per_sample;
+    self->sample_buffer_length -= n;
+    self->base.silent = audiosample_get_silent(self->sample);
+}
+
 audioio_get_buffer_result_t audiodelays_chorus_get_buffer(audiodelays_chorus_obj_t *self, bool single_channel_output, uint8_t channel,
     uint8_t **buffer, uint32_t *buffer_length) {
 
+    // Skip the effect when it would not change anything: with no sample the
+    // output is silence, and with a mix of 0 the sample is handed out as is.
+    // mix is from the last block.
+    chorus_load_sample_buffer(self);
+    mp_float_t last_mix = synthio_block_slot_get_limited(&self->render_context, &self->mix, MICROPY_FLOAT_CONST(0.0), MICROPY_FLOAT_CONST(1.0));
+    if (self->sample == NULL || (self->sample_buffer_length != 0 && last_mix <= MICROPY_FLOAT_CONST(0.01))) {
+        uint32_t n = self->buffer_len / (self->base.bits_per_sample / 8);
+        if (self->sample != NULL) {
+            n = MIN(self->sample_buffer_length, n);
+        }
+        synthio_render_context_tick(&self->render_context, self->base.sample_rate, n / self->base.channel_count);
+        (void)synthio_block_slot_get(&self->render_context, &self->voices);
+        (void)synthio_block_slot_get(&self->render_context, &self->mix);
+        mp_float_t f_delay_ms = synthio_block_slot_get(&self->render_context, &self->delay_ms);
+        if (MICROPY_FLOAT_C_FUN(fabs)(self->current_delay_ms - f_delay_ms) >= self->sample_ms) {
+            chorus_recalculate_delay(self, f_delay_ms);
+        }
+        if (self->sample == NULL) {
+            chorus_get_silence(self, buffer, buffer_length);
+        } else {
+            chorus_pass_through(self, buffer, buffer_length);
+        }
+        return GET_BUFFER_MORE_DATA;
+    }
+    self->base.silent = false;
+    self->buffer_silent = false;
+
     // Switch our buffers to the other buffer
     self->last_buf_idx = !self->last_buf_idx;
 
@@ -203,27 +324,12 @@ audioio_get_buffer_result_t audiodelays_chorus_get_buffer(audiodelays_chorus_obj
     // The chorus buffer is always stored as a 16-bit value internally
     int16_t *chorus_buffer = (int16_t *)self->chorus_buffer;
     uint32_t chorus_buf_len = self->chorus_buffer_len / sizeof(uint16_t);
-    uint32_t max_chorus_buf_len = self->max_chorus_buffer_len / sizeof(uint16_t);
+    uint32_t max_chorus_buf_len = self->allocated_chorus_buffer_len / sizeof(uint16_t);
 
     // Loop over the entire length of our buffer to fill it, this may require several calls to get data from the sample
     while (length != 0) {
         // Check if there is no more sample to play, we will either load more data, reset the sample if loop is on or clear the sample
-        if (self->sample_buffer_length == 0) {
-            if (!self->more_data) { // The sample has indicated it has no more data to play
-                if (self->loop && self->sample) { // If we are supposed to loop reset the sample to the start
-                    audiosample_reset_buffer(self->sample, false, 0);
-                } else { // If we were not supposed to loop the sample, stop playing it but we still need to play the chorus
-                    self->sample = NULL;
-                }
-            }
-            if (self->sample) {
-                // Load another sample buffer to play
-                audioio_get_buffer_result_t result = audiosample_get_buffer(self->sample, false, 0, (uint8_t **)&self->sample_remaining_buffer, &self->sample_buffer_length);
-                // Track length in terms of words.
-                self->sample_buffer_length /= (self->base.bits_per_sample / 8);
-                self->more_data = result == GET_BUFFER_MORE_DATA;
-            }
-        }
+        chorus_load_sample_buffer(self);
 
         // Determine how many bytes we can process to our buffer, the less of the sample we have left and our buffer remaining
         uint32_t n;
@@ -234,31 +340,19 @@ audioio_get_buffer_result_t audiodelays_chorus_get_buffer(audiodelays_chorus_obj
         }
 
         // get the effect values we need from the BlockInput. These may change at run time so you need to do bounds checking if required
-        shared_bindings_synthio_lfo_tick(self->base.sample_rate, n / self->base.channel_count);
+        synthio_render_context_tick(&self->render_context, self->base.sample_rate, n / self->base.channel_count);
 
-        int32_t voices = (int32_t)MAX(synthio_block_slot_get(&self->voices), 1.0);
+        int32_t voices = (int32_t)MAX(synthio_block_slot_get(&self->render_context, &self->voices), 1.0);
         int32_t mix_down_scale = SYNTHIO_MIX_DOWN_SCALE(voices);
-        mp_float_t mix = synthio_block_slot_get_limited(&self->mix, MICROPY_FLOAT_CONST(0.0), MICROPY_FLOAT_CONST(1.0));
+        mp_float_t mix = synthio_block_slot_get_limited(&self->render_context, &self->mix, MICROPY_FLOAT_CONST(0.0), MICROPY_FLOAT_CONST(1.0));
 
-        mp_float_t f_delay_ms = synthio_block_slot_get(&self->delay_ms);
+        mp_float_t f_delay_ms = synthio_block_slot_get(&self->render_context, &self->delay_ms);
         if (MICROPY_FLOAT_C_FUN(fabs)(self->current_delay_ms - f_delay_ms) >= self->sample_ms) {
             chorus_recalculate_delay(self, f_delay_ms);
         }
 
         if (self->sample == NULL) {
-            if (self->base.samples_signed) {
-                memset(word_buffer, 0, n * (self->base.bits_per_sample / 8));
-            } else {
-                // For unsigned samples set to the middle which is "quiet"
-                if (MP_LIKELY(self->base.bits_per_sample == 16)) {
-                    uint16_t *uword_buffer = (uint16_t *)word_buffer;
-                    for (uint32_t i = 0; i < n; i++) {
-                        *uword_buffer++ = 32768;
-                    }
-                } else {
-                    memset(hword_buffer, 128, n * (self->base.bits_per_sample / 8));
-                }
-            }
+            audiosample_fill_silence(&self->base, word_buffer, n * (self->base.bits_per_sample / 8));
         } else {
             int16_t *sample_src = (int16_t *)self->sample_remaining_buffer; // for 16-bit samples
             int8_t *sample_hsrc = (int8_t *)self->sample_remaining_buffer; // for 8-bit samples
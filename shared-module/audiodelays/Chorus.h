@@ -8,6 +8,7 @@
 #include "py/obj.h"
 
 #include "shared-module/audiocore/__init__.h"
+#include "shared-module/synthio/__init__.h"
 #include "shared-module/synthio/block.h"
 
 extern const mp_obj_type_t audiodelays_chorus_type;
@@ -23,6 +24,7 @@ typedef struct {
 
     int8_t *buffer[2];
     uint8_t last_buf_idx;
+    bool buffer_silent; // buffer[last_buf_idx] holds silence
     uint32_t buffer_len; // max buffer in bytes
 
     uint8_t *sample_remaining_buffer;
@@ -34,10 +36,14 @@ typedef struct {
     int8_t *chorus_buffer;
     uint32_t chorus_buffer_len; // bytes
     uint32_t max_chorus_buffer_len; // bytes
+    uint32_t allocated_chorus_buffer_len; // bytes
 
     uint32_t chorus_buffer_pos; // words
 
     mp_obj_t sample;
+    audiosample_converter_t converter; // to our format
+
+    synthio_render_context_t render_context;
 } audiodelays_chorus_obj_t;
 
 void chorus_recalculate_delay(audiodelays_chorus_obj_t *self, mp_float_t f_delay_ms);
@@ -5,11 +5,35 @@
 // SPDX-License-Identifier: MIT
 #include "shared-bindings/audiodelays/Echo.h"
 #include "shared-bindings/audiocore/__init__.h"
+#include "shared-module/audiocore/delay_pool.h"
 
 #include <stdint.h>
 #include "py/runtime.h"
 #include <math.h>
 
+// Size the echo buffer for f_delay_ms when delay_ms is a number. A BlockInput
+// changes the delay from the audio path, where the buffer can't be reallocated,
+// and freq_shift always uses the whole buffer, so both get the maximum.
+static void echo_allocate_buffer(audiodelays_echo_obj_t *self, mp_float_t f_delay_ms) {
+    uint32_t needed = self->max_echo_buffer_len;
+    if (!self->freq_shift && !synthio_obj_is_block(self->delay_ms.obj)) {
+        f_delay_ms = MAX(f_delay_ms, self->sample_ms);
+        uint32_t len = (uint32_t)(self->base.sample_rate / MICROPY_FLOAT_CONST(1000.0) * f_delay_ms) * (self->base.channel_count * sizeof(uint16_t));
+        // Leave headroom so a delay raised a little at a time isn't reallocated at every step
+        needed = MIN(MAX(len + len / 4, self->buffer_len), needed);
+    }
+    if (needed <= self->allocated_echo_buffer_len) {
+        return;
+    }
+    int8_t *echo_buffer = audiocore_delay_pool_alloc(needed, false);
+    if (self->echo_buffer) {
+        memcpy(echo_buffer, self->echo_buffer, self->allocated_echo_buffer_len);
+        audiocore_delay_pool_free(self->echo_buffer, self->allocated_echo_buffer_len, false);
+    }
+    self->echo_buffer = echo_buffer;
+    self->allocated_echo_buffer_len = needed;
+}
+
 void common_hal_audiodelays_echo_construct(audiodelays_echo_obj_t *self, uint32_t max_delay_ms,
     mp_obj_t delay_ms, mp_obj_t decay, mp_obj_t mix,
     uint32_t buffer_size, uint8_t bits_per_sample,
@@ -76,30 +100,30 @@ void common_hal_audiodelays_echo_construct(audiodelays_echo_obj_t *self, uint32_
     synthio_block_assign_slot(mix, &self->mix, MP_QSTR_mix);
 
     // Many effects may need buffers of what was played this shows how it was done for the echo
-    // A maximum length buffer was created and then the current echo length can be dynamically changes
-    // without having to reallocate a large chunk of memory.
+    // The echo buffer comes from the shared delay pool and is sized for the current delay,
+    // up to max_delay_ms, so the current echo length can change without reallocating
+    // in the audio path.
 
-    // Allocate the echo buffer for the max possible delay, echo is always 16-bit
+    // The echo buffer is always 16-bit
     self->max_delay_ms = max_delay_ms;
     self->max_echo_buffer_len = (uint32_t)(self->base.sample_rate / MICROPY_FLOAT_CONST(1000.0) * max_delay_ms) * (self->base.channel_count * sizeof(uint16_t)); // bytes
-    self->echo_buffer = m_malloc(self->max_echo_buffer_len);
-    if (self->echo_buffer == NULL) {
-        common_hal_audiodelays_echo_deinit(self);
-        m_malloc_fail(self->max_echo_buffer_len);
-    }
-    memset(self->echo_buffer, 0, self->max_echo_buffer_len);
+    self->echo_buffer = NULL;
+    self->allocated_echo_buffer_len = 0;
 
     // calculate the length of a single sample in milliseconds
     self->sample_ms = MICROPY_FLOAT_CONST(1000.0) / self->base.sample_rate;
 
     // calculate everything needed for the current delay
-    mp_float_t f_delay_ms = synthio_block_slot_get(&self->delay_ms);
+    mp_float_t f_delay_ms = synthio_block_slot_get(&self->render_context, &self->delay_ms);
+    echo_allocate_buffer(self, f_delay_ms);
     recalculate_delay(self, f_delay_ms);
 
     // read is where we read previous echo from delay_ms ago to play back now
     // write is where the store the latest playing sample to echo back later
     self->echo_buffer_read_pos = self->buffer_len / sizeof(uint16_t);
     self->echo_buffer_write_pos = 0;
+    // the echo buffer starts out silent
+    self->echo_silent_len = UINT32_MAX;
 
     // where we read the previous echo from delay_ms ago to play back now (for freq shift)
     self->echo_buffer_left_pos = self->echo_buffer_right_pos = 0;
@@ -107,9 +131,12 @@ void common_hal_audiodelays_echo_construct(audiodelays_echo_obj_t *self, uint32_
 
 void common_hal_audiodelays_echo_deinit(audiodelays_echo_obj_t *self) {
     audiosample_mark_deinit(&self->base);
+    audiocore_delay_pool_free(self->echo_buffer, self->allocated_echo_buffer_len, false);
     self->echo_buffer = NULL;
+    self->allocated_echo_buffer_len = 0;
     self->buffer[0] = NULL;
     self->buffer[1] = NULL;
+    self->converter.scratch = NULL;
 }
 
 mp_obj_t common_hal_audiodelays_echo_get_delay_ms(audiodelays_echo_obj_t *self) {
@@ -119,8 +146,9 @@ mp_obj_t common_hal_audiodelays_echo_get_delay_ms(audiodelays_echo_obj_t *self)
 void common_hal_audiodelays_echo_set_delay_ms(audiodelays_echo_obj_t *self, mp_obj_t delay_ms) {
     synthio_block_assign_slot(delay_ms, &self->delay_ms, MP_QSTR_delay_ms);
 
-    mp_float_t f_delay_ms = synthio_block_slot_get(&self->delay_ms);
+    mp_float_t f_delay_ms = synthio_block_slot_get(&self->render_context, &self->delay_ms);
 
+    echo_allocate_buffer(self, f_delay_ms);
     recalculate_delay(self, f_delay_ms);
 }
 
@@ -131,13 +159,13 @@ void recalculate_delay(audiodelays_echo_obj_t *self, mp_float_t f_delay_ms) {
     if (self->freq_shift) {
         // Calculate the rate of iteration over the echo buffer with 8 sub-bits
         self->echo_buffer_rate = (uint32_t)MAX(self->max_delay_ms / f_delay_ms * MICROPY_FLOAT_CONST(256.0), MICROPY_FLOAT_CONST(1.0));
-        self->echo_buffer_len = self->max_echo_buffer_len;
+        self->echo_buffer_len = self->allocated_echo_buffer_len;
     } else {
         // Calculate the current echo buffer length in bytes
         uint32_t new_echo_buffer_len = (uint32_t)(self->base.sample_rate / MICROPY_FLOAT_CONST(1000.0) * f_delay_ms) * (self->base.channel_count * sizeof(uint16_t));
 
-        // Check if our new echo is too long for our maximum buffer
-        if (new_echo_buffer_len > self->max_echo_buffer_len) {
+        // Check if our new echo is too long for our buffer
+        if (new_echo_buffer_len > self->allocated_echo_buffer_len) {
             return;
         } else if (new_echo_buffer_len < 0.0) { // or too short!
             return;
@@ -151,7 +179,7 @@ void recalculate_delay(audiodelays_echo_obj_t *self, mp_float_t f_delay_ms) {
         self->echo_buffer_len = new_echo_buffer_len;
 
         // Clear the now unused part of the buffer or some weird artifacts appear
-        memset(self->echo_buffer + self->echo_buffer_len, 0, self->max_echo_buffer_len - self->echo_buffer_len);
+        memset(self->echo_buffer + self->echo_buffer_len, 0, self->allocated_echo_buffer_len - self->echo_buffer_len);
     }
 
     self->current_delay_ms = f_delay_ms;
@@ -179,7 +207,8 @@ bool common_hal_audiodelays_echo_get_freq_shift(audiodelays_echo_obj_t *self) {
 
 void common_hal_audiodelays_echo_set_freq_shift(audiodelays_echo_obj_t *self, bool freq_shift) {
     self->freq_shift = freq_shift;
-    uint32_t delay_ms = (uint32_t)synthio_block_slot_get(&self->delay_ms);
+    uint32_t delay_ms = (uint32_t)synthio_block_slot_get(&self->render_context, &self->delay_ms);
+    echo_allocate_buffer(self, delay_ms);
     recalculate_delay(self, delay_ms);
 }
 
@@ -189,7 +218,9 @@ void audiodelays_echo_reset_buffer(audiodelays_echo_obj_t *self,
 
     memset(self->buffer[0], 0, self->buffer_len);
     memset(self->buffer[1], 0, self->buffer_len);
-    memset(self->echo_buffer, 0, self->max_echo_buffer_len);
+    memset(self->echo_buffer, 0, self->allocated_echo_buffer_len);
+    self->echo_silent_len = UINT32_MAX;
+    self->buffer_silent = false;
 }
 
 bool common_hal_audiodelays_echo_get_playing(audiodelays_echo_obj_t *self) {
@@ -197,13 +228,13 @@ bool common_hal_audiodelays_echo_get_playing(audiodelays_echo_obj_t *self) {
 }
 
 void common_hal_audiodelays_echo_play(audiodelays_echo_obj_t *self, mp_obj_t sample, bool loop) {
-    audiosample_must_match(&self->base, sample);
+    audiosample_converter_play(&self->converter, &self->base, sample, self->buffer_len);
 
     self->sample = sample;
     self->loop = loop;
 
     audiosample_reset_buffer(self->sample, false, 0);
-    audioio_get_buffer_result_t result = audiosample_get_buffer(self->sample, false, 0, (uint8_t **)&self->sample_remaining_buffer, &self->sample_buffer_length);
+    audioio_get_buffer_result_t result = audiosample_converter_get_buffer(&self->converter, self->sample, (uint8_t **)&self->sample_remaining_buffer, &self->sample_buffer_length);
 
     // Track remaining sample length in terms of bytes per sample
     self->sample_buffer_length /= (self->base.bits_per_sample / 8);
@@ -220,6 +251,54 @@ void common_hal_audiodelays_echo_stop(audiodelays_echo_obj_t *self) {
     return;
 }
 
+// Load the next buffer from the sample once the current one is used up. When
+// the sample has ended and isn't looping, it is cleared but the echo plays on.
+static void echo_load_sample_buffer(audiodelays_echo_obj_t *self) {
+    if (self->sample_buffer_length != 0) {
+        return;
+    }
+    if (!self->more_data) { // The sample has indicated it has no more data to play
+        if (self->loop && self->sample) { // If we are supposed to loop reset the sample to the start
+            audiosample_reset_buffer(self->sample, false, 0);
+        } else { // If we were not supposed to loop the sample, stop playing it but we still need to play the echo
+            self->sample = NULL;
+        }
+    }
+    if (self->sample) {
+        // Load another sample buffer to play
+        audioio_get_buffer_result_t result = audiosample_converter_get_buffer(&self->converter, self->sample, (uint8_t **)&self->sample_remaining_buffer, &self->sample_buffer_length);
+        // Track length in terms of words.
+        self->sample_buffer_length /= (self->base.bits_per_sample / 8);
+        self->more_data = result == GET_BUFFER_MORE_DATA;
+    }
+}
+
+// Return a buffer of silence. Once one of our buffers has been filled with
+// silence it is handed out again as is, until there is something to play.
+static void echo_get_silence(audiodelays_echo_obj_t *self, uint8_t **buffer, uint32_t *buffer_length) {
+    if (!self->buffer_silent) {
+        self->last_buf_idx = !self->last_buf_idx;
+        audiosample_fill_silence(&self->base, self->buffer[self->last_buf_idx], self->buffer_len);
+        self->buffer_silent = true;
+    }
+    *buffer = (uint8_t *)self->buffer[self->last_buf_idx];
+    *buffer_length = self->buffer_len;
+    self->base.silent = true;
+}
+
+// Hand out the rest of the current sample buffer, up to our buffer length,
+// without copying it. The sample double buffers, so it stays valid until the
+// sample is asked for its next buffer but one.
+static void echo_pass_through(audiodelays_echo_obj_t *self, uint8_t **buffer, uint32_t *buffer_length) {
+    uint32_t bytes_per_sample = self->base.bits_per_sample / 8;
+    uint32_t n = MIN(self->sample_buffer_length, self->buffer_len / bytes_per_sample);
+    *buffer = self->sample_remaining_buffer;
+    *buffer_length = n * bytes_per_sample;
+    self->sample_remaining_buffer += n * bytes_per_sample;
+    self->sample_buffer_length -= n;
+    self->base.silent = audiosample_get_silent(self->sample);
+}
+
 audioio_get_buffer_result_t audiodelays_echo_get_buffer(audiodelays_echo_obj_t *self, bool single_channel_output, uint8_t channel,
     uint8_t **buffer, uint32_t *buffer_length) {
 
@@ -227,6 +306,26 @@ audioio_get_buffer_result_t audiodelays_echo_get_buffer(audiodelays_echo_obj_t *
         channel = 0;
     }
 
+    // Skip the effect when it would not change anything: with a mix of 0 the
+    // sample is handed out as is, and with no sample and nothing left in the
+    // echo buffer the output is silence. mix is from the last block.
+    echo_load_sample_buffer(self);
+    mp_float_t last_mix = synthio_block_slot_get_limited(&self->render_context, &self->mix, MICROPY_FLOAT_CONST(0.0), MICROPY_FLOAT_CONST(1.0)) * MICROPY_FLOAT_CONST(2.0);
+    if (self->sample == NULL && (last_mix <= MICROPY_FLOAT_CONST(0.01) || self->echo_silent_len >= self->echo_buffer_len / sizeof(uint16_t))) {
+        synthio_render_context_tick(&self->render_context, self->base.sample_rate, self->buffer_len / (self->base.bits_per_sample / 8) / self->base.channel_count);
+        (void)synthio_block_slot_get(&self->render_context, &self->mix);
+        echo_get_silence(self, buffer, buffer_length);
+        return GET_BUFFER_MORE_DATA;
+    }
+    if (self->sample != NULL && self->sample_buffer_length != 0 && last_mix <= MICROPY_FLOAT_CONST(0.01)) {
+        synthio_render_context_tick(&self->render_context, self->base.sample_rate, MIN(self->sample_buffer_length, self->buffer_len / (self->base.bits_per_sample / 8)) / self->base.channel_count);
+        (void)synthio_block_slot_get(&self->render_context, &self->mix);
+        echo_pass_through(self, buffer, buffer_length);
+        return GET_BUFFER_MORE_DATA;
+    }
+    self->base.silent = false;
+    self->buffer_silent = false;
+
     // Switch our buffers to the other buffer
     self->last_buf_idx = !self->last_buf_idx;
 
@@ -241,22 +340,7 @@ audioio_get_buffer_result_t audiodelays_echo_get_buffer(audiodelays_echo_obj_t *
     // Loop over the entire length of our buffer to fill it, this may require several calls to get data from the sample
     while (length != 0) {
         // Check if there is no more sample to play, we will either load more data, reset the sample if loop is on or clear the sample
-        if (self->sample_buffer_length == 0) {
-            if (!self->more_data) { // The sample has indicated it has no more data to play
-                if (self->loop && self->sample) { // If we are supposed to loop reset the sample to the start
-                    audiosample_reset_buffer(self->sample, false, 0);
-                } else { // If we were not supposed to loop the sample, stop playing it but we still need to play the echo
-                    self->sample = NULL;
-                }
-            }
-            if (self->sample) {
-                // Load another sample buffer to play
-                audioio_get_buffer_result_t result = audiosample_get_buffer(self->sample, false, 0, (uint8_t **)&self->sample_remaining_buffer, &self->sample_buffer_length);
-                // Track length in terms of words.
-                self->sample_buffer_length /= (self->base.bits_per_sample / 8);
-                self->more_data = result == GET_BUFFER_MORE_DATA;
-            }
-        }
+        echo_load_sample_buffer(self);
 
         // Determine how many bytes we can process to our buffer, the less of the sample we have left and our buffer remaining
         uint32_t n;
@@ -267,11 +351,11 @@ audioio_get_buffer_result_t audiodelays_echo_get_buffer(audiodelays_echo_obj_t *
         }
 
         // get the effect values we need from the BlockInput. These may change at run time so you need to do bounds checking if required
-        shared_bindings_synthio_lfo_tick(self->base.sample_rate, n / self->base.channel_count);
-        mp_float_t mix = synthio_block_slot_get_limited(&self->mix, MICROPY_FLOAT_CONST(0.0), MICROPY_FLOAT_CONST(1.0)) * MICROPY_FLOAT_CONST(2.0);
-        mp_float_t decay = synthio_block_slot_get_limited(&self->decay, MICROPY_FLOAT_CONST(0.0), MICROPY_FLOAT_CONST(1.0));
+        synthio_render_context_tick(&self->render_context, self->base.sample_rate, n / self->base.channel_count);
+        mp_float_t mix = synthio_block_slot_get_limited(&self->render_context, &self->mix, MICROPY_FLOAT_CONST(0.0), MICROPY_FLOAT_CONST(1.0)) * MICROPY_FLOAT_CONST(2.0);
+        mp_float_t decay = synthio_block_slot_get_limited(&self->render_context, &self->decay, MICROPY_FLOAT_CONST(0.0), MICROPY_FLOAT_CONST(1.0));
 
-        mp_float_t f_delay_ms = synthio_block_slot_get(&self->delay_ms);
+        mp_float_t f_delay_ms = synthio_block_slot_get(&self->render_context, &self->delay_ms);
         if (MICROPY_FLOAT_C_FUN(fabs)(self->current_delay_ms - f_delay_ms) >= self->sample_ms) {
             recalculate_delay(self, f_delay_ms);
         }
@@ -290,19 +374,7 @@ audioio_get_buffer_result_t audiodelays_echo_get_buffer(audiodelays_echo_obj_t *
         // If we have no sample keep the echo echoing
         if (self->sample == NULL) {
             if (mix <= MICROPY_FLOAT_CONST(0.01)) {  // Mix of 0 is pure sample sound. We have no sample so no sound
-                if (self->base.samples_signed) {
-                    memset(word_buffer, 0, length * (self->base.bits_per_sample / 8));
-                } else {
-                    // For unsigned samples set to the middle which is "quiet"
-                    if (MP_LIKELY(self->base.bits_per_sample == 16)) {
-                        uint16_t *uword_buffer = (uint16_t *)word_buffer;
-                        while (length--) {
-                            *uword_buffer++ = 32768;
-                        }
-                    } else {
-                        memset(hword_buffer, 128, length * (self->base.bits_per_sample / 8));
-                    }
-                }
+                audiosample_fill_silence(&self->base, word_buffer, length * (self->base.bits_per_sample / 8));
             } else {
                 // Since we have no sample we can just iterate over the our entire remaining buffer and finish
                 for (uint32_t i = 0; i < length; i++) {
@@ -316,11 +388,13 @@ audioio_get_buffer_result_t audiodelays_echo_get_buffer(audiodelays_echo_obj_t *
                         for (uint32_t j = echo_buffer_pos >> 8; j < next_buffer_pos >> 8; j++) {
                             word = (int16_t)(echo_buffer[j % echo_buf_len] * decay);
                             echo_buffer[j % echo_buf_len] = word;
+                            self->echo_silent_len = word ? 0 : self->echo_silent_len + 1;
                         }
                     } else {
                         echo = echo_buffer[self->echo_buffer_read_pos++];
                         word = (int16_t)(echo * decay);
                         echo_buffer[self->echo_buffer_write_pos++] = word;
+                        self->echo_silent_len = word ? 0 : self->echo_silent_len + 1;
                     }
 
                     word = (int16_t)(echo * MIN(mix, MICROPY_FLOAT_CONST(1.0)));
@@ -353,6 +427,7 @@ audioio_get_buffer_result_t audiodelays_echo_get_buffer(audiodelays_echo_obj_t *
             length = 0;
         } else {
             // we have a sample to play and echo
+            self->echo_silent_len = 0;
             int16_t *sample_src = (int16_t *)self->sample_remaining_buffer; // for 16-bit samples
             int8_t *sample_hsrc = (int8_t *)self->sample_remaining_buffer; // for 8-bit samples
 
@@ -24,6 +24,7 @@ typedef struct {
 
     int8_t *buffer[2];
     uint8_t last_buf_idx;
+    bool buffer_silent; // buffer[last_buf_idx] holds silence
     uint32_t buffer_len; // max buffer in bytes
 
     uint8_t *sample_remaining_buffer;
@@ -36,15 +37,20 @@ typedef struct {
     int8_t *echo_buffer;
     uint32_t echo_buffer_len; // bytes
     uint32_t max_echo_buffer_len; // bytes
+    uint32_t allocated_echo_buffer_len; // bytes
 
     uint32_t echo_buffer_read_pos; // words
     uint32_t echo_buffer_write_pos; // words
+    uint32_t echo_silent_len; // words of silence written to the echo buffer in a row
 
     uint32_t echo_buffer_rate; // words << 8
     uint32_t echo_buffer_left_pos; // words << 8
     uint32_t echo_buffer_right_pos; // words << 8
 
     mp_obj_t sample;
+    audiosample_converter_t converter; // to our format
+
+    synthio_render_context_t render_context;
 } audiodelays_echo_obj_t;
 
 void recalculate_delay(audiodelays_echo_obj_t *self, mp_float_t f_delay_ms);
@@ -5,6 +5,7 @@
 // SPDX-License-Identifier: MIT
 #include "shared-bindings/audiodelays/MultiTapDelay.h"
 #include "shared-bindings/audiocore/__init__.h"
+#include "shared-module/audiocore/delay_pool.h"
 
 #include <stdint.h>
 #include "py/runtime.h"
@@ -67,15 +68,12 @@ void common_hal_audiodelays_multi_tap_delay_construct(audiodelays_multi_tap_dela
     }
     synthio_block_assign_slot(mix, &self->mix, MP_QSTR_mix);
 
-    // Allocate the delay buffer for the max possible delay, delay is always 16-bit
+    // The delay buffer comes from the shared delay pool and is sized for the current delay
+    // by set_delay_ms, up to max_delay_ms. Delay is always 16-bit
     self->max_delay_ms = max_delay_ms;
     self->max_delay_buffer_len = (uint32_t)(self->base.sample_rate / MICROPY_FLOAT_CONST(1000.0) * max_delay_ms) * (self->base.channel_count * sizeof(uint16_t)); // bytes
-    self->delay_buffer = m_malloc_maybe(self->max_delay_buffer_len);
-    if (self->delay_buffer == NULL) {
-        common_hal_audiodelays_multi_tap_delay_deinit(self);
-        m_malloc_fail(self->max_delay_buffer_len);
-    }
-    memset(self->delay_buffer, 0, self->max_delay_buffer_len);
+    self->delay_buffer = NULL;
+    self->allocated_delay_buffer_len = 0;
 
     // calculate the length of a single sample in milliseconds
     self->sample_ms = MICROPY_FLOAT_CONST(1000.0) / self->base.sample_rate;
@@ -95,9 +93,12 @@ void common_hal_audiodelays_multi_tap_delay_construct(audiodelays_multi_tap_dela
 
 void common_hal_audiodelays_multi_tap_delay_deinit(audiodelays_multi_tap_delay_obj_t *self) {
     audiosample_mark_deinit(&self->base);
+    audiocore_delay_pool_free(self->delay_buffer, self->allocated_delay_buffer_len, false);
     self->delay_buffer = NULL;
+    self->allocated_delay_buffer_len = 0;
     self->buffer[0] = NULL;
     self->buffer[1] = NULL;
+    self->converter.scratch = NULL;
 
     self->tap_positions = NULL;
     self->tap_levels = NULL;
@@ -125,8 +126,21 @@ void common_hal_audiodelays_multi_tap_delay_set_delay_ms(audiodelays_multi_tap_d
         self->delay_buffer_len = self->buffer_len;
     }
 
+    // Grow the buffer if needed, with headroom so a delay raised a little at a time
+    // isn't reallocated at every step
+    if (self->delay_buffer_len > self->allocated_delay_buffer_len) {
+        uint32_t allocated_len = MIN(self->delay_buffer_len + self->delay_buffer_len / 4, MAX(self->max_delay_buffer_len, self->delay_buffer_len));
+        int8_t *delay_buffer = audiocore_delay_pool_alloc(allocated_len, false);
+        if (self->delay_buffer) {
+            memcpy(delay_buffer, self->delay_buffer, self->allocated_delay_buffer_len);
+            audiocore_delay_pool_free(self->delay_buffer, self->allocated_delay_buffer_len, false);
+        }
+        self->delay_buffer = delay_buffer;
+        self->allocated_delay_buffer_len = allocated_len;
+    }
+
     // Clear the now unused part of the buffer or some weird artifacts appear
-    memset(self->delay_buffer + self->delay_buffer_len, 0, self->max_delay_buffer_len - self->delay_buffer_len);
+    memset(self->delay_buffer + self->delay_buffer_len, 0, self->allocated_delay_buffer_len - self->delay_buffer_len);
 
     // Update tap offsets if we have any
     recalculate_tap_offsets(self);
@@ -277,7 +291,7 @@ void audiodelays_multi_tap_delay_reset_buffer(audiodelays_multi_tap_delay_obj_t
 
     memset(self->buffer[0], 0, self->buffer_len);
     memset(self->buffer[1], 0, self->buffer_len);
-    memset(self->delay_buffer, 0, self->max_delay_buffer_len);
+    memset(self->delay_buffer, 0, self->allocated_delay_buffer_len);
 }
 
 bool common_hal_audiodelays_multi_tap_delay_get_playing(audiodelays_multi_tap_delay_obj_t *self) {
@@ -285,13 +299,13 @@ bool common_hal_audiodelays_multi_tap_delay_get_playing(audiodelays_multi_tap_de
 }
 
 void common_hal_audiodelays_multi_tap_delay_play(audiodelays_multi_tap_delay_obj_t *self, mp_obj_t sample, bool loop) {
-    audiosample_must_match(&self->base, sample);
+    audiosample_converter_play(&self->converter, &self->base, sample, self->buffer_len);
 
     self->sample = sample;
     self->loop = loop;
 
     audiosample_reset_buffer(self->sample, false, 0);
-    audioio_get_buffer_result_t result = audiosample_get_buffer(self->sample, false, 0, (uint8_t **)&self->sample_remaining_buffer, &self->sample_buffer_length);
+    audioio_get_buffer_result_t result = audiosample_converter_get_buffer(&self->converter, self->sample, (uint8_t **)&self->sample_remaining_buffer, &self->sample_buffer_length);
 
     // Track remaining sample length in terms of bytes per sample
     self->sample_buffer_length /= (self->base.bits_per_sample / 8);
@@ -347,7 +361,7 @@ audioio_get_buffer_result_t audiodelays_multi_tap_delay_get_buffer(audiodelays_m
             }
             if (self->sample) {
                 // Load another sample buffer to play
-                audioio_get_buffer_result_t result = audiosample_get_buffer(self->sample, false, 0, (uint8_t **)&self->sample_remaining_buffer, &self->sample_buffer_length);
+                audioio_get_buffer_result_t result = audiosample_converter_get_buffer(&self->converter, self->sample, (uint8_t **)&self->sample_remaining_buffer, &self->sample_buffer_length);
                 // Track length in terms of words.
                 self->sample_buffer_length /= (self->base.bits_per_sample / 8);
                 self->more_data = result == GET_BUFFER_MORE_DATA;
@@ -363,9 +377,9 @@ audioio_get_buffer_result_t audiodelays_multi_tap_delay_get_buffer(audiodelays_m
         }
 
         // get the effect values we need from the BlockInput. These may change at run time so you need to do bounds checking if required
-        shared_bindings_synthio_lfo_tick(self->base.sample_rate, n / self->base.channel_count);
-        mp_float_t mix = synthio_block_slot_get_limited(&self->mix, MICROPY_FLOAT_CONST(0.0), MICROPY_FLOAT_CONST(1.0)) * MICROPY_FLOAT_CONST(2.0);
-        mp_float_t decay = synthio_block_slot_get_limited(&self->decay, MICROPY_FLOAT_CONST(0.0), MICROPY_FLOAT_CONST(1.0));
+        synthio_render_context_tick(&self->render_context, self->base.sample_rate, n / self->base.channel_count);
+        mp_float_t mix = synthio_block_slot_get_limited(&self->render_context, &self->mix, MICROPY_FLOAT_CONST(0.0), MICROPY_FLOAT_CONST(1.0)) * MICROPY_FLOAT_CONST(2.0);
+        mp_float_t decay = synthio_block_slot_get_limited(&self->render_context, &self->decay, MICROPY_FLOAT_CONST(0.0), MICROPY_FLOAT_CONST(1.0));
 
         int16_t *sample_src = NULL;
         int8_t *sample_hsrc = NULL;
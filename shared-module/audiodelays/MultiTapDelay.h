@@ -39,10 +39,14 @@ typedef struct {
     int8_t *delay_buffer;
     uint32_t delay_buffer_len; // bytes
     uint32_t max_delay_buffer_len; // bytes
+    uint32_t allocated_delay_buffer_len; // bytes
     uint32_t delay_buffer_pos;
     uint32_t delay_buffer_right_pos;
 
     mp_obj_t sample;
+    audiosample_converter_t converter; // to our format
+
+    synthio_render_context_t render_context;
 } audiodelays_multi_tap_delay_obj_t;
 
 void validate_tap_value(mp_obj_t item, qstr arg_name);
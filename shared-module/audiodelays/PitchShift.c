@@ -5,6 +5,7 @@
 // SPDX-License-Identifier: MIT
 #include "shared-bindings/audiodelays/PitchShift.h"
 #include "shared-bindings/audiocore/__init__.h"
+#include "shared-module/audiocore/delay_pool.h"
 
 #include <stdint.h>
 #include "py/runtime.h"
@@ -59,24 +60,12 @@ void common_hal_audiodelays_pitch_shift_construct(audiodelays_pitch_shift_obj_t
     synthio_block_assign_slot(semitones, &self->semitones, MP_QSTR_semitones);
     synthio_block_assign_slot(mix, &self->mix, MP_QSTR_mix);
 
-    // Allocate the window buffer
+    // Allocate the window buffer followed by the overlap buffer from the shared delay pool
     self->window_len = window; // bytes
-    self->window_buffer = m_malloc(self->window_len);
-    if (self->window_buffer == NULL) {
-        common_hal_audiodelays_pitch_shift_deinit(self);
-        m_malloc_fail(self->window_len);
-    }
-    memset(self->window_buffer, 0, self->window_len);
-
-    // Allocate the overlap buffer
     self->overlap_len = overlap; // bytes
+    self->window_buffer = audiocore_delay_pool_alloc(self->window_len + self->overlap_len, false);
     if (self->overlap_len) {
-        self->overlap_buffer = m_malloc(self->overlap_len);
-        if (self->overlap_buffer == NULL) {
-            common_hal_audiodelays_pitch_shift_deinit(self);
-            m_malloc_fail(self->overlap_len);
-        }
-        memset(self->overlap_buffer, 0, self->overlap_len);
+        self->overlap_buffer = self->window_buffer + self->window_len;
     } else {
         self->overlap_buffer = NULL;
     }
@@ -91,16 +80,18 @@ void common_hal_audiodelays_pitch_shift_construct(audiodelays_pitch_shift_obj_t
     self->read_index = 0;
 
     // Calculate the rate to increment the read index
-    mp_float_t f_semitones = synthio_block_slot_get(&self->semitones);
+    mp_float_t f_semitones = synthio_block_slot_get(&self->render_context, &self->semitones);
     recalculate_rate(self, f_semitones);
 }
 
 void common_hal_audiodelays_pitch_shift_deinit(audiodelays_pitch_shift_obj_t *self) {
     audiosample_mark_deinit(&self->base);
+    audiocore_delay_pool_free(self->window_buffer, self->window_len + self->overlap_len, false);
     self->window_buffer = NULL;
     self->overlap_buffer = NULL;
     self->buffer[0] = NULL;
     self->buffer[1] = NULL;
+    self->converter.scratch = NULL;
 }
 
 mp_obj_t common_hal_audiodelays_pitch_shift_get_semitones(audiodelays_pitch_shift_obj_t *self) {
@@ -109,7 +100,7 @@ mp_obj_t common_hal_audiodelays_pitch_shift_get_semitones(audiodelays_pitch_shif
 
 void common_hal_audiodelays_pitch_shift_set_semitones(audiodelays_pitch_shift_obj_t *self, mp_obj_t delay_ms) {
     synthio_block_assign_slot(delay_ms, &self->semitones, MP_QSTR_semitones);
-    mp_float_t semitones = synthio_block_slot_get(&self->semitones);
+    mp_float_t semitones = synthio_block_slot_get(&self->render_context, &self->semitones);
     recalculate_rate(self, semitones);
 }
 
@@ -143,13 +134,13 @@ bool common_hal_audiodelays_pitch_shift_get_playing(audiodelays_pitch_shift_obj_
 }
 
 void common_hal_audiodelays_pitch_shift_play(audiodelays_pitch_shift_obj_t *self, mp_obj_t sample, bool loop) {
-    audiosample_must_match(&self->base, sample);
+    audiosample_converter_play(&self->converter, &self->base, sample, self->buffer_len);
 
     self->sample = sample;
     self->loop = loop;
 
     audiosample_reset_buffer(self->sample, false, 0);
-    audioio_get_buffer_result_t result = audiosample_get_buffer(self->sample, false, 0, (uint8_t **)&self->sample_remaining_buffer, &self->sample_buffer_length);
+    audioio_get_buffer_result_t result = audiosample_converter_get_buffer(&self->converter, self->sample, (uint8_t **)&self->sample_remaining_buffer, &self->sample_buffer_length);
 
     // Track remaining sample length in terms of bytes per sample
     self->sample_buffer_length /= (self->base.bits_per_sample / 8);
@@ -204,7 +195,7 @@ audioio_get_buffer_result_t audiodelays_pitch_shift_get_buffer(audiodelays_pitch
             }
             if (self->sample) {
                 // Load another sample buffer to play
-                audioio_get_buffer_result_t result = audiosample_get_buffer(self->sample, false, 0, (uint8_t **)&self->sample_remaining_buffer, &self->sample_buffer_length);
+                audioio_get_buffer_result_t result = audiosample_converter_get_buffer(&self->converter, self->sample, (uint8_t **)&self->sample_remaining_buffer, &self->sample_buffer_length);
                 // Track length in terms of words.
                 self->sample_buffer_length /= (self->base.bits_per_sample / 8);
                 self->more_data = result == GET_BUFFER_MORE_DATA;
@@ -224,9 +215,9 @@ audioio_get_buffer_result_t audiodelays_pitch_shift_get_buffer(audiodelays_pitch
             }
 
             // tick all block inputs
-            shared_bindings_synthio_lfo_tick(self->base.sample_rate, length / self->base.channel_count);
-            (void)synthio_block_slot_get(&self->semitones);
-            (void)synthio_block_slot_get(&self->mix);
+            synthio_render_context_tick(&self->render_context, self->base.sample_rate, length / self->base.channel_count);
+            (void)synthio_block_slot_get(&self->render_context, &self->semitones);
+            (void)synthio_block_slot_get(&self->render_context, &self->mix);
 
             length = 0;
         } else {
@@ -238,9 +229,9 @@ audioio_get_buffer_result_t audiodelays_pitch_shift_get_buffer(audiodelays_pitch
             int8_t *sample_hsrc = (int8_t *)self->sample_remaining_buffer; // for 8-bit samples
 
             // get the effect values we need from the BlockInput. These may change at run time so you need to do bounds checking if required
-            shared_bindings_synthio_lfo_tick(self->base.sample_rate, n / self->base.channel_count);
-            mp_float_t semitones = synthio_block_slot_get(&self->semitones);
-            mp_float_t mix = synthio_block_slot_get_limited(&self->mix, MICROPY_FLOAT_CONST(0.0), MICROPY_FLOAT_CONST(1.0)) * MICROPY_FLOAT_CONST(2.0);
+            synthio_render_context_tick(&self->render_context, self->base.sample_rate, n / self->base.channel_count);
+            mp_float_t semitones = synthio_block_slot_get(&self->render_context, &self->semitones);
+            mp_float_t mix = synthio_block_slot_get_limited(&self->render_context, &self->mix, MICROPY_FLOAT_CONST(0.0), MICROPY_FLOAT_CONST(1.0)) * MICROPY_FLOAT_CONST(2.0);
 
             // Only recalculate rate if semitones has changes
             if (memcmp(&semitones, &self->current_semitones, sizeof(mp_float_t))) {
@@ -277,8 +268,8 @@ audioio_get_buffer_result_t audiodelays_pitch_shift_get_buffer(audiodelays_pitch
                 uint32_t read_index = self->read_index >> PITCH_READ_SHIFT;
                 uint32_t read_overlap_offset = read_index + window_size * (read_index < self->window_index) - self->window_index;
 
-                // Read sample from buffer
-                int32_t word = (int32_t)window_buffer[read_index + window_size * buf_offset];
+                // Read sample from buffer, between the two samples either side of the read position
+                int32_t word = audiocore_delay_read_interpolated(window_buffer + window_size * buf_offset, window_size, self->read_index);
 
                 // Check if we're within the overlap range and mix buffer sample with overlap sample
                 if (overlap_size && read_overlap_offset > 0 && read_overlap_offset <= overlap_size) {
@@ -11,7 +11,7 @@
 #include "shared-module/synthio/__init__.h"
 #include "shared-module/synthio/block.h"
 
-#define PITCH_READ_SHIFT (8)
+#define PITCH_READ_SHIFT (8) // the fractional bits audiocore_delay_read_interpolated expects
 
 extern const mp_obj_type_t audiodelays_pitch_shift_type;
 
@@ -43,6 +43,9 @@ typedef struct {
     uint32_t read_rate; // words << PITCH_READ_SHIFT
 
     mp_obj_t sample;
+    audiosample_converter_t converter; // to our format
+
+    synthio_render_context_t render_context;
 } audiodelays_pitch_shift_obj_t;
 
 void recalculate_rate(audiodelays_pitch_shift_obj_t *self, mp_float_t semitones);
@@ -78,6 +78,7 @@ void common_hal_audiofilters_distortion_deinit(audiofilters_distortion_obj_t *se
     audiosample_mark_deinit(&self->base);
     self->buffer[0] = NULL;
     self->buffer[1] = NULL;
+    self->converter.scratch = NULL;
 }
 
 mp_obj_t common_hal_audiofilters_distortion_get_drive(audiofilters_distortion_obj_t *self) {
@@ -134,6 +135,7 @@ void audiofilters_distortion_reset_buffer(audiofilters_distortion_obj_t *self,
 
     memset(self->buffer[0], 0, self->buffer_len);
     memset(self->buffer[1], 0, self->buffer_len);
+    self->buffer_silent = false;
 }
 
 bool common_hal_audiofilters_distortion_get_playing(audiofilters_distortion_obj_t *self) {
@@ -141,13 +143,13 @@ bool common_hal_audiofilters_distortion_get_playing(audiofilters_distortion_obj_
 }
 
 void common_hal_audiofilters_distortion_play(audiofilters_distortion_obj_t *self, mp_obj_t sample, bool loop) {
-    audiosample_must_match(&self->base, sample);
+    audiosample_converter_play(&self->converter, &self->base, sample, self->buffer_len);
 
     self->sample = sample;
     self->loop = loop;
 
     audiosample_reset_buffer(self->sample, false, 0);
-    audioio_get_buffer_result_t result = audiosample_get_buffer(self->sample, false, 0, (uint8_t **)&self->sample_remaining_buffer, &self->sample_buffer_length);
+    audioio_get_buffer_result_t result = audiosample_converter_get_buffer(&self->converter, self->sample, (uint8_t **)&self->sample_remaining_buffer, &self->sample_buffer_length);
 
     // Track remaining sample length in terms of bytes per sample
     self->sample_buffer_length /= (self->base.bits_per_sample / 8);
@@ -167,9 +169,83 @@ static mp_float_t db_to_linear(mp_float_t value) {
     return MICROPY_FLOAT_C_FUN(exp)(value * MICROPY_FLOAT_CONST(0.11512925464970228420089957273422));
 }
 
+// Load the next buffer from the sample once the current one is used up. When
+// the sample has ended and isn't looping, it is cleared.
+static void distortion_load_sample_buffer(audiofilters_distortion_obj_t *self) {
+    if (self->sample_buffer_length != 0) {
+        return;
+    }
+    if (!self->more_data) { // The sample has indicated it has no more data to play
+        if (self->loop && self->sample) { // If we are supposed to loop reset the sample to the start
+            audiosample_reset_buffer(self->sample, false, 0);
+        } else { // If we were not supposed to loop the sample, stop playing it
+            self->sample = NULL;
+        }
+    }
+    if (self->sample) {
+        // Load another sample buffer to play
+        audioio_get_buffer_result_t result = audiosample_converter_get_buffer(&self->converter, self->sample, (uint8_t **)&self->sample_remaining_buffer, &self->sample_buffer_length);
+        // Track length in terms of words.
+        self->sample_buffer_length /= (self->base.bits_per_sample / 8);
+        self->more_data = result == GET_BUFFER_MORE_DATA;
+    }
+}
+
+// Return a buffer of silence. Once one of our buffers has been filled with
+// silence it is handed out again as is, until there is something to play.
+static void distortion_get_silence(audiofilters_distortion_obj_t *self, uint8_t **buffer, uint32_t *buffer_length) {
+    if (!self->buffer_silent) {
+        self->last_buf_idx = !self->last_buf_idx;
+        audiosample_fill_silence(&self->base, self->buffer[self->last_buf_idx], self->buffer_len);
+        self->buffer_silent = true;
+    }
+    *buffer = (uint8_t *)self->buffer[self->last_buf_idx];
+    *buffer_length = self->buffer_len;
+    self->base.silent = true;
+}
+
+// Hand out the rest of the current sample buffer, up to our buffer length,
+// without copying it. The sample double buffers, so it stays valid until the
+// sample is asked for its next buffer but one.
+static void distortion_pass_through(audiofilters_distortion_obj_t *self, uint8_t **buffer, uint32_t *buffer_length) {
+    uint32_t bytes_per_sample = self->base.bits_per_sample / 8;
+    uint32_t n = MIN(self->sample_buffer_length, self->buffer_len / bytes_per_sample);
+    *buffer = self->sample_remaining_buffer;
+    *buffer_length = n * bytes_per_sample;
+    self->sample_remaining_buffer += n * bytes_per_sample;
+    self->sample_buffer_length -= n;
+    self->base.silent = audiosample_get_silent(self->sample);
+}
+
 audioio_get_buffer_result_t audiofilters_distortion_get_buffer(audiofilters_distortion_obj_t *self, bool single_channel_output, uint8_t channel,
     uint8_t **buffer, uint32_t *buffer_length) {
 
+    // Skip the effect when it would not change anything: with no sample the
+    // output is silence, and with a mix of 0 the sample is handed out as is.
+    // mix is from the last block.
+    distortion_load_sample_buffer(self);
+    mp_float_t last_mix = synthio_block_slot_get_limited(&self->render_context, &self->mix, MICROPY_FLOAT_CONST(0.0), MICROPY_FLOAT_CONST(1.0));
+    if (self->sample == NULL || (self->sample_buffer_length != 0 && last_mix <= MICROPY_FLOAT_CONST(0.01))) {
+        uint32_t n = self->buffer_len / (self->base.bits_per_sample / 8);
+        if (self->sample != NULL) {
+            n = MIN(self->sample_buffer_length, n);
+        }
+        // tick all block inputs
+        synthio_render_context_tick(&self->render_context, self->base.sample_rate, n / self->base.channel_count);
+        (void)synthio_block_slot_get(&self->render_context, &self->drive);
+        (void)synthio_block_slot_get(&self->render_context, &self->pre_gain);
+        (void)synthio_block_slot_get(&self->render_context, &self->post_gain);
+        (void)synthio_block_slot_get(&self->render_context, &self->mix);
+        if (self->sample == NULL) {
+            distortion_get_silence(self, buffer, buffer_length);
+        } else {
+            distortion_pass_through(self, buffer, buffer_length);
+        }
+        return GET_BUFFER_MORE_DATA;
+    }
+    self->base.silent = false;
+    self->buffer_silent = false;
+
     // Switch our buffers to the other buffer
     self->last_buf_idx = !self->last_buf_idx;
 
@@ -181,41 +257,17 @@ audioio_get_buffer_result_t audiofilters_distortion_get_buffer(audiofilters_dist
     // Loop over the entire length of our buffer to fill it, this may require several calls to get data from the sample
     while (length != 0) {
         // Check if there is no more sample to play, we will either load more data, reset the sample if loop is on or clear the sample
-        if (self->sample_buffer_length == 0) {
-            if (!self->more_data) { // The sample has indicated it has no more data to play
-                if (self->loop && self->sample) { // If we are supposed to loop reset the sample to the start
-                    audiosample_reset_buffer(self->sample, false, 0);
-                } else { // If we were not supposed to loop the sample, stop playing it
-                    self->sample = NULL;
-                }
-            }
-            if (self->sample) {
-                // Load another sample buffer to play
-                audioio_get_buffer_result_t result = audiosample_get_buffer(self->sample, false, 0, (uint8_t **)&self->sample_remaining_buffer, &self->sample_buffer_length);
-                // Track length in terms of words.
-                self->sample_buffer_length /= (self->base.bits_per_sample / 8);
-                self->more_data = result == GET_BUFFER_MORE_DATA;
-            }
-        }
+        distortion_load_sample_buffer(self);
 
         if (self->sample == NULL) {
-            if (self->base.samples_signed) {
-                memset(word_buffer, 0, length * (self->base.bits_per_sample / 8));
-            } else {
-                // For unsigned samples set to the middle which is "quiet"
-                if (MP_LIKELY(self->base.bits_per_sample == 16)) {
-                    memset(word_buffer, 32768, length * (self->base.bits_per_sample / 8));
-                } else {
-                    memset(hword_buffer, 128, length * (self->base.bits_per_sample / 8));
-                }
-            }
+            audiosample_fill_silence(&self->base, word_buffer, length * (self->base.bits_per_sample / 8));
 
             // tick all block inputs
-            shared_bindings_synthio_lfo_tick(self->base.sample_rate, length / self->base.channel_count);
-            (void)synthio_block_slot_get(&self->drive);
-            (void)synthio_block_slot_get(&self->pre_gain);
-            (void)synthio_block_slot_get(&self->post_gain);
-            (void)synthio_block_slot_get(&self->mix);
+            synthio_render_context_tick(&self->render_context, self->base.sample_rate, length / self->base.channel_count);
+            (void)synthio_block_slot_get(&self->render_context, &self->drive);
+            (void)synthio_block_slot_get(&self->render_context, &self->pre_gain);
+            (void)synthio_block_slot_get(&self->render_context, &self->post_gain);
+            (void)synthio_block_slot_get(&self->render_context, &self->mix);
 
             length = 0;
         } else {
@@ -227,11 +279,11 @@ audioio_get_buffer_result_t audiofilters_distortion_get_buffer(audiofilters_dist
             int8_t *sample_hsrc = (int8_t *)self->sample_remaining_buffer; // for 8-bit samples
 
             // get the effect values we need from the BlockInput. These may change at run time so you need to do bounds checking if required
-            shared_bindings_synthio_lfo_tick(self->base.sample_rate, n / self->base.channel_count);
-            mp_float_t drive = synthio_block_slot_get_limited(&self->drive, MICROPY_FLOAT_CONST(0.0), MICROPY_FLOAT_CONST(1.0));
-            mp_float_t pre_gain = db_to_linear(synthio_block_slot_get_limited(&self->pre_gain, MICROPY_FLOAT_CONST(-60.0), MICROPY_FLOAT_CONST(60.0)));
-            mp_float_t post_gain = db_to_linear(synthio_block_slot_get_limited(&self->post_gain, MICROPY_FLOAT_CONST(-80.0), MICROPY_FLOAT_CONST(24.0)));
-            mp_float_t mix = synthio_block_slot_get_limited(&self->mix, MICROPY_FLOAT_CONST(0.0), MICROPY_FLOAT_CONST(1.0));
+            synthio_render_context_tick(&self->render_context, self->base.sample_rate, n / self->base.channel_count);
+            mp_float_t drive = synthio_block_slot_get_limited(&self->render_context, &self->drive, MICROPY_FLOAT_CONST(0.0), MICROPY_FLOAT_CONST(1.0));
+            mp_float_t pre_gain = db_to_linear(synthio_block_slot_get_limited(&self->render_context, &self->pre_gain, MICROPY_FLOAT_CONST(-60.0), MICROPY_FLOAT_CONST(60.0)));
+            mp_float_t post_gain = db_to_linear(synthio_block_slot_get_limited(&self->render_context, &self->post_gain, MICROPY_FLOAT_CONST(-80.0), MICROPY_FLOAT_CONST(24.0)));
+            mp_float_t mix = synthio_block_slot_get_limited(&self->render_context, &self->mix, MICROPY_FLOAT_CONST(0.0), MICROPY_FLOAT_CONST(1.0));
 
             // Modify drive value depending on mode
             uint32_t word_mask = 0;
@@ -9,6 +9,7 @@
 
 #include "shared-bindings/audiofilters/Distortion.h"
 #include "shared-module/audiocore/__init__.h"
+#include "shared-module/synthio/__init__.h"
 #include "shared-module/synthio/block.h"
 
 typedef enum {
@@ -31,6 +32,7 @@ typedef struct {
 
     int8_t *buffer[2];
     uint8_t last_buf_idx;
+    bool buffer_silent; // buffer[last_buf_idx] holds silence
     uint32_t buffer_len; // max buffer in bytes
 
     uint8_t *sample_remaining_buffer;
@@ -40,6 +42,9 @@ typedef struct {
     bool more_data;
 
     mp_obj_t sample;
+    audiosample_converter_t converter; // to our format
+
+    synthio_render_context_t render_context;
 } audiofilters_distortion_obj_t;
 
 void audiofilters_distortion_reset_buffer(audiofilters_distortion_obj_t *self,
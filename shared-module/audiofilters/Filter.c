@@ -61,6 +61,7 @@ void common_hal_audiofilters_filter_deinit(audiofilters_filter_obj_t *self) {
     audiosample_mark_deinit(&self->base);
     self->buffer[0] = NULL;
     self->buffer[1] = NULL;
+    self->converter.scratch = NULL;
     self->filter = mp_const_none;
     self->filter_buffer = NULL;
     self->filter_states = NULL;
@@ -136,6 +137,7 @@ void audiofilters_filter_reset_buffer(audiofilters_filter_obj_t *self,
             synthio_biquad_filter_reset(&self->filter_states[i]);
         }
     }
+    self->buffer_silent = false;
 }
 
 bool common_hal_audiofilters_filter_get_playing(audiofilters_filter_obj_t *self) {
@@ -143,13 +145,13 @@ bool common_hal_audiofilters_filter_get_playing(audiofilters_filter_obj_t *self)
 }
 
 void common_hal_audiofilters_filter_play(audiofilters_filter_obj_t *self, mp_obj_t sample, bool loop) {
-    audiosample_must_match(&self->base, sample);
+    audiosample_converter_play(&self->converter, &self->base, sample, self->buffer_len);
 
     self->sample = sample;
     self->loop = loop;
 
     audiosample_reset_buffer(self->sample, false, 0);
-    audioio_get_buffer_result_t result = audiosample_get_buffer(self->sample, false, 0, (uint8_t **)&self->sample_remaining_buffer, &self->sample_buffer_length);
+    audioio_get_buffer_result_t result = audiosample_converter_get_buffer(&self->converter, self->sample, (uint8_t **)&self->sample_remaining_buffer, &self->sample_buffer_length);
 
     // Track remaining sample length in terms of bytes per sample
     self->sample_buffer_length /= (self->base.bits_per_sample / 8);
@@ -165,6 +167,54 @@ void common_hal_audiofilters_filter_stop(audiofilters_filter_obj_t *self) {
     return;
 }
 
+// Load the next buffer from the sample once the current one is used up. When
+// the sample has ended and isn't looping, it is cleared.
+static void filter_load_sample_buffer(audiofilters_filter_obj_t *self) {
+    if (self->sample_buffer_length != 0) {
+        return;
+    }
+    if (!self->more_data) { // The sample has indicated it has no more data to play
+        if (self->loop && self->sample) { // If we are supposed to loop reset the sample to the start
+            audiosample_reset_buffer(self->sample, false, 0);
+        } else { // If we were not supposed to loop the sample, stop playing it
+            self->sample = NULL;
+        }
+    }
+    if (self->sample) {
+        // Load another sample buffer to play
+        audioio_get_buffer_result_t result = audiosample_converter_get_buffer(&self->converter, self->sample, (uint8_t **)&self->sample_remaining_buffer, &self->sample_buffer_length);
+        // Track length in terms of words.
+        self->sample_buffer_length /= (self->base.bits_per_sample / 8);
+        self->more_data = result == GET_BUFFER_MORE_DATA;
+    }
+}
+
+// Return a buffer of silence. Once one of our buffers has been filled with
+// silence it is handed out again as is, until there is something to play.
+static void filter_get_silence(audiofilters_filter_obj_t *self, uint8_t **buffer, uint32_t *buffer_length) {
+    if (!self->buffer_silent) {
+        self->last_buf_idx = !self->last_buf_idx;
+        audiosample_fill_silence(&self->base, self->buffer[self->last_buf_idx], self->buffer_len);
+        self->buffer_silent = true;
+    }
+    *buffer = (uint8_t *)self->buffer[self->last_buf_idx];
+    *buffer_length = self->buffer_len;
+    self->base.silent = true;
+}
+
+// Hand out the rest of the current sample buffer, up to our buffer length,
+// without copying it. The sample double buffers, so it stays valid until the
+// sample is asked for its next buffer but one.
+static void filter_pass_through(audiofilters_filter_obj_t *self, uint8_t **buffer, uint32_t *buffer_length) {
+    uint32_t bytes_per_sample = self->base.bits_per_sample / 8;
+    uint32_t n = MIN(self->sample_buffer_length, self->buffer_len / bytes_per_sample);
+    *buffer = self->sample_remaining_buffer;
+    *buffer_length = n * bytes_per_sample;
+    self->sample_remaining_buffer += n * bytes_per_sample;
+    self->sample_buffer_length -= n;
+    self->base.silent = audiosample_get_silent(self->sample);
+}
+
 audioio_get_buffer_result_t audiofilters_filter_get_buffer(audiofilters_filter_obj_t *self, bool single_channel_output, uint8_t channel,
     uint8_t **buffer, uint32_t *buffer_length) {
     (void)channel;
@@ -173,6 +223,34 @@ audioio_get_buffer_result_t audiofilters_filter_get_buffer(audiofilters_filter_o
         channel = 0;
     }
 
+    // Skip the effect when it would not change anything: with no sample the
+    // output is silence, and with a mix of 0 or no filters the sample is
+    // handed out as is. mix is from the last block.
+    filter_load_sample_buffer(self);
+    mp_float_t last_mix = synthio_block_slot_get_limited(&self->render_context, &self->mix, MICROPY_FLOAT_CONST(0.0), MICROPY_FLOAT_CONST(1.0));
+    if (self->sample == NULL || (self->sample_buffer_length != 0 && (last_mix <= MICROPY_FLOAT_CONST(0.01) || !self->filter_states))) {
+        uint32_t n = self->buffer_len / (self->base.bits_per_sample / 8);
+        if (self->sample != NULL) {
+            n = MIN(self->sample_buffer_length, n);
+        }
+        // tick all block inputs
+        synthio_render_context_tick(&self->render_context, self->base.sample_rate, n / self->base.channel_count);
+        (void)synthio_block_slot_get(&self->render_context, &self->mix);
+
+        // Tick biquad filters
+        for (uint8_t j = 0; j < self->filter_states_len; j++) {
+            common_hal_synthio_biquad_tick(self->filter_objs[j], &self->render_context);
+        }
+        if (self->sample == NULL) {
+            filter_get_silence(self, buffer, buffer_length);
+        } else {
+            filter_pass_through(self, buffer, buffer_length);
+        }
+        return GET_BUFFER_MORE_DATA;
+    }
+    self->base.silent = false;
+    self->buffer_silent = false;
+
     // Switch our buffers to the other buffer
     self->last_buf_idx = !self->last_buf_idx;
 
@@ -184,45 +262,18 @@ audioio_get_buffer_result_t audiofilters_filter_get_buffer(audiofilters_filter_o
     // Loop over the entire length of our buffer to fill it, this may require several calls to get data from the sample
     while (length != 0) {
         // Check if there is no more sample to play, we will either load more data, reset the sample if loop is on or clear the sample
-        if (self->sample_buffer_length == 0) {
-            if (!self->more_data) { // The sample has indicated it has no more data to play
-                if (self->loop && self->sample) { // If we are supposed to loop reset the sample to the start
-                    audiosample_reset_buffer(self->sample, false, 0);
-                } else { // If we were not supposed to loop the sample, stop playing it
-                    self->sample = NULL;
-                }
-            }
-            if (self->sample) {
-                // Load another sample buffer to play
-                audioio_get_buffer_result_t result = audiosample_get_buffer(self->sample, false, 0, (uint8_t **)&self->sample_remaining_buffer, &self->sample_buffer_length);
-                // Track length in terms of words.
-                self->sample_buffer_length /= (self->base.bits_per_sample / 8);
-                self->more_data = result == GET_BUFFER_MORE_DATA;
-            }
-        }
+        filter_load_sample_buffer(self);
 
         if (self->sample == NULL) {
             // tick all block inputs
-            shared_bindings_synthio_lfo_tick(self->base.sample_rate, length / self->base.channel_count);
-            (void)synthio_block_slot_get(&self->mix);
+            synthio_render_context_tick(&self->render_context, self->base.sample_rate, length / self->base.channel_count);
+            (void)synthio_block_slot_get(&self->render_context, &self->mix);
 
             // Tick biquad filters
             for (uint8_t j = 0; j < self->filter_states_len; j++) {
-                common_hal_synthio_biquad_tick(self->filter_objs[j]);
-            }
-            if (self->base.samples_signed) {
-                memset(word_buffer, 0, length * (self->base.bits_per_sample / 8));
-            } else {
-                // For unsigned samples set to the middle which is "quiet"
-                if (MP_LIKELY(self->base.bits_per_sample == 16)) {
-                    uint16_t *uword_buffer = (uint16_t *)word_buffer;
-                    while (length--) {
-                        *uword_buffer++ = 32768;
-                    }
-                } else {
-                    memset(hword_buffer, 128, length * (self->base.bits_per_sample / 8));
-                }
+                common_hal_synthio_biquad_tick(self->filter_objs[j], &self->render_context);
             }
+            audiosample_fill_silence(&self->base, word_buffer, length * (self->base.bits_per_sample / 8));
 
             length = 0;
         } else {
@@ -234,8 +285,8 @@ audioio_get_buffer_result_t audiofilters_filter_get_buffer(audiofilters_filter_o
             int8_t *sample_hsrc = (int8_t *)self->sample_remaining_buffer; // for 8-bit samples
 
             // get the effect values we need from the BlockInput. These may change at run time so you need to do bounds checking if required
-            shared_bindings_synthio_lfo_tick(self->base.sample_rate, n / self->base.channel_count);
-            mp_float_t mix = synthio_block_slot_get_limited(&self->mix, MICROPY_FLOAT_CONST(0.0), MICROPY_FLOAT_CONST(1.0));
+            synthio_render_context_tick(&self->render_context, self->base.sample_rate, n / self->base.channel_count);
+            mp_float_t mix = synthio_block_slot_get_limited(&self->render_context, &self->mix, MICROPY_FLOAT_CONST(0.0), MICROPY_FLOAT_CONST(1.0));
 
             if (mix <= MICROPY_FLOAT_CONST(0.01) || !self->filter_states) { // if mix is zero pure sample only or no biquad filter objects are provided
                 for (uint32_t i = 0; i < n; i++) {
@@ -267,8 +318,8 @@ audioio_get_buffer_result_t audiofilters_filter_get_buffer(audiofilters_filter_o
                     // Process biquad filters
                     for (uint8_t j = 0; j < self->filter_states_len; j++) {
                         mp_obj_t filter_obj = self->filter_objs[j];
-                        common_hal_synthio_biquad_tick(filter_obj);
-                        synthio_biquad_filter_samples(filter_obj, &self->filter_states[j], self->filter_buffer, n_samples);
+                        common_hal_synthio_biquad_tick(filter_obj, &self->render_context);
+                        synthio_biquad_filter_samples(filter_obj, &self->filter_states[j], self->filter_buffer, n_samples, false);
                     }
 
                     // Mix processed signal with original sample and transfer to output buffer
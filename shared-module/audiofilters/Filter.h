@@ -26,6 +26,7 @@ typedef struct {
 
     int8_t *buffer[2];
     uint8_t last_buf_idx;
+    bool buffer_silent; // buffer[last_buf_idx] holds silence
     uint32_t buffer_len; // max buffer in bytes
 
     uint8_t *sample_remaining_buffer;
@@ -37,6 +38,9 @@ typedef struct {
     bool more_data;
 
     mp_obj_t sample;
+    audiosample_converter_t converter; // to our format
+
+    synthio_render_context_t render_context;
 } audiofilters_filter_obj_t;
 
 void audiofilters_filter_reset_buffer(audiofilters_filter_obj_t *self,
@@ -8,6 +8,7 @@
 // Fixed point ideas from - Paul Stoffregen in the Teensy audio library https://github.com/PaulStoffregen/Audio/blob/master/effect_freeverb.cpp
 //
 #include "shared-bindings/audiofreeverb/Freeverb.h"
+#include "shared-module/audiocore/delay_pool.h"
 
 #include <stdint.h>
 #include "py/runtime.h"
@@ -15,7 +16,7 @@
 
 void common_hal_audiofreeverb_freeverb_construct(audiofreeverb_freeverb_obj_t *self, mp_obj_t roomsize, mp_obj_t damp, mp_obj_t mix,
     uint32_t buffer_size, uint8_t bits_per_sample,
-    bool samples_signed, uint8_t channel_count, uint32_t sample_rate) {
+    bool samples_signed, uint8_t channel_count, uint32_t sample_rate, uint8_t quality, bool internal_memory) {
 
     // Basic settings every effect and audio sample has
     // These are the effects values, not the source sample(s)
@@ -75,43 +76,62 @@ void common_hal_audiofreeverb_freeverb_construct(audiofreeverb_freeverb_obj_t *s
     synthio_block_assign_slot(mix, &self->mix, MP_QSTR_mix);
     common_hal_audiofreeverb_freeverb_set_mix(self, mix);
 
-    // Set up the comb filters
-    // These values come from FreeVerb and are selected for the best reverb sound
-    self->combbuffersizes[0] = self->combbuffersizes[8] = 1116;
-    self->combbuffersizes[1] = self->combbuffersizes[9] = 1188;
-    self->combbuffersizes[2] = self->combbuffersizes[10] = 1277;
-    self->combbuffersizes[3] = self->combbuffersizes[11] = 1356;
-    self->combbuffersizes[4] = self->combbuffersizes[12] = 1422;
-    self->combbuffersizes[5] = self->combbuffersizes[13] = 1491;
-    self->combbuffersizes[6] = self->combbuffersizes[14] = 1557;
-    self->combbuffersizes[7] = self->combbuffersizes[15] = 1617;
-    for (uint32_t i = 0; i < 8 * channel_count; i++) {
-        self->combbuffers[i] = m_malloc_maybe(self->combbuffersizes[i] * sizeof(uint16_t));
-        if (self->combbuffers[i] == NULL) {
-            common_hal_audiofreeverb_freeverb_deinit(self);
-            m_malloc_fail(self->combbuffersizes[i]);
-        }
-        memset(self->combbuffers[i], 0, self->combbuffersizes[i]);
+    // Mono sources only have one bank and one set of allpasses at any quality
+    self->quality = quality;
+    self->comb_count = quality == 0 ? 4 : 8;
+    self->comb_banks = quality == 2 ? channel_count : 1;
+    self->allpass_sets = quality == 0 ? 1 : channel_count;
 
-        self->combbufferindex[i] = 0;
-        self->combfitlers[i] = 0;
+    // Set up the comb filters
+    // These values come from FreeVerb and are selected for the best reverb sound.
+    // The second bank is longer by FreeVerb's stereo spread of 23 samples.
+    static const int16_t comb_sizes[8] = { 1116, 1188, 1277, 1356, 1422, 1491, 1557, 1617 };
+    // quality 0 uses every other comb, so the delays stay spread out
+    static const int16_t comb_sizes_4[4] = { 1116, 1277, 1422, 1557 };
+    for (uint32_t j = 0; j < self->comb_count; j++) {
+        self->combbuffersizes[j] = self->comb_count == 4 ? comb_sizes_4[j] : comb_sizes[j];
+        self->combbuffersizes[j + 8] = self->combbuffersizes[j] + 23;
     }
 
     // Set up the allpass filters
     // These values come from FreeVerb and are selected for the best reverb sound
-    self->allpassbuffersizes[0] = self->allpassbuffersizes[4] = 556;
-    self->allpassbuffersizes[1] = self->allpassbuffersizes[5] = 441;
-    self->allpassbuffersizes[2] = self->allpassbuffersizes[6] = 341;
-    self->allpassbuffersizes[3] = self->allpassbuffersizes[7] = 225;
-    for (uint32_t i = 0; i < 4 * channel_count; i++) {
-        self->allpassbuffers[i] = m_malloc_maybe(self->allpassbuffersizes[i] * sizeof(uint16_t));
-        if (self->allpassbuffers[i] == NULL) {
-            common_hal_audiofreeverb_freeverb_deinit(self);
-            m_malloc_fail(self->allpassbuffersizes[i]);
+    static const int16_t allpass_sizes[4] = { 556, 441, 341, 225 };
+    for (uint32_t j = 0; j < 4; j++) {
+        self->allpassbuffersizes[j] = allpass_sizes[j];
+        self->allpassbuffersizes[j + 4] = allpass_sizes[j] + 23;
+    }
+
+    // Take all the delay lines from one block rather than one allocation each
+    size_t delay_lines_len = 0;
+    for (uint32_t b = 0; b < self->comb_banks; b++) {
+        for (uint32_t j = 0; j < self->comb_count; j++) {
+            delay_lines_len += self->combbuffersizes[b * 8 + j];
+        }
+    }
+    for (uint32_t s = 0; s < self->allpass_sets; s++) {
+        for (uint32_t j = 0; j < 4; j++) {
+            delay_lines_len += self->allpassbuffersizes[s * 4 + j];
+        }
+    }
+    self->internal_memory = internal_memory;
+    self->delay_lines_len = delay_lines_len * sizeof(int16_t);
+    self->delay_lines = audiocore_delay_pool_alloc(self->delay_lines_len, internal_memory);
+
+    int16_t *delay_line = self->delay_lines;
+    for (uint32_t b = 0; b < self->comb_banks; b++) {
+        for (uint32_t j = b * 8; j < b * 8 + self->comb_count; j++) {
+            self->combbuffers[j] = delay_line;
+            delay_line += self->combbuffersizes[j];
+
+            self->combbufferindex[j] = 0;
+            self->combfitlers[j] = 0;
         }
-        memset(self->allpassbuffers[i], 0, self->allpassbuffersizes[i]);
+    }
+    for (uint32_t j = 0; j < 4 * self->allpass_sets; j++) {
+        self->allpassbuffers[j] = delay_line;
+        delay_line += self->allpassbuffersizes[j];
 
-        self->allpassbufferindex[i] = 0;
+        self->allpassbufferindex[j] = 0;
     }
 }
 
@@ -126,8 +146,15 @@ void common_hal_audiofreeverb_freeverb_deinit(audiofreeverb_freeverb_obj_t *self
     if (common_hal_audiofreeverb_freeverb_deinited(self)) {
         return;
     }
+    audiocore_delay_pool_free(self->delay_lines, self->delay_lines_len, self->internal_memory);
+    self->delay_lines = NULL;
     self->buffer[0] = NULL;
     self->buffer[1] = NULL;
+    self->converter.scratch = NULL;
+}
+
+uint8_t common_hal_audiofreeverb_freeverb_get_quality(audiofreeverb_freeverb_obj_t *self) {
+    return self->quality;
 }
 
 mp_obj_t common_hal_audiofreeverb_freeverb_get_roomsize(audiofreeverb_freeverb_obj_t *self) {
@@ -194,13 +221,13 @@ bool common_hal_audiofreeverb_freeverb_get_playing(audiofreeverb_freeverb_obj_t
 }
 
 void common_hal_audiofreeverb_freeverb_play(audiofreeverb_freeverb_obj_t *self, mp_obj_t sample, bool loop) {
-    audiosample_must_match(&self->base, sample);
+    audiosample_converter_play(&self->converter, &self->base, sample, self->buffer_len);
 
     self->sample = sample;
     self->loop = loop;
 
     audiosample_reset_buffer(self->sample, false, 0);
-    audioio_get_buffer_result_t result = audiosample_get_buffer(self->sample, false, 0, (uint8_t **)&self->sample_remaining_buffer, &self->sample_buffer_length);
+    audioio_get_buffer_result_t result = audiosample_converter_get_buffer(&self->converter, self->sample, (uint8_t **)&self->sample_remaining_buffer, &self->sample_buffer_length);
 
     // Track remaining sample length in terms of bytes per sample
     self->sample_buffer_length /= (self->base.bits_per_sample / 8);
@@ -218,7 +245,9 @@ void common_hal_audiofreeverb_freeverb_stop(audiofreeverb_freeverb_obj_t *self)
 }
 
 // cleaner sat16 by http://www.moseleyinstruments.com/
-static int16_t sat16(int32_t n, int rshift) {
+// It is called several times per sample in each filter, so it must be inlined
+// even when optimizing for size.
+static inline MP_ALWAYSINLINE int16_t sat16(int32_t n, int rshift) {
     // we should always round towards 0
     // to avoid recirculating round-off noise
     //
@@ -238,6 +267,64 @@ static int16_t sat16(int32_t n, int rshift) {
     return n;
 }
 
+// Run one comb filter over a block of n samples, adding its output to sum.
+// The delay line wraps at most a few times per block, so the inner loop runs
+// over the stretches between wraps without checking the index.
+static void freeverb_comb_block(audiofreeverb_freeverb_obj_t *self, uint32_t j, const int16_t *input, int32_t *sum, uint32_t n,
+    int16_t feedback, int16_t damp1, int16_t damp2) {
+    int16_t *line = self->combbuffers[j];
+    uint32_t size = self->combbuffersizes[j];
+    uint32_t index = self->combbufferindex[j];
+    int16_t filter = self->combfitlers[j];
+
+    while (n) {
+        uint32_t run = MIN(n, size - index);
+        int16_t *p = line + index;
+        for (uint32_t i = 0; i < run; i++) {
+            int16_t bufout = p[i];
+            sum[i] += bufout;
+            filter = sat16(bufout * damp2 + filter * damp1, 15);
+            p[i] = sat16(input[i] + sat16(filter * feedback, 15), 0);
+        }
+        input += run;
+        sum += run;
+        n -= run;
+        index += run;
+        if (index == size) {
+            index = 0;
+        }
+    }
+
+    self->combbufferindex[j] = index;
+    self->combfitlers[j] = filter;
+}
+
+// Run one allpass filter over a block of n samples in place
+static void freeverb_allpass_block(audiofreeverb_freeverb_obj_t *self, uint32_t j, int16_t *samples, uint32_t n) {
+    int16_t *line = self->allpassbuffers[j];
+    uint32_t size = self->allpassbuffersizes[j];
+    uint32_t index = self->allpassbufferindex[j];
+
+    while (n) {
+        uint32_t run = MIN(n, size - index);
+        int16_t *p = line + index;
+        for (uint32_t i = 0; i < run; i++) {
+            int16_t bufout = p[i];
+            int16_t output = samples[i];
+            p[i] = output + (bufout >> 1); // bufout >> 1 same as bufout*0.5f
+            samples[i] = sat16(bufout - output, 1);
+        }
+        samples += run;
+        n -= run;
+        index += run;
+        if (index == size) {
+            index = 0;
+        }
+    }
+
+    self->allpassbufferindex[j] = index;
+}
+
 audioio_get_buffer_result_t audiofreeverb_freeverb_get_buffer(audiofreeverb_freeverb_obj_t *self, bool single_channel_output, uint8_t channel,
     uint8_t **buffer, uint32_t *buffer_length) {
 
@@ -261,7 +348,7 @@ audioio_get_buffer_result_t audiofreeverb_freeverb_get_buffer(audiofreeverb_free
             }
             if (self->sample) {
                 // Load another sample buffer to play
-                audioio_get_buffer_result_t result = audiosample_get_buffer(self->sample, false, 0, (uint8_t **)&self->sample_remaining_buffer, &self->sample_buffer_length);
+                audioio_get_buffer_result_t result = audiosample_converter_get_buffer(&self->converter, self->sample, (uint8_t **)&self->sample_remaining_buffer, &self->sample_buffer_length);
                 // Track length in terms of words.
                 self->sample_buffer_length /= (self->base.bits_per_sample / 8);
                 self->more_data = result == GET_BUFFER_MORE_DATA;
@@ -277,68 +364,78 @@ audioio_get_buffer_result_t audiofreeverb_freeverb_get_buffer(audiofreeverb_free
         }
 
         // get the effect values we need from the BlockInput. These may change at run time so you need to do bounds checking if required
-        shared_bindings_synthio_lfo_tick(self->base.sample_rate, n / self->base.channel_count);
-        mp_float_t damp = synthio_block_slot_get_limited(&self->damp, MICROPY_FLOAT_CONST(0.0), MICROPY_FLOAT_CONST(1.0));
+        synthio_render_context_tick(&self->render_context, self->base.sample_rate, n / self->base.channel_count);
+        mp_float_t damp = synthio_block_slot_get_limited(&self->render_context, &self->damp, MICROPY_FLOAT_CONST(0.0), MICROPY_FLOAT_CONST(1.0));
         int16_t damp1, damp2;
         audiofreeverb_freeverb_get_damp_fixedpoint(damp, &damp1, &damp2);
 
-        mp_float_t mix = synthio_block_slot_get_limited(&self->mix, MICROPY_FLOAT_CONST(0.0), MICROPY_FLOAT_CONST(1.0));
+        mp_float_t mix = synthio_block_slot_get_limited(&self->render_context, &self->mix, MICROPY_FLOAT_CONST(0.0), MICROPY_FLOAT_CONST(1.0));
         int16_t mix_sample, mix_effect;
         audiofreeverb_freeverb_get_mix_fixedpoint(mix, &mix_sample, &mix_effect);
 
-        mp_float_t roomsize = synthio_block_slot_get_limited(&self->roomsize, MICROPY_FLOAT_CONST(0.0), MICROPY_FLOAT_CONST(1.0));
+        mp_float_t roomsize = synthio_block_slot_get_limited(&self->render_context, &self->roomsize, MICROPY_FLOAT_CONST(0.0), MICROPY_FLOAT_CONST(1.0));
         int16_t feedback = audiofreeverb_freeverb_get_roomsize_fixedpoint(roomsize);
 
         int16_t *sample_src = (int16_t *)self->sample_remaining_buffer;
-
-        for (uint32_t i = 0; i < n; i++) {
-            int32_t sample_word = 0;
-            if (self->sample != NULL) {
-                sample_word = sample_src[i];
-            }
-
-            int32_t word, sum;
-            int16_t input, bufout, output;
-            uint32_t channel_comb_offset = 0, channel_allpass_offset = 0;
-
-            input = sat16(sample_word * 8738, 17); // Initial input scaled down so we can add reverb
-            sum = 0;
-
-            // Calculate each of the 8 comb buffers
-            for (uint32_t j = 0 + channel_comb_offset; j < 8 + channel_comb_offset; j++) {
-                bufout = self->combbuffers[j][self->combbufferindex[j]];
-                sum += bufout;
-                self->combfitlers[j] = sat16(bufout * damp2 + self->combfitlers[j] * damp1, 15);
-                self->combbuffers[j][self->combbufferindex[j]] = sat16(input + sat16(self->combfitlers[j] * feedback, 15), 0);
-                if (++self->combbufferindex[j] >= self->combbuffersizes[j]) {
-                    self->combbufferindex[j] = 0;
+        uint32_t channel_count = self->base.channel_count;
+        uint32_t frames = n / channel_count;
+
+        // The reverb runs a block at a time, one delay line after another,
+        // rather than visiting every delay line for each sample
+        int16_t input[SYNTHIO_MAX_DUR];
+        int32_t sum[SYNTHIO_MAX_DUR];
+        int16_t wet[2][SYNTHIO_MAX_DUR];
+        // 31457 = 0.24f with shift of 17; half as many combs need twice the gain
+        int comb_shift = self->comb_count == 4 ? 16 : 17;
+
+        for (uint32_t b = 0; b < self->comb_banks; b++) {
+            // Initial input scaled down so we can add reverb
+            if (self->sample == NULL) {
+                memset(input, 0, frames * sizeof(int16_t));
+            } else if (self->comb_banks == channel_count) {
+                for (uint32_t i = 0; i < frames; i++) {
+                    input[i] = sat16(sample_src[i * channel_count + b] * 8738, 17);
+                }
+            } else {
+                // one bank for all channels: feed it their average
+                for (uint32_t i = 0; i < frames; i++) {
+                    int32_t sample_word = 0;
+                    for (uint32_t c = 0; c < channel_count; c++) {
+                        sample_word += sample_src[i * channel_count + c];
+                    }
+                    input[i] = sat16(sample_word * 8738, 16 + channel_count);
                 }
             }
 
-            output = sat16(sum * 31457, 17); // 31457 = 0.24f with shift of 17
+            memset(sum, 0, frames * sizeof(int32_t));
+            for (uint32_t j = b * 8; j < b * 8 + self->comb_count; j++) {
+                freeverb_comb_block(self, j, input, sum, frames, feedback, damp1, damp2);
+            }
 
-            // Calculate each of the 4 all pass buffers
-            for (uint32_t j = 0 + channel_allpass_offset; j < 4 + channel_allpass_offset; j++) {
-                bufout = self->allpassbuffers[j][self->allpassbufferindex[j]];
-                self->allpassbuffers[j][self->allpassbufferindex[j]] = output + (bufout >> 1); // bufout >> 1 same as bufout*0.5f
-                output = sat16(bufout - output, 1);
-                if (++self->allpassbufferindex[j] >= self->allpassbuffersizes[j]) {
-                    self->allpassbufferindex[j] = 0;
+            // Each set of allpasses after one bank takes its output, the sets
+            // after a shared bank each take a copy
+            for (uint32_t s = b; s < self->allpass_sets; s += self->comb_banks) {
+                for (uint32_t i = 0; i < frames; i++) {
+                    wet[s][i] = sat16(sum[i] * 31457, comb_shift);
+                }
+                for (uint32_t j = s * 4; j < s * 4 + 4; j++) {
+                    freeverb_allpass_block(self, j, wet[s], frames);
                 }
             }
+        }
 
-            word = output * 30; // Add some volume back don't have to saturate as next step will
+        for (uint32_t i = 0; i < frames; i++) {
+            for (uint32_t c = 0; c < channel_count; c++) {
+                int32_t sample_word = 0;
+                if (self->sample != NULL) {
+                    sample_word = sample_src[i * channel_count + c];
+                }
 
-            word = sat16(sample_word * mix_sample, 15) + sat16(word * mix_effect, 15);
-            word = synthio_mix_down_sample(word, SYNTHIO_MIX_DOWN_SCALE(2));
-            word_buffer[i] = (int16_t)word;
+                int32_t word = wet[MIN(c, self->allpass_sets - 1u)][i] * 30; // Add some volume back don't have to saturate as next step will
 
-            if ((self->base.channel_count == 2) && (channel_comb_offset == 0)) {
-                channel_comb_offset = 8;
-                channel_allpass_offset = 4;
-            } else {
-                channel_comb_offset = 0;
-                channel_allpass_offset = 0;
+                word = sat16(sample_word * mix_sample, 15) + sat16(word * mix_effect, 15);
+                word = synthio_mix_down_sample(word, SYNTHIO_MIX_DOWN_SCALE(2));
+                word_buffer[i * channel_count + c] = (int16_t)word;
             }
         }
 
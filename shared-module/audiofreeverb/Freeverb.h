@@ -29,6 +29,15 @@ typedef struct {
     bool loop;
     bool more_data;
 
+    // quality 2 has a bank of 8 combs and a set of 4 allpasses per channel.
+    // Lower qualities share one bank between the channels, and quality 0 has
+    // a bank of 4 combs and one set of allpasses.
+    uint8_t quality;
+    uint8_t comb_count; // per bank
+    uint8_t comb_banks;
+    uint8_t allpass_sets;
+
+    // Comb j of bank b is at index b * 8 + j, allpass k of set s at s * 4 + k
     int16_t combbuffersizes[16];
     int16_t *combbuffers[16];
     int16_t combbufferindex[16];
@@ -38,7 +47,15 @@ typedef struct {
     int16_t *allpassbuffers[8];
     int16_t allpassbufferindex[8];
 
+    // All comb and allpass buffers, in one block from the shared delay pool
+    int16_t *delay_lines;
+    size_t delay_lines_len; // bytes
+    bool internal_memory;
+
     mp_obj_t sample;
+    audiosample_converter_t converter; // to our format
+
+    synthio_render_context_t render_context;
 } audiofreeverb_freeverb_obj_t;
 
 void audiofreeverb_freeverb_reset_buffer(audiofreeverb_freeverb_obj_t *self,
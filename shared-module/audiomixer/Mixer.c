@@ -8,15 +8,12 @@
 #include "shared-bindings/audiomixer/MixerVoice.h"
 
 #include <stdint.h>
+#include <string.h>
 
 #include "py/runtime.h"
 #include "shared-module/audiocore/__init__.h"
 #include "shared-bindings/audiocore/__init__.h"
 
-#if defined(__arm__) && __arm__
-#include "cmsis_compiler.h"
-#endif
-
 void common_hal_audiomixer_mixer_construct(audiomixer_mixer_obj_t *self,
     uint8_t voice_count,
     uint32_t buffer_size,
@@ -38,6 +35,12 @@ void common_hal_audiomixer_mixer_construct(audiomixer_mixer_obj_t *self,
         m_malloc_fail(self->len);
     }
 
+    self->mix_buffer = m_malloc(self->len / (bits_per_sample / 8) * sizeof(int32_t));
+    if (self->mix_buffer == NULL) {
+        common_hal_audiomixer_mixer_deinit(self);
+        m_malloc_fail(self->len / (bits_per_sample / 8) * sizeof(int32_t));
+    }
+
     self->base.bits_per_sample = bits_per_sample;
     self->base.samples_signed = samples_signed;
     self->base.channel_count = channel_count;
@@ -51,6 +54,7 @@ void common_hal_audiomixer_mixer_deinit(audiomixer_mixer_obj_t *self) {
     audiosample_mark_deinit(&self->base);
     self->first_buffer = NULL;
     self->second_buffer = NULL;
+    self->mix_buffer = NULL;
 }
 
 bool common_hal_audiomixer_mixer_get_playing(audiomixer_mixer_obj_t *self) {
@@ -70,93 +74,87 @@ void audiomixer_mixer_reset_buffer(audiomixer_mixer_obj_t *self,
     }
 }
 
-__attribute__((always_inline))
-static inline uint32_t add16signed(uint32_t a, uint32_t b) {
-    #if (defined(__ARM_ARCH_7EM__) && (__ARM_ARCH_7EM__ == 1))
-    return __QADD16(a, b);
-    #else
-    uint32_t result = 0;
-    for (int8_t i = 0; i < 2; i++) {
-        int16_t ai = a >> (sizeof(int16_t) * 8 * i);
-        int16_t bi = b >> (sizeof(int16_t) * 8 * i);
-        int32_t intermediate = (int32_t)ai + bi;
-        if (intermediate > SHRT_MAX) {
-            intermediate = SHRT_MAX;
-        } else if (intermediate < SHRT_MIN) {
-            intermediate = SHRT_MIN;
-        }
-        result |= (((uint32_t)intermediate) & 0xffff) << (sizeof(int16_t) * 8 * i);
+// Voices are summed into a 32-bit mix bus with no intermediate saturation, so
+// the result does not depend on voice order. The bus is brought back into
+// 16-bit range once, after all voices have been added, by mix_down_bus.
+//
+// The kernels below are plain loops over restrict-qualified arrays with no
+// data-dependent branches, so that the compiler can vectorise them.
+
+// src is signed 16 bit; level has 15 fractional bits
+static void mix_s16(int32_t *restrict bus, const int16_t *restrict src, uint32_t n, int32_t level) {
+    for (uint32_t i = 0; i < n; i++) {
+        bus[i] += (src[i] * level) >> 15;
     }
-    return result;
-    #endif
 }
 
-__attribute__((always_inline))
-static inline uint32_t mult16signed(uint32_t val, int32_t mul) {
-    #if (defined(__ARM_ARCH_7EM__) && (__ARM_ARCH_7EM__ == 1))
-    mul <<= 16;
-    int32_t hi, lo;
-    enum { bits = 16 }; // saturate to 16 bits
-    enum { shift = 15 }; // shift is done automatically
-    asm volatile ("smulwb %0, %1, %2" : "=r" (lo) : "r" (mul), "r" (val));
-    asm volatile ("smulwt %0, %1, %2" : "=r" (hi) : "r" (mul), "r" (val));
-    asm volatile ("ssat %0, %1, %2, asr %3" : "=r" (lo) : "I" (bits), "r" (lo), "I" (shift));
-    asm volatile ("ssat %0, %1, %2, asr %3" : "=r" (hi) : "I" (bits), "r" (hi), "I" (shift));
-    asm volatile ("pkhbt %0, %1, %2, lsl #16" : "=r" (val) : "r" (lo), "r" (hi)); // pack
-    return val;
-    #else
-    uint32_t result = 0;
-    float mod_mul = (float)mul / (float)((1 << 15) - 1);
-    for (int8_t i = 0; i < 2; i++) {
-        int16_t ai = (val >> (sizeof(uint16_t) * 8 * i));
-        int32_t intermediate = (int32_t)(ai * mod_mul);
-        if (intermediate > SHRT_MAX) {
-            intermediate = SHRT_MAX;
-        } else if (intermediate < SHRT_MIN) {
-            intermediate = SHRT_MIN;
-        }
-        intermediate &= 0x0000FFFF;
-        result |= (((uint32_t)intermediate)) << (sizeof(int16_t) * 8 * i);
+static void mix_u16(int32_t *restrict bus, const uint16_t *restrict src, uint32_t n, int32_t level) {
+    for (uint32_t i = 0; i < n; i++) {
+        bus[i] += ((int16_t)(src[i] ^ 0x8000) * level) >> 15;
     }
-    return result;
-    #endif
 }
 
-static inline uint32_t tounsigned8(uint32_t val) {
-    #if (defined(__ARM_ARCH_7EM__) && (__ARM_ARCH_7EM__ == 1))
-    return __UADD8(val, 0x80808080);
-    #else
-    return val ^ 0x80808080;
-    #endif
+// 8 bit samples are mixed as if they were the high byte of a 16 bit sample
+static void mix_s8(int32_t *restrict bus, const int8_t *restrict src, uint32_t n, int32_t level) {
+    for (uint32_t i = 0; i < n; i++) {
+        bus[i] += (src[i] * level) >> 7;
+    }
 }
 
-static inline uint32_t tounsigned16(uint32_t val) {
-    #if (defined(__ARM_ARCH_7EM__) && (__ARM_ARCH_7EM__ == 1))
-    return __UADD16(val, 0x80008000);
-    #else
-    return val ^ 0x80008000;
-    #endif
+static void mix_u8(int32_t *restrict bus, const uint8_t *restrict src, uint32_t n, int32_t level) {
+    for (uint32_t i = 0; i < n; i++) {
+        bus[i] += ((int8_t)(src[i] ^ 0x80) * level) >> 7;
+    }
 }
 
-static inline uint32_t tosigned16(uint32_t val) {
-    #if (defined(__ARM_ARCH_7EM__) && (__ARM_ARCH_7EM__ == 1))
-    return __UADD16(val, 0x80008000);
-    #else
-    return val ^ 0x80008000;
-    #endif
+// Downward compressor with a knee at +-MIX_DOWN_RANGE, in the same manner as
+// synthio_mix_down_sample. Above the knee the gain is reduced so that the
+// loudest possible sum of voice_count full-scale voices just fits in 16 bits.
+// The product (over * scale) is bounded by 2**28 by the choice of scale.
+#define MIX_DOWN_RANGE (28000)
+#define MIX_DOWN_SHIFT (16)
+
+static int32_t mix_down_scale(uint32_t voice_count) {
+    return 0xfffffff / (32768 * voice_count - MIX_DOWN_RANGE);
 }
 
-static inline uint32_t unpack8(uint16_t val) {
-    return ((val & 0xff00) << 16) | ((val & 0x00ff) << 8);
+static void limit_bus(int32_t *restrict bus, uint32_t n, int32_t scale) {
+    for (uint32_t i = 0; i < n; i++) {
+        int32_t v = bus[i];
+        int32_t over = v - MIN(MAX(v, -MIX_DOWN_RANGE), MIX_DOWN_RANGE);
+        v = v - over + ((over * scale) >> MIX_DOWN_SHIFT);
+        bus[i] = MIN(MAX(v, -32768), 32767);
+    }
 }
 
-static inline uint32_t pack8(uint32_t val) {
-    return ((val & 0xff000000) >> 16) | ((val & 0xff00) >> 8);
+// The limiter is set for all the voices the mixer was made with, whether or not
+// they are playing, so that the gain doesn't change as voices start and stop
+static void mix_down_bus(audiomixer_mixer_obj_t *self, void *buffer, uint32_t n) {
+    int32_t *bus = self->mix_buffer;
+    // A single voice at level <= 1.0 always fits, so leave it untouched
+    if (self->voice_count > 1) {
+        limit_bus(bus, n, mix_down_scale(self->voice_count));
+    }
+    if (self->base.bits_per_sample == 16) {
+        uint16_t *out = buffer;
+        uint16_t flip = self->base.samples_signed ? 0 : 0x8000;
+        for (uint32_t i = 0; i < n; i++) {
+            out[i] = (uint16_t)bus[i] ^ flip;
+        }
+    } else {
+        uint8_t *out = buffer;
+        uint8_t flip = self->base.samples_signed ? 0 : 0x80;
+        for (uint32_t i = 0; i < n; i++) {
+            out[i] = (uint8_t)(bus[i] >> 8) ^ flip;
+        }
+    }
 }
 
-static void mix_down_one_voice(audiomixer_mixer_obj_t *self,
-    audiomixer_mixervoice_obj_t *voice, bool voices_active,
-    uint32_t *word_buffer, uint32_t length) {
+// Returns whether anything audible was added to the bus
+static bool mix_down_one_voice(audiomixer_mixer_obj_t *self,
+    audiomixer_mixervoice_obj_t *voice, int32_t *bus, uint32_t length) {
+    bool audible = false;
+    uint32_t samples_per_word = sizeof(uint32_t) / (self->base.bits_per_sample / 8);
     while (length != 0) {
         if (voice->buffer_length == 0) {
             if (!voice->more_data) {
@@ -169,10 +167,11 @@ static void mix_down_one_voice(audiomixer_mixer_obj_t *self,
             }
             if (voice->sample) {
                 // Load another buffer
-                audioio_get_buffer_result_t result = audiosample_get_buffer(voice->sample, false, 0, (uint8_t **)&voice->remaining_buffer, &voice->buffer_length);
+                audioio_get_buffer_result_t result = audiosample_converter_get_buffer(&voice->converter, voice->sample, (uint8_t **)&voice->remaining_buffer, &voice->buffer_length);
                 // Track length in terms of words.
                 voice->buffer_length /= sizeof(uint32_t);
                 voice->more_data = result == GET_BUFFER_MORE_DATA;
+                voice->silent = audiosample_get_silent(voice->sample);
             }
         }
 
@@ -182,79 +181,36 @@ static void mix_down_one_voice(audiomixer_mixer_obj_t *self,
         uint32_t n = MIN(MIN(voice->buffer_length, length), SYNTHIO_MAX_DUR * self->base.channel_count);
 
         // Get the current level from the BlockInput. These may change at run time so you need to do bounds checking if required.
-        shared_bindings_synthio_lfo_tick(self->base.sample_rate, n / self->base.channel_count);
-        uint16_t level = (uint16_t)(synthio_block_slot_get_limited(&voice->level, MICROPY_FLOAT_CONST(0.0), MICROPY_FLOAT_CONST(1.0)) * (1 << 15));
+        synthio_render_context_tick(&self->render_context, self->base.sample_rate, n / self->base.channel_count);
+        int32_t level = (int32_t)(synthio_block_slot_get_limited(&self->render_context, &voice->level, MICROPY_FLOAT_CONST(0.0), MICROPY_FLOAT_CONST(1.0)) * (1 << 15));
         #else
         uint32_t n = MIN(voice->buffer_length, length);
-        uint16_t level = voice->level;
+        int32_t level = voice->level;
         #endif
 
-        // First active voice gets copied over verbatim.
-        if (!voices_active) {
-            if (MP_LIKELY(self->base.bits_per_sample == 16)) {
-                if (MP_LIKELY(self->base.samples_signed)) {
-                    for (uint32_t i = 0; i < n; i++) {
-                        uint32_t v = src[i];
-                        word_buffer[i] = mult16signed(v, level);
-                    }
-                } else {
-                    for (uint32_t i = 0; i < n; i++) {
-                        uint32_t v = src[i];
-                        v = tosigned16(v);
-                        word_buffer[i] = mult16signed(v, level);
-                    }
-                }
+        uint32_t n_samples = n * samples_per_word;
+        if (voice->silent || level == 0) {
+            // nothing to add
+        } else if (MP_LIKELY(self->base.bits_per_sample == 16)) {
+            if (MP_LIKELY(self->base.samples_signed)) {
+                mix_s16(bus, (const int16_t *)src, n_samples, level);
             } else {
-                uint16_t *hword_buffer = (uint16_t *)word_buffer;
-                uint16_t *hsrc = (uint16_t *)src;
-                for (uint32_t i = 0; i < n * 2; i++) {
-                    uint32_t word = unpack8(hsrc[i]);
-                    if (MP_LIKELY(!self->base.samples_signed)) {
-                        word = tosigned16(word);
-                    }
-                    word = mult16signed(word, level);
-                    hword_buffer[i] = pack8(word);
-                }
+                mix_u16(bus, (const uint16_t *)src, n_samples, level);
             }
         } else {
-            if (MP_LIKELY(self->base.bits_per_sample == 16)) {
-                if (MP_LIKELY(self->base.samples_signed)) {
-                    for (uint32_t i = 0; i < n; i++) {
-                        uint32_t word = src[i];
-                        word_buffer[i] = add16signed(mult16signed(word, level), word_buffer[i]);
-                    }
-                } else {
-                    for (uint32_t i = 0; i < n; i++) {
-                        uint32_t word = src[i];
-                        word = tosigned16(word);
-                        word_buffer[i] = add16signed(mult16signed(word, level), word_buffer[i]);
-                    }
-                }
+            if (self->base.samples_signed) {
+                mix_s8(bus, (const int8_t *)src, n_samples, level);
             } else {
-                uint16_t *hword_buffer = (uint16_t *)word_buffer;
-                uint16_t *hsrc = (uint16_t *)src;
-                for (uint32_t i = 0; i < n * 2; i++) {
-                    uint32_t word = unpack8(hsrc[i]);
-                    if (MP_LIKELY(!self->base.samples_signed)) {
-                        word = tosigned16(word);
-                    }
-                    word = mult16signed(word, level);
-                    word = add16signed(word, unpack8(hword_buffer[i]));
-                    hword_buffer[i] = pack8(word);
-                }
+                mix_u8(bus, (const uint8_t *)src, n_samples, level);
             }
         }
+        audible |= !voice->silent && level != 0;
         length -= n;
-        word_buffer += n;
+        bus += n_samples;
         voice->remaining_buffer += n;
         voice->buffer_length -= n;
     }
-
-    if (length && !voices_active) {
-        for (uint32_t i = 0; i < length; i++) {
-            word_buffer[i] = 0;
-        }
-    }
+    return audible;
 }
 
 audioio_get_buffer_result_t audiomixer_mixer_get_buffer(audiomixer_mixer_obj_t *self,
@@ -283,34 +239,24 @@ audioio_get_buffer_result_t audiomixer_mixer_get_buffer(audiomixer_mixer_obj_t *
             word_buffer = self->second_buffer;
         }
         self->use_first_buffer = !self->use_first_buffer;
-        bool voices_active = false;
+        bool audible = false;
         uint32_t length = self->len / sizeof(uint32_t);
+        uint32_t n_samples = self->len / (self->base.bits_per_sample / 8);
 
+        memset(self->mix_buffer, 0, n_samples * sizeof(int32_t));
         for (int32_t v = 0; v < self->voice_count; v++) {
             audiomixer_mixervoice_obj_t *voice = MP_OBJ_TO_PTR(self->voice[v]);
             if (voice->sample) {
-                mix_down_one_voice(self, voice, voices_active, word_buffer, length);
-                voices_active = true;
+                audible |= mix_down_one_voice(self, voice, self->mix_buffer, length);
             }
         }
 
-        if (!voices_active) {
-            for (uint32_t i = 0; i < length; i++) {
-                word_buffer[i] = 0;
-            }
-        }
-
-        if (!self->base.samples_signed) {
-            if (self->base.bits_per_sample == 16) {
-                for (uint32_t i = 0; i < length; i++) {
-                    word_buffer[i] = tounsigned16(word_buffer[i]);
-                }
-            } else {
-                for (uint32_t i = 0; i < length; i++) {
-                    word_buffer[i] = tounsigned8(word_buffer[i]);
-                }
-            }
+        if (audible) {
+            mix_down_bus(self, word_buffer, n_samples);
+        } else {
+            audiosample_fill_silence(&self->base, word_buffer, self->len);
         }
+        self->base.silent = !audible;
 
         self->read_count += 1;
     } else if (!self->use_first_buffer) {
@@ -10,18 +10,26 @@
 #include "py/objtuple.h"
 
 #include "shared-module/audiocore/__init__.h"
+#if CIRCUITPY_SYNTHIO
+#include "shared-module/synthio/__init__.h"
+#endif
 
 typedef struct {
     audiosample_base_t base;
     uint32_t *first_buffer;
     uint32_t *second_buffer;
-    uint32_t len; // in words
+    int32_t *mix_buffer; // one 32-bit accumulator per output sample
+    uint32_t len; // in bytes
     bool use_first_buffer;
 
     uint32_t read_count;
     uint32_t left_read_count;
     uint32_t right_read_count;
 
+    #if CIRCUITPY_SYNTHIO
+    synthio_render_context_t render_context;
+    #endif
+
     uint8_t voice_count;
     mp_obj_tuple_t *voice_tuple;
     mp_obj_t voice[];
@@ -47,17 +47,18 @@ void common_hal_audiomixer_mixervoice_set_loop(audiomixer_mixervoice_obj_t *self
 }
 
 void common_hal_audiomixer_mixervoice_play(audiomixer_mixervoice_obj_t *self, mp_obj_t sample_in, bool loop) {
-    audiosample_must_match(&self->parent->base, sample_in);
-    // cast is safe, checked by must_match
+    audiosample_converter_play(&self->converter, &self->parent->base, sample_in, self->parent->len);
+    // cast is safe, checked by audiosample_converter_play
     audiosample_base_t *sample = MP_OBJ_TO_PTR(sample_in);
     self->sample = sample;
     self->loop = loop;
 
     audiosample_reset_buffer(sample, false, 0);
-    audioio_get_buffer_result_t result = audiosample_get_buffer(sample, false, 0, (uint8_t **)&self->remaining_buffer, &self->buffer_length);
+    audioio_get_buffer_result_t result = audiosample_converter_get_buffer(&self->converter, sample, (uint8_t **)&self->remaining_buffer, &self->buffer_length);
     // Track length in terms of words.
     self->buffer_length /= sizeof(uint32_t);
     self->more_data = result == GET_BUFFER_MORE_DATA;
+    self->silent = sample->silent;
 }
 
 bool common_hal_audiomixer_mixervoice_get_playing(audiomixer_mixervoice_obj_t *self) {
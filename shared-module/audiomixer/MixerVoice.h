@@ -17,10 +17,12 @@ typedef struct {
     mp_obj_base_t base;
     audiomixer_mixer_obj_t *parent;
     mp_obj_t sample;
+    audiosample_converter_t converter; // to the mixer's format
     bool loop;
     bool more_data;
     uint32_t *remaining_buffer;
     uint32_t buffer_length;
+    bool silent; // remaining_buffer is silence
     #if CIRCUITPY_SYNTHIO
     synthio_block_slot_t level;
     #else
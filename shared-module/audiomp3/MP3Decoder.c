@@ -15,9 +15,11 @@
 #include <unistd.h>
 
 #include "py/mperrno.h"
+#include "py/mphal.h"
 #include "py/runtime.h"
 #include "py/stream.h"
 
+#include "shared-bindings/time/__init__.h"
 #include "shared-module/audiomp3/MP3Decoder.h"
 #include "supervisor/background_callback.h"
 #include "lib/mp3/src/mp3common.h"
@@ -30,9 +32,31 @@
 #if defined(MICROPY_UNIX_COVERAGE)
 #define background_callback_prevent() ((void)0)
 #define background_callback_allow() ((void)0)
-#define background_callback_add(buf, fn, arg) ((fn)((arg)))
+#define common_hal_time_monotonic_ns() ((uint64_t)mp_hal_ticks_us() * 1000)
+
+// There are no background tasks here, so a callback runs as soon as it is
+// added. One that adds itself again would only run on a later pass through
+// the background tasks, so that is dropped, which keeps tests deterministic.
+static background_callback_t *coverage_callback_running;
+
+static void coverage_callback_add(background_callback_t *cb, background_callback_fun fun, void *data) {
+    if (cb == coverage_callback_running) {
+        return;
+    }
+    background_callback_t *outer = coverage_callback_running;
+    coverage_callback_running = cb;
+    fun(data);
+    coverage_callback_running = outer;
+}
+#define background_callback_add coverage_callback_add
 #endif
 
+#define RING_SLOT(self, n) ((self)->ring + ((n) % (self)->ring_count) * (MAX_BUFFER_LEN / sizeof(int16_t)))
+#define RING_AVAILABLE(self) ((self)->ring_write - (self)->ring_read)
+
+// Initial spacing, in frames, of the seek index (about 0.4s at 44.1kHz)
+#define INDEX_INTERVAL (16)
+
 static bool stream_readable(void *stream) {
     int errcode = 0;
     mp_obj_base_t *o = MP_OBJ_TO_PTR(stream);
@@ -153,6 +177,7 @@ static bool mp3file_update_inbuf_always(audiomp3_mp3file_obj_t *self, bool block
         }
 
         self->inbuf.write_off += n_read;
+        self->stream_pos += n_read;
     }
 
     if (DO_DEBUG) {
@@ -176,14 +201,12 @@ static void mp3file_update_inbuf_cb(void *self_in) {
         mp3file_update_inbuf_always(self, false);
     }
 
-    #if !defined(MICROPY_UNIX_COVERAGE)
     if (!self->eof && INPUT_BUFFER_SPACE(self->inbuf) > 512) {
         background_callback_add(
             &self->inbuf_fill_cb,
             mp3file_update_inbuf_cb,
             self);
     }
-    #endif
 }
 
 /** Fill the input buffer if it is less than half full.
@@ -234,7 +257,8 @@ static void mp3file_skip_id3v2(audiomp3_mp3file_obj_t *self, bool block_ok) {
     size -= to_consume;
 
     // Next, seek in the file after the header
-    if (stream_lseek(self->stream, SEEK_CUR, size) == 0) {
+    if (stream_lseek(self->stream, size, SEEK_CUR) >= 0) {
+        self->stream_pos += size;
         return;
     }
 
@@ -277,13 +301,265 @@ static bool mp3file_get_next_frame_info(audiomp3_mp3file_obj_t *self, MP3FrameIn
     return err == ERR_MP3_NONE;
 }
 
+static uint32_t mp3file_read_be(const uint8_t *data, size_t len) {
+    uint32_t value = 0;
+    while (len--) {
+        value = (value << 8) | *data++;
+    }
+    return value;
+}
+
+// Layer III frame length in bytes, including the header
+static uint32_t mp3file_frame_length(const MP3FrameInfo *fi, const uint8_t *header) {
+    uint32_t slots = fi->version == MPEG1 ? 144 : 72;
+    return slots * fi->bitrate / fi->samprate + ((header[2] >> 1) & 1);
+}
+
+// Record the frame at the read pointer in the seek index if it falls on the
+// index spacing. The index only covers frames whose number is known exactly.
+static void mp3file_index_frame(audiomp3_mp3file_obj_t *self) {
+    if (!self->frame_exact || self->frame_number != self->index_len * self->index_interval) {
+        return;
+    }
+    if (self->index_len == MP3_SEEK_INDEX_LEN) {
+        for (size_t i = 0; i < MP3_SEEK_INDEX_LEN / 2; i++) {
+            self->index[i] = self->index[2 * i];
+        }
+        self->index_len = MP3_SEEK_INDEX_LEN / 2;
+        self->index_interval *= 2;
+    }
+    self->index[self->index_len++] = self->stream_pos - BYTES_LEFT(self);
+}
+
+// A file without a Xing or VBRI header is taken to have a constant bitrate
+// until a frame with another one turns up. Checks the frame at the read
+// pointer, and returns whether the bitrate is still taken to be constant.
+static bool mp3file_check_bitrate(audiomp3_mp3file_obj_t *self) {
+    MP3FrameInfo fi;
+    if (self->cbr_bitrate != 0 && BYTES_LEFT(self) >= 4
+        && MP3GetNextFrameInfo(self->decoder, &fi, READ_PTR(self)) == ERR_MP3_NONE
+        && fi.bitrate != 0 && (uint32_t)fi.bitrate != self->cbr_bitrate) {
+        self->cbr_bitrate = 0;
+    }
+    return self->cbr_bitrate != 0;
+}
+
+static void mp3file_restart_index(audiomp3_mp3file_obj_t *self) {
+    self->frame_number = 0;
+    self->frame_exact = true;
+    self->index_len = 0;
+    self->index_interval = INDEX_INTERVAL;
+    mp3file_index_frame(self);
+}
+
+// The first frame of a VBR file usually carries a Xing (or, for CBR, Info)
+// header with the total frame and byte counts and a 100-entry table mapping
+// percent of duration to 1/256ths of the file size. Returns true if there is
+// a table or the header is a Xing one.
+static bool mp3file_parse_xing(audiomp3_mp3file_obj_t *self, const MP3FrameInfo *fi) {
+    size_t side_info_size;
+    if (fi->version == MPEG1) {
+        side_info_size = fi->nChans == 1 ? 17 : 32;
+    } else {
+        side_info_size = fi->nChans == 1 ? 9 : 17;
+    }
+    size_t offset = 4 + side_info_size;
+    if (BYTES_LEFT(self) < (mp_int_t)(offset + 16 + sizeof(self->toc))) {
+        return false;
+    }
+    const uint8_t *data = READ_PTR(self) + offset;
+    bool xing = memcmp(data, "Xing", 4) == 0;
+    if (!xing && memcmp(data, "Info", 4) != 0) {
+        return false;
+    }
+    uint32_t flags = mp3file_read_be(data + 4, 4);
+    data += 8;
+    uint32_t frames = 0, bytes = 0;
+    if (flags & 1) {
+        frames = mp3file_read_be(data, 4);
+        data += 4;
+    }
+    if (flags & 2) {
+        bytes = mp3file_read_be(data, 4);
+        data += 4;
+    }
+    if (!(flags & 4) || frames == 0 || bytes == 0) {
+        return xing;
+    }
+    memcpy(self->toc, data, sizeof(self->toc));
+    self->toc_frames = frames;
+    self->toc_bytes = bytes;
+    return true;
+}
+
+// Fraunhofer encoders put a VBRI header 32 bytes into the first frame's data
+// instead. Its table has one entry per fixed number of frames, holding the
+// size of those frames; it is turned into a Xing style table here. The
+// entries describe the frames after the header frame. Returns true if there
+// is a VBRI header, even if its table didn't fit in the input buffer.
+static bool mp3file_parse_vbri(audiomp3_mp3file_obj_t *self, const MP3FrameInfo *fi) {
+    const size_t offset = 4 + 32;
+    if (BYTES_LEFT(self) < (mp_int_t)(offset + 26)) {
+        return false;
+    }
+    const uint8_t *data = READ_PTR(self) + offset;
+    if (memcmp(data, "VBRI", 4) != 0) {
+        return false;
+    }
+    uint32_t frames = mp3file_read_be(data + 14, 4);
+    uint32_t n_entries = mp3file_read_be(data + 18, 2);
+    uint32_t scale = mp3file_read_be(data + 20, 2);
+    uint32_t entry_size = mp3file_read_be(data + 22, 2);
+    uint32_t frames_per_entry = mp3file_read_be(data + 24, 2);
+    const uint8_t *entries = data + 26;
+    if (frames == 0 || n_entries == 0 || entry_size < 1 || entry_size > 4 || frames_per_entry == 0 ||
+        BYTES_LEFT(self) < (mp_int_t)(offset + 26 + n_entries * entry_size)) {
+        return true;
+    }
+    uint32_t header_bytes = mp3file_frame_length(fi, READ_PTR(self));
+    uint64_t bytes = header_bytes;
+    for (size_t i = 0; i < n_entries; i++) {
+        bytes += (uint64_t)mp3file_read_be(entries + i * entry_size, entry_size) * scale;
+    }
+    // Frame 0 is the header frame; frame f > 0 starts after the header frame
+    // and the first f - 1 frames in the table.
+    self->toc_frames = frames + 1;
+    self->toc_bytes = bytes;
+    uint64_t before = header_bytes;
+    size_t entry = 0;
+    for (size_t i = 0; i < sizeof(self->toc); i++) {
+        uint64_t frame = (uint64_t)i * self->toc_frames / 100;
+        uint64_t position = 0;
+        if (frame > 0) {
+            while (entry < n_entries && (entry + 1) * frames_per_entry <= frame - 1) {
+                before += (uint64_t)mp3file_read_be(entries + entry * entry_size, entry_size) * scale;
+                entry++;
+            }
+            position = before;
+            if (entry < n_entries) {
+                uint64_t entry_bytes = (uint64_t)mp3file_read_be(entries + entry * entry_size, entry_size) * scale;
+                position += entry_bytes * (frame - 1 - entry * frames_per_entry) / frames_per_entry;
+            }
+        }
+        self->toc[i] = MIN(position * 256 / bytes, 255);
+    }
+    return true;
+}
+
+// Looks for a table of contents in the first frame, which is at the read
+// pointer. A file without a header that says its bitrate varies is taken to
+// have a constant bitrate.
+static void mp3file_parse_toc(audiomp3_mp3file_obj_t *self, const MP3FrameInfo *fi) {
+    self->toc_start = self->stream_pos - BYTES_LEFT(self);
+    self->toc_frames = 0;
+    self->cbr_bitrate = 0;
+    if (!mp3file_parse_xing(self, fi) && !mp3file_parse_vbri(self, fi)) {
+        self->cbr_bitrate = fi->bitrate;
+    }
+}
+
+static void mp3file_flush_ring(audiomp3_mp3file_obj_t *self) {
+    self->ring_read = self->ring_write = 0;
+    self->decode_done = false;
+    self->decode_error = false;
+}
+
+/** Decode the next frame into buffer.
+ *
+ * *buffer_length is set to 0 if no frame could be produced.  Returns
+ * GET_BUFFER_DONE if there is no further frame in the stream.
+ */
+static audioio_get_buffer_result_t mp3file_decode_frame(audiomp3_mp3file_obj_t *self, int16_t *buffer, uint32_t *buffer_length) {
+    size_t frame_buffer_size_bytes = self->base.max_buffer_length;
+    *buffer_length = frame_buffer_size_bytes;
+
+    mp3file_skip_id3v2(self, false);
+    if (!mp3file_find_sync_word(self, false)) {
+        memset(buffer, 0, frame_buffer_size_bytes);
+        *buffer_length = 0;
+        return self->eof ? GET_BUFFER_DONE : GET_BUFFER_ERROR;
+    }
+    mp3file_index_frame(self);
+    mp3file_check_bitrate(self);
+    int bytes_left = BYTES_LEFT(self);
+    uint8_t *inbuf = READ_PTR(self);
+    uint64_t start = common_hal_time_monotonic_ns();
+    int err = MP3Decode(self->decoder, &inbuf, &bytes_left, buffer, 0);
+    self->decode_time_ns = common_hal_time_monotonic_ns() - start;
+    if (err != ERR_MP3_INDATA_UNDERFLOW) {
+        CONSUME(self, BYTES_LEFT(self) - bytes_left);
+        self->frame_number++;
+    }
+    if (err) {
+        memset(buffer, 0, frame_buffer_size_bytes);
+        if (DO_DEBUG) {
+            mp_printf(&mp_plat_print, "%s:%d err=%d\n", __FILE__, __LINE__, err);
+        }
+        if (self->eof || (err != ERR_MP3_INDATA_UNDERFLOW && err != ERR_MP3_MAINDATA_UNDERFLOW)) {
+            *buffer_length = 0;
+            self->eof = true;
+            return GET_BUFFER_ERROR;
+        }
+    }
+
+    mp3file_skip_id3v2(self, false);
+    audioio_get_buffer_result_t result = mp3file_find_sync_word(self, false) ? GET_BUFFER_MORE_DATA : GET_BUFFER_DONE;
+
+    if (DO_DEBUG) {
+        mp_printf(&mp_plat_print, "%s:%d result=%d\n", __FILE__, __LINE__, result);
+    }
+    if (INPUT_BUFFER_SPACE(self->inbuf) > 512) {
+        background_callback_add(
+            &self->inbuf_fill_cb,
+            mp3file_update_inbuf_cb,
+            self);
+    }
+
+    if (DO_DEBUG) {
+        mp_printf(&mp_plat_print, "post-decode avail=%d eof=%d\n", (int)INPUT_BUFFER_AVAILABLE(self->inbuf), self->eof);
+    }
+    return result;
+}
+
+/** Decode one frame into the ring from a background callback.
+ *
+ * Re-queue until the ring holds ring_count - 2 frames; the two remaining
+ * slots are the ones most recently handed out by get_buffer.
+ */
+static void mp3file_decode_cb(void *self_in) {
+    audiomp3_mp3file_obj_t *self = self_in;
+    if (audiosample_deinited(&self->base) || !self->ring) {
+        return;
+    }
+    if (self->decode_done || RING_AVAILABLE(self) >= self->ring_count - 2) {
+        return;
+    }
+    uint32_t length;
+    audioio_get_buffer_result_t result = mp3file_decode_frame(self, RING_SLOT(self, self->ring_write), &length);
+    if (length) {
+        self->ring_write++;
+    }
+    if (result != GET_BUFFER_MORE_DATA) {
+        self->decode_done = true;
+        self->decode_error = result == GET_BUFFER_ERROR;
+        return;
+    }
+    if (RING_AVAILABLE(self) < self->ring_count - 2) {
+        background_callback_add(
+            &self->decode_cb,
+            mp3file_decode_cb,
+            self);
+    }
+}
+
 #define DEFAULT_INPUT_BUFFER_SIZE (2048)
 #define MIN_USER_BUFFER_SIZE (DEFAULT_INPUT_BUFFER_SIZE + 2 * MAX_BUFFER_LEN)
 
 void common_hal_audiomp3_mp3file_construct(audiomp3_mp3file_obj_t *self,
     mp_obj_t stream,
     uint8_t *buffer,
-    size_t buffer_size) {
+    size_t buffer_size,
+    uint32_t frames_ahead) {
     // Note: Adafruit_MP3 uses a 2kB input buffer and two 4kB output pcm_buffer.
     // for a whopping total of 10kB pcm_buffer (+mp3 decoder state and frame buffer)
     // At 44kHz, that's 23ms of output audio data.
@@ -298,7 +574,28 @@ void common_hal_audiomp3_mp3file_construct(audiomp3_mp3file_obj_t *self,
         buffer += 1;
         buffer_size -= 1;
     }
-    if (buffer && buffer_size > MIN_USER_BUFFER_SIZE) {
+    if (frames_ahead) {
+        // Decoded frames go to the ring, so the whole user buffer (if any)
+        // holds undecoded data.
+        self->ring_count = frames_ahead + 2;
+        size_t ring_size = self->ring_count * MAX_BUFFER_LEN;
+        self->ring = m_malloc_maybe(ring_size);
+        if (self->ring == NULL) {
+            common_hal_audiomp3_mp3file_deinit(self);
+            m_malloc_fail(ring_size);
+        }
+        if (buffer && buffer_size >= DEFAULT_INPUT_BUFFER_SIZE) {
+            self->inbuf.buf = buffer;
+            self->inbuf.size = buffer_size;
+        } else {
+            self->inbuf.size = DEFAULT_INPUT_BUFFER_SIZE;
+            self->inbuf.buf = m_malloc(DEFAULT_INPUT_BUFFER_SIZE);
+            if (self->inbuf.buf == NULL) {
+                common_hal_audiomp3_mp3file_deinit(self);
+                m_malloc_fail(DEFAULT_INPUT_BUFFER_SIZE);
+            }
+        }
+    } else if (buffer && buffer_size > MIN_USER_BUFFER_SIZE) {
         self->pcm_buffer[0] = (int16_t *)(void *)buffer;
         self->pcm_buffer[1] = (int16_t *)(void *)(buffer + MAX_BUFFER_LEN);
         self->inbuf.buf = buffer + 2 * MAX_BUFFER_LEN;
@@ -348,20 +645,29 @@ void common_hal_audiomp3_mp3file_set_file(audiomp3_mp3file_obj_t *self, mp_obj_t
 
     INPUT_BUFFER_CLEAR(self->inbuf);
     self->eof = 0;
+    off_t stream_pos = stream_lseek(stream, 0, SEEK_CUR);
+    self->stream_pos = stream_pos < 0 ? 0 : stream_pos;
 
     self->block_ok = false;
     stream_set_blocking(self, true);
 
     self->other_channel = -1;
+    mp3file_flush_ring(self);
+    self->underruns = 0;
+    self->decode_time_ns = 0;
     mp3file_update_inbuf_half(self, true);
+    mp3file_skip_id3v2(self, true);
     mp3file_find_sync_word(self, true);
+    mp3file_restart_index(self);
     // It **SHOULD** not be necessary to do this; the buffer should be filled
     // with fresh content before it is returned by get_buffer().  The fact that
     // this is necessary to avoid a glitch at the start of playback of a second
     // track using the same decoder object means there's still a bug in
     // get_buffer() that I didn't understand.
-    memset(self->pcm_buffer[0], 0, MAX_BUFFER_LEN);
-    memset(self->pcm_buffer[1], 0, MAX_BUFFER_LEN);
+    if (!self->ring) {
+        memset(self->pcm_buffer[0], 0, MAX_BUFFER_LEN);
+        memset(self->pcm_buffer[1], 0, MAX_BUFFER_LEN);
+    }
 
     /* important to do this - DSP primitives assume a bunch of state variables are 0 on first use */
     struct _MP3DecInfo *decoder = self->decoder;
@@ -375,6 +681,9 @@ void common_hal_audiomp3_mp3file_set_file(audiomp3_mp3file_obj_t *self, mp_obj_t
 
     MP3FrameInfo fi;
     bool result = mp3file_get_next_frame_info(self, &fi, true);
+    if (result) {
+        mp3file_parse_toc(self, &fi);
+    }
     background_callback_allow();
     if (!result) {
         mp_raise_msg(&mp_type_RuntimeError,
@@ -389,6 +698,13 @@ void common_hal_audiomp3_mp3file_set_file(audiomp3_mp3file_obj_t *self, mp_obj_t
     self->base.max_buffer_length = fi.outputSamps * sizeof(int16_t);
     self->len = 2 * self->base.max_buffer_length;
     self->samples_decoded = 0;
+
+    if (self->ring) {
+        background_callback_add(
+            &self->decode_cb,
+            mp3file_decode_cb,
+            self);
+    }
 }
 
 void common_hal_audiomp3_mp3file_deinit(audiomp3_mp3file_obj_t *self) {
@@ -400,6 +716,7 @@ void common_hal_audiomp3_mp3file_deinit(audiomp3_mp3file_obj_t *self) {
     self->inbuf.buf = NULL;
     self->pcm_buffer[0] = NULL;
     self->pcm_buffer[1] = NULL;
+    self->ring = NULL;
     self->stream = mp_const_none;
     self->settimeout_args[0] = MP_OBJ_NULL;
     self->samples_decoded = 0;
@@ -414,15 +731,24 @@ void audiomp3_mp3file_reset_buffer(audiomp3_mp3file_obj_t *self,
     // We don't reset the buffer index in case we're looping and we have an odd number of buffer
     // loads
     background_callback_prevent();
-    if (self->eof && stream_lseek(self->stream, SEEK_SET, 0) == 0) {
+    if (self->eof && stream_lseek(self->stream, 0, SEEK_SET) == 0) {
         INPUT_BUFFER_CLEAR(self->inbuf);
         self->eof = 0;
+        self->stream_pos = 0;
         self->samples_decoded = 0;
         self->other_channel = -1;
+        mp3file_flush_ring(self);
         mp3file_skip_id3v2(self, false);
         mp3file_find_sync_word(self, false);
+        mp3file_restart_index(self);
     }
     background_callback_allow();
+    if (self->ring) {
+        background_callback_add(
+            &self->decode_cb,
+            mp3file_decode_cb,
+            self);
+    }
 }
 
 audioio_get_buffer_result_t audiomp3_mp3file_get_buffer(audiomp3_mp3file_obj_t *self,
@@ -445,7 +771,8 @@ audioio_get_buffer_result_t audiomp3_mp3file_get_buffer(audiomp3_mp3file_obj_t *
     *buffer_length = frame_buffer_size_bytes;
 
     if (channel == self->other_channel) {
-        *bufptr = (uint8_t *)(self->pcm_buffer[self->other_buffer_index] + channel);
+        int16_t *buffer = self->ring ? RING_SLOT(self, self->ring_read - 1) : self->pcm_buffer[self->other_buffer_index];
+        *bufptr = (uint8_t *)(buffer + channel);
         self->other_channel = -1;
         self->samples_decoded += *buffer_length / sizeof(int16_t);
         if (DO_DEBUG) {
@@ -454,6 +781,28 @@ audioio_get_buffer_result_t audiomp3_mp3file_get_buffer(audiomp3_mp3file_obj_t *
         return GET_BUFFER_MORE_DATA;
     }
 
+    if (self->ring) {
+        if (RING_AVAILABLE(self) == 0 && !self->decode_done) {
+            // Decoding fell behind playback, so catch up synchronously
+            self->underruns++;
+            mp3file_decode_cb(self);
+        }
+        if (RING_AVAILABLE(self) == 0) {
+            *buffer_length = 0;
+            return self->decode_error || !self->decode_done ? GET_BUFFER_ERROR : GET_BUFFER_DONE;
+        }
+        *bufptr = (uint8_t *)RING_SLOT(self, self->ring_read);
+        self->ring_read++;
+        self->other_channel = 1 - channel;
+        self->samples_decoded += frame_buffer_size_bytes / sizeof(int16_t);
+        if (!self->decode_done) {
+            background_callback_add(
+                &self->decode_cb,
+                mp3file_decode_cb,
+                self);
+        }
+        return RING_AVAILABLE(self) == 0 && self->decode_done && !self->decode_error ? GET_BUFFER_DONE : GET_BUFFER_MORE_DATA;
+    }
 
     self->buffer_index = !self->buffer_index;
     self->other_channel = 1 - channel;
@@ -461,48 +810,9 @@ audioio_get_buffer_result_t audiomp3_mp3file_get_buffer(audiomp3_mp3file_obj_t *
     int16_t *buffer = (int16_t *)(void *)self->pcm_buffer[self->buffer_index];
     *bufptr = (uint8_t *)buffer;
 
-    mp3file_skip_id3v2(self, false);
-    if (!mp3file_find_sync_word(self, false)) {
-        memset(buffer, 0, self->base.max_buffer_length);
-        *buffer_length = 0;
-        return self->eof ? GET_BUFFER_DONE : GET_BUFFER_ERROR;
-    }
-    int bytes_left = BYTES_LEFT(self);
-    uint8_t *inbuf = READ_PTR(self);
-    int err = MP3Decode(self->decoder, &inbuf, &bytes_left, buffer, 0);
-    if (err != ERR_MP3_INDATA_UNDERFLOW) {
-        CONSUME(self, BYTES_LEFT(self) - bytes_left);
-    }
-    if (err) {
-        memset(buffer, 0, frame_buffer_size_bytes);
-        if (DO_DEBUG) {
-            mp_printf(&mp_plat_print, "%s:%d err=%d\n", __FILE__, __LINE__, err);
-        }
-        if (self->eof || (err != ERR_MP3_INDATA_UNDERFLOW && err != ERR_MP3_MAINDATA_UNDERFLOW)) {
-            memset(buffer, 0, self->base.max_buffer_length);
-            *buffer_length = 0;
-            self->eof = true;
-            return GET_BUFFER_ERROR;
-        }
-    }
-
-    self->samples_decoded += frame_buffer_size_bytes / sizeof(int16_t);
-
-    mp3file_skip_id3v2(self, false);
-    int result = mp3file_find_sync_word(self, false) ? GET_BUFFER_MORE_DATA : GET_BUFFER_DONE;
-
-    if (DO_DEBUG) {
-        mp_printf(&mp_plat_print, "%s:%d result=%d\n", __FILE__, __LINE__, result);
-    }
-    if (INPUT_BUFFER_SPACE(self->inbuf) > 512) {
-        background_callback_add(
-            &self->inbuf_fill_cb,
-            mp3file_update_inbuf_cb,
-            self);
-    }
-
-    if (DO_DEBUG) {
-        mp_printf(&mp_plat_print, "post-decode avail=%d eof=%d\n", (int)INPUT_BUFFER_AVAILABLE(self->inbuf), self->eof);
+    audioio_get_buffer_result_t result = mp3file_decode_frame(self, buffer, buffer_length);
+    if (*buffer_length) {
+        self->samples_decoded += *buffer_length / sizeof(int16_t);
     }
     return result;
 }
@@ -510,7 +820,7 @@ audioio_get_buffer_result_t audiomp3_mp3file_get_buffer(audiomp3_mp3file_obj_t *
 float common_hal_audiomp3_mp3file_get_rms_level(audiomp3_mp3file_obj_t *self) {
     float sumsq = 0.f;
     // Assumes no DC component to the audio.  Is that a safe assumption?
-    int16_t *buffer = (int16_t *)(void *)self->pcm_buffer[self->buffer_index];
+    int16_t *buffer = self->ring ? RING_SLOT(self, self->ring_read - 1) : self->pcm_buffer[self->buffer_index];
     for (size_t i = 0; i < self->base.max_buffer_length / sizeof(int16_t); i++) {
         sumsq += (float)buffer[i] * buffer[i];
     }
@@ -520,3 +830,95 @@ float common_hal_audiomp3_mp3file_get_rms_level(audiomp3_mp3file_obj_t *self) {
 uint32_t common_hal_audiomp3_mp3file_get_samples_decoded(audiomp3_mp3file_obj_t *self) {
     return self->samples_decoded;
 }
+
+uint32_t common_hal_audiomp3_mp3file_get_underruns(audiomp3_mp3file_obj_t *self) {
+    return self->underruns;
+}
+
+mp_float_t common_hal_audiomp3_mp3file_get_decode_time(audiomp3_mp3file_obj_t *self) {
+    return self->decode_time_ns / (mp_float_t)1e9;
+}
+
+void common_hal_audiomp3_mp3file_seek(audiomp3_mp3file_obj_t *self, mp_float_t position) {
+    uint32_t frame_samples = self->base.max_buffer_length / sizeof(int16_t);
+    uint32_t target = (uint32_t)MAX(0, position * self->base.sample_rate / (frame_samples / self->base.channel_count));
+
+    // Start from the closest indexed frame at or before the target, unless
+    // the target lies beyond the index and the file has a TOC or a constant
+    // bitrate to jump with.
+    uint32_t last_indexed = (self->index_len - 1) * self->index_interval;
+    uint32_t offset;
+    bool exact = target <= last_indexed || (self->toc_frames == 0 && self->cbr_bitrate == 0);
+    if (exact) {
+        uint32_t i = MIN(target / self->index_interval, (uint32_t)self->index_len - 1);
+        offset = self->index[i];
+        self->frame_number = i * self->index_interval;
+    } else if (self->toc_frames == 0) {
+        // Frames are samples / 8 * bitrate / sample_rate bytes long, give or
+        // take a padding byte
+        uint32_t slots = frame_samples / self->base.channel_count / 8;
+        offset = self->toc_start + (uint64_t)target * slots * self->cbr_bitrate / self->base.sample_rate;
+        self->frame_number = target;
+    } else {
+        mp_float_t percent = MIN((mp_float_t)target * 100 / self->toc_frames, (mp_float_t)99.99);
+        size_t i = (size_t)percent;
+        mp_float_t lo = self->toc[i];
+        mp_float_t hi = i < 99 ? self->toc[i + 1] : 256;
+        offset = self->toc_start + (uint32_t)((lo + (hi - lo) * (percent - i)) * self->toc_bytes / 256);
+        self->frame_number = target;
+    }
+
+    background_callback_prevent();
+    off_t result = stream_lseek(self->stream, offset, SEEK_SET);
+    if (result < 0) {
+        background_callback_allow();
+        mp_raise_OSError(-result);
+    }
+    INPUT_BUFFER_CLEAR(self->inbuf);
+    self->eof = 0;
+    self->stream_pos = offset;
+    self->frame_exact = exact;
+    self->other_channel = -1;
+    mp3file_flush_ring(self);
+
+    // Hop frame headers up to the target without decoding, extending the
+    // index on the way.
+    while (exact && self->frame_number < target && mp3file_find_sync_word(self, true)) {
+        mp3file_index_frame(self);
+        MP3FrameInfo fi;
+        if (BYTES_LEFT(self) < 4 ||
+            MP3GetNextFrameInfo(self->decoder, &fi, READ_PTR(self)) != ERR_MP3_NONE ||
+            fi.bitrate == 0) {
+            CONSUME(self, 1);
+            continue;
+        }
+        if (self->cbr_bitrate != 0 && (uint32_t)fi.bitrate != self->cbr_bitrate) {
+            self->cbr_bitrate = 0;
+        }
+        uint32_t length = mp3file_frame_length(&fi, READ_PTR(self));
+        while (length > 0 && BYTES_LEFT(self) > 0) {
+            uint32_t to_consume = MIN(length, (uint32_t)BYTES_LEFT(self));
+            CONSUME(self, to_consume);
+            length -= to_consume;
+            mp3file_update_inbuf_half(self, true);
+        }
+        self->frame_number++;
+    }
+    mp3file_find_sync_word(self, true);
+    // If the frame jumped to by bitrate shows that it varies after all, walk
+    // there from the index instead
+    if (!exact && self->toc_frames == 0 && !mp3file_check_bitrate(self)) {
+        background_callback_allow();
+        common_hal_audiomp3_mp3file_seek(self, position);
+        return;
+    }
+    self->samples_decoded = self->frame_number * frame_samples;
+    background_callback_allow();
+
+    if (self->ring) {
+        background_callback_add(
+            &self->decode_cb,
+            mp3file_decode_cb,
+            self);
+    }
+}
@@ -20,6 +20,10 @@ typedef struct {
     mp_int_t write_off;
 } mp3_input_buffer_t;
 
+// Number of frame offsets kept for seeking. When the index fills up, every
+// other entry is dropped and the spacing between entries doubles.
+#define MP3_SEEK_INDEX_LEN (64)
+
 typedef struct {
     audiosample_base_t base;
     struct _MP3DecInfo *decoder;
@@ -39,6 +43,37 @@ typedef struct {
     int8_t other_buffer_index;
 
     uint32_t samples_decoded;
+
+    // Decoded frames kept ahead of playback when frames_ahead > 0
+    int16_t *ring;
+    background_callback_t decode_cb;
+    uint32_t ring_count;
+    uint32_t ring_read;
+    uint32_t ring_write;
+    bool decode_done;
+    bool decode_error;
+    uint32_t underruns;
+    uint32_t decode_time_ns;
+
+    // Stream offset of inbuf.buf[inbuf.write_off]
+    uint32_t stream_pos;
+    // Frames consumed since the start of the file; only exact when
+    // frame_exact is set (a TOC seek lands on an estimated position)
+    uint32_t frame_number;
+    bool frame_exact;
+    uint16_t index_len;
+    uint32_t index_interval;
+    uint32_t index[MP3_SEEK_INDEX_LEN];
+
+    // Stream offset of the first frame
+    uint32_t toc_start;
+    // Xing/Info or VBRI table of contents, valid when toc_frames != 0
+    uint32_t toc_frames;
+    uint32_t toc_bytes;
+    uint8_t toc[100];
+    // Bitrate of the first frame when the file has no header saying that
+    // the bitrate varies and no frame seen so far has another, otherwise 0
+    uint32_t cbr_bitrate;
 } audiomp3_mp3file_obj_t;
 
 // These are not available from Python because it may be called in an interrupt.
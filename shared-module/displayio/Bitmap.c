@@ -31,10 +31,13 @@ void common_hal_displayio_bitmap_construct_from_buffer(displayio_bitmap_t *self,
     self->stride = stride(width, bits_per_value);
     self->data_alloc = false;
     if (!data) {
-        data = m_malloc(self->stride * height * sizeof(uint32_t));
+        data = m_malloc_bulk(self->stride * height * sizeof(uint32_t));
         self->data_alloc = true;
     }
     self->data = data;
+    if (self->data_alloc) {
+        gc_movable(self, (void **)&self->data, self->stride * height * sizeof(uint32_t));
+    }
     self->read_only = read_only;
     self->bits_per_value = bits_per_value;
 
@@ -0,0 +1,216 @@
+// This file is part of the CircuitPython project: https://circuitpython.org
+//
+// SPDX-FileCopyrightText: Copyright (c) 2026 Adafruit Industries LLC
+//
+// SPDX-License-Identifier: MIT
+
+#include "shared-bindings/memorymonitor/AllocationProfiler.h"
+
+#include "py/bc.h"
+#include "py/objfun.h"
+#include "py/mpstate.h"
+#include "py/nlr.h"
+#include "py/runtime.h"
+
+void common_hal_memorymonitor_allocationprofiler_construct(memorymonitor_allocationprofiler_obj_t *self,
+    uint32_t every, uint32_t every_bytes, uint16_t max_sites) {
+    self->sites = m_new(memorymonitor_allocation_site_t, max_sites);
+    self->max_sites = max_sites;
+    self->every = every;
+    self->every_bytes = every_bytes;
+    self->reporting = false;
+    common_hal_memorymonitor_allocationprofiler_clear(self);
+    self->next = NULL;
+    self->previous = NULL;
+}
+
+void common_hal_memorymonitor_allocationprofiler_pause(memorymonitor_allocationprofiler_obj_t *self) {
+    if (self->previous == NULL) {
+        return;
+    }
+    *self->previous = self->next;
+    if (self->next != NULL) {
+        self->next->previous = self->previous;
+    }
+    self->next = NULL;
+    self->previous = NULL;
+}
+
+void common_hal_memorymonitor_allocationprofiler_resume(memorymonitor_allocationprofiler_obj_t *self) {
+    if (self->previous != NULL) {
+        mp_raise_RuntimeError(MP_ERROR_TEXT("Already running"));
+    }
+    self->next = MP_STATE_VM(active_allocationprofilers);
+    self->previous = (memorymonitor_allocationprofiler_obj_t **)&MP_STATE_VM(active_allocationprofilers);
+    if (self->next != NULL) {
+        self->next->previous = &self->next;
+    }
+    MP_STATE_VM(active_allocationprofilers) = self;
+}
+
+void common_hal_memorymonitor_allocationprofiler_clear(memorymonitor_allocationprofiler_obj_t *self) {
+    self->site_count = 0;
+    self->countdown = self->every_bytes != 0 ? self->every_bytes : self->every;
+    self->total_allocations = 0;
+    self->total_bytes = 0;
+    self->dropped = 0;
+}
+
+bool common_hal_memorymonitor_allocationprofiler_get_running(memorymonitor_allocationprofiler_obj_t *self) {
+    return self->previous != NULL;
+}
+
+uint32_t common_hal_memorymonitor_allocationprofiler_get_total_allocations(memorymonitor_allocationprofiler_obj_t *self) {
+    return self->total_allocations;
+}
+
+size_t common_hal_memorymonitor_allocationprofiler_get_total_bytes(memorymonitor_allocationprofiler_obj_t *self) {
+    return self->total_bytes;
+}
+
+uint32_t common_hal_memorymonitor_allocationprofiler_get_dropped(memorymonitor_allocationprofiler_obj_t *self) {
+    return self->dropped;
+}
+
+static mp_obj_t qstr_or_none(qstr q) {
+    return q == MP_QSTRnull ? mp_const_none : MP_OBJ_NEW_QSTR(q);
+}
+
+static mp_obj_t build_report(memorymonitor_allocationprofiler_obj_t *self) {
+    // Sort by bytes, largest first. The table is small so insertion sort will do.
+    memorymonitor_allocation_site_t *sites = self->sites;
+    for (size_t i = 1; i < self->site_count; i++) {
+        memorymonitor_allocation_site_t site = sites[i];
+        size_t j = i;
+        while (j > 0 && sites[j - 1].bytes < site.bytes) {
+            sites[j] = sites[j - 1];
+            j--;
+        }
+        sites[j] = site;
+    }
+
+    mp_obj_list_t *report = MP_OBJ_TO_PTR(mp_obj_new_list(self->site_count, NULL));
+    for (size_t i = 0; i < self->site_count; i++) {
+        mp_obj_t items[] = {
+            qstr_or_none(sites[i].file),
+            qstr_or_none(sites[i].function),
+            MP_OBJ_NEW_SMALL_INT(sites[i].line),
+            mp_obj_new_int_from_uint((uintptr_t)sites[i].caller),
+            mp_obj_new_int_from_uint(sites[i].count),
+            mp_obj_new_int_from_uint(sites[i].bytes),
+        };
+        report->items[i] = mp_obj_new_tuple(MP_ARRAY_SIZE(items), items);
+    }
+    return MP_OBJ_FROM_PTR(report);
+}
+
+mp_obj_t common_hal_memorymonitor_allocationprofiler_report(memorymonitor_allocationprofiler_obj_t *self) {
+    // Leave the report's own allocations out of the table it is reading.
+    self->reporting = true;
+    nlr_buf_t nlr;
+    if (nlr_push(&nlr) == 0) {
+        mp_obj_t report = build_report(self);
+        nlr_pop();
+        self->reporting = false;
+        return report;
+    } else {
+        self->reporting = false;
+        nlr_jump(nlr.ret_val);
+    }
+}
+
+// Fill in the Python function and line that is running, if any.
+static void locate(memorymonitor_allocation_site_t *site) {
+    site->file = MP_QSTRnull;
+    site->function = MP_QSTRnull;
+    site->line = 0;
+    #if MICROPY_TRACK_CODE_STATE
+    const mp_code_state_t *code_state = MP_STATE_THREAD(current_code_state);
+    if (code_state == NULL) {
+        return;
+    }
+    const byte *ip = code_state->fun_bc->bytecode;
+    MP_BC_PRELUDE_SIG_DECODE(ip);
+    MP_BC_PRELUDE_SIZE_DECODE(ip);
+    const byte *line_info_top = ip + n_info;
+    const byte *bytecode_start = ip + n_info + n_cell;
+    size_t bc = code_state->ip - bytecode_start;
+    qstr block_name = mp_decode_uint_value(ip);
+    for (size_t i = 0; i < 1 + n_pos_args + n_kwonly_args; ++i) {
+        ip = mp_decode_uint_skip(ip);
+    }
+    #if MICROPY_EMIT_BYTECODE_USES_QSTR_TABLE
+    site->function = code_state->fun_bc->context->constants.qstr_table[block_name];
+    site->file = code_state->fun_bc->context->constants.qstr_table[0];
+    #else
+    site->function = block_name;
+    site->file = code_state->fun_bc->context->constants.source_file;
+    #endif
+    site->line = mp_bytecode_get_source_line(ip, line_info_top, bc);
+    #endif
+}
+
+static bool take_sample(memorymonitor_allocationprofiler_obj_t *self, size_t num_bytes) {
+    self->total_allocations++;
+    self->total_bytes += num_bytes;
+    uint32_t period = self->every;
+    uint32_t step = 1;
+    if (self->every_bytes != 0) {
+        period = self->every_bytes;
+        step = MIN(num_bytes, UINT32_MAX);
+    }
+    if (step < self->countdown) {
+        self->countdown -= step;
+        return false;
+    }
+    // An allocation that spans several periods is still one sample.
+    self->countdown = period - (step - self->countdown) % period;
+    return true;
+}
+
+static void record(memorymonitor_allocationprofiler_obj_t *self, const memorymonitor_allocation_site_t *here, size_t num_bytes) {
+    memorymonitor_allocation_site_t *site = self->sites;
+    memorymonitor_allocation_site_t *end = site + self->site_count;
+    for (; site < end; site++) {
+        if (site->caller == here->caller && site->line == here->line &&
+            site->function == here->function && site->file == here->file) {
+            break;
+        }
+    }
+    if (site == end) {
+        if (self->site_count == self->max_sites) {
+            self->dropped++;
+            return;
+        }
+        *site = *here;
+        site->count = 0;
+        site->bytes = 0;
+        self->site_count++;
+    }
+    site->count++;
+    site->bytes += num_bytes;
+}
+
+void memorymonitor_allocationprofilers_track_allocation(size_t num_bytes, const void *caller) {
+    memorymonitor_allocationprofiler_obj_t *profiler = MP_STATE_VM(active_allocationprofilers);
+    memorymonitor_allocation_site_t here;
+    bool located = false;
+    while (profiler != NULL) {
+        if (!profiler->reporting && take_sample(profiler, num_bytes)) {
+            // Only look up the source line when something samples this allocation.
+            if (!located) {
+                here.caller = caller;
+                locate(&here);
+                located = true;
+            }
+            record(profiler, &here, num_bytes);
+        }
+        profiler = profiler->next;
+    }
+}
+
+void memorymonitor_allocationprofilers_reset(void) {
+    MP_STATE_VM(active_allocationprofilers) = NULL;
+}
+
+MP_REGISTER_ROOT_POINTER(struct _memorymonitor_allocationprofiler_obj_t *active_allocationprofilers);
@@ -0,0 +1,52 @@
+// This file is part of the CircuitPython project: https://circuitpython.org
+//
+// SPDX-FileCopyrightText: Copyright (c) 2026 Adafruit Industries LLC
+//
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "py/obj.h"
+#include "py/qstr.h"
+
+typedef struct _memorymonitor_allocationprofiler_obj_t memorymonitor_allocationprofiler_obj_t;
+
+#define ALLOCATION_PROFILER_MAX_SITES 256
+
+// One place that allocates: a line of Python code together with the C function
+// it called into. Names are kept as qstrs rather than pointers to the code so
+// that profiling doesn't keep unloaded code alive.
+typedef struct {
+    const void *caller;
+    qstr file;
+    qstr function;
+    uint32_t line;
+    uint32_t count;
+    size_t bytes;
+} memorymonitor_allocation_site_t;
+
+typedef struct _memorymonitor_allocationprofiler_obj_t {
+    mp_obj_base_t base;
+    memorymonitor_allocation_site_t *sites;
+    uint16_t max_sites;
+    uint16_t site_count;
+    // Sampling period, in allocations or, if every_bytes isn't zero, in bytes.
+    uint32_t every;
+    uint32_t every_bytes;
+    // Allocations or bytes left until the next sample.
+    uint32_t countdown;
+    uint32_t total_allocations;
+    size_t total_bytes;
+    uint32_t dropped;
+    // Set while the profiler builds its own report.
+    bool reporting;
+    // Store the location that points to us so we can remove ourselves.
+    memorymonitor_allocationprofiler_obj_t **previous;
+    memorymonitor_allocationprofiler_obj_t *next;
+} memorymonitor_allocationprofiler_obj_t;
+
+void memorymonitor_allocationprofilers_track_allocation(size_t num_bytes, const void *caller);
+void memorymonitor_allocationprofilers_reset(void);
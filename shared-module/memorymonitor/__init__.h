@@ -9,4 +9,7 @@
 #include <stddef.h>
 
 void memorymonitor_track_allocation(size_t block_count);
+// Called by the m_malloc family with the number of bytes asked for and the
+// address of the C code that asked.
+void memorymonitor_profile_allocation(size_t num_bytes, const void *caller);
 void memorymonitor_reset(void);
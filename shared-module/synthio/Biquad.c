@@ -97,13 +97,13 @@ static int float_equal_or_update(
     return true;
 }
 
-void common_hal_synthio_biquad_tick(mp_obj_t self_in) {
+void common_hal_synthio_biquad_tick(mp_obj_t self_in, const synthio_render_context_t *ctx) {
     synthio_biquad_t *self = MP_OBJ_TO_PTR(self_in);
 
-    mp_float_t W0 = synthio_block_slot_get(&self->f0) * synthio_global_W_scale;
-    mp_float_t Q = synthio_block_slot_get(&self->Q);
+    mp_float_t W0 = synthio_block_slot_get(ctx, &self->f0) * ctx->W_scale;
+    mp_float_t Q = synthio_block_slot_get(ctx, &self->Q);
     mp_float_t A =
-        (self->mode >= SYNTHIO_PEAKING_EQ) ? synthio_block_slot_get(&self->A) : 0;
+        (self->mode >= SYNTHIO_PEAKING_EQ) ? synthio_block_slot_get(ctx, &self->A) : 0;
 
     // n.b., assumes that the `mode` field is read-only
     // n.b., use of `&` is deliberate, avoids short-circuiting behavior
@@ -193,17 +193,20 @@ void common_hal_synthio_biquad_tick(mp_obj_t self_in) {
 }
 
 void synthio_biquad_filter_reset(biquad_filter_state *st) {
-    memset(&st->x, 0, 4 * sizeof(int16_t));
+    memset(st->x, 0, sizeof(st->x));
+    memset(st->y, 0, sizeof(st->y));
+    st->has_coefficients = false;
 }
 
-void synthio_biquad_filter_samples(mp_obj_t self_in, biquad_filter_state *st, int32_t *buffer, size_t n_samples) {
-    synthio_biquad_t *self = MP_OBJ_TO_PTR(self_in);
+// Coefficients are stepped with this many extra fractional bits while ramping
+#define RAMP_SHIFT (8)
 
-    int32_t a1 = self->a1;
-    int32_t a2 = self->a2;
-    int32_t b0 = self->b0;
-    int32_t b1 = self->b1;
-    int32_t b2 = self->b2;
+static void synthio_biquad_filter_samples_ramped(synthio_biquad_t *self, biquad_filter_state *st, int32_t *buffer, size_t n_samples) {
+    int32_t a1 = st->a1 << RAMP_SHIFT, a1_step = ((self->a1 - st->a1) << RAMP_SHIFT) / (int32_t)n_samples;
+    int32_t a2 = st->a2 << RAMP_SHIFT, a2_step = ((self->a2 - st->a2) << RAMP_SHIFT) / (int32_t)n_samples;
+    int32_t b0 = st->b0 << RAMP_SHIFT, b0_step = ((self->b0 - st->b0) << RAMP_SHIFT) / (int32_t)n_samples;
+    int32_t b1 = st->b1 << RAMP_SHIFT, b1_step = ((self->b1 - st->b1) << RAMP_SHIFT) / (int32_t)n_samples;
+    int32_t b2 = st->b2 << RAMP_SHIFT, b2_step = ((self->b2 - st->b2) << RAMP_SHIFT) / (int32_t)n_samples;
 
     int32_t x0 = st->x[0];
     int32_t x1 = st->x[1];
@@ -211,8 +214,15 @@ void synthio_biquad_filter_samples(mp_obj_t self_in, biquad_filter_state *st, in
     int32_t y1 = st->y[1];
 
     for (size_t n = n_samples; n; --n, ++buffer) {
+        a1 += a1_step;
+        a2 += a2_step;
+        b0 += b0_step;
+        b1 += b1_step;
+        b2 += b2_step;
+
         int32_t input = *buffer;
-        int32_t output = (b0 * input + b1 * x0 + b2 * x1 - a1 * y0 - a2 * y1 + (1 << (BIQUAD_SHIFT - 1))) >> BIQUAD_SHIFT;
+        int32_t output = ((b0 >> RAMP_SHIFT) * input + (b1 >> RAMP_SHIFT) * x0 + (b2 >> RAMP_SHIFT) * x1
+            - (a1 >> RAMP_SHIFT) * y0 - (a2 >> RAMP_SHIFT) * y1 + (1 << (BIQUAD_SHIFT - 1))) >> BIQUAD_SHIFT;
 
         x1 = x0;
         x0 = input;
@@ -225,3 +235,138 @@ void synthio_biquad_filter_samples(mp_obj_t self_in, biquad_filter_state *st, in
     st->y[0] = y0;
     st->y[1] = y1;
 }
+
+bool synthio_biquad_filter_would_ramp(mp_obj_t self_in, const biquad_filter_state *st) {
+    synthio_biquad_t *self = MP_OBJ_TO_PTR(self_in);
+    return st->has_coefficients
+           && (st->a1 != self->a1 || st->a2 != self->a2
+               || st->b0 != self->b0 || st->b1 != self->b1 || st->b2 != self->b2);
+}
+
+static void synthio_biquad_filter_state_set_coefficients(biquad_filter_state *st, const synthio_biquad_t *self) {
+    st->a1 = self->a1;
+    st->a2 = self->a2;
+    st->b0 = self->b0;
+    st->b1 = self->b1;
+    st->b2 = self->b2;
+    st->has_coefficients = true;
+}
+
+void synthio_biquad_filter_samples(mp_obj_t self_in, biquad_filter_state *st, int32_t *buffer, size_t n_samples, bool ramp) {
+    synthio_biquad_t *self = MP_OBJ_TO_PTR(self_in);
+
+    if (ramp && n_samples > 1 && synthio_biquad_filter_would_ramp(self_in, st)) {
+        synthio_biquad_filter_samples_ramped(self, st, buffer, n_samples);
+    } else {
+        int32_t a1 = self->a1;
+        int32_t a2 = self->a2;
+        int32_t b0 = self->b0;
+        int32_t b1 = self->b1;
+        int32_t b2 = self->b2;
+
+        int32_t x0 = st->x[0];
+        int32_t x1 = st->x[1];
+        int32_t y0 = st->y[0];
+        int32_t y1 = st->y[1];
+
+        for (size_t n = n_samples; n; --n, ++buffer) {
+            int32_t input = *buffer;
+            int32_t output = (b0 * input + b1 * x0 + b2 * x1 - a1 * y0 - a2 * y1 + (1 << (BIQUAD_SHIFT - 1))) >> BIQUAD_SHIFT;
+
+            x1 = x0;
+            x0 = input;
+            y1 = y0;
+            y0 = output;
+            *buffer = output;
+        }
+        st->x[0] = x0;
+        st->x[1] = x1;
+        st->y[0] = y0;
+        st->y[1] = y1;
+    }
+
+    synthio_biquad_filter_state_set_coefficients(st, self);
+}
+
+#if SYNTHIO_FILTER_BANK && SYNTHIO_FILTER_BANK_VECTOR
+typedef int32_t biquad_lanes_t __attribute__((vector_size(SYNTHIO_FILTER_BANK_LANES * sizeof(int32_t))));
+
+// Each variable holds one value for every lane, so the filter runs on all the
+// lanes at once. Unused lanes filter whatever is left in the buffer, and the
+// result is ignored.
+void synthio_biquad_filter_bank_samples(const mp_obj_t *filter_objs, biquad_filter_state *const *states, size_t n_lanes, int32_t *buffer, size_t n_samples) {
+    biquad_lanes_t a1 = {0}, a2 = {0}, b0 = {0}, b1 = {0}, b2 = {0};
+    biquad_lanes_t x0 = {0}, x1 = {0}, y0 = {0}, y1 = {0};
+    const biquad_lanes_t round = a1 + (1 << (BIQUAD_SHIFT - 1));
+
+    for (size_t k = 0; k < n_lanes; k++) {
+        const synthio_biquad_t *self = MP_OBJ_TO_PTR(filter_objs[k]);
+        const biquad_filter_state *st = states[k];
+        a1[k] = self->a1;
+        a2[k] = self->a2;
+        b0[k] = self->b0;
+        b1[k] = self->b1;
+        b2[k] = self->b2;
+        x0[k] = st->x[0];
+        x1[k] = st->x[1];
+        y0[k] = st->y[0];
+        y1[k] = st->y[1];
+    }
+
+    for (size_t n = n_samples; n; --n, buffer += SYNTHIO_FILTER_BANK_LANES) {
+        biquad_lanes_t input;
+        memcpy(&input, buffer, sizeof(input));
+        biquad_lanes_t output = (b0 * input + b1 * x0 + b2 * x1 - a1 * y0 - a2 * y1 + round) >> BIQUAD_SHIFT;
+
+        x1 = x0;
+        x0 = input;
+        y1 = y0;
+        y0 = output;
+        memcpy(buffer, &output, sizeof(output));
+    }
+
+    for (size_t k = 0; k < n_lanes; k++) {
+        biquad_filter_state *st = states[k];
+        st->x[0] = x0[k];
+        st->x[1] = x1[k];
+        st->y[0] = y0[k];
+        st->y[1] = y1[k];
+        synthio_biquad_filter_state_set_coefficients(st, MP_OBJ_TO_PTR(filter_objs[k]));
+    }
+}
+#elif SYNTHIO_FILTER_BANK
+// Without SIMD registers, filter each lane in turn, stepping over the others
+void synthio_biquad_filter_bank_samples(const mp_obj_t *filter_objs, biquad_filter_state *const *states, size_t n_lanes, int32_t *buffer, size_t n_samples) {
+    for (size_t k = 0; k < n_lanes; k++) {
+        const synthio_biquad_t *self = MP_OBJ_TO_PTR(filter_objs[k]);
+        biquad_filter_state *st = states[k];
+        int32_t a1 = self->a1;
+        int32_t a2 = self->a2;
+        int32_t b0 = self->b0;
+        int32_t b1 = self->b1;
+        int32_t b2 = self->b2;
+
+        int32_t x0 = st->x[0];
+        int32_t x1 = st->x[1];
+        int32_t y0 = st->y[0];
+        int32_t y1 = st->y[1];
+
+        int32_t *lane = buffer + k;
+        for (size_t n = n_samples; n; --n, lane += SYNTHIO_FILTER_BANK_LANES) {
+            int32_t input = *lane;
+            int32_t output = (b0 * input + b1 * x0 + b2 * x1 - a1 * y0 - a2 * y1 + (1 << (BIQUAD_SHIFT - 1))) >> BIQUAD_SHIFT;
+
+            x1 = x0;
+            x0 = input;
+            y1 = y0;
+            y0 = output;
+            *lane = output;
+        }
+        st->x[0] = x0;
+        st->x[1] = x1;
+        st->y[0] = y0;
+        st->y[1] = y1;
+        synthio_biquad_filter_state_set_coefficients(st, self);
+    }
+}
+#endif
@@ -12,6 +12,27 @@
 
 #define BIQUAD_SHIFT (15)
 
+// A Synthesizer filters several notes at once with
+// synthio_biquad_filter_bank_samples. Where there are SIMD registers to hold
+// them, it filters all the notes together with the compiler's vector
+// extensions. Otherwise it filters them one after another, which is no faster
+// than filtering each note on its own, so a port turns the bank on by defining
+// SYNTHIO_FILTER_BANK to (1) itself.
+#ifndef SYNTHIO_FILTER_BANK_VECTOR
+#if defined(__GNUC__) && (defined(__SSE2__) || defined(__ARM_NEON) || defined(__wasm_simd128__))
+#define SYNTHIO_FILTER_BANK_VECTOR (1)
+#else
+#define SYNTHIO_FILTER_BANK_VECTOR (0)
+#endif
+#endif
+
+#ifndef SYNTHIO_FILTER_BANK
+#define SYNTHIO_FILTER_BANK (SYNTHIO_FILTER_BANK_VECTOR)
+#endif
+
+// The number of signals synthio_biquad_filter_bank_samples filters at once
+#define SYNTHIO_FILTER_BANK_LANES (4)
+
 typedef struct synthio_biquad {
     mp_obj_base_t base;
     synthio_filter_mode mode;
@@ -22,8 +43,25 @@ typedef struct synthio_biquad {
 
 typedef struct {
     int32_t x[2], y[2];
+    // The coefficients at the end of the last block, where a ramp starts
+    int32_t a1, a2, b0, b1, b2;
+    bool has_coefficients;
 } biquad_filter_state;
 
-void common_hal_synthio_biquad_tick(mp_obj_t self_in);
+void common_hal_synthio_biquad_tick(mp_obj_t self_in, const synthio_render_context_t *ctx);
 void synthio_biquad_filter_reset(biquad_filter_state *st);
-void synthio_biquad_filter_samples(mp_obj_t self_in, biquad_filter_state *st, int32_t *buffer, size_t n_samples);
+// When ramp is true and the coefficients changed since the last block filtered
+// with st, they move linearly from the old to the new values across the block
+// instead of changing at its start.
+void synthio_biquad_filter_samples(mp_obj_t self_in, biquad_filter_state *st, int32_t *buffer, size_t n_samples, bool ramp);
+// True if the coefficients changed since the last block filtered with st, so
+// that synthio_biquad_filter_samples would ramp them
+bool synthio_biquad_filter_would_ramp(mp_obj_t self_in, const biquad_filter_state *st);
+#if SYNTHIO_FILTER_BANK
+// Filter up to SYNTHIO_FILTER_BANK_LANES independent signals together, signal
+// i through filter_objs[i] with state states[i]. The signals are interleaved:
+// sample j of signal i is at buffer[j * SYNTHIO_FILTER_BANK_LANES + i]. The
+// result is the same as filtering each signal with
+// synthio_biquad_filter_samples without ramping.
+void synthio_biquad_filter_bank_samples(const mp_obj_t *filter_objs, biquad_filter_state *const *states, size_t n_lanes, int32_t *buffer, size_t n_samples);
+#endif
@@ -9,117 +9,262 @@
 #include "shared-bindings/audiocore/__init__.h"
 
 
-static void record_midi_stream_error(synthio_miditrack_obj_t *self) {
-    self->error_location = self->pos;
-    self->pos = self->track.len;
+static bool decode_varlen(const uint8_t *buffer, size_t len, size_t *pos, uint32_t *result) {
+    uint32_t value = 0;
+    uint8_t c;
+    do {
+        if (*pos >= len) {
+            return false;
+        }
+        c = buffer[(*pos)++];
+        value = (value << 7) | (c & 0x7f);
+    } while (c & 0x80);
+    *result = value;
+    return true;
 }
 
-static mp_obj_t parse_note(synthio_miditrack_obj_t *self) {
-    uint8_t *buffer = self->track.buf;
-    size_t len = self->track.len;
-    if (self->pos + 1 >= len) {
-        record_midi_stream_error(self);
-    }
-    uint8_t note = buffer[(self->pos)++];
-    if (note > 127 || buffer[(self->pos)++] > 127) {
-        record_midi_stream_error(self);
+static size_t add_event(synthio_midi_event_t *events, size_t n, uint32_t tick, synthio_midi_event_kind_t kind, uint32_t value) {
+    if (events) {
+        events[n] = (synthio_midi_event_t) { .tick = tick, .kind = kind, .value = value };
     }
-    return MP_OBJ_NEW_SMALL_INT(note);
+    return n + 1;
 }
 
-static int decode_duration(synthio_miditrack_obj_t *self) {
-    uint8_t *buffer = self->track.buf;
-    size_t len = self->track.len;
-    uint8_t c;
-    uint32_t delta = 0;
-    do {
-        c = buffer[self->pos++];
-        delta <<= 7;
-        delta |= c & 0x7f;
-    } while ((c & 0x80) && (self->pos < len));
-
-    // errors cannot be raised from the background task, so simply end the track.
-    if (c & 0x80) {
-        self->pos = self->track.len;
-        record_midi_stream_error(self);
-    }
-    return delta * self->synth.base.sample_rate / self->tempo;
-}
+// Decode a track into events and return how many there are. If events is NULL,
+// only count them. Decoding stops at the end of the track or at the first
+// error, whose offset is recorded.
+static size_t decode_track(synthio_miditrack_obj_t *self, const uint8_t *buffer, size_t len, synthio_midi_event_t *events, uint32_t *end_tick) {
+    size_t pos = 0, n = 0, event_pos = 0;
+    uint32_t tick = 0;
+    uint8_t status = 0;
+    while (pos < len) {
+        uint32_t delta;
+        event_pos = pos;
+        if (!decode_varlen(buffer, len, &pos, &delta)) {
+            goto error;
+        }
+        tick += delta;
+        if (pos == len) {
+            // a delay at the end of the track is played as silence
+            break;
+        }
 
-// invariant: pointing at a MIDI message
-static void decode_until_pause(synthio_miditrack_obj_t *self) {
-    uint8_t *buffer = self->track.buf;
-    size_t len = self->track.len;
-    do {
-        switch (buffer[self->pos++] >> 4) {
-            case 8: { // Note Off
-                mp_obj_t note = parse_note(self);
-                synthio_span_change_note(&self->synth, note, SYNTHIO_SILENCE);
-                break;
+        event_pos = pos;
+        uint8_t c = buffer[pos];
+        if (c & 0x80) {
+            pos++;
+        }
+        if (c == 0xff) { // meta event
+            uint32_t meta_len;
+            if (pos >= len) {
+                goto error;
             }
-            case 9: { // Note On
-                mp_obj_t note = parse_note(self);
-                synthio_span_change_note(&self->synth, SYNTHIO_SILENCE, note);
-                break;
+            uint8_t type = buffer[pos++];
+            if (!decode_varlen(buffer, len, &pos, &meta_len) || meta_len > len - pos) {
+                goto error;
             }
-            case 10:
-            case 11:
-            case 14: // two data bytes to ignore
-                parse_note(self);
+            if (type == 0x2f) { // End of Track
                 break;
-            case 12:
-            case 13: // one data byte to ignore
-                if (self->pos >= len || buffer[self->pos++] > 127) {
-                    record_midi_stream_error(self);
+            }
+            if (type == 0x51 && meta_len == 3) { // Set Tempo
+                uint32_t us_per_beat = (buffer[pos] << 16) | (buffer[pos + 1] << 8) | buffer[pos + 2];
+                if (us_per_beat) {
+                    n = add_event(events, n, tick, SYNTHIO_MIDI_TEMPO, us_per_beat);
                 }
+            }
+            pos += meta_len;
+            status = 0;
+            continue;
+        }
+        if (c == 0xf0 || c == 0xf7) { // System Exclusive
+            uint32_t sysex_len;
+            if (!decode_varlen(buffer, len, &pos, &sysex_len) || sysex_len > len - pos) {
+                goto error;
+            }
+            pos += sysex_len;
+            status = 0;
+            continue;
+        }
+        if (c > 0xf0) {
+            // other system messages don't belong in a track, so treat them
+            // as its end
+            break;
+        }
+        if (c & 0x80) {
+            status = c;
+        } else if (status == 0) {
+            // a data byte without running status
+            goto error;
+        }
+
+        size_t n_data = (status >> 4) == 12 || (status >> 4) == 13 ? 1 : 2;
+        if (n_data > len - pos || buffer[pos] > 127 || (n_data == 2 && buffer[pos + 1] > 127)) {
+            goto error;
+        }
+        switch (status >> 4) {
+            case 8: // Note Off
+                n = add_event(events, n, tick, SYNTHIO_MIDI_NOTE_OFF, buffer[pos]);
+                break;
+            case 9: // Note On
+                n = add_event(events, n, tick, SYNTHIO_MIDI_NOTE_ON, buffer[pos]);
                 break;
-            case 15: // the full syntax is too complicated, just assume it's "End of Track" event
-                self->pos = len;
+            default: // ignored
                 break;
-            default: // invalid event
-                record_midi_stream_error(self);
         }
-        if (self->pos < len) {
-            self->synth.span.dur = decode_duration(self);
+        pos += n_data;
+    }
+    *end_tick = tick;
+    return n;
+
+error:
+    if (self->error_location < 0) {
+        self->error_location = event_pos;
+    }
+    *end_tick = tick;
+    return n;
+}
+
+static void decode_tracks(synthio_miditrack_obj_t *self, const mp_buffer_info_t *tracks, size_t n_tracks) {
+    size_t n_events = 0;
+    uint32_t end_tick = 0;
+    for (size_t i = 0; i < n_tracks; i++) {
+        n_events += decode_track(self, tracks[i].buf, tracks[i].len, NULL, &end_tick);
+        self->end_tick = MAX(self->end_tick, end_tick);
+    }
+    self->n_events = n_events;
+
+    // Decode each track into its own run of events ...
+    synthio_midi_event_t *decoded = m_new(synthio_midi_event_t, MAX(n_events, 1));
+    size_t *run = m_new(size_t, 2 * n_tracks);
+    n_events = 0;
+    for (size_t i = 0; i < n_tracks; i++) {
+        run[2 * i] = n_events;
+        n_events += decode_track(self, tracks[i].buf, tracks[i].len, decoded + n_events, &end_tick);
+        run[2 * i + 1] = n_events;
+    }
+    if (n_tracks == 1) {
+        self->events = decoded;
+        m_del(size_t, run, 2 * n_tracks);
+        return;
+    }
+
+    // ... then merge the runs. Events at the same time play in track order.
+    self->events = m_new(synthio_midi_event_t, MAX(n_events, 1));
+    for (size_t n = 0; n < n_events; n++) {
+        size_t best = 0;
+        bool found = false;
+        for (size_t i = 0; i < n_tracks; i++) {
+            if (run[2 * i] < run[2 * i + 1] && (!found || decoded[run[2 * i]].tick < decoded[run[2 * best]].tick)) {
+                best = i;
+                found = true;
+            }
         }
-    } while (self->pos < len && self->synth.span.dur == 0);
+        self->events[n] = decoded[run[2 * best]++];
+    }
+    m_del(synthio_midi_event_t, decoded, MAX(n_events, 1));
+    m_del(size_t, run, 2 * n_tracks);
 }
 
-static void start_parse(synthio_miditrack_obj_t *self) {
-    self->pos = 0;
-    self->error_location = -1;
-    self->synth.span.dur = decode_duration(self);
-    if (self->synth.span.dur == 0) {
-        // the usual case: the file starts with some MIDI event, not a delay
-        decode_until_pause(self);
+// The sample at which the given tick plays at the current tempo
+static uint32_t tick_to_sample(synthio_miditrack_obj_t *self, uint32_t tick) {
+    uint64_t tick_scaled = ((uint64_t)tick * self->synth.base.sample_rate) << 8;
+    return self->origin_sample + (uint32_t)((tick_scaled - self->origin_tick_scaled) / self->tempo);
+}
+
+// Play the events that are due at the end of the span, and start a span that
+// lasts until the next event (or the end of the tracks).
+static void miditrack_span_end(synthio_synth_t *synth) {
+    synthio_miditrack_obj_t *self = (synthio_miditrack_obj_t *)synth;
+    uint32_t now = self->span_end_sample;
+    while (self->next_event < self->n_events) {
+        const synthio_midi_event_t *event = &self->events[self->next_event];
+        if (tick_to_sample(self, event->tick) > now) {
+            break;
+        }
+        self->next_event++;
+        switch (event->kind) {
+            case SYNTHIO_MIDI_NOTE_OFF:
+                synthio_span_change_note(synth, MP_OBJ_NEW_SMALL_INT(event->value), SYNTHIO_SILENCE);
+                break;
+            case SYNTHIO_MIDI_NOTE_ON:
+                synthio_span_change_note(synth, SYNTHIO_SILENCE, MP_OBJ_NEW_SMALL_INT(event->value));
+                break;
+            case SYNTHIO_MIDI_TEMPO:
+                if (self->ticks_per_beat) {
+                    self->origin_tick_scaled = ((uint64_t)event->tick * self->synth.base.sample_rate) << 8;
+                    self->origin_sample = now;
+                    self->tempo = (((uint64_t)self->ticks_per_beat * 1000000) << 8) / event->value;
+                }
+                break;
+        }
     }
+
+    uint32_t next_tick = self->next_event < self->n_events ? self->events[self->next_event].tick : self->end_tick;
+    uint32_t next_sample = tick_to_sample(self, next_tick);
+    // span.dur is 0 at the end of the tracks
+    synth->span.dur = next_sample > now ? MIN(next_sample - now, UINT16_MAX) : 0;
+    self->span_end_sample = now + synth->span.dur;
+}
+
+static void start_playing(synthio_miditrack_obj_t *self) {
+    self->next_event = 0;
+    self->tempo = self->initial_tempo;
+    self->origin_tick_scaled = 0;
+    self->origin_sample = 0;
+    self->span_end_sample = 0;
+    self->synth.span.dur = 0;
+    miditrack_span_end(&self->synth);
 }
 
 void common_hal_synthio_miditrack_construct(synthio_miditrack_obj_t *self,
-    const uint8_t *buffer, uint32_t len, uint32_t tempo, uint32_t sample_rate,
-    mp_obj_t waveform_obj, mp_obj_t filter_obj, mp_obj_t envelope_obj) {
+    const mp_buffer_info_t *tracks, size_t n_tracks, uint32_t tempo, uint16_t ticks_per_beat,
+    uint32_t sample_rate, mp_obj_t waveform_obj, mp_obj_t filter_obj, mp_obj_t envelope_obj) {
 
-    self->tempo = tempo;
-    self->track.buf = (void *)buffer;
-    self->track.len = len;
+    self->initial_tempo = tempo << 8;
+    self->ticks_per_beat = ticks_per_beat;
+    self->error_location = -1;
+    decode_tracks(self, tracks, n_tracks);
 
     synthio_synth_init(&self->synth, sample_rate, 1, waveform_obj, envelope_obj);
+    self->synth.span_end = miditrack_span_end;
 
-    start_parse(self);
+    start_playing(self);
 }
 
 void common_hal_synthio_miditrack_deinit(synthio_miditrack_obj_t *self) {
     synthio_synth_deinit(&self->synth);
+    self->events = NULL;
 }
 
 mp_int_t common_hal_synthio_miditrack_get_error_location(synthio_miditrack_obj_t *self) {
     return self->error_location;
 }
 
+mp_int_t common_hal_synthio_miditrack_get_tempo(synthio_miditrack_obj_t *self) {
+    return (self->tempo + 128) >> 8;
+}
+
+void common_hal_synthio_miditrack_set_tempo(synthio_miditrack_obj_t *self, mp_int_t tempo) {
+    // Notes that are playing keep the time they have played for at the old
+    // tempo, and the rest of the track follows the new one
+    uint32_t now = self->span_end_sample - self->synth.span.dur;
+    self->origin_tick_scaled += (uint64_t)(now - self->origin_sample) * self->tempo;
+    self->origin_sample = now;
+    self->tempo = self->initial_tempo = tempo << 8;
+    if (self->synth.span.dur == 0) {
+        // the track has ended
+        return;
+    }
+    uint32_t next_tick = self->next_event < self->n_events ? self->events[self->next_event].tick : self->end_tick;
+    uint32_t next_sample = tick_to_sample(self, next_tick);
+    self->synth.span.dur = next_sample > now ? MIN(next_sample - now, UINT16_MAX) : 1;
+    self->span_end_sample = now + self->synth.span.dur;
+}
+
 void synthio_miditrack_reset_buffer(synthio_miditrack_obj_t *self,
     bool single_channel_output, uint8_t channel) {
     synthio_synth_reset_buffer(&self->synth, single_channel_output, channel);
-    start_parse(self);
+    start_playing(self);
 }
 
 audioio_get_buffer_result_t synthio_miditrack_get_buffer(synthio_miditrack_obj_t *self,
@@ -129,13 +274,10 @@ audioio_get_buffer_result_t synthio_miditrack_get_buffer(synthio_miditrack_obj_t
         return GET_BUFFER_ERROR;
     }
 
+    // Notes change partway through the buffer, on the sample where their events are due
     synthio_synth_synthesize(&self->synth, buffer, buffer_length, single_channel_output ? 0 : channel);
     if (self->synth.span.dur == 0) {
-        if (self->pos == self->track.len) {
-            return GET_BUFFER_DONE;
-        } else {
-            decode_until_pause(self);
-        }
+        return GET_BUFFER_DONE;
     }
     return GET_BUFFER_MORE_DATA;
 }
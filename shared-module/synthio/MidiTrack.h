@@ -10,13 +10,40 @@
 
 #include "shared-module/synthio/__init__.h"
 
+typedef enum {
+    SYNTHIO_MIDI_NOTE_OFF,
+    SYNTHIO_MIDI_NOTE_ON,
+    SYNTHIO_MIDI_TEMPO,
+} synthio_midi_event_kind_t;
+
+// The tracks are decoded into events when the MidiTrack is constructed, so
+// nothing is parsed while playing.
+typedef struct {
+    // time since the start of the track, in MIDI ticks
+    uint32_t tick;
+    uint32_t kind : 8;
+    // the note number, or for a tempo change the microseconds per beat
+    uint32_t value : 24;
+} synthio_midi_event_t;
+
 typedef struct {
     synthio_synth_t synth;
-    mp_buffer_info_t track;
-    // invariant: after initial startup, pos always points just after an encoded duration, i.e., at a midi message (or at EOF)
-    size_t pos;
+    // the events of all tracks, merged in order of time
+    synthio_midi_event_t *events;
+    size_t n_events;
+    size_t next_event;
+    // the time at which the last track ends
+    uint32_t end_tick;
+    // the sample at which the current span ends and the next events are played
+    uint32_t span_end_sample;
+    // the tempo when playback starts and the current tempo, in ticks per second with 8 fractional bits
+    uint32_t initial_tempo, tempo;
+    // the point at which the tempo last changed, as ticks * sample_rate with 8 fractional bits and as a sample
+    uint64_t origin_tick_scaled;
+    uint32_t origin_sample;
+    // when nonzero, Set Tempo meta events change the tempo
+    uint16_t ticks_per_beat;
     mp_int_t error_location;
-    uint32_t tempo;
 } synthio_miditrack_obj_t;
 
 
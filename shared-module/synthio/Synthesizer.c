@@ -15,9 +15,15 @@
 
 void common_hal_synthio_synthesizer_construct(synthio_synthesizer_obj_t *self,
     uint32_t sample_rate, int channel_count, mp_obj_t waveform_obj,
-    mp_obj_t envelope_obj) {
+    mp_obj_t envelope_obj, bool ramp) {
 
     synthio_synth_init(&self->synth, sample_rate, channel_count, waveform_obj, envelope_obj);
+    self->synth.ramp = ramp;
+    #if SYNTHIO_FILTER_BANK
+    // MidiTrack only plays integer notes, which are never filtered, so only a
+    // Synthesizer needs this
+    self->synth.filter_bank = m_malloc(SYNTHIO_FILTER_BANK_LANES * SYNTHIO_MAX_DUR * sizeof(int32_t));
+    #endif
     self->blocks = mp_obj_new_list(0, NULL);
 }
 
@@ -50,7 +56,7 @@ audioio_get_buffer_result_t synthio_synthesizer_get_buffer(synthio_synthesizer_o
             continue;
         }
         synthio_block_slot_t slot = { item };
-        (void)synthio_block_slot_get(&slot);
+        (void)synthio_block_slot_get(&self->synth.render_context, &slot);
     }
     return GET_BUFFER_MORE_DATA;
 }
@@ -162,3 +168,11 @@ envelope_state_e common_hal_synthio_synthesizer_note_info(synthio_synthesizer_ob
 mp_obj_t common_hal_synthio_synthesizer_get_blocks(synthio_synthesizer_obj_t *self) {
     return self->blocks;
 }
+
+bool common_hal_synthio_synthesizer_get_ramp(synthio_synthesizer_obj_t *self) {
+    return self->synth.ramp;
+}
+
+void common_hal_synthio_synthesizer_set_ramp(synthio_synthesizer_obj_t *self, bool ramp) {
+    self->synth.ramp = ramp;
+}
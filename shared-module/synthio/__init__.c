@@ -16,9 +16,6 @@
 
 #define MP_PI MICROPY_FLOAT_CONST(3.14159265358979323846)
 
-mp_float_t synthio_global_rate_scale, synthio_global_W_scale;
-uint8_t synthio_global_tick;
-
 static const int16_t square_wave[] = {-32768, 32767};
 
 static const uint16_t notes[] = {8372, 8870, 9397, 9956, 10548, 11175, 11840,
@@ -151,7 +148,8 @@ int16_t synthio_mix_down_sample(int32_t sample, int32_t scale) {
     return sample;
 }
 
-static bool synth_note_into_buffer(synthio_synth_t *synth, int chan, int32_t *out_buffer32, int16_t dur, int16_t loudness[2]) {
+// Write the note playing on chan to every stride'th element of out_buffer32
+static bool synth_note_into_buffer(synthio_synth_t *synth, int chan, int32_t *out_buffer32, size_t stride, int16_t dur, int16_t loudness[2]) {
     mp_obj_t note_obj = synth->span.note_obj[chan];
 
     int32_t sample_rate = synth->base.sample_rate;
@@ -179,19 +177,19 @@ static bool synth_note_into_buffer(synthio_synth_t *synth, int chan, int32_t *ou
         dds_rate = (sample_rate / 2 + ((uint64_t)(base_freq * waveform_length) << (SYNTHIO_FREQUENCY_SHIFT - 10 + octave))) / sample_rate;
     } else {
         synthio_note_obj_t *note = MP_OBJ_TO_PTR(note_obj);
-        int32_t frequency_scaled = synthio_note_step(note, sample_rate, dur, loudness);
+        int32_t frequency_scaled = synthio_note_step(note, &synth->render_context, sample_rate, dur, loudness);
         if (note->waveform_buf.buf) {
             waveform = note->waveform_buf.buf;
             waveform_length = note->waveform_buf.len;
-            waveform_start = (uint32_t)synthio_block_slot_get_limited(&note->waveform_loop_start, 0, waveform_length - 1);
-            waveform_length = (uint32_t)synthio_block_slot_get_limited(&note->waveform_loop_end, waveform_start + 1, waveform_length);
+            waveform_start = (uint32_t)synthio_block_slot_get_limited(&synth->render_context, &note->waveform_loop_start, 0, waveform_length - 1);
+            waveform_length = (uint32_t)synthio_block_slot_get_limited(&synth->render_context, &note->waveform_loop_end, waveform_start + 1, waveform_length);
         }
         dds_rate = synthio_frequency_convert_scaled_to_dds((uint64_t)frequency_scaled * (waveform_length - waveform_start), sample_rate);
         if (note->ring_frequency_scaled != 0 && note->ring_waveform_buf.buf) {
             ring_waveform = note->ring_waveform_buf.buf;
             ring_waveform_length = note->ring_waveform_buf.len;
-            ring_waveform_start = (uint32_t)synthio_block_slot_get_limited(&note->ring_waveform_loop_start, 0, ring_waveform_length - 1);
-            ring_waveform_length = (uint32_t)synthio_block_slot_get_limited(&note->ring_waveform_loop_end, ring_waveform_start + 1, ring_waveform_length);
+            ring_waveform_start = (uint32_t)synthio_block_slot_get_limited(&synth->render_context, &note->ring_waveform_loop_start, 0, ring_waveform_length - 1);
+            ring_waveform_length = (uint32_t)synthio_block_slot_get_limited(&synth->render_context, &note->ring_waveform_loop_end, ring_waveform_start + 1, ring_waveform_length);
             ring_dds_rate = synthio_frequency_convert_scaled_to_dds((uint64_t)note->ring_frequency_bent * (ring_waveform_length - ring_waveform_start), sample_rate);
             uint32_t lim = ring_waveform_length << SYNTHIO_FREQUENCY_SHIFT;
             if (ring_dds_rate > lim / sizeof(int16_t)) {
@@ -222,7 +220,7 @@ static bool synth_note_into_buffer(synthio_synth_t *synth, int chan, int32_t *ou
             accum = accum - lim + offset;
         }
         int16_t idx = accum >> SYNTHIO_FREQUENCY_SHIFT;
-        out_buffer32[i] = waveform[idx];
+        out_buffer32[i * stride] = waveform[idx];
     }
     synth->accum[chan] = accum;
 
@@ -250,8 +248,8 @@ static bool synth_note_into_buffer(synthio_synth_t *synth, int chan, int32_t *ou
                 accum = accum - lim + offset;
             }
             int16_t idx = accum >> SYNTHIO_FREQUENCY_SHIFT;
-            int16_t wi = (ring_waveform[idx] * out_buffer32[i]) / 32768;
-            out_buffer32[i] = wi;
+            int16_t wi = (ring_waveform[idx] * out_buffer32[i * stride]) / 32768;
+            out_buffer32[i * stride] = wi;
         }
         synth->ring_accum[chan] = accum;
     }
@@ -269,39 +267,84 @@ static mp_obj_t synthio_synth_get_note_filter(mp_obj_t note_obj) {
     return mp_const_none;
 }
 
-static void sum_with_loudness(int32_t *out_buffer32, int32_t *tmp_buffer32, int16_t loudness[2], size_t dur, int synth_chan) {
+// tmp_buffer32 holds the note in every stride'th element
+static void sum_with_loudness(int32_t *out_buffer32, int32_t *tmp_buffer32, size_t stride, int16_t loudness[2], size_t dur, int synth_chan) {
     if (synth_chan == 1) {
-        for (size_t i = 0; i < dur; i++) {
-            *out_buffer32++ += (*tmp_buffer32++ *loudness[0]) >> 16;
+        for (size_t i = 0; i < dur; i++, tmp_buffer32 += stride) {
+            *out_buffer32++ += (*tmp_buffer32 * loudness[0]) >> 16;
         }
     } else {
-        for (size_t i = 0; i < dur; i++) {
+        for (size_t i = 0; i < dur; i++, tmp_buffer32 += stride) {
             *out_buffer32++ += (*tmp_buffer32 * loudness[0]) >> 16;
-            *out_buffer32++ += (*tmp_buffer32++ *loudness[1]) >> 16;
+            *out_buffer32++ += (*tmp_buffer32 * loudness[1]) >> 16;
         }
     }
 }
 
-void synthio_synth_synthesize(synthio_synth_t *synth, uint8_t **bufptr, uint32_t *buffer_length, uint8_t channel) {
+// Like sum_with_loudness, but the loudness moves linearly from
+// prev_loudness to loudness across the block. The levels are stepped with 8
+// extra fractional bits.
+static void sum_with_loudness_ramped(int32_t *out_buffer32, int32_t *tmp_buffer32, size_t stride, const int16_t prev_loudness[2], int16_t loudness[2], size_t dur, int synth_chan) {
+    int32_t left = prev_loudness[0] << 8, left_step = ((loudness[0] - prev_loudness[0]) << 8) / (int32_t)dur;
+    if (synth_chan == 1) {
+        for (size_t i = 0; i < dur; i++, tmp_buffer32 += stride) {
+            left += left_step;
+            *out_buffer32++ += (*tmp_buffer32 * (left >> 8)) >> 16;
+        }
+    } else {
+        int32_t right = prev_loudness[1] << 8, right_step = ((loudness[1] - prev_loudness[1]) << 8) / (int32_t)dur;
+        for (size_t i = 0; i < dur; i++, tmp_buffer32 += stride) {
+            left += left_step;
+            right += right_step;
+            *out_buffer32++ += (*tmp_buffer32 * (left >> 8)) >> 16;
+            *out_buffer32++ += (*tmp_buffer32 * (right >> 8)) >> 16;
+        }
+    }
+}
 
-    if (channel == synth->other_channel) {
-        *buffer_length = synth->last_buffer_length;
-        *bufptr = (uint8_t *)(synth->buffers[synth->other_buffer_index] + channel);
+// Scale the note playing on chan by its loudness and add it to out_buffer32
+static void synth_sum_note(synthio_synth_t *synth, int chan, int32_t *out_buffer32, int32_t *tmp_buffer32, size_t stride, int16_t loudness[2], size_t dur) {
+    int16_t *last_loudness = synth->last_loudness[chan];
+    if (synth->ramp && dur > 1 && (last_loudness[0] != loudness[0] || last_loudness[1] != loudness[1])) {
+        sum_with_loudness_ramped(out_buffer32, tmp_buffer32, stride, last_loudness, loudness, dur, synth->base.channel_count);
+    } else {
+        sum_with_loudness(out_buffer32, tmp_buffer32, stride, loudness, dur, synth->base.channel_count);
+    }
+    last_loudness[0] = loudness[0];
+    last_loudness[1] = loudness[1];
+}
+
+#if SYNTHIO_FILTER_BANK
+// Notes waiting in synth->filter_bank to be filtered together. Note k is in
+// every SYNTHIO_FILTER_BANK_LANES'th element starting at filter_bank[k].
+typedef struct {
+    size_t n_lanes;
+    int chan[SYNTHIO_FILTER_BANK_LANES];
+    int16_t loudness[SYNTHIO_FILTER_BANK_LANES][2];
+    mp_obj_t filter_obj[SYNTHIO_FILTER_BANK_LANES];
+    biquad_filter_state *filter_state[SYNTHIO_FILTER_BANK_LANES];
+} synth_filter_bank_t;
+
+static void synth_filter_bank_flush(synthio_synth_t *synth, synth_filter_bank_t *bank, int32_t *out_buffer32, size_t dur) {
+    if (bank->n_lanes == 0) {
         return;
     }
+    synthio_biquad_filter_bank_samples(bank->filter_obj, bank->filter_state, bank->n_lanes, synth->filter_bank, dur);
+    for (size_t k = 0; k < bank->n_lanes; k++) {
+        synth_sum_note(synth, bank->chan[k], out_buffer32, synth->filter_bank + k, SYNTHIO_FILTER_BANK_LANES, bank->loudness[k], dur);
+    }
+    bank->n_lanes = 0;
+}
+#endif
 
-    shared_bindings_synthio_lfo_tick(synth->base.sample_rate, SYNTHIO_MAX_DUR);
-
-    synth->buffer_index = !synth->buffer_index;
-    synth->other_channel = 1 - channel;
-    synth->other_buffer_index = synth->buffer_index;
-
-    uint16_t dur = MIN(SYNTHIO_MAX_DUR, synth->span.dur);
-    synth->span.dur -= dur;
-
+// Render dur frames of the notes in the current span into out_buffer16
+static void synth_synthesize_span(synthio_synth_t *synth, int16_t *out_buffer16, uint16_t dur) {
     int32_t out_buffer32[SYNTHIO_MAX_DUR * synth->base.channel_count];
     int32_t tmp_buffer32[SYNTHIO_MAX_DUR];
     memset(out_buffer32, 0, synth->base.channel_count * dur * sizeof(int32_t));
+    #if SYNTHIO_FILTER_BANK
+    synth_filter_bank_t bank = { .n_lanes = 0 };
+    #endif
 
     for (int chan = 0; chan < CIRCUITPY_SYNTHIO_MAX_CHANNELS; chan++) {
         mp_obj_t note_obj = synth->span.note_obj[chan];
@@ -317,24 +360,50 @@ void synthio_synth_synthesize(synthio_synth_t *synth, uint8_t **bufptr, uint32_t
 
         int16_t loudness[2] = {synth->envelope_state[chan].level, synth->envelope_state[chan].level};
 
-        if (!synth_note_into_buffer(synth, chan, tmp_buffer32, dur, loudness)) {
+        mp_obj_t filter_obj = synthio_synth_get_note_filter(note_obj);
+        biquad_filter_state *filter_state = NULL;
+        if (filter_obj != mp_const_none) {
+            synthio_note_obj_t *note = MP_OBJ_TO_PTR(note_obj);
+            filter_state = &note->filter_state;
+            // A Biquad shared by several notes only computes its coefficients once
+            common_hal_synthio_biquad_tick(filter_obj, &synth->render_context);
+        }
+
+        #if SYNTHIO_FILTER_BANK
+        if (filter_state && synth->filter_bank && !(synth->ramp && synthio_biquad_filter_would_ramp(filter_obj, filter_state))) {
+            // queue the note to be filtered together with others, then summed
+            size_t k = bank.n_lanes;
+            if (!synth_note_into_buffer(synth, chan, synth->filter_bank + k, SYNTHIO_FILTER_BANK_LANES, dur, loudness)) {
+                continue;
+            }
+            bank.chan[k] = chan;
+            bank.loudness[k][0] = loudness[0];
+            bank.loudness[k][1] = loudness[1];
+            bank.filter_obj[k] = filter_obj;
+            bank.filter_state[k] = filter_state;
+            if (++bank.n_lanes == SYNTHIO_FILTER_BANK_LANES) {
+                synth_filter_bank_flush(synth, &bank, out_buffer32, dur);
+            }
+            continue;
+        }
+        #endif
+
+        if (!synth_note_into_buffer(synth, chan, tmp_buffer32, 1, dur, loudness)) {
             // for some other reason, such as being above nyquist, note
             // couldn't be synthed, so don't filter or sum it in
             continue;
         }
 
-        mp_obj_t filter_obj = synthio_synth_get_note_filter(note_obj);
-        if (filter_obj != mp_const_none) {
-            synthio_note_obj_t *note = MP_OBJ_TO_PTR(note_obj);
-            common_hal_synthio_biquad_tick(filter_obj);
-            synthio_biquad_filter_samples(filter_obj, &note->filter_state, tmp_buffer32, dur);
+        if (filter_state) {
+            synthio_biquad_filter_samples(filter_obj, filter_state, tmp_buffer32, dur, synth->ramp);
         }
 
         // adjust loudness by envelope
-        sum_with_loudness(out_buffer32, tmp_buffer32, loudness, dur, synth->base.channel_count);
+        synth_sum_note(synth, chan, out_buffer32, tmp_buffer32, 1, loudness, dur);
     }
-
-    int16_t *out_buffer16 = (int16_t *)(void *)synth->buffers[synth->buffer_index];
+    #if SYNTHIO_FILTER_BANK
+    synth_filter_bank_flush(synth, &bank, out_buffer32, dur);
+    #endif
 
     // mix down audio
     for (size_t i = 0; i < dur * synth->base.channel_count; i++) {
@@ -350,6 +419,36 @@ void synthio_synth_synthesize(synthio_synth_t *synth, uint8_t **bufptr, uint32_t
         }
         synthio_envelope_state_step(&synth->envelope_state[chan], synthio_synth_get_note_envelope(synth, note_obj), dur);
     }
+}
+
+void synthio_synth_synthesize(synthio_synth_t *synth, uint8_t **bufptr, uint32_t *buffer_length, uint8_t channel) {
+
+    if (channel == synth->other_channel) {
+        *buffer_length = synth->last_buffer_length;
+        *bufptr = (uint8_t *)(synth->buffers[synth->other_buffer_index] + channel);
+        return;
+    }
+
+    synthio_render_context_tick(&synth->render_context, synth->base.sample_rate, SYNTHIO_MAX_DUR);
+
+    synth->buffer_index = !synth->buffer_index;
+    synth->other_channel = 1 - channel;
+    synth->other_buffer_index = synth->buffer_index;
+
+    int16_t *out_buffer16 = (int16_t *)(void *)synth->buffers[synth->buffer_index];
+
+    // Fill the buffer span by span, so that notes change on the exact sample
+    // where a span ends rather than at a buffer boundary
+    uint16_t dur = 0;
+    while (dur < SYNTHIO_MAX_DUR && synth->span.dur) {
+        uint16_t span_dur = MIN(SYNTHIO_MAX_DUR - dur, synth->span.dur);
+        synth_synthesize_span(synth, out_buffer16 + dur * synth->base.channel_count, span_dur);
+        synth->span.dur -= span_dur;
+        dur += span_dur;
+        if (synth->span.dur == 0 && synth->span_end) {
+            synth->span_end(synth);
+        }
+    }
 
     *buffer_length = synth->last_buffer_length = dur * SYNTHIO_BYTES_PER_SAMPLE * synth->base.channel_count;
     *bufptr = (uint8_t *)out_buffer16;
@@ -365,6 +464,7 @@ void synthio_synth_reset_buffer(synthio_synth_t *synth, bool single_channel_outp
 void synthio_synth_deinit(synthio_synth_t *synth) {
     synth->buffers[0] = NULL;
     synth->buffers[1] = NULL;
+    synth->filter_bank = NULL;
     audiosample_mark_deinit(&synth->base);
 }
 
@@ -452,6 +552,7 @@ bool synthio_span_change_note(synthio_synth_t *synth, mp_obj_t old_note, mp_obj_
             synth->span.note_obj[channel] = new_note;
             synthio_envelope_state_init(&synth->envelope_state[channel], synthio_synth_get_note_envelope(synth, new_note));
             synth->accum[channel] = 0;
+            synth->last_loudness[channel][0] = synth->last_loudness[channel][1] = 0;
         }
         return true;
     }
@@ -470,34 +571,35 @@ uint32_t synthio_frequency_convert_scaled_to_dds(uint64_t frequency_scaled, int3
     return (sample_rate / 2 + frequency_scaled) / sample_rate;
 }
 
-void shared_bindings_synthio_lfo_tick(uint32_t sample_rate, uint16_t num_samples) {
+void synthio_render_context_tick(synthio_render_context_t *ctx, uint32_t sample_rate, uint16_t num_samples) {
     mp_float_t recip_sample_rate = MICROPY_FLOAT_CONST(1.) / sample_rate;
-    synthio_global_rate_scale = num_samples * recip_sample_rate;
-    synthio_global_W_scale = (2 * MP_PI) * recip_sample_rate;
-    synthio_global_tick++;
+    ctx->rate_scale = num_samples * recip_sample_rate;
+    ctx->W_scale = (2 * MP_PI) * recip_sample_rate;
+    ctx->tick++;
 }
 
-mp_float_t synthio_block_slot_get(synthio_block_slot_t *slot) {
+mp_float_t synthio_block_slot_get(const synthio_render_context_t *ctx, synthio_block_slot_t *slot) {
     // all numbers (and None!) previously converted to float in synthio_block_assign_slot
     if (mp_obj_is_float(slot->obj)) {
         return mp_obj_get_float(slot->obj);
     }
 
     synthio_block_base_t *block = MP_OBJ_TO_PTR(slot->obj);
-    if (block->last_tick == synthio_global_tick) {
+    if (block->last_context == ctx && block->last_tick == ctx->tick) {
         return block->value;
     }
 
-    block->last_tick = synthio_global_tick;
+    block->last_context = ctx;
+    block->last_tick = ctx->tick;
     // previously verified by call to mp_proto_get in synthio_block_assign_slot
     const synthio_block_proto_t *p = MP_OBJ_TYPE_GET_SLOT(mp_obj_get_type(slot->obj), protocol);
-    mp_float_t value = p->tick(slot->obj);
+    mp_float_t value = p->tick(slot->obj, ctx);
     block->value = value;
     return value;
 }
 
-mp_float_t synthio_block_slot_get_limited(synthio_block_slot_t *lfo_slot, mp_float_t lo, mp_float_t hi) {
-    mp_float_t value = synthio_block_slot_get(lfo_slot);
+mp_float_t synthio_block_slot_get_limited(const synthio_render_context_t *ctx, synthio_block_slot_t *lfo_slot, mp_float_t lo, mp_float_t hi) {
+    mp_float_t value = synthio_block_slot_get(ctx, lfo_slot);
     if (value < lo) {
         return lo;
     }
@@ -507,8 +609,8 @@ mp_float_t synthio_block_slot_get_limited(synthio_block_slot_t *lfo_slot, mp_flo
     return value;
 }
 
-int32_t synthio_block_slot_get_scaled(synthio_block_slot_t *lfo_slot, mp_float_t lo, mp_float_t hi) {
-    mp_float_t value = synthio_block_slot_get_limited(lfo_slot, lo, hi);
+int32_t synthio_block_slot_get_scaled(const synthio_render_context_t *ctx, synthio_block_slot_t *lfo_slot, mp_float_t lo, mp_float_t hi) {
+    mp_float_t value = synthio_block_slot_get_limited(ctx, lfo_slot, lo, hi);
     return (int32_t)MICROPY_FLOAT_C_FUN(round)(MICROPY_FLOAT_C_FUN(ldexp)(value, 15));
 }
 
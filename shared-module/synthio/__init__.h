@@ -27,6 +27,19 @@ typedef struct {
     mp_obj_t note_obj[CIRCUITPY_SYNTHIO_MAX_CHANNELS];
 } synthio_midi_span_t;
 
+// The clock that block inputs (LFOs, Math blocks) and Biquad filters are
+// evaluated against. Each audio node that reads block inputs owns one and
+// ticks it once per block, so nodes running at different sample rates or
+// block lengths (or on different cores) do not disturb each other. A block's
+// value is computed once per context and tick.
+typedef struct synthio_render_context {
+    // the block length, in seconds
+    mp_float_t rate_scale;
+    // radians per sample per Hz
+    mp_float_t W_scale;
+    uint32_t tick;
+} synthio_render_context_t;
+
 typedef struct {
     // the number of attack or decay steps (signed) per sample
     // therefore the maximum time is 32767 samples or 0.68s at 48kHz
@@ -55,6 +68,16 @@ typedef struct synthio_synth {
     uint32_t accum[CIRCUITPY_SYNTHIO_MAX_CHANNELS];
     uint32_t ring_accum[CIRCUITPY_SYNTHIO_MAX_CHANNELS];
     synthio_envelope_state_t envelope_state[CIRCUITPY_SYNTHIO_MAX_CHANNELS];
+    synthio_render_context_t render_context;
+    // When set, loudness and filter changes are ramped across each block
+    bool ramp;
+    int16_t last_loudness[CIRCUITPY_SYNTHIO_MAX_CHANNELS][2];
+    // Interleaved buffers of notes that are filtered together, or NULL to
+    // filter each note on its own
+    int32_t *filter_bank;
+    // Called when span.dur runs out partway through a buffer to start the
+    // next span, or NULL. span.dur left at 0 ends the buffer early.
+    void (*span_end)(struct synthio_synth *synth);
 } synthio_synth_t;
 
 typedef struct {
@@ -92,6 +115,5 @@ int synthio_lfo_step(synthio_lfo_state_t *state, uint16_t dur);
 int synthio_sweep_step(synthio_lfo_state_t *state, uint16_t dur);
 int synthio_sweep_in_step(synthio_lfo_state_t *state, uint16_t dur);
 
-extern mp_float_t synthio_global_rate_scale, synthio_global_W_scale;
-extern uint8_t synthio_global_tick;
-void shared_bindings_synthio_lfo_tick(uint32_t sample_rate, uint16_t num_samples);
+// Advance ctx to the next block of num_samples samples at sample_rate
+void synthio_render_context_tick(synthio_render_context_t *ctx, uint32_t sample_rate, uint16_t num_samples);
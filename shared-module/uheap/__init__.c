@@ -6,267 +6,358 @@
 
 #include <stdint.h>
 
-#include "py/bc.h"
-#include "py/binary.h"
 #include "py/gc.h"
 #include "py/obj.h"
-#include "py/objarray.h"
-#include "py/objfun.h"
-#include "py/objint.h"
-#include "py/objstr.h"
-#include "py/objtype.h"
+#include "py/objmodule.h"
 #include "py/runtime.h"
+#include "py/stream.h"
 
 #include "shared-bindings/uheap/__init__.h"
 
-#define VERIFY_PTR(ptr) ( \
-    (void *)ptr >= (void *)MP_STATE_MEM(gc_pool_start)         /* must be above start of pool */ \
-    && (void *)ptr < (void *)MP_STATE_MEM(gc_pool_end)            /* must be below end of pool */ \
-    )
-
-static void indent(uint8_t levels) {
-    for (int i = 0; i < levels; i++) {
-        mp_printf(&mp_plat_print, "  ");
+// Types past this many are counted as unrecognised blocks
+#define UHEAP_MAX_TYPES (64)
+
+// Types that are used internally but not exported by any module
+static const mp_obj_type_t *const core_types[] = {
+    &mp_type_type,
+    &mp_type_module,
+    &mp_type_fun_bc,
+    &mp_type_fun_builtin_0,
+    &mp_type_fun_builtin_1,
+    &mp_type_fun_builtin_2,
+    &mp_type_fun_builtin_3,
+    &mp_type_fun_builtin_var,
+    &mp_type_gen_wrap,
+    &mp_type_gen_instance,
+    &mp_type_bound_meth,
+    &mp_type_traceback,
+    &mp_type_polymorph_iter,
+};
+
+typedef struct {
+    const mp_obj_type_t *type;
+    uint32_t count;
+    size_t bytes;
+} uheap_type_count_t;
+
+typedef struct {
+    // Types that aren't on the heap, sorted by address
+    const mp_obj_type_t **known;
+    size_t n_known;
+    // counts[0] is for blocks that aren't recognised as objects
+    uheap_type_count_t *counts;
+    size_t n_counts;
+} uheap_census_t;
+
+typedef struct {
+    mp_obj_t name;
+    void *root;
+    size_t retained;
+    size_t reachable;
+} uheap_module_t;
+
+static void add_known_type(uheap_census_t *census, const mp_obj_type_t *type, size_t max) {
+    size_t i = census->n_known;
+    while (i > 0 && census->known[i - 1] > type) {
+        i--;
     }
-}
-
-static uint32_t object_size(uint8_t indent_level, mp_obj_t obj);
-
-static uint32_t int_size(uint8_t indent_level, mp_obj_t obj) {
-    if (mp_obj_is_small_int(obj)) {
-        return 0;
+    if ((i > 0 && census->known[i - 1] == type) || census->n_known == max) {
+        return;
     }
-    if (!VERIFY_PTR(obj)) {
-        return 0;
+    for (size_t j = census->n_known; j > i; j--) {
+        census->known[j] = census->known[j - 1];
     }
-    #if MICROPY_LONGINT_IMPL == MICROPY_LONGINT_IMPL_MPZ
-    mp_obj_int_t *i = MP_OBJ_TO_PTR(obj);
-    return gc_nbytes(obj) + gc_nbytes(i->mpz.dig);
-    #else
-    return gc_nbytes(obj);
-    #endif
+    census->known[i] = type;
+    census->n_known++;
 }
 
-static uint32_t string_size(uint8_t indent_level, mp_obj_t obj) {
-    if (mp_obj_is_qstr(obj)) {
-        qstr qs = MP_OBJ_QSTR_VALUE(obj);
-        const char *s = qstr_str(qs);
-        if (!VERIFY_PTR(s)) {
-            return 0;
+// Adds the types exported by built in modules to the census, returning how many
+// there are. Reading these is safe because they are all real objects.
+static size_t for_each_module_type(uheap_census_t *census, size_t max) {
+    static const mp_map_t *const maps[] = { &mp_builtin_module_map, &mp_builtin_extensible_module_map };
+    size_t n = 0;
+    for (size_t m = 0; m < MP_ARRAY_SIZE(maps); m++) {
+        const mp_map_t *modules = maps[m];
+        for (size_t i = 0; i < modules->alloc; i++) {
+            if (!mp_map_slot_is_filled(modules, i) || !mp_obj_is_type(modules->table[i].value, &mp_type_module)) {
+                continue;
+            }
+            const mp_obj_module_t *module = MP_OBJ_TO_PTR(modules->table[i].value);
+            const mp_map_t *globals = &module->globals->map;
+            for (size_t j = 0; j < globals->alloc; j++) {
+                if (mp_map_slot_is_filled(globals, j) && mp_obj_is_type(globals->table[j].value, &mp_type_type)) {
+                    const mp_obj_type_t *type = MP_OBJ_TO_PTR(globals->table[j].value);
+                    if (census != NULL && !gc_ptr_on_heap((void *)type)) {
+                        add_known_type(census, type, max);
+                    }
+                    n++;
+                }
+            }
         }
-        indent(indent_level);
-        mp_printf(&mp_plat_print, "%s\n", s);
-        return 0;
-    } else { // mp_obj_is_type(o, &mp_type_str)
-        mp_obj_str_t *s = MP_OBJ_TO_PTR(obj);
-        return gc_nbytes(s) + gc_nbytes(s->data);
     }
+    return n;
 }
 
-static uint32_t map_size(uint8_t indent_level, const mp_map_t *map) {
-    uint32_t total_size = gc_nbytes(map->table);
-    for (int i = 0; i < map->used; i++) {
-        uint32_t this_size = 0;
-        indent(indent_level);
-        if (map->table[i].key != NULL) {
-            mp_print_str(&mp_plat_print, "key: ");
-            mp_obj_print_helper(&mp_plat_print, map->table[i].key, PRINT_STR);
-            mp_print_str(&mp_plat_print, "\n");
+static bool is_known_type(const uheap_census_t *census, const mp_obj_type_t *type) {
+    size_t lo = 0;
+    size_t hi = census->n_known;
+    while (lo < hi) {
+        size_t mid = (lo + hi) / 2;
+        if (census->known[mid] < type) {
+            lo = mid + 1;
         } else {
-            mp_print_str(&mp_plat_print, "null key\n");
+            hi = mid;
         }
-        this_size += object_size(indent_level + 1, map->table[i].key);
-        this_size += object_size(indent_level + 1, map->table[i].value);
-
-        indent(indent_level);
-        mp_printf(&mp_plat_print, "Entry size: %u\n\n", this_size);
-        total_size += this_size;
     }
-
-    return total_size;
+    return lo < census->n_known && census->known[lo] == type;
 }
 
-static uint32_t dict_size(uint8_t indent_level, mp_obj_dict_t *dict) {
-    uint32_t total_size = gc_nbytes(dict);
-
-    indent(indent_level);
-    mp_printf(&mp_plat_print, "Dictionary @%x\n", dict);
-
-    total_size += map_size(indent_level, &dict->map);
-
-    return total_size;
+// Returns the type of the object in the block, or NULL if it doesn't look like
+// one. Pointers off the heap are only followed when they are known types, as
+// raw data may hold anything.
+static const mp_obj_type_t *block_type(const uheap_census_t *census, void *ptr, size_t n_bytes) {
+    if (n_bytes < sizeof(mp_obj_base_t)) {
+        return NULL;
+    }
+    const mp_obj_type_t *type = ((mp_obj_base_t *)ptr)->type;
+    if (gc_ptr_on_heap((void *)type)) {
+        // Classes made by Python code are on the heap
+        if (((uintptr_t)type & (MICROPY_BYTES_PER_GC_BLOCK - 1)) == 0 && type->base.type == &mp_type_type) {
+            return type;
+        }
+        return NULL;
+    }
+    return is_known_type(census, type) ? type : NULL;
 }
 
-static uint32_t function_size(uint8_t indent_level, mp_obj_t obj) {
-    // indent(indent_level);
-    // mp_print_str(&mp_plat_print, "function\n");
-    if (mp_obj_is_type(obj, &mp_type_fun_builtin_0)) {
-        return 0;
-    } else if (mp_obj_is_type(obj, &mp_type_fun_builtin_1)) {
-        return 0;
-    } else if (mp_obj_is_type(obj, &mp_type_fun_builtin_2)) {
-        return 0;
-    } else if (mp_obj_is_type(obj, &mp_type_fun_builtin_3)) {
-        return 0;
-    } else if (mp_obj_is_type(obj, &mp_type_fun_builtin_var)) {
-        return 0;
-    } else if (mp_obj_is_type(obj, &mp_type_fun_bc)) {
-        mp_obj_fun_bc_t *fn = MP_OBJ_TO_PTR(obj);
-        uint32_t total_size = gc_nbytes(fn) + gc_nbytes(fn->bytecode) + gc_nbytes(fn->const_table);
-        #if MICROPY_DEBUG_PRINTERS
-        mp_printf(&mp_plat_print, "BYTECODE START\n");
-        mp_bytecode_print(fn, fn->bytecode, gc_nbytes(fn->bytecode), fn->const_table);
-        mp_printf(&mp_plat_print, "BYTECODE END\n");
-        #endif
-        return total_size;
-    #if MICROPY_EMIT_NATIVE
-    } else if (mp_obj_is_type(obj, &mp_type_fun_native)) {
-        return 0;
-    #endif
-    #if MICROPY_EMIT_NATIVE
-    } else if (mp_obj_is_type(obj, &mp_obj_fun_viper_t)) {
-        return 0;
-    #endif
-    #if MICROPY_EMIT_THUMB
-    } else if (mp_obj_is_type(obj, &mp_type_fun_asm)) {
-        return 0;
-    #endif
+static void census_block(void *ptr, size_t n_bytes, void *arg) {
+    uheap_census_t *census = arg;
+    // Leave out the census itself
+    if (ptr == census->known || ptr == census->counts) {
+        return;
     }
-    return 0;
+    const mp_obj_type_t *type = block_type(census, ptr, n_bytes);
+    uheap_type_count_t *count = &census->counts[0];
+    if (type != NULL) {
+        size_t i = 1;
+        while (i < census->n_counts && census->counts[i].type != type) {
+            i++;
+        }
+        if (i < census->n_counts) {
+            count = &census->counts[i];
+        } else if (i < UHEAP_MAX_TYPES) {
+            count = &census->counts[i];
+            count->type = type;
+            count->count = 0;
+            count->bytes = 0;
+            census->n_counts++;
+        }
+    }
+    count->count++;
+    count->bytes += n_bytes;
 }
 
-static uint32_t array_size(uint8_t indent_level, mp_obj_array_t *array) {
-    uint32_t total_size = gc_nbytes(array);
-
-    uint32_t item_size = gc_nbytes(array->items);
-    total_size += item_size;
-    indent(indent_level);
-    mp_printf(&mp_plat_print, "Array of size: %u\n\n", item_size);
-
-    return total_size;
+// The heap memory that a module's globals can be found from, if any
+static void *module_root(mp_obj_t module) {
+    mp_obj_dict_t *globals = mp_obj_module_get_globals(module);
+    if (gc_ptr_on_heap(globals)) {
+        return globals;
+    }
+    if (gc_ptr_on_heap(globals->map.table)) {
+        return globals->map.table;
+    }
+    return NULL;
 }
 
-static uint32_t memoryview_size(uint8_t indent_level, mp_obj_array_t *array) {
-    uint32_t total_size = gc_nbytes(array);
-
-    indent(indent_level);
-    mp_printf(&mp_plat_print, "memoryview\n");
-
-    return total_size;
+// Fills in modules and stops from the loaded modules and __main__, returning
+// how many modules have something on the heap.
+static size_t find_modules(uheap_module_t *modules, void **stops, size_t *n_stops) {
+    mp_map_t *loaded = &MP_STATE_VM(mp_loaded_modules_dict).map;
+    size_t n = 0;
+    bool have_main = false;
+    for (size_t i = 0; i < loaded->alloc; i++) {
+        if (!mp_map_slot_is_filled(loaded, i) || !mp_obj_is_type(loaded->table[i].value, &mp_type_module)) {
+            continue;
+        }
+        mp_obj_t name = loaded->table[i].key;
+        have_main |= mp_obj_is_qstr(name) && MP_OBJ_QSTR_VALUE(name) == MP_QSTR___main__;
+        void *root = module_root(loaded->table[i].value);
+        if (root == NULL) {
+            continue;
+        }
+        modules[n].name = name;
+        modules[n].root = root;
+        stops[(*n_stops)++] = root;
+        stops[(*n_stops)++] = MP_OBJ_TO_PTR(loaded->table[i].value);
+        n++;
+    }
+    if (!have_main && gc_ptr_on_heap(MP_STATE_VM(dict_main).map.table)) {
+        modules[n].name = MP_OBJ_NEW_QSTR(MP_QSTR___main__);
+        modules[n].root = MP_STATE_VM(dict_main).map.table;
+        stops[(*n_stops)++] = modules[n].root;
+        n++;
+    }
+    return n;
 }
 
-static uint32_t type_size(uint8_t indent_level, mp_obj_type_t *type) {
-    uint32_t total_size = gc_nbytes(type);
-
-    // mp_obj_base_t base;
-    // qstr name;
-    // total_size += string_size(indent_level, MP_OBJ_TO_PTR(type->name));
-    // mp_print_fun_t print;
-    // mp_make_new_fun_t make_new;     // to make an instance of the type
-    //
-    // mp_call_fun_t call;
-    // mp_unary_op_fun_t unary_op;     // can return MP_OBJ_NULL if op not supported
-    // mp_binary_op_fun_t binary_op;   // can return MP_OBJ_NULL if op not supported
-    //
-    // // implements load, store and delete attribute
-    // //
-    // // dest[0] = MP_OBJ_NULL means load
-    // //  return: for fail, do nothing
-    // //          for attr, dest[0] = value
-    // //          for method, dest[0] = method, dest[1] = self
-    // //
-    // // dest[0,1] = {MP_OBJ_SENTINEL, MP_OBJ_NULL} means delete
-    // // dest[0,1] = {MP_OBJ_SENTINEL, object} means store
-    // //  return: for fail, do nothing
-    // //          for success set dest[0] = MP_OBJ_NULL
-    // mp_attr_fun_t attr;
-    //
-    // mp_subscr_fun_t subscr;         // implements load, store, delete subscripting
-    //                                 // value=MP_OBJ_NULL means delete, value=MP_OBJ_SENTINEL means load, else store
-    //                                 // can return MP_OBJ_NULL if op not supported
-    //
-    // mp_fun_1_t getiter;             // corresponds to __iter__ special method
-    // mp_fun_1_t iternext; // may return MP_OBJ_STOP_ITERATION as an optimisation instead of raising StopIteration() (with no args)
-    //
-    // mp_buffer_p_t buffer_p;
-    // // One of disjoint protocols (interfaces), like mp_stream_p_t, etc.
-    // const void *protocol;
-    //
-    // // these are for dynamically created types (classes)
-    // struct _mp_obj_tuple_t *bases_tuple;
-    // struct _mp_obj_dict_t *locals_dict;
-    if (type->locals_dict != NULL) {
-        total_size += dict_size(indent_level, type->locals_dict);
+size_t shared_module_uheap_info(mp_obj_t obj) {
+    mp_map_t *loaded = &MP_STATE_VM(mp_loaded_modules_dict).map;
+    size_t max_modules = loaded->alloc + 1;
+    uheap_module_t *modules = m_new(uheap_module_t, max_modules);
+    void **stops = m_new(void *, 2 * max_modules);
+    size_t n_stops = 0;
+    find_modules(modules, stops, &n_stops);
+
+    void *roots[2] = { MP_OBJ_TO_PTR(obj), NULL };
+    if (mp_obj_is_type(obj, &mp_type_module)) {
+        roots[1] = module_root(obj);
     }
+    size_t n_bytes = gc_reachable_bytes(roots, MP_ARRAY_SIZE(roots), stops, n_stops);
 
-    indent(indent_level);
-    mp_printf(&mp_plat_print, "TYPE\n");
-    return total_size;
+    m_del(void *, stops, 2 * max_modules);
+    m_del(uheap_module_t, modules, max_modules);
+    return n_bytes;
 }
 
-
-static uint32_t instance_size(uint8_t indent_level, mp_obj_instance_t *instance) {
-    uint32_t total_size = gc_nbytes(instance);
-
-    total_size += map_size(indent_level, &instance->members);
-
-    return total_size;
+static void write_bytes(mp_obj_t file, const mp_stream_p_t *stream_p, const void *buf, size_t len) {
+    int errcode = 0;
+    mp_uint_t ret = stream_p->write(file, buf, len, &errcode);
+    if (ret == MP_STREAM_ERROR) {
+        mp_raise_OSError(errcode);
+    }
 }
 
-static uint32_t module_size(uint8_t indent_level, mp_obj_module_t *module) {
-    uint32_t total_size = gc_nbytes(module);
+static void write_uint(mp_obj_t file, const mp_stream_p_t *stream_p, uint32_t value, size_t len) {
+    uint8_t buf[4];
+    for (size_t i = 0; i < len; i++) {
+        buf[i] = value >> (8 * i);
+    }
+    write_bytes(file, stream_p, buf, len);
+}
 
-    indent(indent_level);
-    mp_printf(&mp_plat_print, ".globals\n");
+static void write_name(mp_obj_t file, const mp_stream_p_t *stream_p, mp_obj_t name) {
+    size_t len = 0;
+    const char *str = "";
+    if (name != mp_const_none) {
+        str = mp_obj_str_get_data(name, &len);
+    }
+    len = MIN(len, 255);
+    write_uint(file, stream_p, len, 1);
+    write_bytes(file, stream_p, str, len);
+}
 
-    total_size += dict_size(indent_level + 1, module->globals);
+// Writes the snapshot in the format that tools/uheap_snapshot.py reads. All
+// numbers are little endian.
+static void write_snapshot(mp_obj_t file, mp_obj_t types, mp_obj_t modules) {
+    const mp_stream_p_t *stream_p = mp_get_stream_raise(file, MP_STREAM_OP_WRITE);
+    gc_info_t info;
+    gc_info(&info);
+    write_bytes(file, stream_p, "UHP1", 4);
+    write_uint(file, stream_p, MICROPY_BYTES_PER_GC_BLOCK, 1);
+    write_uint(file, stream_p, sizeof(void *), 1);
+    write_uint(file, stream_p, 0, 2);
+    write_uint(file, stream_p, info.total, 4);
+    write_uint(file, stream_p, info.used, 4);
+
+    mp_obj_t lists[] = { types, modules };
+    for (size_t l = 0; l < MP_ARRAY_SIZE(lists); l++) {
+        size_t len;
+        mp_obj_t *items;
+        mp_obj_list_get(lists[l], &len, &items);
+        write_uint(file, stream_p, len, 2);
+        for (size_t i = 0; i < len; i++) {
+            size_t n_fields;
+            mp_obj_t *fields;
+            mp_obj_tuple_get(items[i], &n_fields, &fields);
+            write_name(file, stream_p, fields[0]);
+            write_uint(file, stream_p, mp_obj_get_int(fields[1]), 4);
+            write_uint(file, stream_p, mp_obj_get_int(fields[2]), 4);
+        }
+    }
+}
 
-    indent(indent_level);
-    mp_printf(&mp_plat_print, "Module size: %u\n", total_size);
-    return total_size;
+static mp_obj_t new_entry(mp_obj_t name, size_t a, size_t b) {
+    mp_obj_t items[] = { name, mp_obj_new_int_from_uint(a), mp_obj_new_int_from_uint(b) };
+    return mp_obj_new_tuple(MP_ARRAY_SIZE(items), items);
 }
 
-static uint32_t object_size(uint8_t indent_level, mp_obj_t obj) {
-    if (obj == NULL) {
-        return 0;
+mp_obj_t shared_module_uheap_snapshot(mp_obj_t file) {
+    // Everything is allocated up front, because the heap can't change while
+    // it is being walked.
+    uheap_census_t census;
+    size_t max_known = for_each_module_type(NULL, 0) + MP_ARRAY_SIZE(core_types);
+    census.known = m_new(const mp_obj_type_t *, max_known);
+    census.n_known = 0;
+    for (size_t i = 0; i < MP_ARRAY_SIZE(core_types); i++) {
+        add_known_type(&census, core_types[i], max_known);
     }
-    if (mp_obj_is_int(obj)) {
-        return int_size(indent_level, MP_OBJ_TO_PTR(obj));
-    } else if (mp_obj_is_str(obj)) {
-        return string_size(indent_level, MP_OBJ_TO_PTR(obj));
-    } else if (mp_obj_is_fun(obj)) {
-        return function_size(indent_level, MP_OBJ_TO_PTR(obj));
+    for_each_module_type(&census, max_known);
+    census.counts = m_new(uheap_type_count_t, UHEAP_MAX_TYPES);
+    census.counts[0].type = NULL;
+    census.counts[0].count = 0;
+    census.counts[0].bytes = 0;
+    census.n_counts = 1;
+
+    mp_map_t *loaded = &MP_STATE_VM(mp_loaded_modules_dict).map;
+    size_t max_modules = loaded->alloc + 1;
+    uheap_module_t *modules = m_new(uheap_module_t, max_modules);
+    void **stops = m_new(void *, 2 * max_modules);
+    void **roots = m_new(void *, max_modules);
+    size_t n_stops = 0;
+    size_t n_modules = find_modules(modules, stops, &n_stops);
+
+    gc_heap_walk(census_block, &census);
+
+    // What a module retains is what can no longer be reached once it is gone
+    for (size_t i = 0; i < n_modules; i++) {
+        roots[i] = modules[i].root;
     }
-    if (!VERIFY_PTR(obj)) {
-        // indent(indent_level);
-        // mp_printf(&mp_plat_print, "In ROM\n");
-        return 0;
+    size_t total = gc_reachable_bytes(roots, n_modules, stops, n_stops);
+    for (size_t i = 0; i < n_modules; i++) {
+        roots[i] = NULL;
+        modules[i].retained = total - gc_reachable_bytes(roots, n_modules, stops, n_stops);
+        roots[i] = modules[i].root;
+        modules[i].reachable = gc_reachable_bytes(&roots[i], 1, stops, n_stops);
     }
-    mp_obj_t type = MP_OBJ_FROM_PTR(mp_obj_get_type(obj));
 
-    if (type == &mp_type_module) {
-        return module_size(indent_level, MP_OBJ_TO_PTR(obj));
-    } else if (type == &mp_type_dict) {
-        return dict_size(indent_level, MP_OBJ_TO_PTR(obj));
-    } else if (type == &mp_type_type) {
-        return type_size(indent_level, MP_OBJ_TO_PTR(obj));
-    } else if (type == &mp_type_bytearray || type == &mp_type_array) {
-        return array_size(indent_level, MP_OBJ_TO_PTR(obj));
-    } else if (type == &mp_type_memoryview) {
-        return memoryview_size(indent_level, MP_OBJ_TO_PTR(obj));
-    } else if (mp_obj_is_obj(obj) && VERIFY_PTR(type)) {
-        return instance_size(indent_level, MP_OBJ_TO_PTR(obj));
+    // Both lists go largest first
+    mp_obj_t types = mp_obj_new_list(0, NULL);
+    while (census.n_counts > 0) {
+        size_t largest = 0;
+        for (size_t i = 1; i < census.n_counts; i++) {
+            if (census.counts[i].bytes > census.counts[largest].bytes) {
+                largest = i;
+            }
+        }
+        uheap_type_count_t *count = &census.counts[largest];
+        if (count->count != 0) {
+            mp_obj_t name = count->type == NULL ? mp_const_none : MP_OBJ_NEW_QSTR(count->type->name);
+            mp_obj_list_append(types, new_entry(name, count->count, count->bytes));
+        }
+        *count = census.counts[--census.n_counts];
+    }
+    mp_obj_t module_list = mp_obj_new_list(0, NULL);
+    while (n_modules > 0) {
+        size_t largest = 0;
+        for (size_t i = 1; i < n_modules; i++) {
+            if (modules[i].retained > modules[largest].retained) {
+                largest = i;
+            }
+        }
+        uheap_module_t *module = &modules[largest];
+        mp_obj_list_append(module_list, new_entry(module->name, module->retained, module->reachable));
+        *module = modules[--n_modules];
     }
 
-    indent(indent_level);
-    mp_printf(&mp_plat_print, "unknown type %x\n", type);
-    return 0;
-}
+    m_del(void *, roots, max_modules);
+    m_del(void *, stops, 2 * max_modules);
+    m_del(uheap_module_t, modules, max_modules);
+    m_del(uheap_type_count_t, census.counts, UHEAP_MAX_TYPES);
+    m_del(const mp_obj_type_t *, census.known, max_known);
 
-uint32_t shared_module_uheap_info(mp_obj_t obj) {
-    if (!VERIFY_PTR(obj)) {
-        mp_printf(&mp_plat_print, "Object not on heap.\n");
-        return 0;
+    if (file != mp_const_none) {
+        write_snapshot(file, types, module_list);
     }
-    return object_size(0, obj);
+    mp_obj_t result[] = { types, module_list };
+    return mp_obj_new_tuple(MP_ARRAY_SIZE(result), result);
 }
@@ -27,3 +27,7 @@ void port_free(void *ptr);
 void *port_realloc(void *ptr, size_t size, bool dma_capable);
 
 size_t port_heap_get_largest_free_size(void);
+
+// Whether the RAM at ptr is fast, such as internal SRAM rather than PSRAM. The
+// VM heap places small objects in fast RAM and large buffers in slow RAM.
+bool port_heap_ptr_is_fast(const void *ptr);
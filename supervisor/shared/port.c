@@ -51,6 +51,10 @@ MP_WEAK void *port_realloc(void *ptr, size_t size, bool dma_capable) {
     return tlsf_realloc(heap, ptr, size);
 }
 
+MP_WEAK bool port_heap_ptr_is_fast(const void *ptr) {
+    return true;
+}
+
 static bool max_size_walker(void *ptr, size_t size, int used, void *user) {
     size_t *max_size = (size_t *)user;
     if (!used && *max_size < size) {
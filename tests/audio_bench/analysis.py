@@ -0,0 +1,27 @@
+# Levels alone and with spectra of two sizes, on a stereo source
+import array
+import audioanalysis
+import audiocore
+import math
+
+SAMPLE_RATE = 48000
+BUFFER_SIZE = 1024
+
+
+def source():
+    data = array.array("h", [int(12000 * math.sin(2 * math.pi * k / 120)) for k in range(240)] * 4)
+    return audiocore.RawSample(data, channel_count=2, sample_rate=SAMPLE_RATE)
+
+
+def analyzer(fft_size):
+    a = audioanalysis.Analyzer(
+        fft_size=fft_size, buffer_size=BUFFER_SIZE, channel_count=2, sample_rate=SAMPLE_RATE
+    )
+    a.play(source(), loop=True)
+    return a
+
+
+def bm_nodes():
+    yield "levels", analyzer(0)
+    yield "fft256", analyzer(256)
+    yield "fft1024", analyzer(1024)
@@ -0,0 +1,31 @@
+def bm_run(seconds):
+    try:
+        from time import ticks_us, ticks_diff
+    except ImportError:
+        # CIRCUITPY-CHANGE
+        import time
+
+        ticks_us = lambda: int(time.monotonic_ns() // 1000)
+        ticks_diff = lambda a, b: a - b
+    import audiocore
+
+    # Render each node offline for the given number of seconds of audio and
+    # report how many frames were produced and how long that took
+    for name, node in bm_nodes():
+        wanted = seconds * node.sample_rate
+        channel_count = node.channel_count
+        frames = 0
+        t0 = ticks_us()
+        while frames < wanted:
+            result, buf = audiocore.get_buffer(node)
+            frames += len(buf) // channel_count
+            if result == 0:
+                audiocore.reset_buffer(node)
+            elif result != 1:
+                print(name, -1, -1, "ERROR: get_buffer returned", result)
+                break
+        else:
+            t1 = ticks_us()
+            print(name, frames, ticks_diff(t1, t0))
+        if hasattr(node, "deinit"):
+            node.deinit()
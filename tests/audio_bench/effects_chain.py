@@ -0,0 +1,51 @@
+# Echo, filter and reverb on their own and chained echo -> filter -> reverb
+import array
+import audiocore
+import audiodelays
+import audiofilters
+import audiofreeverb
+import math
+import synthio
+
+SAMPLE_RATE = 48000
+BUFFER_SIZE = 1024
+FORMAT = {
+    "buffer_size": BUFFER_SIZE,
+    "channel_count": 2,
+    "sample_rate": SAMPLE_RATE,
+}
+
+
+def source():
+    data = array.array("h", [int(12000 * math.sin(2 * math.pi * k / 120)) for k in range(240)] * 4)
+    return audiocore.RawSample(data, channel_count=2, sample_rate=SAMPLE_RATE)
+
+
+def echo():
+    return audiodelays.Echo(max_delay_ms=250, delay_ms=200, decay=0.6, mix=0.5, **FORMAT)
+
+
+def filter():
+    return audiofilters.Filter(
+        filter=synthio.Biquad(synthio.FilterMode.LOW_PASS, frequency=3000), mix=1.0, **FORMAT
+    )
+
+
+def reverb():
+    return audiofreeverb.Freeverb(roomsize=0.7, damp=0.5, mix=0.4, **FORMAT)
+
+
+def play(effect, src):
+    effect.play(src, loop=True)
+    return effect
+
+
+def chain():
+    return play(reverb(), play(filter(), play(echo(), source())))
+
+
+def bm_nodes():
+    yield "echo", play(echo(), source())
+    yield "filter", play(filter(), source())
+    yield "reverb", play(reverb(), source())
+    yield "echo_filter_reverb", chain()
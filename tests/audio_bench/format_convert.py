@@ -0,0 +1,38 @@
+# Mixer voices in other formats, converted to the mixer's 16 bit stereo
+import array
+import audiocore
+import audiomixer
+import math
+
+SAMPLE_RATE = 48000
+BUFFER_SIZE = 1024
+
+
+def wave(typecode, scale, offset, channels):
+    return array.array(
+        typecode,
+        [int(offset + scale * math.sin(2 * math.pi * k / 120)) for k in range(240 * channels)] * 4,
+    )
+
+
+FORMATS = {
+    "s16m": lambda: wave("h", 12000, 0, 1),
+    "u8m": lambda: wave("B", 100, 128, 1),
+    "s8s": lambda: wave("b", 100, 0, 2),
+    "u16s": lambda: wave("H", 12000, 32768, 2),
+}
+
+
+def mixer(name):
+    data = FORMATS[name]()
+    channels = 2 if name.endswith("s") else 1
+    m = audiomixer.Mixer(
+        voice_count=1, channel_count=2, buffer_size=BUFFER_SIZE, sample_rate=SAMPLE_RATE
+    )
+    m.play(audiocore.RawSample(data, channel_count=channels, sample_rate=SAMPLE_RATE), loop=True)
+    return m
+
+
+def bm_nodes():
+    for name in FORMATS:
+        yield name, mixer(name)
@@ -0,0 +1,32 @@
+# Mixer summing M looping voices
+import array
+import audiocore
+import audiomixer
+import math
+
+SAMPLE_RATE = 48000
+BUFFER_SIZE = 1024
+
+
+def voice(i):
+    period = 50 + 7 * i
+    data = array.array(
+        "h", [int(12000 * math.sin(2 * math.pi * k / period)) for k in range(period * 2)] * 2
+    )
+    return audiocore.RawSample(data, channel_count=2, sample_rate=SAMPLE_RATE)
+
+
+def mixer(voices):
+    m = audiomixer.Mixer(
+        voice_count=voices, channel_count=2, buffer_size=BUFFER_SIZE, sample_rate=SAMPLE_RATE
+    )
+    for i in range(voices):
+        m.voice[i].level = 0.8
+        m.play(voice(i), voice=i, loop=True)
+    return m
+
+
+def bm_nodes():
+    yield "mixer_1", mixer(1)
+    yield "mixer_4", mixer(4)
+    yield "mixer_8", mixer(8)
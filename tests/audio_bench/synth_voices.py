@@ -0,0 +1,25 @@
+# Synthesizer rendering N simultaneous notes, each with an LFO on its bend and
+# a per-note filter on the largest one
+import synthio
+
+SAMPLE_RATE = 48000
+
+
+def synth(voices, filtered=False):
+    s = synthio.Synthesizer(sample_rate=SAMPLE_RATE, channel_count=2)
+    notes = []
+    for i in range(voices):
+        n = synthio.Note(frequency=220 + 37 * i, panning=(i % 3 - 1) / 2)
+        n.bend = synthio.LFO(rate=5 + i, scale=0.01)
+        if filtered:
+            n.filter = synthio.Biquad(synthio.FilterMode.LOW_PASS, frequency=2000 + 100 * i)
+        notes.append(n)
+    s.press(notes)
+    return s
+
+
+def bm_nodes():
+    yield "synth_1", synth(1)
+    yield "synth_4", synth(4)
+    yield "synth_12", synth(12)
+    yield "synth_12_filtered", synth(12, filtered=True)
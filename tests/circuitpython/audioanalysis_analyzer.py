@@ -0,0 +1,105 @@
+import array
+import audioanalysis
+import audiocore
+import math
+import micropython
+
+SAMPLE_RATE = 8000
+N = 64
+
+
+def sine(amplitude, cycles, channel_count=1):
+    data = array.array("h")
+    for i in range(N):
+        v = int(amplitude * math.sin(2 * math.pi * cycles * i / N))
+        for _ in range(channel_count):
+            data.append(v)
+    return audiocore.RawSample(data, channel_count=channel_count, sample_rate=SAMPLE_RATE)
+
+
+def fmt(values):
+    return " ".join("%.2f" % x for x in values)
+
+
+def levels(a):
+    return fmt((a.rms, a.peak, a.envelope))
+
+
+def bins(a):
+    return list(a.spectrum)
+
+
+# Without a sample the output is silence, and so are the levels
+a = audioanalysis.Analyzer(buffer_size=2 * N, sample_rate=SAMPLE_RATE, attack=0, release=0)
+result, buf = audiocore.get_buffer(a)
+print(result, len(buf), audiocore.get_silent(a), levels(a), a.spectrum, a.fft_size)
+
+# A sample in our format is passed through as it is
+src = sine(16384, 4)
+a.play(src, loop=True)
+result, buf = audiocore.get_buffer(a)
+print(result, list(buf) == list(audiocore.get_buffer(src)[1]), audiocore.get_silent(a), levels(a))
+a.stop()
+audiocore.get_buffer(a)
+print(a.playing, levels(a))
+
+# The envelope rises and falls at the attack and release rates
+a.attack = 0.016
+a.release = 0.08
+a.play(sine(32767, 4), loop=True)
+print(fmt(audiocore.get_buffer(a) and a.envelope for _ in range(4)))
+a.stop()
+print(fmt(audiocore.get_buffer(a) and a.envelope for _ in range(4)))
+print(a.attack, a.release)
+
+# The spectrum of a sine wave centred on a bin, through a Hann window
+a = audioanalysis.Analyzer(fft_size=N, buffer_size=2 * N, sample_rate=SAMPLE_RATE)
+spectrum = a.spectrum
+print(len(spectrum), spectrum is a.spectrum)
+a.play(sine(32767, 8), loop=True)
+audiocore.get_buffer(a)
+print(bins(a))
+# Reading the spectrum doesn't allocate
+peak_bin = None
+micropython.heap_lock()
+peak_bin = spectrum[8]
+micropython.heap_unlock()
+print(peak_bin)
+a.play(sine(8192, 3), loop=True)
+audiocore.get_buffer(a)
+print(bins(a))
+
+# Stereo is measured as the average of both channels, and 8 bit unsigned
+# output is measured after conversion
+a = audioanalysis.Analyzer(
+    fft_size=N,
+    buffer_size=N,
+    sample_rate=SAMPLE_RATE,
+    channel_count=2,
+    bits_per_sample=8,
+    samples_signed=False,
+)
+spectrum = a.spectrum
+a.play(sine(32767, 5, channel_count=2), loop=True)
+for _ in range(2):
+    result, buf = audiocore.get_buffer(a)
+print(len(buf), list(buf[:4]), levels(a))
+print(max(spectrum), list(spectrum).index(max(spectrum)))
+
+# Silent buffers clear the spectrum once enough of them have passed
+a.stop()
+for _ in range(2):
+    audiocore.get_buffer(a)
+print(max(spectrum))
+
+for kw in ({"fft_size": 8}, {"fft_size": 100}, {"fft_size": 4096}, {"attack": -1}, {"buffer_size": 2}):
+    try:
+        audioanalysis.Analyzer(**kw)
+    except ValueError as e:
+        print(kw, e)
+
+a.deinit()
+try:
+    a.rms
+except ValueError as e:
+    print(e)
@@ -0,0 +1,101 @@
+import array
+import audiocore
+import audiomixer
+import io
+
+BLOCK = 4
+
+
+def source(block_count, **kwargs):
+    data = array.array("h")
+    for i in range(block_count):
+        for j in range(BLOCK):
+            data.append(100 * (i + 1) + j)
+    return audiocore.FileCaptureSource(io.BytesIO(data), sample_rate=8000, **kwargs)
+
+
+def dump(sample):
+    result, buf = audiocore.get_buffer(sample)
+    print(result, list(buf), audiocore.get_silent(sample))
+
+
+def counts(capture):
+    print("overruns", capture.overruns, "underruns", capture.underruns)
+
+
+src = source(40)
+mic = audiocore.Capture(src, block_size=2 * BLOCK, block_count=8)
+print(src.running, mic.sample_rate, mic.channel_count, mic.bits_per_sample)
+
+# Before anything has been captured the output is silence, and that is not an underrun
+dump(mic)
+counts(mic)
+
+# Blocks are played in the order they were captured
+print(src.capture(2))
+dump(mic)
+dump(mic)
+
+# Running out after that is an underrun
+dump(mic)
+counts(mic)
+
+# Falling behind drops the oldest blocks, keeping only the newest
+print(src.capture(7))
+dump(mic)
+dump(mic)
+counts(mic)
+
+# Resetting skips whatever was captured before playback starts
+print(src.capture(3))
+audiocore.reset_buffer(mic)
+dump(mic)
+counts(mic)
+print(src.capture(1))
+dump(mic)
+
+# Capture plays through the rest of the audio graph, once the mixer has used up
+# the silence it was given when it started playing
+mixer = audiomixer.Mixer(voice_count=1, channel_count=1, buffer_size=4 * BLOCK, sample_rate=8000)
+mixer.play(mic, loop=True)
+print(src.capture(1))
+dump(mixer)
+dump(mixer)
+
+# Capturing stops at the end of the input
+print(src.capture(100))
+
+# Deinit stops the source, which can then be used again
+mic.deinit()
+print(src.running)
+try:
+    mic.overruns
+except ValueError as e:
+    print(e)
+with audiocore.Capture(src, block_size=2 * BLOCK) as mic2:
+    print(src.running)
+print(src.running)
+
+# The block size is rounded to whole frames
+stereo_src = source(4, channel_count=2)
+with audiocore.Capture(stereo_src, block_size=7) as stereo:
+    print(stereo_src.capture(1))
+    dump(stereo)
+
+# A source can only feed one capture at a time
+mic = audiocore.Capture(src)
+try:
+    audiocore.Capture(src)
+except RuntimeError as e:
+    print(e)
+mic.deinit()
+
+for kwargs in ({"block_size": 0}, {"block_count": 3}, {"block_count": 65}):
+    try:
+        audiocore.Capture(src, **kwargs)
+    except ValueError as e:
+        print(e)
+try:
+    audiocore.Capture(audiocore.RawSample(array.array("h", [0])))
+except TypeError as e:
+    print("TypeError")
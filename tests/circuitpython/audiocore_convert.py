@@ -0,0 +1,58 @@
+import array
+import audiocore
+import audiodelays
+import audiofilters
+import audiomixer
+
+SAMPLE_RATE = 8000
+
+
+def first(sample, count=6):
+    result, buf = audiocore.get_buffer(sample)
+    return result, len(buf), list(buf[:count])
+
+
+# Every format is converted to the mixer's
+sources = {
+    "u8m": (array.array("B", [0, 64, 128, 192, 255, 128, 128, 128]), 1),
+    "s8m": (array.array("b", [-128, -64, 0, 64, 127, 0, 0, 0]), 1),
+    "u16m": (array.array("H", [0, 16384, 32768, 49152, 65535, 32768, 32768, 32768]), 1),
+    "s16m": (array.array("h", [-32768, -16384, 0, 16384, 32767, 0, 0, 0]), 1),
+    "u8s": (array.array("B", [0, 255, 64, 192, 128, 128, 128, 128]), 2),
+    "s16s": (array.array("h", [-32768, 32767, -16384, 16384, 0, 0, 0, 0]), 2),
+}
+for out_channels in (1, 2):
+    for bits, signed in ((16, True), (16, False), (8, False), (8, True)):
+        print("mixer", bits, signed, out_channels)
+        for name, (data, channels) in sources.items():
+            m = audiomixer.Mixer(
+                voice_count=1,
+                buffer_size=32,
+                channel_count=out_channels,
+                bits_per_sample=bits,
+                samples_signed=signed,
+                sample_rate=SAMPLE_RATE,
+            )
+            m.play(audiocore.RawSample(data, channel_count=channels, sample_rate=SAMPLE_RATE))
+            print(name, first(m))
+
+# A long buffer is converted a piece at a time, and looping starts over
+m = audiomixer.Mixer(voice_count=1, buffer_size=64, channel_count=1, sample_rate=SAMPLE_RATE)
+m.play(audiocore.RawSample(array.array("b", range(-100, 100, 2)), sample_rate=SAMPLE_RATE), loop=True)
+for _ in range(8):
+    result, buf = audiocore.get_buffer(m)
+    print(result, len(buf), buf[0] >> 8, buf[-1] >> 8)
+
+# Effects convert too
+for effect in (
+    audiodelays.Echo(max_delay_ms=50, delay_ms=20, decay=0.0, mix=0.0, buffer_size=16, sample_rate=SAMPLE_RATE),
+    audiofilters.Distortion(mix=0.0, buffer_size=16, sample_rate=SAMPLE_RATE),
+):
+    effect.play(audiocore.RawSample(sources["u8s"][0], channel_count=2, sample_rate=SAMPLE_RATE))
+    print(type(effect).__name__, first(effect))
+
+# The sample rate has to match
+try:
+    m.play(audiocore.RawSample(sources["s16m"][0], sample_rate=16000))
+except ValueError as e:
+    print(e)
@@ -0,0 +1,99 @@
+import array
+import audiocore
+import audiodelays
+import audiofreeverb
+
+SAMPLE_RATE = 8000
+
+
+def impulse():
+    return audiocore.RawSample(array.array("h", [20000] + [0] * 799), sample_rate=SAMPLE_RATE)
+
+
+def peaks(effect, count):
+    # Buffer number, index and value of the first few nonzero samples
+    result = []
+    for k in range(count):
+        buf = audiocore.get_buffer(effect)[1]
+        result.extend((k, i, buf[i]) for i in range(len(buf)) if buf[i])
+    print(result[:4])
+
+
+def echo(**kwargs):
+    e = audiodelays.Echo(
+        max_delay_ms=500,
+        mix=1.0,
+        decay=0.5,
+        buffer_size=128,
+        channel_count=1,
+        sample_rate=SAMPLE_RATE,
+        **kwargs,
+    )
+    e.play(impulse())
+    return e
+
+
+e = echo(delay_ms=20)
+peaks(e, 8)
+
+# Raising the delay past what was allocated grows the buffer
+e = echo(delay_ms=20)
+e.delay_ms = 100
+peaks(e, 16)
+e.deinit()
+
+# Re-creating effects reuses released delay lines
+for _ in range(4):
+    e = echo(delay_ms=250)
+    e.deinit()
+e = echo(delay_ms=20, freq_shift=True)
+peaks(e, 4)
+e.deinit()
+
+c = audiodelays.Chorus(
+    max_delay_ms=50,
+    delay_ms=10,
+    voices=2,
+    mix=0.5,
+    buffer_size=128,
+    channel_count=1,
+    sample_rate=SAMPLE_RATE,
+)
+c.play(impulse())
+peaks(c, 4)
+c.deinit()
+
+m = audiodelays.MultiTapDelay(
+    max_delay_ms=500,
+    delay_ms=20,
+    taps=(1.0,),
+    mix=1.0,
+    decay=0.0,
+    buffer_size=128,
+    channel_count=1,
+    sample_rate=SAMPLE_RATE,
+)
+m.play(impulse())
+peaks(m, 4)
+m.delay_ms = 300
+m.deinit()
+
+p = audiodelays.PitchShift(
+    semitones=7,
+    mix=1.0,
+    window=256,
+    overlap=32,
+    buffer_size=128,
+    channel_count=1,
+    sample_rate=SAMPLE_RATE,
+)
+p.play(audiocore.RawSample(array.array("h", [0, 8000, 16000, 8000] * 64), sample_rate=SAMPLE_RATE))
+for _ in range(3):
+    audiocore.get_buffer(p)
+print(list(audiocore.get_buffer(p)[1][:8]))
+p.deinit()
+
+r = audiofreeverb.Freeverb(mix=1.0, buffer_size=128, channel_count=2, sample_rate=SAMPLE_RATE)
+r.play(audiocore.RawSample(array.array("h", [20000] * 2 + [0] * 1598), channel_count=2, sample_rate=SAMPLE_RATE))
+print(sum(abs(x) for _ in range(40) for x in audiocore.get_buffer(r)[1]) > 0)
+r.deinit()
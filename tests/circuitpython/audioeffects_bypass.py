@@ -0,0 +1,59 @@
+import array
+import audiocore
+import audiodelays
+import audiofilters
+import audiomixer
+import synthio
+
+SAMPLE_RATE = 8000
+KW = dict(buffer_size=64, channel_count=1, sample_rate=SAMPLE_RATE)
+
+
+def ramp():
+    return audiocore.RawSample(array.array("h", range(-2400, 2400, 50)), sample_rate=SAMPLE_RATE)
+
+
+def show(effect, count=1):
+    # Result, length, first values and whether the buffer was reported silent
+    for _ in range(count):
+        result, buf = audiocore.get_buffer(effect)
+        print(result, len(buf), list(buf[:3]), audiocore.get_silent(effect))
+
+
+effects = (
+    audiodelays.Echo(max_delay_ms=50, delay_ms=20, decay=0.5, **KW),
+    audiodelays.Chorus(max_delay_ms=50, delay_ms=10, voices=2, **KW),
+    audiofilters.Distortion(**KW),
+    audiofilters.Filter(filter=synthio.Biquad(synthio.FilterMode.LOW_PASS, 400), **KW),
+)
+
+for effect in effects:
+    print(type(effect).__name__)
+    # Nothing to play is silence
+    show(effect, 2)
+    # With a mix of 0 the sample is handed out as it is
+    effect.mix = 0.0
+    effect.play(ramp())
+    show(effect, 3)
+    # Once the sample runs out the output is silent again
+    effect.mix = 1.0
+    show(effect, 2)
+
+# The echo keeps going after the sample has ended, until it dies out
+e = audiodelays.Echo(max_delay_ms=50, delay_ms=20, decay=0.5, mix=1.0, **KW)
+e.play(audiocore.RawSample(array.array("h", [20000] + [0] * 63), sample_rate=SAMPLE_RATE))
+silent = [audiocore.get_buffer(e) and audiocore.get_silent(e) for _ in range(100)]
+print(silent.index(True), all(silent[silent.index(True) :]))
+print(sum(abs(x) for x in audiocore.get_buffer(e)[1]))
+
+# Unsigned silence is the middle of the range
+d = audiofilters.Distortion(buffer_size=8, channel_count=1, sample_rate=SAMPLE_RATE, samples_signed=False)
+print(list(audiocore.get_buffer(d)[1]))
+
+# A mixer with only silent voices is silent too
+m = audiomixer.Mixer(voice_count=2, **KW)
+m.play(effects[0], voice=0)
+m.play(effects[2], voice=1)
+show(m)
+m.voice[1].play(ramp())
+show(m)
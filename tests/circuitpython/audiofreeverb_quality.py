@@ -0,0 +1,55 @@
+import array
+import audiocore
+import audiofreeverb
+
+SAMPLE_RATE = 8000
+
+
+def impulse(channel_count):
+    # an impulse in the first channel only
+    return audiocore.RawSample(
+        array.array("h", [20000] + [0] * (800 * channel_count - 1)),
+        channel_count=channel_count,
+        sample_rate=SAMPLE_RATE,
+    )
+
+
+def tail(channel_count, **kwargs):
+    r = audiofreeverb.Freeverb(
+        roomsize=0.8,
+        mix=1.0,
+        buffer_size=512,
+        channel_count=channel_count,
+        sample_rate=SAMPLE_RATE,
+        **kwargs,
+    )
+    r.play(impulse(channel_count))
+    samples = []
+    for _ in range(24):
+        samples.extend(audiocore.get_buffer(r)[1])
+    r.deinit()
+    return [samples[c::channel_count] for c in range(channel_count)]
+
+
+def first_echo(samples):
+    for i, s in enumerate(samples):
+        if s:
+            return i, s
+
+
+for quality in (2, 1, 0):
+    left, right = tail(2, quality=quality)
+    print(quality, first_echo(left), first_echo(right), left == right, sum(abs(s) for s in left) > 0)
+
+# A mono reverb only has one bank, so qualities 1 and 2 are the same
+print(tail(1, quality=2) == tail(1, quality=1), tail(1, quality=2) == tail(1, quality=0))
+print(tail(1) == tail(1, internal_memory=True))
+
+r = audiofreeverb.Freeverb(quality=1, channel_count=2)
+print(r.quality)
+r.deinit()
+
+try:
+    audiofreeverb.Freeverb(quality=3)
+except ValueError as e:
+    print("ValueError")
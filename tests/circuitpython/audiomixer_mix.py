@@ -0,0 +1,57 @@
+import array
+import audiocore
+import audiomixer
+
+
+def sample(data, typecode="h"):
+    return audiocore.RawSample(array.array(typecode, data * 16), sample_rate=8000)
+
+
+def dump(mixer):
+    print(list(audiocore.get_buffer(mixer)[1][:4]))
+
+
+loud = sample([30000, -30000, 20000, -20000])
+loud_inverted = sample([-30000, 30000, -20000, 20000])
+quiet = sample([1000, -1000, 500, -500])
+
+m = audiomixer.Mixer(voice_count=3, channel_count=1, buffer_size=64, sample_rate=8000)
+dump(m)
+
+# The limiter is set for all three voices, so the peaks of a single voice are
+# already compressed, the same as when the others are playing
+m.play(loud, voice=0, loop=True)
+dump(m)
+
+# Peaks of the sum are compressed instead of clipped
+m.play(loud, voice=1, loop=True)
+dump(m)
+
+# Voices are summed before limiting, so they can cancel out
+m.play(loud_inverted, voice=2, loop=True)
+dump(m)
+
+# The result does not depend on the order of the voices
+for order in ((quiet, loud, loud), (loud, quiet, loud), (loud, loud, quiet)):
+    m = audiomixer.Mixer(voice_count=3, channel_count=1, buffer_size=64, sample_rate=8000)
+    for i, s in enumerate(order):
+        m.play(s, voice=i, loop=True)
+    dump(m)
+
+m.voice[0].level = 0.5
+m.voice[1].level = 0.5
+m.voice[2].level = 0.5
+dump(m)
+
+m = audiomixer.Mixer(
+    voice_count=2,
+    channel_count=1,
+    buffer_size=64,
+    sample_rate=8000,
+    bits_per_sample=8,
+    samples_signed=False,
+)
+m.play(sample([250, 5, 128, 200], "B"), voice=0, loop=True)
+dump(m)
+m.play(sample([250, 5, 128, 100], "B"), voice=1, loop=True)
+dump(m)
@@ -0,0 +1,108 @@
+import io
+import struct
+
+try:
+    import audiocore
+    import audiomp3
+
+    audiocore.get_buffer
+except (ImportError, AttributeError):
+    print("SKIP")
+    raise SystemExit
+
+# Silent MPEG-1 layer III frames at 32kHz, mono, without padding. All-zero
+# side info decodes to silence. A 32kbit/s frame is 144 bytes and 64kbit/s
+# one 288 bytes; both hold 1152 samples (36ms).
+SAMPLES = 1152
+
+
+def frame(kbps=32, data=b""):
+    header = bytes((0xFF, 0xFB, {32: 1, 64: 5}[kbps] << 4 | 2 << 2, 0xC0))
+    return header + data + bytes(144 * kbps // 32 - 4 - len(data))
+
+
+def xing(frames, length):
+    toc = bytes(i * 256 // 100 for i in range(100))
+    return frame(data=bytes(17) + b"Xing" + struct.pack(">III", 7, frames, length) + toc)
+
+
+def vbri(frames, length, sizes, frames_per_entry):
+    table = b"".join(struct.pack(">H", size) for size in sizes)
+    fields = struct.pack(">HHHIIHHHH", 1, 0, 75, length, frames, len(sizes), 1, 2, frames_per_entry)
+    return frame(data=bytes(32) + b"VBRI" + fields + table)
+
+
+cbr = frame() * 200
+vbr = frame() * 100 + frame(64) * 100
+with_xing = xing(201, 201 * 144) + cbr
+with_vbri = vbri(200, 144 + len(vbr), [1440] * 10 + [2880] * 10, 10) + vbr
+
+
+def position(n):
+    # The middle of frame n, in seconds
+    return (n + 0.5) * SAMPLES / 32000
+
+
+def play(mp3):
+    frames = 0
+    while True:
+        r, buf = audiocore.get_buffer(mp3)
+        if len(buf):
+            frames += 1
+        if r != 1:
+            return frames
+
+
+def pull(mp3, n):
+    for _ in range(n):
+        audiocore.get_buffer(mp3)
+
+
+mp3 = audiomp3.MP3Decoder(io.BytesIO(cbr))
+print(mp3.sample_rate, mp3.channel_count, mp3.samples_decoded, mp3.decode_time)
+print(play(mp3), mp3.samples_decoded // SAMPLES)
+print(0 <= mp3.decode_time < 0.1)
+
+# Loop from the start
+audiocore.reset_buffer(mp3)
+print(mp3.samples_decoded, play(mp3))
+
+# Into the index, and past it. Without a table of contents, the jump assumes
+# a constant bitrate.
+mp3 = audiomp3.MP3Decoder(io.BytesIO(cbr))
+pull(mp3, 40)
+mp3.seek(position(150))
+print(mp3.samples_decoded // SAMPLES, play(mp3))
+mp3.seek(position(20))
+print(mp3.samples_decoded // SAMPLES, play(mp3))
+mp3.seek(position(300))
+print(play(mp3))
+
+# Which lands on a frame with a higher bitrate when it actually goes up, so
+# the frames are walked through instead, then and for later seeks
+mp3 = audiomp3.MP3Decoder(io.BytesIO(vbr))
+mp3.seek(position(150))
+print(mp3.samples_decoded // SAMPLES, play(mp3))
+mp3.seek(position(170))
+print(mp3.samples_decoded // SAMPLES, play(mp3))
+
+# Tables of contents in Xing and VBRI headers
+for data in (with_xing, with_vbri):
+    mp3 = audiomp3.MP3Decoder(io.BytesIO(data))
+    mp3.seek(position(150))
+    print(mp3.samples_decoded // SAMPLES, 50 <= play(mp3) <= 52)
+    mp3.seek(position(10))
+    print(play(mp3))
+
+# Decoding ahead. Here a frame is decoded in the background as soon as one
+# is handed out, so playback never catches up with decoding.
+mp3 = audiomp3.MP3Decoder(io.BytesIO(cbr), frames_ahead=4)
+print(mp3.underruns, mp3.decode_time >= 0)
+print(play(mp3), mp3.underruns, mp3.samples_decoded // SAMPLES)
+audiocore.reset_buffer(mp3)
+print(mp3.samples_decoded, play(mp3))
+mp3.seek(position(150))
+print(mp3.samples_decoded // SAMPLES, play(mp3))
+mp3.seek(position(20))
+print(mp3.samples_decoded // SAMPLES, play(mp3))
+mp3.deinit()
@@ -0,0 +1,74 @@
+import memorymonitor
+
+
+def small(n):
+    return [(i, i) for i in range(n)]
+
+
+def big(n):
+    return [bytearray(1000) for _ in range(n)]
+
+
+def work():
+    a = small(10)
+    b = big(5)
+    return a, b
+
+
+def counts(report):
+    return sum(r[4] for r in report), sum(r[5] for r in report)
+
+
+# Every allocation is attributed to the Python line and C function that made it
+profiler = memorymonitor.AllocationProfiler()
+print(profiler.running)
+with profiler:
+    print(profiler.running)
+    work()
+print(profiler.running)
+report = profiler.report()
+print(counts(report) == (profiler.total_allocations, profiler.total_bytes))
+print(profiler.dropped)
+file, function, line, caller, count, size = report[0]
+print(file.endswith("memorymonitor_profiler.py"), function, line, count, size >= 5000)
+print(all(isinstance(r[3], int) and r[3] != 0 for r in report))
+print({r[1] for r in report if r[1] in ("small", "big", "work")} == {"small", "big", "work"})
+
+# Reports don't record their own allocations
+with profiler:
+    work()
+    print(profiler.report() == profiler.report())
+
+# Sampling every few allocations or bytes
+profiler = memorymonitor.AllocationProfiler(every=4)
+with profiler:
+    work()
+print(counts(profiler.report())[0] == profiler.total_allocations // 4)
+
+profiler = memorymonitor.AllocationProfiler(every_bytes=4096)
+with profiler:
+    work()
+print(counts(profiler.report())[0] == profiler.total_bytes // 4096)
+
+# Places past max_sites are dropped
+profiler = memorymonitor.AllocationProfiler(max_sites=2)
+with profiler:
+    work()
+print(len(profiler.report()), profiler.dropped > 0)
+profiler.clear()
+print(profiler.report(), profiler.total_allocations, profiler.dropped)
+
+for kwargs in ({"every": 0}, {"every_bytes": -1}, {"max_sites": 0}, {"max_sites": 257}):
+    try:
+        memorymonitor.AllocationProfiler(**kwargs)
+    except ValueError as e:
+        print(e)
+
+# Profiling can't be started twice
+profiler = memorymonitor.AllocationProfiler()
+with profiler:
+    try:
+        profiler.__enter__()
+    except RuntimeError as e:
+        print(e)
+print(profiler.running)
@@ -0,0 +1,73 @@
+try:
+    from synthio import MidiTrack
+    from audiocore import get_buffer
+except ImportError:
+    print("SKIP")
+    raise SystemExit
+
+
+# Render the whole track and print the buffer lengths and the sample ranges
+# where a note sounds
+def play(m):
+    lengths = []
+    samples = []
+    while True:
+        result, data = get_buffer(m)
+        lengths.append(len(data))
+        samples.extend(data)
+        if result == 0:
+            break
+    spans = []
+    start = None
+    for i, s in enumerate(samples + [0]):
+        if s and start is None:
+            start = i
+        elif not s and start is not None:
+            spans.append((start, i))
+            start = None
+    print(lengths, spans)
+
+
+# 8 samples per tick: the note starts at sample 40, within a full length
+# buffer, and is released at sample 320, after which the envelope fades it out
+# in steps of 256 samples.
+TRACK = b"\x05\x90@\0\x23\x80@\0\x3c\xff\x2f\0"
+play(MidiTrack(TRACK, tempo=1000, sample_rate=8000))
+
+# running status, and meta events before the end of the track
+TRACK2 = b"\0\xff\x03\x04name\x05\x90@\0\x23@\0\0\x80@\0\x01\xff\x2f\0"
+m = MidiTrack(TRACK2, tempo=1000, sample_rate=8000)
+play(m)
+print(m.error_location)
+
+# merged tracks; the track lasts as long as the longest one
+play(
+    MidiTrack(
+        (b"\x05\x90@\0\x05\x80@\0", b"\x14\x90@\0\x05\x80@\0\x28\xff\x2f\0"),
+        tempo=1000,
+        sample_rate=8000,
+    )
+)
+
+# a Set Tempo event halves the tempo from tick 10 when ticks_per_beat is given
+TRACK3 = b"\0\x90@\0\x0a\xff\x51\x03\x0f\x42\x40\0\x80@\0\x0a\x90@\0\x0a\x80@\0"
+play(MidiTrack(TRACK3, tempo=2000, sample_rate=8000, ticks_per_beat=1000))
+play(MidiTrack(TRACK3, tempo=2000, sample_rate=8000))
+
+# changing the tempo while playing
+m = MidiTrack(TRACK, tempo=1000, sample_rate=8000)
+print(m.tempo)
+result, data = get_buffer(m)
+m.tempo = 500
+print(m.tempo)
+play(m)
+
+# errors stop the track
+m = MidiTrack(b"\0\x90@\0\x10\x90\x80\0", tempo=1000, sample_rate=8000)
+play(m)
+print(m.error_location)
+
+try:
+    MidiTrack(TRACK, tempo=0)
+except ValueError as e:
+    print("ValueError")
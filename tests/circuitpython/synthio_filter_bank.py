@@ -0,0 +1,23 @@
+import audiocore
+import synthio
+
+# Many filtered notes are filtered in groups; the result must not depend on
+# how the notes fall into groups, or on Biquads being shared between notes
+s = synthio.Synthesizer(sample_rate=8000, channel_count=2)
+low = synthio.Biquad(synthio.FilterMode.LOW_PASS, frequency=800)
+sweep = synthio.Biquad(
+    synthio.FilterMode.BAND_PASS, frequency=synthio.LFO(rate=3, scale=200, offset=1000)
+)
+notes = []
+for i in range(9):
+    f = low if i % 3 == 0 else sweep if i % 3 == 1 else synthio.Biquad(synthio.FilterMode.HIGH_PASS, frequency=300 + 50 * i)
+    notes.append(synthio.Note(110 + 30 * i, panning=(i % 3 - 1) / 2, filter=f))
+# one unfiltered note in between
+notes.insert(4, synthio.Note(330))
+s.press(notes)
+
+for n in range(8):
+    buf = audiocore.get_buffer(s)[1]
+    print(n, sum(buf), list(buf[:6]))
+    if n == 3:
+        s.release(notes[:5])
@@ -0,0 +1,41 @@
+import array
+import audiocore
+import synthio
+
+# A constant waveform, so that the output follows the note's loudness
+dc = array.array("h", [16000, 16000])
+
+
+def render(ramp, **kwargs):
+    s = synthio.Synthesizer(sample_rate=8000, waveform=dc, ramp=ramp)
+    n = synthio.Note(440, **kwargs)
+    s.press(n)
+    first = list(audiocore.get_buffer(s)[1])
+    n.amplitude = 0.25
+    second = list(audiocore.get_buffer(s)[1])
+    return s, first + second
+
+
+for ramp in (False, True):
+    s, samples = render(ramp)
+    print(s.ramp, samples[254:258], samples[-1])
+    print("largest step", max(abs(a - b) for a, b in zip(samples[256:], samples[255:])))
+
+s = synthio.Synthesizer(sample_rate=8000)
+print(s.ramp)
+s.ramp = True
+print(s.ramp)
+
+# A filter sweep is ramped too: once the ramp is done the output matches the
+# unramped filter
+for ramp in (False, True):
+    s = synthio.Synthesizer(sample_rate=8000, ramp=ramp)
+    f = synthio.Biquad(synthio.FilterMode.LOW_PASS, frequency=200)
+    n = synthio.Note(110, filter=f)
+    s.press(n)
+    audiocore.get_buffer(s)
+    f.frequency = 2000
+    buf = audiocore.get_buffer(s)[1]
+    print(ramp, list(buf[:4]), list(buf[-4:]))
+    buf = audiocore.get_buffer(s)[1]
+    print(ramp, list(buf[:4]))
@@ -0,0 +1,36 @@
+import audiocore
+import synthio
+
+# Each synthesizer advances its LFOs by its own clock
+slow = synthio.Synthesizer(sample_rate=8000)
+fast = synthio.Synthesizer(sample_rate=16000)
+slow_lfo = synthio.LFO(rate=1)
+fast_lfo = synthio.LFO(rate=1)
+slow.blocks.append(slow_lfo)
+fast.blocks.append(fast_lfo)
+
+for _ in range(4):
+    audiocore.get_buffer(slow)
+    audiocore.get_buffer(fast)
+print(round(slow_lfo.phase, 3), round(fast_lfo.phase, 3))
+
+# Rendering another graph in between does not leave stale values behind, even
+# after many blocks
+other = synthio.Synthesizer(sample_rate=8000)
+other.blocks.append(synthio.LFO(rate=3))
+for n in (1, 255, 256, 1000):
+    before = slow_lfo.phase
+    for _ in range(n):
+        audiocore.get_buffer(other)
+    audiocore.get_buffer(slow)
+    print(n, round(slow_lfo.phase - before, 3))
+
+# An LFO used by two synthesizers advances with each of them
+shared = synthio.LFO(rate=2)
+a = synthio.Synthesizer(sample_rate=8000)
+b = synthio.Synthesizer(sample_rate=8000)
+a.blocks.append(shared)
+b.blocks.append(shared)
+audiocore.get_buffer(a)
+audiocore.get_buffer(b)
+print(round(shared.phase, 3))
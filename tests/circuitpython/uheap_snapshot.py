@@ -0,0 +1,81 @@
+import io
+import struct
+import sys
+import uheap
+
+try:
+    import frzqstr
+except ImportError:
+    print("SKIP")
+    raise SystemExit
+
+
+class Thing:
+    def __init__(self, n):
+        self.n = n
+
+
+def count(types, name):
+    for t in types:
+        if t[0] == name:
+            return t[1]
+    return 0
+
+
+def module(modules, name):
+    for m in modules:
+        if m[0] == name:
+            return m
+    return None
+
+
+# Objects are counted by type
+things = [Thing(i) for i in range(50)]
+types, modules = uheap.snapshot()
+print(count(types, "Thing"), count(types, "NoSuchType"))
+print(types == sorted(types, key=lambda t: t[2], reverse=True))
+print(modules == sorted(modules, key=lambda m: m[1], reverse=True))
+print(all(t[0] is None or isinstance(t[0], str) for t in types))
+things = None
+
+# info() counts everything an object holds on to
+data = bytearray(5000)
+print(uheap.info(data) >= 5000)
+print(uheap.info([data, data]) - uheap.info(data) < 100)
+print(uheap.info(1))
+
+# Nesting deeper than any stack doesn't matter
+deep = []
+for i in range(10000):
+    deep = [deep]
+print(uheap.info(deep) >= 10000 * 16)
+deep = None
+
+# What only one module can reach is retained by it; shared data is not
+frzqstr.private = bytearray(3000)
+frzqstr.shared = bytearray(7000)
+shared = frzqstr.shared
+types, modules = uheap.snapshot()
+name, retained, reachable = module(modules, "frzqstr")
+print(3000 <= retained < 7000, reachable >= 10000)
+name, retained, reachable = module(modules, "__main__")
+print(reachable - retained >= 7000)
+print(uheap.info(frzqstr) >= 10000)
+
+# The snapshot can be written to a stream
+stream = io.BytesIO()
+types, modules = uheap.snapshot(stream)
+data = stream.getvalue()
+magic, block_size, pointer_size, _, total, used = struct.unpack_from("<4sBBHII", data)
+print(magic, block_size > 0, pointer_size == struct.calcsize("P"), used <= total)
+offset = 16
+n_types = struct.unpack_from("<H", data, offset)[0]
+print(n_types == len(types))
+
+# A module loaded under two names is only counted once, and neither name
+# retains anything the other still reaches
+sys.modules["frzqstr_alias"] = frzqstr
+types, modules = uheap.snapshot()
+print(module(modules, "frzqstr")[1], module(modules, "frzqstr_alias")[1])
+print(module(modules, "frzqstr")[2] == module(modules, "frzqstr_alias")[2])
+del sys.modules["frzqstr_alias"]
@@ -0,0 +1,68 @@
+import array
+import struct
+
+import audiocore
+
+
+def wave(data, extra=b""):
+    return (
+        b"RIFF"
+        + struct.pack("<I", 36 + len(extra) + len(data) * 2)
+        + b"WAVEfmt "
+        + struct.pack("<IHHIIHH", 16, 1, 1, 8000, 16000, 2, 16)
+        + extra
+        + b"data"
+        + struct.pack("<I", len(data) * 2)
+        + bytes(data)
+    )
+
+
+def play(w):
+    audiocore.reset_buffer(w)
+    result = []
+    while True:
+        r, buf = audiocore.get_buffer(w)
+        result.append((r, len(buf), buf[0], buf[-1]))
+        if r != 1:
+            return result
+
+
+data = array.array("h", range(0, 3000, 3))
+contents = bytearray(wave(data))
+w = audiocore.WaveFile(contents)
+print(w.sample_rate, w.bits_per_sample, w.channel_count)
+# play twice, as when looping
+reference = play(w)
+print(reference)
+print(play(w) == reference)
+
+# The data is played in place, so changes to the buffer are heard
+contents[44:46] = struct.pack("<h", -1234)
+print(play(w)[0])
+
+# A chunk ahead of the data leaves it unaligned, so it is copied
+unaligned = bytearray(wave(data, b"LIST" + struct.pack("<I", 2) + b"xx"))
+w = audiocore.WaveFile(unaligned)
+unaligned[54:56] = struct.pack("<h", -1234)
+print(play(w) == reference)
+
+# A trailing partial word is left off
+print(play(audiocore.WaveFile(wave(array.array("h", range(3)))))[-1])
+
+# RawSample plays a buffer in place too
+print(audiocore.RawSample(memoryview(contents)[44:].cast("h"), sample_rate=8000).sample_rate)
+
+for kwargs in ({"readahead": 1024}, {"outside_heap": True}):
+    try:
+        audiocore.WaveFile(contents, **kwargs)
+    except ValueError as e:
+        print(e)
+try:
+    audiocore.WaveFile(contents, bytearray(16))
+except ValueError as e:
+    print(e)
+
+try:
+    audiocore.WaveFile(b"RIFX" + bytes(40))
+except ValueError as e:
+    print(e)
@@ -0,0 +1,81 @@
+import array
+import os
+import struct
+
+import audiocore
+
+try:
+    os.VfsFat
+except AttributeError:
+    print("SKIP")
+    raise SystemExit
+
+
+class RAMBlockDev:
+    def __init__(self, blocks):
+        self.data = bytearray(blocks * 512)
+
+    def readblocks(self, n, buf):
+        buf[:] = self.data[n * 512 : n * 512 + len(buf)]
+        return 0
+
+    def writeblocks(self, n, buf):
+        self.data[n * 512 : n * 512 + len(buf)] = buf
+        return 0
+
+    def ioctl(self, op, arg):
+        if op == 4:  # block count
+            return len(self.data) // 512
+        if op == 5:  # block size
+            return 512
+
+
+bdev = RAMBlockDev(64)
+os.VfsFat.mkfs(bdev)
+os.mount(os.VfsFat(bdev), "/ramdisk")
+
+data = array.array("h", range(0, 3000, 3))
+with open("/ramdisk/test.wav", "wb") as f:
+    f.write(b"RIFF" + struct.pack("<I", 36 + len(data) * 2) + b"WAVEfmt ")
+    f.write(struct.pack("<IHHIIHH", 16, 1, 1, 8000, 16000, 2, 16))
+    f.write(b"data" + struct.pack("<I", len(data) * 2))
+    f.write(data)
+
+
+def play(w):
+    audiocore.reset_buffer(w)
+    result = []
+    while True:
+        r, buf = audiocore.get_buffer(w)
+        result.append((r, len(buf), buf[0], buf[-1]))
+        if r != 1:
+            return result
+
+
+reference = play(audiocore.WaveFile("/ramdisk/test.wav"))
+print(reference)
+
+for kwargs in (
+    {"readahead": 1},
+    {"readahead": 1024},
+    {"readahead": 1024, "outside_heap": True},
+    {"preload": True},
+    {"preload": True, "outside_heap": True},
+):
+    w = audiocore.WaveFile("/ramdisk/test.wav", **kwargs)
+    # play twice, as when looping
+    print(kwargs, play(w) == reference, play(w) == reference)
+    print(w.readahead_refills > 0, w.readahead_stalls)
+    w.deinit()
+
+try:
+    audiocore.WaveFile("/ramdisk/test.wav", bytearray(16), preload=True)
+except ValueError as e:
+    print(e)
+
+try:
+    audiocore.WaveFile("/ramdisk/test.wav", readahead=-1)
+except ValueError as e:
+    print(e)
+
+os.umount("/ramdisk")
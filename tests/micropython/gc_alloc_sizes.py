@@ -0,0 +1,59 @@
+# test that allocations of mixed sizes find the free space left between others
+
+import gc
+
+try:
+    gc.disable
+except AttributeError:
+    print("SKIP")
+    raise SystemExit
+
+
+def fill(n, size):
+    return bytearray((n + i) & 0xFF for i in range(size))
+
+
+def check(objs):
+    for n, b in objs:
+        if b != fill(n, len(b)):
+            return False
+    return True
+
+
+# Objects of many sizes, with every other one dropped to leave gaps
+objs = [(n, fill(n, 1 + n * 13 % 200)) for n in range(300)]
+objs = objs[::2]
+gc.collect()
+print(check(objs))
+
+# New objects of all sizes fill the gaps, without disturbing the old ones
+objs += [(n, fill(n, 1 + n * 7 % 250)) for n in range(300, 600)]
+print(check(objs))
+
+# Growing and shrinking in place keeps the contents
+for i in range(0, len(objs), 3):
+    n, b = objs[i]
+    b.extend(fill(n + len(b), 40))
+    objs[i] = (n, b)
+print(check(objs))
+for i in range(1, len(objs), 3):
+    n, b = objs[i]
+    objs[i] = (n, b[: len(b) // 2])
+gc.collect()
+print(check(objs))
+
+# With collection disabled, a failed large allocation doesn't stop small ones
+gc.disable()
+hog = []
+try:
+    while True:
+        hog.append(bytearray(4096))
+except MemoryError:
+    pass
+small = [bytearray(8) for _ in range(10)]
+print(len(small))
+hog = None
+gc.enable()
+gc.collect()
+print(check(objs))
+
@@ -0,0 +1,62 @@
+# test that large lists, bytearrays and arrays keep their contents when
+# memory runs out, which may compact the heap
+
+import gc
+
+try:
+    import array
+except ImportError:
+    print("SKIP")
+    raise SystemExit
+
+
+def make(n):
+    k = n % 3
+    if k == 0:
+        return [n + i for i in range(300)]
+    if k == 1:
+        return bytearray((n + i) & 0xFF for i in range(2000))
+    return array.array("i", (n + i for i in range(500)))
+
+
+def check(objs):
+    for n, o in objs:
+        if o != make(n):
+            return False
+    return True
+
+
+# Large objects with garbage of the same size between them
+objs = []
+for n in range(30):
+    objs.append((n, make(n)))
+    make(n + 100)
+gc.collect()
+print(check(objs))
+
+# A memoryview and an iterator hold on to some of them
+view = memoryview(objs[4][1])
+it = iter(objs[3][1])
+next(it)
+
+# Run out of memory with ever larger allocations
+size = 4096
+big = None
+try:
+    while True:
+        big = None
+        big = bytearray(size)
+        size *= 2
+except MemoryError:
+    pass
+big = None
+print(check(objs))
+print(view[0] == objs[4][1][0], view[:10] == objs[4][1][:10])
+print(next(it) == objs[3][1][1])
+
+# They still grow and shrink as usual
+view = None
+for n, o in objs:
+    o.extend(make(n))
+    o[len(o) // 2 :] = o[:0]
+print(check(objs))
@@ -0,0 +1,66 @@
+# test that objects stay intact when automatic collections mark them a slice
+# at a time, while the program keeps storing new objects in old ones
+
+import gc
+
+try:
+    gc.threshold
+except AttributeError:
+    print("SKIP")
+    raise SystemExit
+
+
+class Node:
+    pass
+
+
+def counter():
+    seen = []
+
+    def add(i):
+        nonlocal seen
+        seen = [i, seen[:1]]
+        return seen
+
+    return add
+
+
+gc.collect()
+gc.threshold(8192)
+
+# Old lists, dicts, sets and instances have new objects stored in them
+nodes = [Node() for _ in range(200)]
+table = {}
+names = set()
+add = counter()
+for i in range(30000):
+    n = nodes[i % 200]
+    n.value = [i, str(i)]
+    table[i % 300] = (i, [i])
+    names.add(str(i % 40))
+    add(i)
+    if i % 500 == 0:
+        # and new ones are put in place of old ones
+        nodes[(i // 500) % 200] = Node()
+        nodes[(i // 500) % 200].value = [i, str(i)]
+print(all(n.value[1] == str(n.value[0]) for n in nodes))
+print(all(v[1][0] == v[0] and v[0] % 300 == k for k, v in table.items()))
+print(len(names), add(30000)[1][0])
+
+# A linked list that is built while it is being marked
+head = None
+for i in range(5000):
+    n = Node()
+    n.next = head
+    n.value = i
+    head = n
+    bytearray(40)
+total = 0
+while head is not None:
+    total += head.value
+    head = head.next
+print(total)
+
+gc.threshold(-1)
+nodes = table = names = add = None
+gc.collect()
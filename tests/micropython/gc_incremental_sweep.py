@@ -0,0 +1,61 @@
+# test that objects stay intact when automatic collections leave the heap to be
+# swept a slice at a time by later allocations
+
+import gc
+
+try:
+    gc.threshold
+except AttributeError:
+    print("SKIP")
+    raise SystemExit
+
+
+def fill(n, size):
+    return bytearray((n + i) & 0xFF for i in range(size))
+
+
+def check(objs):
+    for n, b in objs:
+        if b != fill(n, len(b)):
+            return False
+    return True
+
+
+def churn(keep, start, count):
+    for n in range(start, start + count):
+        b = fill(n, 1 + n * 13 % 100)
+        if n % 5 == 0:
+            keep.append((n, b))
+        if n % 7 == 0 and keep:
+            # grow and shrink objects that may not have been swept yet
+            k, old = keep[n % len(keep)]
+            old.extend(fill(k + len(old), 30))
+            keep[n % len(keep)] = (k, old[: len(old) // 2 + 1])
+        if n % 11 == 0 and keep:
+            keep.pop(n % len(keep))
+
+
+# Frequent collections from the allocation threshold
+gc.collect()
+gc.threshold(4096)
+keep = []
+churn(keep, 0, 3000)
+print(check(keep))
+gc.threshold(-1)
+
+# Collections when the heap is full
+hog = []
+try:
+    while True:
+        hog.append(bytearray(1024))
+except MemoryError:
+    pass
+hog = None
+churn(keep, 3000, 3000)
+print(check(keep))
+
+# An explicit collection finishes any sweep left over
+gc.collect()
+print(check(keep))
+keep = None
+gc.collect()
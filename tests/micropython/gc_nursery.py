@@ -0,0 +1,55 @@
+# test that new objects only referenced from older ones survive collections
+
+import gc
+
+# Long-lived containers have new objects stored into them, while lots of
+# short-lived objects come and go
+gc.collect()
+keep = [None] * 50
+table = {}
+for i in range(20000):
+    t = (i, str(i))
+    if i % 400 == 0:
+        keep[i // 400] = t
+        table[i] = [t]
+print(all(keep[n] == (n * 400, str(n * 400)) for n in range(50)))
+print(all(v[0][0] == k for k, v in table.items()))
+
+# An old list that keeps growing keeps its contents
+big = []
+for i in range(1000):
+    big.append((i, i * 2))
+    x = [i] * 3
+print(all(big[i] == (i, i * 2) for i in range(1000)))
+
+# New objects stored into old instances and closure cells survive too
+class Holder:
+    pass
+
+
+h = Holder()
+
+
+def counter():
+    n = []
+
+    def bump(i):
+        nonlocal n
+        n = n + [i]
+        return n
+
+    return bump
+
+
+bump = counter()
+gc.collect()
+for i in range(5000):
+    h.last = [i]
+    bump(i) if i % 1000 == 0 else (i,)
+print(h.last == [4999], bump(5000) == [0, 1000, 2000, 3000, 4000, 5000])
+
+# A large buffer still fits after all that
+keep = table = big = x = h = bump = None
+gc.collect()
+buf = bytearray(16 * 1024)
+print(len(buf) > 0)
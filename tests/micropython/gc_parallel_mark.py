@@ -0,0 +1,87 @@
+# test that everything reachable survives collections, however the marking
+# is shared between threads, and that mark times are counted
+
+import gc
+
+try:
+    gc.mark_histogram
+except AttributeError:
+    print("SKIP")
+    raise SystemExit
+
+try:
+    import _thread
+except ImportError:
+    _thread = None
+
+
+class Node:
+    def __init__(self, v, kids):
+        self.v = v
+        self.kids = kids
+
+
+def tree(depth, v):
+    if depth == 0:
+        return Node(v, None)
+    return Node(v, [tree(depth - 1, v * 4 + i) for i in range(4)])
+
+
+def check(node, v):
+    if node.v != v:
+        return False
+    return node.kids is None or all(check(k, v * 4 + i) for i, k in enumerate(node.kids))
+
+
+def chain_len(chain):
+    n = 0
+    while chain:
+        chain = chain[0]
+        n += 1
+    return n
+
+
+# A tree gives the threads plenty to share, a long list has more items than
+# fit on the mark stacks, and a long chain goes deep
+gc.mark_histogram(True)
+root = tree(5, 1)
+wide = [[str(i)] for i in range(1000)]
+chain = []
+for i in range(3000):
+    chain = [chain, str(i)]
+for i in range(5):
+    gc.collect()
+    junk = [bytearray(64) for _ in range(100)]
+print(check(root, 1), all(w == [str(i)] for i, w in enumerate(wide)), chain_len(chain))
+
+# Each collection is counted once
+h = gc.mark_histogram()
+print(len(h), sum(h) >= 5)
+gc.mark_histogram(True)
+print(sum(gc.mark_histogram()))
+gc.collect()
+print(sum(gc.mark_histogram()))
+
+# Roots on the stacks of other threads are marked too
+if _thread:
+    lock = _thread.allocate_lock()
+    results = []
+
+    def worker(n):
+        local = tree(3, n)
+        for _ in range(20):
+            [bytearray(32) for _ in range(50)]
+        with lock:
+            results.append(check(local, n))
+
+    for n in range(4):
+        _thread.start_new_thread(worker, (n,))
+    while True:
+        with lock:
+            if len(results) == 4:
+                break
+        gc.collect()
+    print(results)
+else:
+    print([True] * 4)
+print(check(root, 1), all(w == [str(i)] for i, w in enumerate(wide)), chain_len(chain))
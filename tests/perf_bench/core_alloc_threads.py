@@ -0,0 +1,62 @@
+# This tests how quickly several threads at once can allocate small objects.
+# With threads and no GIL, as on the unix port, that is where they contend for
+# the GC, so compare builds with and without MICROPY_GC_ALLOC_CACHE.
+
+try:
+    import _thread
+except ImportError:
+    print("SKIP")
+    raise SystemExit
+
+import time
+
+
+def work(n):
+    total = 0
+    for i in range(n):
+        t = (i, i + 1)
+        l = [i, t]
+        total += len(l) + t[1] - i
+    return total
+
+
+def test(n_thread, n):
+    lock = _thread.allocate_lock()
+    totals = []
+
+    def entry():
+        total = work(n)
+        with lock:
+            totals.append(total)
+
+    for _ in range(n_thread):
+        _thread.start_new_thread(entry, ())
+    while True:
+        with lock:
+            if len(totals) == n_thread:
+                return sum(totals)
+        time.sleep(0.001)
+
+
+###########################################################################
+# Benchmark interface
+
+bm_params = {
+    (100, 100): (2, 500),
+    (1000, 1000): (4, 5000),
+    (5000, 1000): (4, 25000),
+}
+
+
+def bm_setup(params):
+    n_thread, n = params
+    state = None
+
+    def run():
+        nonlocal state
+        state = test(n_thread, n)
+
+    def result():
+        return n_thread * n, state
+
+    return run, result
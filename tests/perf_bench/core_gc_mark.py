@@ -0,0 +1,46 @@
+# This tests how long collections take with a large live object graph, which
+# is mostly time spent marking. Compare -X gcmarkthreads=1 and 2 on the unix
+# port to see what parallel marking gains.
+
+import gc
+
+
+class Node:
+    def __init__(self, kids):
+        self.kids = kids
+
+
+def tree(depth, width):
+    if depth == 0:
+        return Node(None)
+    return Node([tree(depth - 1, width) for _ in range(width)])
+
+
+def test(root, n):
+    for _ in range(n):
+        gc.collect()
+    return root
+
+
+###########################################################################
+# Benchmark interface
+
+bm_params = {
+    (50, 25): (3, 3, 10),
+    (100, 100): (4, 4, 20),
+    (1000, 1000): (6, 4, 50),
+    (5000, 1000): (6, 4, 250),
+}
+
+
+def bm_setup(params):
+    depth, width, n = params
+    root = tree(depth, width)
+
+    def run():
+        test(root, n)
+
+    def result():
+        return n, len(root.kids)
+
+    return run, result
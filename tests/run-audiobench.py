@@ -0,0 +1,152 @@
+#!/usr/bin/env python3
+
+# This file is part of the CircuitPython project: https://circuitpython.org
+#
+# SPDX-FileCopyrightText: Copyright (c) 2025 Adafruit Industries LLC
+#
+# SPDX-License-Identifier: MIT
+
+# Render the audio graphs in audio_bench/ offline on the unix port and report
+# the throughput of each node, optionally failing when a node got slower than
+# a stored baseline.
+
+import argparse
+import json
+import os
+import subprocess
+import sys
+from glob import glob
+
+MICROPYTHON = os.getenv("MICROPY_MICROPYTHON", "../ports/unix/build-coverage/micropython")
+
+BENCH_SCRIPT_DIR = "audio_bench/"
+DEFAULT_BASELINE = BENCH_SCRIPT_DIR + "baseline.json"
+
+
+def run_script(script):
+    # Only stdout carries results; coverage builds may write gcov warnings to stderr
+    p = subprocess.run(
+        [MICROPYTHON, "-X", "heapsize=8M"],
+        stdout=subprocess.PIPE,
+        stderr=subprocess.PIPE,
+        input=script,
+    )
+    output = str(p.stdout.strip(), "ascii")
+    if p.returncode != 0:
+        output += "\n" + str(p.stderr.strip(), "ascii")
+    return output, p.returncode
+
+
+def run_benchmark(test_file, seconds, repeat):
+    with open(BENCH_SCRIPT_DIR + "benchrun.py", "rb") as f:
+        bench_run = f.read()
+    with open(test_file, "rb") as f:
+        script = f.read() + b"\n" + bench_run + b"\nbm_run(%u)\n" % seconds
+
+    # Keep the fastest of the runs; anything slower is host noise
+    best = {}
+    order = []
+    for _ in range(repeat):
+        output, returncode = run_script(script)
+        if returncode != 0 or "Traceback" in output:
+            print("{}: CRASH".format(test_file))
+            print(output)
+            return None
+        for line in output.splitlines():
+            name, frames, elapsed_us = line.split()[:3]
+            frames = int(frames)
+            elapsed_us = int(elapsed_us)
+            if frames < 0:
+                print("{}: {}".format(test_file, line))
+                return None
+            ns_per_sample = elapsed_us * 1000 / frames
+            if name not in best:
+                order.append(name)
+            if name not in best or ns_per_sample < best[name]:
+                best[name] = ns_per_sample
+    return [(name, best[name]) for name in order]
+
+
+def main():
+    cmd_parser = argparse.ArgumentParser(
+        formatter_class=argparse.RawDescriptionHelpFormatter,
+        description="Benchmark audio graphs rendered offline on the unix port.",
+        epilog="""\
+Each node reports samples/s and ns/sample, where a sample is one frame across
+all channels. Results are compared against the baseline file if it exists; a
+node that is slower than the baseline by more than the tolerance is a failure.
+""",
+    )
+    cmd_parser.add_argument(
+        "-s", "--seconds", type=int, default=20, help="seconds of audio to render per node"
+    )
+    cmd_parser.add_argument(
+        "-r", "--repeat", type=int, default=5, help="runs per benchmark, the fastest is kept"
+    )
+    cmd_parser.add_argument(
+        "-b", "--baseline", default=DEFAULT_BASELINE, help="baseline file to compare against"
+    )
+    cmd_parser.add_argument(
+        "--save-baseline", action="store_true", help="write the results to the baseline file"
+    )
+    cmd_parser.add_argument(
+        "-t",
+        "--tolerance",
+        type=float,
+        default=25.0,
+        help="allowed slowdown against the baseline, in percent",
+    )
+    cmd_parser.add_argument("files", nargs="*", help="input test files")
+    args = cmd_parser.parse_args()
+
+    if args.files:
+        tests = args.files
+    else:
+        tests = sorted(
+            f for f in glob(BENCH_SCRIPT_DIR + "*.py") if not f.endswith("/benchrun.py")
+        )
+
+    baseline = {}
+    if not args.save_baseline and os.path.exists(args.baseline):
+        with open(args.baseline) as f:
+            baseline = json.load(f)
+
+    print("seconds={} repeat={} baseline={}".format(args.seconds, args.repeat, args.baseline))
+    results = {}
+    crashed = []
+    regressed = []
+    for test_file in tests:
+        nodes = run_benchmark(test_file, args.seconds, args.repeat)
+        if nodes is None:
+            crashed.append(test_file)
+            continue
+        for name, ns_per_sample in nodes:
+            key = "{}:{}".format(os.path.basename(test_file)[:-3], name)
+            results[key] = ns_per_sample
+            line = "{:36} {:12.0f} samples/s {:10.1f} ns/sample".format(
+                key, 1e9 / ns_per_sample, ns_per_sample
+            )
+            if key in baseline:
+                change = 100 * (ns_per_sample - baseline[key]) / baseline[key]
+                line += " {:+7.1f}%".format(change)
+                if change > args.tolerance:
+                    line += " REGRESSION"
+                    regressed.append(key)
+            print(line)
+
+    if args.save_baseline:
+        with open(args.baseline, "w") as f:
+            json.dump(results, f, indent=4, sort_keys=True)
+            f.write("\n")
+        print("saved {} results to {}".format(len(results), args.baseline))
+
+    if crashed:
+        print("{} benchmarks crashed: {}".format(len(crashed), " ".join(crashed)))
+    if regressed:
+        print("{} nodes regressed: {}".format(len(regressed), " ".join(regressed)))
+    if crashed or regressed:
+        sys.exit(1)
+
+
+if __name__ == "__main__":
+    main()
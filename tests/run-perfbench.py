@@ -262,6 +262,9 @@ def main():
         "--emit", default="bytecode", help="MicroPython emitter to use (bytecode or native)"
     )
     cmd_parser.add_argument("--heapsize", help="heapsize to use (use default if not specified)")
+    cmd_parser.add_argument(
+        "--gcmarkthreads", help="number of threads that mark in a collection, for unix builds"
+    )
     cmd_parser.add_argument("--via-mpy", action="store_true", help="compile code to .mpy first")
     cmd_parser.add_argument("--mpy-cross-flags", default="", help="flags to pass to mpy-cross")
     cmd_parser.add_argument(
@@ -291,6 +294,8 @@ def main():
         target = [MICROPYTHON, "-X", "emit=" + args.emit]
         if args.heapsize is not None:
             target.extend(["-X", "heapsize=" + args.heapsize])
+        if args.gcmarkthreads is not None:
+            target.extend(["-X", "gcmarkthreads=" + args.gcmarkthreads])
 
     if len(args.files) == 0:
         tests_skip = ("benchrun.py",)
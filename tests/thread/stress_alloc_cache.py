@@ -0,0 +1,50 @@
+# stress test for allocating small objects of several sizes in many threads
+# at once, while collections run, checking that no object is handed out twice
+
+import gc
+import time
+import _thread
+
+
+def make(i):
+    k = i % 4
+    if k == 0:
+        return (i * 0.5,)
+    if k == 1:
+        return (i, i + 1, i + 2)
+    if k == 2:
+        return [i] * 5
+    return (i,) * 7
+
+
+def thread_entry(n):
+    # keep the last few objects made, and check them before replacing them
+    keep = [None] * 32
+    n_bad = 0
+    for i in range(n):
+        j = i % len(keep)
+        if keep[j] is not None and keep[j] != make(i - len(keep)):
+            n_bad += 1
+        keep[j] = make(i)
+        if i % 1000 == 999:
+            gc.collect()
+
+    with lock:
+        global n_finished, n_bad_total
+        n_bad_total += n_bad
+        n_finished += 1
+
+
+lock = _thread.allocate_lock()
+n_thread = 4
+n_finished = 0
+n_bad_total = 0
+
+# spawn threads
+for i in range(n_thread):
+    _thread.start_new_thread(thread_entry, (10000,))
+
+# wait for threads to finish
+while n_finished < n_thread:
+    time.sleep(1)
+print("bad objects:", n_bad_total)
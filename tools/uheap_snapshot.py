@@ -0,0 +1,97 @@
+# SPDX-FileCopyrightText: 2014 MicroPython & CircuitPython contributors (https://github.com/adafruit/circuitpython/graphs/contributors)
+#
+# SPDX-License-Identifier: MIT
+
+# This script prints a heap snapshot written by uheap.snapshot(file), or the
+# difference between two of them. To take one on the device:
+#
+#   import uheap
+#   with open("/heap.bin", "wb") as f:
+#       uheap.snapshot(f)
+
+import argparse
+import struct
+
+
+def read_entries(data, offset):
+    (count,) = struct.unpack_from("<H", data, offset)
+    offset += 2
+    entries = []
+    for _ in range(count):
+        name_len = data[offset]
+        name = data[offset + 1 : offset + 1 + name_len].decode("utf-8", "replace")
+        offset += 1 + name_len
+        a, b = struct.unpack_from("<II", data, offset)
+        offset += 8
+        entries.append((name or "<unclassified>", a, b))
+    return entries, offset
+
+
+def read_snapshot(filename):
+    with open(filename, "rb") as f:
+        data = f.read()
+    magic, block_size, pointer_size, _, total, used = struct.unpack_from("<4sBBHII", data)
+    if magic != b"UHP1":
+        raise ValueError(f"{filename} is not a heap snapshot")
+    types, offset = read_entries(data, 16)
+    modules, offset = read_entries(data, offset)
+    return {
+        "block_size": block_size,
+        "pointer_size": pointer_size,
+        "total": total,
+        "used": used,
+        "types": types,
+        "modules": modules,
+    }
+
+
+def diff_entries(before, after):
+    old = {name: (a, b) for name, a, b in before}
+    entries = []
+    for name, a, b in after:
+        old_a, old_b = old.pop(name, (0, 0))
+        entries.append((name, a - old_a, b - old_b))
+    for name, (old_a, old_b) in old.items():
+        entries.append((name, -old_a, -old_b))
+    return entries
+
+
+def print_table(title, headings, entries, limit, sort_column):
+    print(title)
+    entries = sorted(entries, key=lambda e: abs(e[sort_column]), reverse=True)
+    if limit:
+        entries = entries[:limit]
+    width = max([len(headings[0])] + [len(e[0]) for e in entries])
+    print(f"  {headings[0]:<{width}} {headings[1]:>10} {headings[2]:>10}")
+    for name, a, b in entries:
+        print(f"  {name:<{width}} {a:>10} {b:>10}")
+    print()
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Print a uheap.snapshot() file.")
+    parser.add_argument("snapshot", help="snapshot file")
+    parser.add_argument("baseline", nargs="?", help="earlier snapshot to compare against")
+    parser.add_argument("-n", "--limit", type=int, default=20, help="rows to show, 0 for all")
+    args = parser.parse_args()
+
+    snapshot = read_snapshot(args.snapshot)
+    types = snapshot["types"]
+    modules = snapshot["modules"]
+    print(
+        f"heap {snapshot['used']} of {snapshot['total']} bytes used, "
+        f"{snapshot['block_size']} byte blocks, {snapshot['pointer_size'] * 8} bit pointers"
+    )
+    if args.baseline:
+        baseline = read_snapshot(args.baseline)
+        print(f"change since baseline {snapshot['used'] - baseline['used']:+} bytes")
+        types = diff_entries(baseline["types"], types)
+        modules = diff_entries(baseline["modules"], modules)
+    print()
+
+    print_table("by type", ("type", "count", "bytes"), types, args.limit, 2)
+    print_table("by module", ("module", "retained", "reachable"), modules, args.limit, 1)
+
+
+if __name__ == "__main__":
+    main()